@@ -1,4 +1,4 @@
-QT       += core gui serialport charts multimedia
+QT       += core gui serialport charts multimedia qml
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -7,6 +7,16 @@ CONFIG += c++17
 RC_ICONS=logo/LD_Control.ico
 
 SOURCES += \
+    automation/characterizationrunner.cpp \
+    automation/devicesession.cpp \
+    automation/illuminanceregulator.cpp \
+    automation/pairedacquisition.cpp \
+    automation/scriptapi.cpp \
+    automation/scriptrunner.cpp \
+    automation/sequencerunner.cpp \
+    automation/station.cpp \
+    automation/stationpool.cpp \
+    automation/testsequence.cpp \
     communication/drivergeneral.cpp \
     main.cpp \
     mainwindow.cpp \
@@ -16,6 +26,8 @@ SOURCES += \
     communication/protocol.cpp \
     devices/driver/driverbase.cpp \
     devices/driver/driverwidget.cpp \
+    devices/driver/sweepengine.cpp \
+    devices/driver/channelcalibration.cpp \
     devices/driver/driver8ch/driver8ch.cpp \
     devices/driver/widgets/controlwidget.cpp \
     devices/driver/widgets/driverinfowidget.cpp \
@@ -24,27 +36,54 @@ SOURCES += \
     devices/driver/widgets/paramtablewidget.cpp \
     devices/load/loadbase.cpp \
     devices/load/it8512plus/it8512plus_widget.cpp \
+    devices/load/it8512plus/listsequenceeditor.cpp \
+    devices/load/it8512plus/listuploader.cpp \
+    devices/load/it8512plus/loadtelemetry.cpp \
+    devices/load/it8512plus/setpointmanager.cpp \
     devices/meter/meterbase.cpp \
+    devices/meter/cl200a/cl200aengine.cpp \
     devices/meter/cl200a/cl200awidget.cpp \
     menu/drivemenu.cpp \
+    station/stationoverview.cpp \
     serial/serialutil.cpp \
+    serial/serialtrace.cpp \
+    serial/replayport.cpp \
+    serial/portwatcher.cpp \
+    serial/reconnectsupervisor.cpp \
     splash/splashscreen.cpp \
     util/config.cpp \
+    util/colorimetry.cpp \
     util/datamanager.cpp \
     util/errorhandler.cpp \
     util/logger.cpp \
+    util/logcategories.cpp \
     chart/chartwidget.cpp
 
 
 HEADERS += \
+    automation/characterizationrunner.h \
+    automation/devicesession.h \
+    automation/illuminanceregulator.h \
+    automation/pairedacquisition.h \
+    automation/scriptapi.h \
+    automation/scriptrunner.h \
+    automation/sequencerunner.h \
+    automation/station.h \
+    automation/stationpool.h \
+    automation/testsequence.h \
     communication/drivergeneral.h \
     mainwindow.h \
     communication/driverprotocol.h \
     communication/eleload_itplus.h \
+    communication/fieldcodec.h \
+    communication/clblockcodec.h \
+    communication/fixedframedecoder.h \
     communication/cl_twozerozeroacom.h \
     communication/protocol.h \
     devices/driver/driverbase.h \
     devices/driver/driverwidget.h \
+    devices/driver/sweepengine.h \
+    devices/driver/channelcalibration.h \
     devices/driver/driver8ch/driver8ch.h \
     devices/driver/widgets/controlwidget.h \
     devices/driver/widgets/driverinfowidget.h \
@@ -52,17 +91,32 @@ HEADERS += \
     devices/driver/widgets/sliderwidget.h \
     devices/driver/widgets/paramtablewidget.h \
     devices/meter/meterbase.h \
+    devices/meter/cl200a/cl200aengine.h \
     devices/meter/cl200a/cl200awidget.h \
     menu/drivemenu.h \
+    station/stationoverview.h \
     serial/serialutil.h \
+    serial/serialtrace.h \
+    serial/replayport.h \
+    serial/portwatcher.h \
+    serial/reconnectsupervisor.h \
     splash/splashscreen.h \
     util/config.h \
+    util/colorimetry.h \
     util/datamanager.h \
+    util/devicestate.h \
     util/errorhandler.h \
     util/logger.h \
+    util/logcategories.h \
+    util/mpscqueue.h \
+    util/steadyclock.h \
     util/ToastMessage.h \
     devices/load/load_base.h \
     devices/load/it8512plus/it8512plus_widget.h \
+    devices/load/it8512plus/listsequenceeditor.h \
+    devices/load/it8512plus/listuploader.h \
+    devices/load/it8512plus/loadtelemetry.h \
+    devices/load/it8512plus/setpointmanager.h \
     chart/chartwidget.h
     
 
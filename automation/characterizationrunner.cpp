@@ -0,0 +1,225 @@
+#include "characterizationrunner.h"
+#include "communication/drivergeneral.h"
+#include "devices/driver/sweepengine.h"
+#include "devices/load/load_base.h"
+#include "devices/meter/meterbase.h"
+#include "serial/serialutil.h"
+#include "util/datamanager.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+
+using SteadyClock::toMs;
+
+CharacterizationRunner::CharacterizationRunner(SerialUtil *driverSerial, DriverGeneral *driver,
+                                               LoadBase *load, MeterBase *meter, QObject *parent)
+    : QObject(parent)
+    , m_driverSerial(driverSerial)
+    , m_driver(driver)
+    , m_load(load)
+    , m_meter(meter)
+{
+    qRegisterMetaType<CharacterizationRunner::Row>("CharacterizationRunner::Row");
+
+    m_settleTimer.setSingleShot(true);
+    m_settleTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_settleTimer, &QTimer::timeout, this, &CharacterizationRunner::onSettled);
+
+    connect(&m_acquisition, &PairedAcquisition::completed, this, &CharacterizationRunner::recordRow);
+    connect(&m_acquisition, &PairedAcquisition::timedOut, this, [this](const QString &missing) {
+        LOG_WARNING(QString("特性测试第 %1 步读数超时:%2").arg(m_index + 1).arg(missing));
+    });
+    if (m_meter) {
+        connect(m_meter, &MeterBase::singleMeasured, &m_acquisition, &PairedAcquisition::meterMeasured);
+        // 结束未完成的单次测量，下一步可以重新触发
+        connect(&m_acquisition, &PairedAcquisition::meterAbandoned, m_meter, &MeterBase::stopMeasurement);
+    }
+    if (m_load) {
+        connect(m_load, &LoadBase::sampleAcquired, &m_acquisition, &PairedAcquisition::loadSampled);
+    }
+}
+
+void CharacterizationRunner::setAddresses(quint8 sendAddress, quint8 receiveAddress)
+{
+    m_sendAddress = sendAddress;
+    m_receiveAddress = receiveAddress;
+}
+
+bool CharacterizationRunner::start(const Plan &plan)
+{
+    if (m_running) {
+        return false;
+    }
+    if (!m_driverSerial->isConnected()) {
+        LOG_ERROR("特性测试无法开始：驱动器串口未连接");
+        return false;
+    }
+
+    SweepEngine::Range range;
+    range.firstChannel = plan.firstChannel;
+    range.channelCount = plan.channelCount;
+    range.start = plan.start;
+    range.stop = plan.stop;
+    range.step = plan.step;
+    const int count = SweepEngine::stepCount(range);
+    if (count <= 0 || plan.firstChannel < 1 || plan.channelCount < 1 || plan.settleMs < 0 ||
+        plan.start < 0 || plan.start > 0xFFFF || plan.stop < 0 || plan.stop > 0xFFFF) {
+        LOG_WARNING("特性测试参数无效");
+        return false;
+    }
+
+    m_useMeter = m_meter && m_meter->isConnected();
+    m_useLoad = m_load && m_load->isConnected();
+    if (!m_useMeter && !m_useLoad) {
+        LOG_ERROR("特性测试无法开始：照度计和电子负载都未连接");
+        return false;
+    }
+    if (!m_useMeter) {
+        LOG_WARNING("特性测试：照度计未连接，只记录负载读数");
+    }
+    if (!m_useLoad) {
+        LOG_WARNING("特性测试：电子负载未连接，只记录照度计读数");
+    }
+
+    // 预先生成全部写入帧
+    m_values.clear();
+    m_frames.clear();
+    m_values.reserve(count);
+    m_frames.reserve(count);
+    for (int k = 0; k < count; ++k) {
+        const quint16 value = quint16(SweepEngine::valueAt(range, k));
+        m_values.append(value);
+        m_frames.append(m_driver->writeUniformLEDStrength(m_sendAddress, m_receiveAddress,
+                                                          quint8(plan.firstChannel), quint8(plan.channelCount), value));
+    }
+
+    m_plan = plan;
+    m_rows.clear();
+    m_rows.reserve(count);
+    m_index = 0;
+    m_running = true;
+    m_start = Clock::now();
+    LOG_INFO(QString("特性测试开始: 通道 %1~%2，%3 → %4 步长 %5，共 %6 步，稳定时间 %7 ms")
+             .arg(plan.firstChannel).arg(plan.firstChannel + plan.channelCount - 1)
+             .arg(plan.start).arg(plan.stop).arg(plan.step).arg(count).arg(plan.settleMs));
+    applyStep();
+    return m_running;
+}
+
+void CharacterizationRunner::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    finish(false);
+}
+
+// 写入本步的驱动强度并开始稳定等待
+void CharacterizationRunner::applyStep()
+{
+    if (!m_driverSerial->writeData(m_frames.at(m_index))) {
+        LOG_ERROR(QString("特性测试第 %1 步写入驱动强度失败").arg(m_index + 1));
+        finish(false);
+        return;
+    }
+    m_stepStart = Clock::now();
+
+    m_row = Row();
+    m_row.index = m_index;
+    m_row.value = m_values.at(m_index);
+    emit stepApplied(m_index, m_plan.firstChannel, m_plan.channelCount, m_row.value);
+
+    const int settle = m_plan.settleMs + (m_index == 0 ? m_plan.firstSettleMs : 0);
+    m_settleTimer.start(settle);
+}
+
+// 稳定后同时向照度计和负载请求读数
+void CharacterizationRunner::onSettled()
+{
+    if (!m_running) {
+        return;
+    }
+    m_row.settleMs = sinceStep(Clock::now());
+
+    const bool meterRequested = m_useMeter && m_meter->measureOnce();
+    if (m_useMeter && !meterRequested) {
+        LD_DEBUG(lcMeter) << "特性测试第" << m_index + 1 << "步无法触发照度计测量";
+    }
+    const bool loadRequested = m_useLoad && m_load->requestSample();
+    if (m_useLoad && !loadRequested) {
+        LD_DEBUG(lcLoad) << "特性测试第" << m_index + 1 << "步无法请求负载读数";
+    }
+
+    if (!m_acquisition.begin(meterRequested, loadRequested, m_plan.timeoutMs)) {
+        recordRow(PairedAcquisition::Result());
+    }
+}
+
+// 两个读数都到齐（或超时）后写入一行，进入下一步
+void CharacterizationRunner::recordRow(const PairedAcquisition::Result &result)
+{
+    if (!m_running) {
+        return;
+    }
+    m_row.meterOk = result.meterOk;
+    m_row.loadOk = result.loadOk;
+    m_row.meter = result.meter;
+    m_row.load = result.load;
+    if (result.meterOk) {
+        m_row.meterMs = sinceStep(result.meter.time);
+    }
+    if (result.loadOk) {
+        m_row.loadMs = sinceStep(result.load.time);
+    }
+    m_row.stepMs = sinceStep(Clock::now());
+    m_rows.append(m_row);
+
+    DataManager::instance()->addMeasurement(result.toMeasurementData(m_row.value, m_stepStart));
+
+    LD_DEBUG(lcMeter) << "特性测试第" << m_index + 1 << "步 强度" << m_row.value
+                      << "照度" << m_row.meter.ev << "电流" << m_row.load.current
+                      << "用时" << m_row.stepMs << "ms";
+    emit rowRecorded(m_row);
+
+    ++m_index;
+    if (m_index >= m_frames.size()) {
+        finish(true);
+        return;
+    }
+    applyStep();
+}
+
+void CharacterizationRunner::finish(bool completed)
+{
+    m_settleTimer.stop();
+    m_acquisition.cancel();
+    m_running = false;
+
+    Report report;
+    report.planned = m_frames.size();
+    report.recorded = m_rows.size();
+    report.completed = completed;
+    report.durationMs = toMs(Clock::now() - m_start);
+    double sumStep = 0;
+    for (const Row &row : m_rows) {
+        sumStep += row.stepMs;
+        if ((m_useMeter && !row.meterOk) || (m_useLoad && !row.loadOk)) {
+            ++report.incomplete;
+        }
+    }
+    if (!m_rows.isEmpty()) {
+        report.meanStepMs = sumStep / double(m_rows.size());
+    }
+
+    LOG_INFO(QString("特性测试%1: %2/%3 步，读数缺失 %4 步，用时 %5 s，平均每步 %6 ms")
+             .arg(completed ? "完成" : "停止")
+             .arg(report.recorded).arg(report.planned)
+             .arg(report.incomplete)
+             .arg(report.durationMs / 1000.0, 0, 'f', 1)
+             .arg(report.meanStepMs, 0, 'f', 0));
+    emit finished(report);
+}
+
+double CharacterizationRunner::sinceStep(Clock::time_point time) const
+{
+    return toMs(time - m_stepStart);
+}
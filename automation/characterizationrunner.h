@@ -0,0 +1,118 @@
+#ifndef CHARACTERIZATIONRUNNER_H
+#define CHARACTERIZATIONRUNNER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <chrono>
+#include "automation/pairedacquisition.h"
+#include "util/devicestate.h"
+
+class SerialUtil;
+class DriverGeneral;
+class LoadBase;
+class MeterBase;
+
+/**
+ * 特性测试（L-I-V / 光通-电流曲线）
+    每一步：写驱动强度（0x26）-> 等待稳定 -> 同时触发一次照度计EXT测量和取一次负载输入参数（0x5F）
+      -> 两个读数都到达（或超时）后写入 DataManager 一行，立即进入下一步
+    照度计和负载在各自的串口上并行收发，每一步用时约为 稳定时间 + max(照度计积分读取, 负载应答)
+    稳定时间可调：每步的稳定时间来自计划，第一步可附加一段时间（Characterization/FirstSettleMs）
+    负载读数只接受稳定之后才发出的查询的应答，照度计读数的触发时刻也在稳定之后，两者与驱动步对齐
+    每行记录驱动步开始到照度计触发、负载应答的时间，结束时统计每步平均用时
+    照度计或负载未连接时跳过该设备，只记录另一台
+ */
+class CharacterizationRunner : public QObject
+{
+    Q_OBJECT
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Plan {
+        int firstChannel = 1;       // 起始通道（寄存器号，从1开始）
+        int channelCount = 1;
+        int start = 0;
+        int stop = 0;               // 终止值（包含；步长走不到时停在最后一个不越过的值）
+        int step = 1;
+        int settleMs = 100;         // 每步写入后的稳定时间
+        int firstSettleMs = 0;      // 第一步附加的稳定时间
+        int timeoutMs = 3000;       // 等待读数的超时
+    };
+
+    // 一步的测量结果
+    struct Row {
+        int index = 0;
+        int value = 0;              // 驱动强度
+        bool meterOk = false;
+        bool loadOk = false;
+        MeterState meter;
+        LoadState load;
+        double settleMs = 0;        // 驱动步开始到开始读取
+        double meterMs = 0;         // 驱动步开始到照度计EXT触发
+        double loadMs = 0;          // 驱动步开始到负载应答
+        double stepMs = 0;          // 本步总用时
+    };
+
+    struct Report {
+        int planned = 0;
+        int recorded = 0;           // 已记录的行
+        int incomplete = 0;         // 有设备读数缺失的行
+        bool completed = false;
+        double durationMs = 0;
+        double meanStepMs = 0;
+    };
+
+    CharacterizationRunner(SerialUtil *driverSerial, DriverGeneral *driver,
+                           LoadBase *load, MeterBase *meter, QObject *parent = nullptr);
+
+    void setAddresses(quint8 sendAddress, quint8 receiveAddress);
+
+    bool start(const Plan &plan);   // 参数无效或驱动器未连接时返回false
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    const Plan &plan() const { return m_plan; }
+    const QVector<Row> &rows() const { return m_rows; }
+
+signals:
+    void stepApplied(int index, int firstChannel, int channelCount, int value);
+    void rowRecorded(const CharacterizationRunner::Row &row);
+    void finished(const CharacterizationRunner::Report &report);
+
+private slots:
+    void onSettled();
+    void recordRow(const PairedAcquisition::Result &result);
+
+private:
+    void applyStep();
+    void finish(bool completed);
+    double sinceStep(Clock::time_point time) const;
+
+    SerialUtil *m_driverSerial;
+    DriverGeneral *m_driver;
+    LoadBase *m_load;
+    MeterBase *m_meter;
+    quint8 m_sendAddress = 0x00;
+    quint8 m_receiveAddress = 0xFF;
+
+    QTimer m_settleTimer;
+    PairedAcquisition m_acquisition;
+
+    bool m_running = false;
+    Plan m_plan;
+    QVector<int> m_values;
+    QVector<QByteArray> m_frames;   // 预先生成的各步写入帧
+    int m_index = 0;
+    bool m_useMeter = false;
+    bool m_useLoad = false;
+
+    Clock::time_point m_start;
+    Clock::time_point m_stepStart;
+    Row m_row;
+    QVector<Row> m_rows;
+};
+
+Q_DECLARE_METATYPE(CharacterizationRunner::Row)
+
+#endif // CHARACTERIZATIONRUNNER_H
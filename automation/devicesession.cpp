@@ -0,0 +1,356 @@
+#include "devicesession.h"
+#include "devices/load/it8512plus/loadtelemetry.h"
+#include "devices/meter/cl200a/cl200aengine.h"
+#include "util/config.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+
+// ---------------------------------------------------------------- DriverSession
+
+DriverSession::DriverSession(QObject *parent)
+    : QObject(parent)
+    , m_serial(new SerialUtil(this))
+    , m_protocol(new DriverGeneral(this))
+{
+    m_handshakeTimer.setSingleShot(true);
+    m_handshakeTimer.setInterval(3000);
+    connect(&m_handshakeTimer, &QTimer::timeout, this, [this]() {
+        m_pending = false;
+        m_serial->disconnectPort();
+        emit failed("驱动器连接超时");
+    });
+    connect(m_serial, &SerialUtil::dataReceived, this, &DriverSession::onData);
+    connect(m_serial, &SerialUtil::portDisconnected, this, [this]() {
+        const bool wasReady = m_ready;
+        m_ready = false;
+        m_pending = false;
+        m_handshakeTimer.stop();
+        if (wasReady) {
+            emit disconnected();
+        }
+    });
+}
+
+bool DriverSession::open(const QString &portName)
+{
+    close();
+    if (!m_serial->connectToPort(portName, 115200)) {
+        emit failed("无法打开驱动器串口 " + portName);
+        return false;
+    }
+    m_receiveAddress = 0xFF;
+    m_pending = true;
+    m_serial->writeData(m_protocol->connectInit(m_sendAddress, m_receiveAddress));
+    m_handshakeTimer.start();
+    return true;
+}
+
+void DriverSession::close()
+{
+    m_handshakeTimer.stop();
+    m_pending = false;
+    m_ready = false;
+    if (m_serial->isConnected()) {
+        m_serial->disconnectPort();
+    }
+}
+
+void DriverSession::onData(const QByteArray &data)
+{
+    // 帧格式同 DriverWidget::handleSerialData：'LD' 长度 类型 发送方 接收方 功能码 数据 CRC
+    if (data.size() < 9 || quint8(data[0]) != 0x4C || quint8(data[1]) != 0x44) {
+        return;
+    }
+    const quint8 len = quint8(data[2]);
+    const quint8 sender = quint8(data[4]);
+    const quint8 function = quint8(data[6]);
+    if (m_pending && function == 0x08) {
+        const DriverGeneral::DriverMessage message = m_protocol->parseInit(data.mid(7, len - 3));
+        m_handshakeTimer.stop();
+        m_pending = false;
+        m_ready = true;
+        m_receiveAddress = sender;
+        m_channelCount = message.ChannelCount;
+        LOG_INFO(QString("驱动器已连接: %1，地址 %2，%3 通道")
+                 .arg(portName()).arg(sender, 2, 16, QChar('0')).arg(m_channelCount));
+        emit ready();
+    }
+}
+
+bool DriverSession::writeStrength(int firstChannel, int channelCount, int value)
+{
+    if (!m_ready || firstChannel < 1 || channelCount < 1) {
+        return false;
+    }
+    return m_serial->writeData(m_protocol->writeUniformLEDStrength(m_sendAddress, m_receiveAddress,
+                                                                   quint8(firstChannel), quint8(channelCount),
+                                                                   quint16(qBound(0, value, 0xFFFF))));
+}
+
+bool DriverSession::setLightOn(bool on)
+{
+    if (!m_ready) {
+        return false;
+    }
+    return m_serial->writeData(m_protocol->writeLEDOnOff(m_sendAddress, m_receiveAddress, on ? 0x0001 : 0x0000));
+}
+
+// ---------------------------------------------------------------- LoadSession
+
+LoadSession::LoadSession(QObject *parent)
+    : QObject(parent)
+    , m_serial(new SerialUtil(this))
+    , m_protocol(new EleLoad_ITPlus(0x00, this))
+{
+    // 与 IT8512Plus_Widget 相同：轮询先于其他处理连接协议信号
+    m_telemetry = new LoadTelemetry(m_serial, m_protocol, this);
+
+    m_handshakeTimer.setSingleShot(true);
+    m_handshakeTimer.setInterval(1000);
+    connect(&m_handshakeTimer, &QTimer::timeout, this, [this]() {
+        m_pending = false;
+        m_serial->disconnectPort();
+        emit failed("电子负载连接超时");
+    });
+    connect(m_serial, &SerialUtil::dataReceived, this, &LoadSession::onData);
+    connect(m_serial, &SerialUtil::portDisconnected, this, [this]() {
+        const bool wasReady = m_ready;
+        m_ready = false;
+        m_pending = false;
+        m_handshakeTimer.stop();
+        m_telemetry->stop();
+        m_protocol->state().reset();
+        if (wasReady) {
+            emit disconnected();
+        }
+    });
+    connect(m_protocol, &EleLoad_ITPlus::setResponseReceived, this, &LoadSession::onSetResponse);
+    connect(m_telemetry, &LoadTelemetry::freshSample, this, [this]() {
+        emit sampled(m_protocol->state().snapshot());
+    });
+}
+
+bool LoadSession::open(const QString &portName)
+{
+    close();
+    if (!m_serial->connectToPort(portName)) {
+        emit failed("无法打开电子负载串口 " + portName);
+        return false;
+    }
+    m_decoder.clear();
+    m_pending = true;
+    m_serial->writeData(m_protocol->createControlModeCommand(0x01));
+    m_handshakeTimer.start();
+    return true;
+}
+
+void LoadSession::close()
+{
+    m_handshakeTimer.stop();
+    m_telemetry->stop();
+    m_pending = false;
+    m_ready = false;
+    if (m_serial->isConnected()) {
+        m_serial->disconnectPort();
+    }
+}
+
+void LoadSession::onData(const QByteArray &data)
+{
+    const auto receivedAt = std::chrono::steady_clock::now();
+    m_decoder.append(data.constData(), data.size());
+    m_decoder.decode([this, receivedAt](const uint8_t *frame) {
+        const QByteArray packet = QByteArray::fromRawData(reinterpret_cast<const char *>(frame),
+                                                          EleLoad_ITPlus::CommandLength);
+        m_protocol->dispatchResponse(packet, receivedAt);
+    });
+}
+
+void LoadSession::onSetResponse(uint8_t status)
+{
+    if (m_pending) {
+        m_handshakeTimer.stop();
+        m_pending = false;
+        m_ready = true;
+        m_telemetry->start();
+        LOG_INFO("电子负载已连接: " + portName());
+        emit ready();
+        return;
+    }
+    emit acknowledged(status);
+}
+
+bool LoadSession::sendSetting(const QByteArray &command)
+{
+    return m_ready && m_serial->writeData(command);
+}
+
+bool LoadSession::requestSample()
+{
+    return m_ready && m_telemetry->requestSample();
+}
+
+// ---------------------------------------------------------------- MeterSession
+
+MeterSession::MeterSession(QObject *parent)
+    : QObject(parent)
+    , m_serial(new SerialUtil(this))
+    , m_protocol(new CL_TwoZeroZeroACOM(this))
+{
+    m_engine = new CL200AEngine(m_serial, m_protocol, this);
+
+    m_handshakeTimer.setSingleShot(true);
+    m_handshakeTimer.setInterval(2000);
+    connect(&m_handshakeTimer, &QTimer::timeout, this, [this]() {
+        fail("照度计初始化超时");
+    });
+    connect(m_serial, &SerialUtil::dataReceived, this, &MeterSession::onData);
+    connect(m_serial, &SerialUtil::portDisconnected, this, [this]() {
+        const bool wasReady = m_ready;
+        m_engine->stop();
+        m_ready = false;
+        m_phase = Phase::Closed;
+        ++m_handshakeId;
+        m_handshakeTimer.stop();
+        if (wasReady) {
+            emit disconnected();
+        }
+    });
+    connect(m_engine, &CL200AEngine::triggerCompleted, this, [this]() {
+        emit measured(true, m_engine->state().snapshot());
+    });
+    connect(m_engine, &CL200AEngine::triggerFailed, this, [this]() {
+        emit measured(false, m_engine->state().snapshot());
+    });
+}
+
+bool MeterSession::open(const QString &portName)
+{
+    close();
+    if (!m_serial->connectToPort(portName, QSerialPort::Baud9600, QSerialPort::Data7,
+                                 QSerialPort::EvenParity, QSerialPort::OneStop,
+                                 QSerialPort::NoFlowControl)) {
+        emit failed("无法打开照度计串口 " + portName);
+        return false;
+    }
+
+    QVector<int> heads;
+    const QStringList headList = Config::getValue(ConfigKeys::METER_HEADS, "0").toString().split(',');
+    for (const QString &head : headList) {
+        bool ok = false;
+        const int number = head.trimmed().toInt(&ok);
+        if (ok) {
+            heads.append(number);
+        }
+    }
+    m_engine->setHeads(heads);
+
+    m_received.clear();
+    m_phase = Phase::WaitingPCMode;
+    m_serial->writeData(m_protocol->setPCConnect54());
+    m_handshakeTimer.start();
+    return true;
+}
+
+void MeterSession::close()
+{
+    m_handshakeTimer.stop();
+    m_engine->stop();
+    m_phase = Phase::Closed;
+    ++m_handshakeId;
+    m_ready = false;
+    if (m_serial->isConnected()) {
+        m_serial->disconnectPort();
+    }
+}
+
+void MeterSession::fail(const QString &reason)
+{
+    close();
+    LOG_ERROR(reason);
+    emit failed(reason);
+}
+
+void MeterSession::onData(const QByteArray &data)
+{
+    m_received.append(data);
+    int end;
+    while ((end = m_received.indexOf("\r\n")) >= 0) {
+        const QByteArray frame = m_received.left(end + 2);
+        m_received.remove(0, end + 2);
+        handleFrame(frame);
+    }
+}
+
+// 握手顺序和等待时间同 CL200AWidget
+void MeterSession::handleFrame(const QByteArray &frame)
+{
+    switch (m_phase) {
+    case Phase::WaitingPCMode: {
+        m_handshakeTimer.stop();
+        const auto result = m_protocol->handleReceivedSettingResult(frame);
+        if (result.registerCode != "54" || result.err != ' ') {
+            fail("照度计设置PC模式失败");
+            return;
+        }
+        const quint32 handshake = m_handshakeId;
+        QTimer::singleShot(500, this, [this, handshake]() {
+            if (handshake != m_handshakeId || m_phase != Phase::WaitingPCMode) {
+                return;
+            }
+            m_serial->writeData(m_protocol->setHoldState55());
+            QTimer::singleShot(500, this, [this, handshake]() {
+                if (handshake != m_handshakeId || m_phase != Phase::WaitingPCMode) {
+                    return;
+                }
+                m_phase = Phase::WaitingEXTMode;
+                m_extHeadIndex = 0;
+                sendEXTMode();
+            });
+        });
+        break;
+    }
+    case Phase::WaitingEXTMode: {
+        m_handshakeTimer.stop();
+        const auto result = m_protocol->handleReceivedSettingResult(frame);
+        if (result.registerCode != "40" || result.err != ' ') {
+            fail("照度计设置EXT模式失败");
+            return;
+        }
+        if (++m_extHeadIndex < m_engine->heads().size()) {
+            sendEXTMode();
+            return;
+        }
+        const quint32 handshake = m_handshakeId;
+        QTimer::singleShot(175, this, [this, handshake]() {
+            if (handshake != m_handshakeId || m_phase != Phase::WaitingEXTMode) {
+                return;
+            }
+            m_phase = Phase::Ready;
+            m_ready = true;
+            LOG_INFO(QString("照度计已连接: %1（%2 个受光部）").arg(portName()).arg(m_engine->heads().size()));
+            emit ready();
+        });
+        break;
+    }
+    case Phase::Ready:
+        if (!m_engine->handleFrame(frame)) {
+            LD_DEBUG(lcMeter) << "ignored illuminometer frame:" << frame;
+        }
+        break;
+    case Phase::Closed:
+        break;
+    }
+}
+
+void MeterSession::sendEXTMode()
+{
+    const int head = m_engine->heads().at(m_extHeadIndex);
+    m_serial->writeData(m_protocol->setEXT40(CL200AEngine::headAddress(head)));
+    m_handshakeTimer.start();
+}
+
+bool MeterSession::measureOnce()
+{
+    return m_ready && m_engine->triggerOnce();
+}
@@ -0,0 +1,155 @@
+#ifndef DEVICESESSION_H
+#define DEVICESESSION_H
+
+#include <QObject>
+#include <QTimer>
+#include "serial/serialutil.h"
+#include "communication/drivergeneral.h"
+#include "communication/eleload_itplus.h"
+#include "communication/cl_twozerozeroacom.h"
+#include "communication/fixedframedecoder.h"
+#include "util/devicestate.h"
+
+class LoadTelemetry;
+class CL200AEngine;
+
+/**
+ * 无界面的设备会话
+    每个会话持有自己的 SerialUtil 和协议对象，完成与对应控制界面相同的连接握手，
+    只提供自动化流程需要的操作；不依赖界面模块，供无界面测试程序（tools/ldrunner）等使用
+    open() 立即返回，握手结果由 ready / failed 给出；串口断开发出 disconnected
+ */
+
+// LD驱动：初始化命令（0x08）应答后就绪，应答的发送方地址作为设备地址
+class DriverSession : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DriverSession(QObject *parent = nullptr);
+
+    bool open(const QString &portName);
+    void close();
+    bool isReady() const { return m_ready; }
+    QString portName() const { return m_serial->currentPortName(); }
+
+    quint8 address() const { return m_receiveAddress; }
+    int channelCount() const { return m_channelCount; }
+    SerialUtil *serial() const { return m_serial; }
+    DriverGeneral *protocol() const { return m_protocol; }
+
+    // 直接写串口，不经过50ms发送队列
+    bool writeStrength(int firstChannel, int channelCount, int value);
+    bool setLightOn(bool on);
+
+signals:
+    void ready();
+    void failed(const QString &reason);
+    void disconnected();
+
+private slots:
+    void onData(const QByteArray &data);
+
+private:
+    SerialUtil *m_serial;
+    DriverGeneral *m_protocol;
+    QTimer m_handshakeTimer;
+    quint8 m_sendAddress = 0x00;
+    quint8 m_receiveAddress = 0xFF;
+    int m_channelCount = 0;
+    bool m_pending = false;
+    bool m_ready = false;
+};
+
+// IT8512+ 电子负载：切换到PC控制并收到设置应答后就绪，随后开始输入参数轮询
+class LoadSession : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LoadSession(QObject *parent = nullptr);
+
+    bool open(const QString &portName);
+    void close();
+    bool isReady() const { return m_ready; }
+    QString portName() const { return m_serial->currentPortName(); }
+
+    SerialUtil *serial() const { return m_serial; }
+    EleLoad_ITPlus *protocol() const { return m_protocol; }
+    const DeviceState<LoadState> &state() const { return m_protocol->state(); }
+
+    // 发送一条设置命令，应答由 acknowledged 给出（0x80 为成功）
+    bool sendSetting(const QByteArray &command);
+    // 取一个在调用之后发出的查询的应答，由 sampled 给出
+    bool requestSample();
+
+signals:
+    void ready();
+    void failed(const QString &reason);
+    void disconnected();
+    void acknowledged(quint8 status);
+    void sampled(const LoadState &state);
+
+private slots:
+    void onData(const QByteArray &data);
+    void onSetResponse(uint8_t status);
+
+private:
+    SerialUtil *m_serial;
+    EleLoad_ITPlus *m_protocol;
+    LoadTelemetry *m_telemetry;
+    FixedFrameDecoder<EleLoad_ITPlus::CommandLength> m_decoder{EleLoad_ITPlus::SyncHeader,
+                                                              &EleLoad_ITPlus::validateFrame};
+    QTimer m_handshakeTimer;
+    bool m_pending = false;
+    bool m_ready = false;
+};
+
+// CL-200A 照度计：PC连接（54）-> 保持（55）-> 各受光部EXT模式（40）完成后就绪，测量由 CL200AEngine 单次触发
+class MeterSession : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MeterSession(QObject *parent = nullptr);
+
+    bool open(const QString &portName);
+    void close();
+    bool isReady() const { return m_ready; }
+    QString portName() const { return m_serial->currentPortName(); }
+
+    SerialUtil *serial() const { return m_serial; }
+    CL200AEngine *engine() const { return m_engine; }
+
+    bool measureOnce();     // 结果由 measured 给出
+
+signals:
+    void ready();
+    void failed(const QString &reason);
+    void disconnected();
+    void measured(bool ok, const MeterState &state);
+
+private slots:
+    void onData(const QByteArray &data);
+
+private:
+    enum class Phase {
+        Closed,
+        WaitingPCMode,
+        WaitingEXTMode,
+        Ready
+    };
+
+    void handleFrame(const QByteArray &frame);
+    void sendEXTMode();
+    void fail(const QString &reason);
+
+    SerialUtil *m_serial;
+    CL_TwoZeroZeroACOM *m_protocol;
+    CL200AEngine *m_engine;
+    QTimer m_handshakeTimer;
+    QByteArray m_received;
+    Phase m_phase = Phase::Closed;
+    quint32 m_handshakeId = 0;      // 每次打开和断开时递增，过期的延时回调据此放弃
+    int m_extHeadIndex = 0;
+    bool m_ready = false;
+};
+
+#endif // DEVICESESSION_H
@@ -0,0 +1,206 @@
+#include "illuminanceregulator.h"
+#include "communication/drivergeneral.h"
+#include "devices/meter/meterbase.h"
+#include "serial/serialutil.h"
+#include "util/config.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+#include "util/steadyclock.h"
+#include <cmath>
+
+using SteadyClock::toMs;
+
+IlluminanceRegulator::IlluminanceRegulator(SerialUtil *driverSerial, DriverGeneral *driver, MeterBase *meter,
+                                           QObject *parent)
+    : QObject(parent)
+    , m_driverSerial(driverSerial)
+    , m_driver(driver)
+    , m_meter(meter)
+{
+    connect(m_meter, &MeterBase::measurementUpdated, this, &IlluminanceRegulator::onMeasurement);
+}
+
+void IlluminanceRegulator::setAddresses(quint8 sendAddress, quint8 receiveAddress)
+{
+    m_sendAddress = sendAddress;
+    m_receiveAddress = receiveAddress;
+}
+
+IlluminanceRegulator::Settings IlluminanceRegulator::loadSettings()
+{
+    Settings settings;
+    settings.kp = Config::getValue(ConfigKeys::REGULATOR_KP, settings.kp).toDouble();
+    settings.ki = Config::getValue(ConfigKeys::REGULATOR_KI, settings.ki).toDouble();
+    settings.kd = Config::getValue(ConfigKeys::REGULATOR_KD, settings.kd).toDouble();
+    settings.outputMax = Config::getValue(ConfigKeys::REGULATOR_OUTPUT_MAX, settings.outputMax).toInt();
+    settings.tolerance = Config::getValue(ConfigKeys::REGULATOR_TOLERANCE, settings.tolerance).toDouble();
+    settings.settleSamples = Config::getValue(ConfigKeys::REGULATOR_SETTLE_SAMPLES, settings.settleSamples).toInt();
+    return settings;
+}
+
+bool IlluminanceRegulator::start(const Settings &settings, double target, int initialOutput)
+{
+    if (m_running) {
+        return false;
+    }
+    if (!m_driverSerial->isConnected()) {
+        LOG_ERROR("恒照度无法开始：驱动器串口未连接");
+        return false;
+    }
+    if (settings.firstChannel < 1 || settings.channelCount < 1 || settings.outputMin < 0 ||
+        settings.outputMax > 0xFFFF || settings.outputMin >= settings.outputMax || target <= 0 ||
+        (!settings.weights.isEmpty() && settings.weights.size() != settings.channelCount)) {
+        LOG_WARNING("恒照度参数无效");
+        return false;
+    }
+
+    m_settings = settings;
+    m_settings.settleSamples = qMax(1, m_settings.settleSamples);
+    m_output = qBound(settings.outputMin, initialOutput, settings.outputMax);
+    m_integral = m_output;
+    m_hasMeasured = false;
+    m_lastWrite = Clock::now();     // 开始之前触发的样本不参与计算
+    m_running = true;
+    m_target = target;
+    resetReport();
+
+    LOG_INFO(QString("恒照度开始: 目标 %1 lx，通道 %2~%3，Kp %4 Ki %5 Kd %6，起始强度 %7")
+             .arg(target, 0, 'f', 1)
+             .arg(settings.firstChannel).arg(settings.firstChannel + settings.channelCount - 1)
+             .arg(settings.kp).arg(settings.ki).arg(settings.kd).arg(m_output));
+    return true;
+}
+
+void IlluminanceRegulator::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    LOG_INFO(QString("恒照度结束: 目标 %1 lx，%2，超调 %3%，样本 %4（丢弃 %5），写入 %6 次")
+             .arg(m_report.target, 0, 'f', 1)
+             .arg(m_report.settled ? QString("调节时间 %1 ms").arg(m_report.settlingMs, 0, 'f', 0) : QString("未稳定"))
+             .arg(m_report.overshootPercent, 0, 'f', 1)
+             .arg(m_report.samples).arg(m_report.dropped).arg(m_report.writes));
+    emit stopped(m_report);
+}
+
+void IlluminanceRegulator::setTarget(double target)
+{
+    if (target <= 0 || target == m_target) {
+        return;
+    }
+    m_target = target;
+    if (m_running) {
+        resetReport();
+    }
+}
+
+void IlluminanceRegulator::resetReport()
+{
+    m_report = Report();
+    m_report.target = m_target;
+    m_targetTime = Clock::now();
+    m_initialError = m_hasMeasured ? m_target - m_lastMeasured : 0;
+    m_initialKnown = m_hasMeasured;
+    m_inBand = 0;
+}
+
+void IlluminanceRegulator::onMeasurement(float illuminance)
+{
+    if (!m_running) {
+        return;
+    }
+
+    // 样本的EXT触发时刻：早于上一次写入说明积分期间强度还是旧值
+    const DeviceState<MeterState> *state = m_meter->state();
+    const Clock::time_point sampleTime = state ? state->snapshot().time : Clock::now();
+    if (sampleTime < m_lastWrite) {
+        ++m_report.dropped;
+        return;
+    }
+
+    const double measured = illuminance;
+    const double error = m_target - measured;
+    const double dt = m_hasMeasured ? toMs(sampleTime - m_lastSampleTime) / 1000.0 : 0.0;
+    if (!m_initialKnown) {
+        m_initialError = error;
+        m_initialKnown = true;
+    }
+
+    // 位置式 PID，微分作用于测量值
+    const double proportional = m_settings.kp * error;
+    const double derivative = (dt > 0 && m_hasMeasured) ? -m_settings.kd * (measured - m_lastMeasured) / dt : 0.0;
+    const double integral = m_integral + m_settings.ki * error * dt;
+    const double unclamped = proportional + integral + derivative;
+    const double clamped = qBound(double(m_settings.outputMin), unclamped, double(m_settings.outputMax));
+
+    // 抗积分饱和：饱和且误差继续推向饱和方向时保持积分项
+    const bool windingUp = (unclamped > m_settings.outputMax && error > 0) ||
+                           (unclamped < m_settings.outputMin && error < 0);
+    if (!windingUp) {
+        m_integral = integral;
+    }
+
+    m_lastMeasured = measured;
+    m_lastSampleTime = sampleTime;
+    m_hasMeasured = true;
+    ++m_report.samples;
+    m_report.finalError = error;
+
+    const int output = int(std::lround(clamped));
+    if (output != m_output) {
+        if (!writeOutput(output)) {
+            stop();
+            return;
+        }
+    }
+    emit updated(measured, m_output, error);
+
+    // 超调：越过目标的最大幅度（相对起始误差的方向）
+    if (!m_report.settled) {
+        const double beyond = m_initialError >= 0 ? measured - m_target : m_target - measured;
+        if (beyond > 0) {
+            m_report.overshootPercent = qMax(m_report.overshootPercent, beyond / m_target * 100.0);
+        }
+
+        if (std::fabs(error) <= m_settings.tolerance * m_target) {
+            if (m_inBand == 0) {
+                m_bandEntry = sampleTime;
+            }
+            if (++m_inBand >= m_settings.settleSamples) {
+                m_report.settled = true;
+                m_report.settlingMs = qMax(0.0, toMs(m_bandEntry - m_targetTime));
+                LOG_INFO(QString("恒照度已稳定: 目标 %1 lx，调节时间 %2 ms，超调 %3%")
+                         .arg(m_target, 0, 'f', 1)
+                         .arg(m_report.settlingMs, 0, 'f', 0)
+                         .arg(m_report.overshootPercent, 0, 'f', 1));
+                emit settled(m_report);
+            }
+        } else {
+            m_inBand = 0;
+        }
+    }
+}
+
+bool IlluminanceRegulator::writeOutput(int value)
+{
+    const int count = m_settings.channelCount;
+    QVector<quint16> values(count);
+    for (int c = 0; c < count; ++c) {
+        const double weight = m_settings.weights.isEmpty() ? 1.0 : m_settings.weights.at(c);
+        values[c] = quint16(qBound(0L, std::lround(value * weight), 0xFFFFL));
+    }
+    const QByteArray frame = m_driver->writeLEDStrengths(m_sendAddress, m_receiveAddress,
+                                                         quint8(m_settings.firstChannel), values);
+    if (!m_driverSerial->writeData(frame)) {
+        LOG_ERROR("恒照度写入驱动强度失败");
+        return false;
+    }
+    m_lastWrite = Clock::now();
+    m_output = value;
+    ++m_report.writes;
+    LD_DEBUG(lcMeter) << "恒照度输出" << value;
+    emit outputWritten(m_settings.firstChannel, count, value);
+    return true;
+}
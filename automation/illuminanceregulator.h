@@ -0,0 +1,106 @@
+#ifndef ILLUMINANCEREGULATOR_H
+#define ILLUMINANCEREGULATOR_H
+
+#include <QObject>
+#include <QVector>
+#include <chrono>
+
+class SerialUtil;
+class DriverGeneral;
+class MeterBase;
+
+/**
+ * 恒照度闭环（PID）
+    照度计每给出一个新样本（measurementUpdated）计算一次，按结果写驱动强度（0x26），
+      控制频率就是照度计的实际采样率，不另设定时器
+    EXT触发时刻早于上一次写入的样本（积分期间强度还没变）直接丢弃，避免按旧读数重复修正
+    PID 为位置式：比例项、积分项、对测量值的微分项（目标突变时没有微分冲击）；
+      积分项从当前输出起算（无扰切换），输出饱和且误差继续推向饱和方向时停止积分（抗积分饱和）
+    通道范围内各通道写同一输出，可按权重分配（各通道光效不同时）
+    每次设定目标后统计：超调量（越过目标的最大幅度，百分比）和调节时间（误差连续 N 个样本落在容差带内的起始时刻）
+    增益和容差由配置项 Regulator/* 给出
+ */
+class IlluminanceRegulator : public QObject
+{
+    Q_OBJECT
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings {
+        int firstChannel = 1;
+        int channelCount = 1;
+        QVector<double> weights;    // 各通道输出权重，空表示全部为1
+        double kp = 0.02;           // 强度/lx
+        double ki = 0.1;            // 强度/(lx·s)
+        double kd = 0.0;            // 强度·s/lx
+        int outputMin = 0;
+        int outputMax = 255;
+        double tolerance = 0.02;    // 容差带，相对目标值
+        int settleSamples = 3;      // 连续落在容差带内的样本数
+    };
+
+    struct Report {
+        double target = 0;
+        bool settled = false;
+        double settlingMs = 0;      // 设定目标到进入容差带（之后不再离开 settleSamples 个样本）
+        double overshootPercent = 0;
+        double finalError = 0;      // 最近一次的误差（lx）
+        int samples = 0;            // 参与计算的样本数
+        int dropped = 0;            // 触发早于写入而丢弃的样本数
+        int writes = 0;             // 写入驱动强度的次数
+    };
+
+    IlluminanceRegulator(SerialUtil *driverSerial, DriverGeneral *driver, MeterBase *meter,
+                         QObject *parent = nullptr);
+
+    void setAddresses(quint8 sendAddress, quint8 receiveAddress);
+    static Settings loadSettings();     // 按配置项填写增益和容差
+
+    // initialOutput：当前驱动强度，积分项从此起算
+    bool start(const Settings &settings, double target, int initialOutput);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    void setTarget(double target);      // 运行中修改目标，重新统计超调和调节时间
+    double target() const { return m_target; }
+    const Report &report() const { return m_report; }
+
+signals:
+    void outputWritten(int firstChannel, int channelCount, int value);
+    void updated(double illuminance, int output, double error);
+    void settled(const IlluminanceRegulator::Report &report);
+    void stopped(const IlluminanceRegulator::Report &report);      // 停止（调用 stop 或写入失败）
+
+private slots:
+    void onMeasurement(float illuminance);
+
+private:
+    void resetReport();
+    bool writeOutput(int value);
+
+    SerialUtil *m_driverSerial;
+    DriverGeneral *m_driver;
+    MeterBase *m_meter;
+    quint8 m_sendAddress = 0x00;
+    quint8 m_receiveAddress = 0xFF;
+
+    bool m_running = false;
+    Settings m_settings;
+    double m_target = 0;
+
+    double m_integral = 0;          // 积分项（含起始输出）
+    double m_lastMeasured = 0;
+    bool m_hasMeasured = false;
+    int m_output = 0;
+    Clock::time_point m_lastSampleTime;     // 上一个参与计算的样本的触发时刻
+    Clock::time_point m_lastWrite;
+
+    Clock::time_point m_targetTime;
+    double m_initialError = 0;      // 设定目标时的误差，决定超调的方向
+    bool m_initialKnown = false;
+    int m_inBand = 0;
+    Clock::time_point m_bandEntry;
+    Report m_report;
+};
+
+#endif // ILLUMINANCEREGULATOR_H
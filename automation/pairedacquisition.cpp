@@ -0,0 +1,100 @@
+#include "pairedacquisition.h"
+#include "util/datamanager.h"
+
+PairedAcquisition::Clock::time_point PairedAcquisition::Result::time(Clock::time_point fallback) const
+{
+    return meterOk ? meter.time : loadOk ? load.time : fallback;
+}
+
+MeasurementData PairedAcquisition::Result::toMeasurementData(int drive, Clock::time_point fallback) const
+{
+    MeasurementData data;
+    data.timestamp = SteadyClock::wallTime(time(fallback));
+    data.voltage = load.voltage;
+    data.current = load.current;
+    data.power = load.power;
+    data.resistance = loadOk ? load.voltage / (load.current > 0.001f ? load.current : 0.001f) : 0;
+    data.illuminance = meter.ev;
+    data.colorTemp = meter.tcp;
+    data.r = meter.X;
+    data.g = meter.Y;
+    data.b = meter.Z;
+    data.drive = drive;
+    return data;
+}
+
+PairedAcquisition::PairedAcquisition(QObject *parent)
+    : QObject(parent)
+{
+    m_timeoutTimer.setSingleShot(true);
+    connect(&m_timeoutTimer, &QTimer::timeout, this, &PairedAcquisition::onTimeout);
+}
+
+bool PairedAcquisition::begin(bool meterRequested, bool loadRequested, int timeoutMs)
+{
+    cancel();
+    if (!meterRequested && !loadRequested) {
+        return false;
+    }
+    m_result = Result();
+    m_meterPending = meterRequested;
+    m_loadPending = loadRequested;
+    m_timeoutTimer.start(timeoutMs);
+    return true;
+}
+
+void PairedAcquisition::cancel()
+{
+    m_timeoutTimer.stop();
+    const bool meterPending = m_meterPending;
+    m_meterPending = false;
+    m_loadPending = false;
+    if (meterPending) {
+        emit meterAbandoned();
+    }
+}
+
+void PairedAcquisition::meterMeasured(bool ok, const MeterState &state)
+{
+    if (!m_meterPending) {
+        return;
+    }
+    m_meterPending = false;
+    m_result.meterOk = ok;
+    if (ok) {
+        m_result.meter = state;
+    }
+    if (!m_loadPending) {
+        complete();
+    }
+}
+
+void PairedAcquisition::loadSampled(const LoadState &state)
+{
+    if (!m_loadPending) {
+        return;
+    }
+    m_loadPending = false;
+    m_result.loadOk = true;
+    m_result.load = state;
+    if (!m_meterPending) {
+        complete();
+    }
+}
+
+void PairedAcquisition::onTimeout()
+{
+    if (!isActive()) {
+        return;
+    }
+    emit timedOut(QString("%1%2").arg(m_meterPending ? " 照度计" : "").arg(m_loadPending ? " 电子负载" : ""));
+    cancel();
+    complete();
+}
+
+void PairedAcquisition::complete()
+{
+    m_timeoutTimer.stop();
+    const Result result = m_result;     // 接收方可能立即开始下一次读数
+    emit completed(result);
+}
@@ -0,0 +1,62 @@
+#ifndef PAIREDACQUISITION_H
+#define PAIREDACQUISITION_H
+
+#include <QObject>
+#include <QTimer>
+#include "util/devicestate.h"
+#include "util/steadyclock.h"
+
+struct MeasurementData;
+
+/**
+ * 照度计 + 电子负载配对读数
+    调用者先触发照度计单次测量和负载新读数请求，再用 begin() 说明哪些已经发出；
+    设备的结果接到 meterMeasured / loadSampled，两者到齐或超时后发出 completed
+    超时或取消时若照度计读数未到，发出 meterAbandoned，由调用者结束未完成的单次测量，下一次可以重新触发
+    特性测试、测试脚本和测试序列共用
+ */
+class PairedAcquisition : public QObject
+{
+    Q_OBJECT
+public:
+    using Clock = SteadyClock::Clock;
+
+    struct Result {
+        bool meterOk = false;
+        bool loadOk = false;
+        MeterState meter;
+        LoadState load;
+
+        // 读数时刻：照度计触发时刻，其次负载应答时刻，都没有时为 fallback
+        Clock::time_point time(Clock::time_point fallback) const;
+        // DataManager 的一行（电阻 = 电压 / 电流，电流不足 1mA 时按 1mA 计）
+        MeasurementData toMeasurementData(int drive, Clock::time_point fallback) const;
+    };
+
+    explicit PairedAcquisition(QObject *parent = nullptr);
+
+    // 两者都未发出时返回 false，不进入等待
+    bool begin(bool meterRequested, bool loadRequested, int timeoutMs);
+    void cancel();          // 放弃当前读数，不发出 completed
+    bool isActive() const { return m_meterPending || m_loadPending; }
+
+public slots:
+    void meterMeasured(bool ok, const MeterState &state);
+    void loadSampled(const LoadState &state);
+
+signals:
+    void completed(const PairedAcquisition::Result &result);
+    void timedOut(const QString &missing);      // 未到的读数，如 " 照度计 电子负载"，在 completed 之前发出
+    void meterAbandoned();
+
+private:
+    void onTimeout();
+    void complete();
+
+    QTimer m_timeoutTimer;
+    bool m_meterPending = false;
+    bool m_loadPending = false;
+    Result m_result;
+};
+
+#endif // PAIREDACQUISITION_H
@@ -0,0 +1,266 @@
+#include "scriptapi.h"
+#include "util/errorhandler.h"
+#include "util/steadyclock.h"
+#include <QJSEngine>
+#include <QSemaphore>
+#include <cmath>
+
+using SteadyClock::toMs;
+
+namespace {
+    const int PollMs = 50;      // 等待界面线程或定时期间检查停止请求的间隔
+}
+
+ScriptApi::ScriptApi(ScriptRunner *runner, QJSEngine *engine, int channelCount)
+    : m_runner(runner)
+    , m_engine(engine)
+    , m_channelCount(channelCount)
+    , m_start(ScriptRunner::Clock::now())
+{
+}
+
+// 脚本可见的接口，参数检查在这里完成，出错时抛出带行号的异常
+const char *ScriptApi::prelude()
+{
+    return R"JS(
+var driver = {
+    set: function (first, count, value) {
+        if (value === undefined) { value = count; count = 1; }
+        __ld.setStrength(first, count, value);
+    },
+    all: function (value) { __ld.setStrength(1, __ld.channelCount(), value); },
+    light: function (on) { __ld.light(on === undefined ? true : !!on); },
+    get channels() { return __ld.channelCount(); }
+};
+var load = {
+    cc: function (a) { __ld.loadConstant(0, a); },
+    cv: function (v) { __ld.loadConstant(1, v); },
+    cw: function (w) { __ld.loadConstant(2, w); },
+    cr: function (ohm) { __ld.loadConstant(3, ohm); },
+    input: function (on) { __ld.loadInput(on === undefined ? true : !!on); }
+};
+function wait(ms) { __ld.wait(ms); }
+function measure() { return __ld.measure(); }
+function check(name, value, min, max) {
+    return __ld.check(name, value, min === undefined ? -Infinity : min, max === undefined ? Infinity : max);
+}
+function assert(condition, message) {
+    if (!condition) { __ld.fail(message === undefined ? "assert" : String(message)); }
+}
+function log() { __ld.log(Array.prototype.slice.call(arguments).join(" ")); }
+function elapsed() { return __ld.elapsed(); }
+function sweep(first, count, start, stop, step, settleMs, fn) {
+    if (!(step > 0)) { throw new Error("sweep: step 必须大于0"); }
+    var direction = stop >= start ? 1 : -1;
+    for (var value = start; direction > 0 ? value <= stop : value >= stop; value += direction * step) {
+        driver.set(first, count, value);
+        wait(settleMs);
+        var result = measure();
+        if (fn) { fn(value, result); }
+    }
+}
+)JS";
+}
+
+bool ScriptApi::checkStopped()
+{
+    if (m_runner->isStopping()) {
+        m_engine->throwError("已停止");
+        return true;
+    }
+    return false;
+}
+
+bool ScriptApi::call(const std::function<bool()> &function)
+{
+    auto done = std::make_shared<QSemaphore>();
+    auto result = std::make_shared<bool>(false);
+    QMetaObject::invokeMethod(m_runner, [function, done, result]() {
+        *result = function();
+        done->release();
+    }, Qt::QueuedConnection);
+    while (!done->tryAcquire(1, PollMs)) {
+        if (checkStopped()) {
+            return false;
+        }
+    }
+    return *result;
+}
+
+void ScriptApi::setStrength(int firstChannel, int count, int value)
+{
+    if (checkStopped()) {
+        return;
+    }
+    if (firstChannel < 1 || count < 1 || firstChannel + count - 1 > m_channelCount) {
+        m_engine->throwError(QString("driver.set: 通道 %1~%2 超出 1~%3")
+                             .arg(firstChannel).arg(firstChannel + count - 1).arg(m_channelCount));
+        return;
+    }
+    if (value < 0 || value > 0xFFFF) {
+        m_engine->throwError(QString("driver.set: 强度 %1 超出 0~65535").arg(value));
+        return;
+    }
+    ++m_strengthCalls;
+    for (int channel = firstChannel; channel < firstChannel + count; ++channel) {
+        m_pending[channel] = value;
+    }
+}
+
+bool ScriptApi::flush()
+{
+    if (m_pending.isEmpty()) {
+        return true;
+    }
+    const QMap<int, int> values = m_pending;
+    m_pending.clear();
+    ScriptRunner *runner = m_runner;
+    if (!call([runner, values]() { return runner->writeStrengths(values); })) {
+        if (!m_runner->isStopping()) {
+            m_engine->throwError("写驱动强度失败（驱动器未连接？）");
+        }
+        return false;
+    }
+    return true;
+}
+
+void ScriptApi::light(bool on)
+{
+    if (checkStopped() || !flush()) {
+        return;
+    }
+    ScriptRunner *runner = m_runner;
+    if (!call([runner, on]() { return runner->writeLight(on); }) && !m_runner->isStopping()) {
+        m_engine->throwError("写LED开关失败（驱动器未连接？）");
+    }
+}
+
+void ScriptApi::loadConstant(int mode, double value)
+{
+    if (checkStopped() || !flush()) {
+        return;
+    }
+    if (!std::isfinite(value) || value < 0) {
+        m_engine->throwError(QString("load: 定值 %1 无效").arg(value));
+        return;
+    }
+    ScriptRunner *runner = m_runner;
+    if (!call([runner, mode, value]() { return runner->applyLoadConstant(mode, value); }) &&
+        !m_runner->isStopping()) {
+        m_engine->throwError("负载设置失败（未连接或超出负载界面的设定范围）");
+    }
+}
+
+void ScriptApi::loadInput(bool on)
+{
+    if (checkStopped() || !flush()) {
+        return;
+    }
+    ScriptRunner *runner = m_runner;
+    if (!call([runner, on]() { return runner->setLoadInput(on); }) && !m_runner->isStopping()) {
+        m_engine->throwError("负载输入开关失败（负载未连接？）");
+    }
+}
+
+void ScriptApi::wait(int ms)
+{
+    if (checkStopped() || !flush()) {
+        return;
+    }
+    // 按绝对截止时刻等待，分段检查停止请求
+    const auto deadline = ScriptRunner::Clock::now() + std::chrono::milliseconds(qMax(0, ms));
+    QSemaphore sleeper;
+    for (;;) {
+        const double remaining = toMs(deadline - ScriptRunner::Clock::now());
+        if (remaining <= 0 || checkStopped()) {
+            return;
+        }
+        sleeper.tryAcquire(1, qMin(PollMs, int(std::ceil(remaining))));
+    }
+}
+
+QJSValue ScriptApi::measure()
+{
+    if (checkStopped() || !flush()) {
+        return QJSValue();
+    }
+    auto measurement = std::make_shared<ScriptRunner::Measurement>();
+    ScriptRunner *runner = m_runner;
+    if (!call([runner, measurement]() { return runner->beginMeasure(measurement); })) {
+        if (!m_runner->isStopping()) {
+            m_engine->throwError("measure: 照度计和电子负载都未连接");
+        }
+        return QJSValue();
+    }
+    // 超时由界面线程处理，这里只等待结果或停止
+    while (!measurement->done.tryAcquire(1, PollMs)) {
+        if (checkStopped()) {
+            return QJSValue();
+        }
+    }
+    ++m_measurements;
+
+    QJSValue result = m_engine->newObject();
+    const MeterState &m = measurement->meter;
+    const LoadState &l = measurement->load;
+    const double nan = std::nan("");
+    result.setProperty("meterOk", measurement->meterOk);
+    result.setProperty("loadOk", measurement->loadOk);
+    result.setProperty("drive", measurement->drive);
+    result.setProperty("ev", measurement->meterOk ? double(m.ev) : nan);
+    result.setProperty("x", measurement->meterOk ? double(m.x) : nan);
+    result.setProperty("y", measurement->meterOk ? double(m.y) : nan);
+    result.setProperty("u", measurement->meterOk ? double(m.u) : nan);
+    result.setProperty("v", measurement->meterOk ? double(m.v) : nan);
+    result.setProperty("tcp", measurement->meterOk ? double(m.tcp) : nan);
+    result.setProperty("duv", measurement->meterOk ? double(m.duv) : nan);
+    result.setProperty("X", measurement->meterOk ? double(m.X) : nan);
+    result.setProperty("Y", measurement->meterOk ? double(m.Y) : nan);
+    result.setProperty("Z", measurement->meterOk ? double(m.Z) : nan);
+    result.setProperty("voltage", measurement->loadOk ? double(l.voltage) : nan);
+    result.setProperty("current", measurement->loadOk ? double(l.current) : nan);
+    result.setProperty("power", measurement->loadOk ? double(l.power) : nan);
+    return result;
+}
+
+bool ScriptApi::check(const QString &name, double value, double min, double max)
+{
+    const bool passed = !std::isnan(value) && value >= min && value <= max;
+    ++m_checks;
+    if (!passed) {
+        ++m_failedChecks;
+    }
+    const QString line = QString("检查 %1 = %2 [%3, %4] %5")
+            .arg(name).arg(value).arg(min).arg(max).arg(passed ? "通过" : "不通过");
+    if (passed) {
+        LOG_INFO("脚本" + line);
+    } else {
+        LOG_WARNING("脚本" + line);
+    }
+    emit m_runner->output(line);
+    return passed;
+}
+
+void ScriptApi::fail(const QString &message)
+{
+    m_engine->throwError("assert: " + message);
+}
+
+void ScriptApi::log(const QString &message)
+{
+    LOG_INFO("脚本: " + message);
+    emit m_runner->output(message);
+}
+
+double ScriptApi::elapsed() const
+{
+    return toMs(ScriptRunner::Clock::now() - m_start);
+}
+
+void ScriptApi::fillReport(ScriptRunner::Report &report) const
+{
+    report.measurements = m_measurements;
+    report.checks = m_checks;
+    report.failedChecks = m_failedChecks;
+    report.strengthCalls = m_strengthCalls;
+}
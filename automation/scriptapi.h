@@ -0,0 +1,57 @@
+#ifndef SCRIPTAPI_H
+#define SCRIPTAPI_H
+
+#include <QJSValue>
+#include <QMap>
+#include <QObject>
+#include <functional>
+#include "automation/scriptrunner.h"
+
+class QJSEngine;
+
+/**
+ * 测试脚本的底层接口（脚本中的全局对象 __ld），在脚本线程中创建和调用
+    脚本看到的 driver / load / wait / measure 等由 ScriptApi::prelude() 在其上包装
+    需要设备的操作通过排队调用交给界面线程中的 ScriptRunner，等待完成期间每 50ms 检查一次停止请求，
+    停止后抛出脚本异常结束执行
+ */
+class ScriptApi : public QObject
+{
+    Q_OBJECT
+public:
+    ScriptApi(ScriptRunner *runner, QJSEngine *engine, int channelCount);
+
+    static const char *prelude();
+
+    Q_INVOKABLE int channelCount() const { return m_channelCount; }
+    Q_INVOKABLE void setStrength(int firstChannel, int count, int value);
+    Q_INVOKABLE void light(bool on);
+    Q_INVOKABLE void loadConstant(int mode, double value);
+    Q_INVOKABLE void loadInput(bool on);
+    Q_INVOKABLE void wait(int ms);
+    Q_INVOKABLE QJSValue measure();
+    Q_INVOKABLE bool check(const QString &name, double value, double min, double max);
+    Q_INVOKABLE void fail(const QString &message);
+    Q_INVOKABLE void log(const QString &message);
+    Q_INVOKABLE double elapsed() const;
+
+    bool flush();                   // 发送合并中的强度写入
+    void fillReport(ScriptRunner::Report &report) const;
+
+private:
+    bool call(const std::function<bool()> &function);   // 在界面线程中执行并等待结果
+    bool checkStopped();            // 已请求停止时抛出脚本异常
+
+    ScriptRunner *m_runner;
+    QJSEngine *m_engine;
+    int m_channelCount;
+    QMap<int, int> m_pending;       // 尚未发送的强度：通道号 -> 值
+    ScriptRunner::Clock::time_point m_start;
+
+    int m_measurements = 0;
+    int m_checks = 0;
+    int m_failedChecks = 0;
+    int m_strengthCalls = 0;
+};
+
+#endif // SCRIPTAPI_H
@@ -0,0 +1,236 @@
+#include "scriptrunner.h"
+#include "automation/scriptapi.h"
+#include "communication/drivergeneral.h"
+#include "devices/load/load_base.h"
+#include "devices/meter/meterbase.h"
+#include "serial/serialutil.h"
+#include "util/config.h"
+#include "util/datamanager.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+#include <QJSEngine>
+#include <QThread>
+
+using SteadyClock::toMs;
+
+ScriptRunner::ScriptRunner(SerialUtil *driverSerial, DriverGeneral *driver,
+                           LoadBase *load, MeterBase *meter, QObject *parent)
+    : QObject(parent)
+    , m_driverSerial(driverSerial)
+    , m_driver(driver)
+    , m_load(load)
+    , m_meter(meter)
+{
+    qRegisterMetaType<ScriptRunner::Report>("ScriptRunner::Report");
+
+    connect(&m_acquisition, &PairedAcquisition::completed, this, &ScriptRunner::completeMeasure);
+    connect(&m_acquisition, &PairedAcquisition::timedOut, this, [](const QString &missing) {
+        LOG_WARNING("脚本测量读数超时:" + missing);
+    });
+    if (m_meter) {
+        connect(m_meter, &MeterBase::singleMeasured, &m_acquisition, &PairedAcquisition::meterMeasured);
+        // 结束未完成的单次测量，下一次可以重新触发
+        connect(&m_acquisition, &PairedAcquisition::meterAbandoned, m_meter, &MeterBase::stopMeasurement);
+    }
+    if (m_load) {
+        connect(m_load, &LoadBase::sampleAcquired, &m_acquisition, &PairedAcquisition::loadSampled);
+    }
+}
+
+ScriptRunner::~ScriptRunner()
+{
+    if (m_thread) {
+        // 脚本线程在等待设备或定时时每50ms检查一次停止请求
+        stop();
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+void ScriptRunner::setAddresses(quint8 sendAddress, quint8 receiveAddress)
+{
+    m_sendAddress = sendAddress;
+    m_receiveAddress = receiveAddress;
+}
+
+bool ScriptRunner::start(const QString &source, const QString &fileName)
+{
+    if (m_thread) {
+        return false;
+    }
+    m_stopping = false;
+    m_lastDrive = -1;
+    m_strengthFrames = 0;
+    m_start = Clock::now();
+    LOG_INFO("脚本开始: " + fileName);
+
+    const int channelCount = m_channelCount;
+    m_thread = QThread::create([this, source, fileName, channelCount]() {
+        run(source, fileName, channelCount);
+    });
+    m_thread->setObjectName("script");
+    connect(m_thread, &QThread::finished, this, &ScriptRunner::onThreadFinished);
+    m_thread->start();
+    return true;
+}
+
+void ScriptRunner::stop()
+{
+    if (!m_thread || m_stopping) {
+        return;
+    }
+    m_stopping = true;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    // 不调用设备接口的纯脚本循环也能中断
+    QMutexLocker locker(&m_mutex);
+    if (m_engine) {
+        m_engine->setInterrupted(true);
+    }
+#endif
+}
+
+// 脚本线程：引擎和 ScriptApi 都在本线程中创建和销毁
+void ScriptRunner::run(const QString &source, const QString &fileName, int channelCount)
+{
+    QJSEngine engine;
+    ScriptApi api(this, &engine, channelCount);
+    QJSEngine::setObjectOwnership(&api, QJSEngine::CppOwnership);
+    engine.globalObject().setProperty("__ld", engine.newQObject(&api));
+    {
+        QMutexLocker locker(&m_mutex);
+        m_engine = &engine;
+    }
+
+    Report report;
+    engine.evaluate(QString::fromUtf8(ScriptApi::prelude()), "prelude");
+    const QJSValue result = engine.evaluate(source, fileName);
+    if (result.isError()) {
+        report.error = m_stopping ? QString("已停止")
+                                  : QString("%1:%2: %3").arg(fileName)
+                                    .arg(result.property("lineNumber").toInt()).arg(result.toString());
+    } else if (m_stopping) {
+        report.error = "已停止";
+    } else if (api.flush()) {
+        report.completed = true;    // 脚本末尾的强度写入也要发出
+    } else {
+        report.error = "写驱动强度失败";
+    }
+    api.fillReport(report);
+
+    QMutexLocker locker(&m_mutex);
+    m_engine = nullptr;
+    m_report = report;
+}
+
+void ScriptRunner::onThreadFinished()
+{
+    m_thread->deleteLater();
+    m_thread = nullptr;
+    if (m_measurement) {
+        // 脚本已不再等待这次测量
+        m_acquisition.cancel();
+        m_measurement.reset();
+    }
+
+    Report report;
+    {
+        QMutexLocker locker(&m_mutex);
+        report = m_report;
+    }
+    report.strengthFrames = m_strengthFrames;
+    report.durationMs = toMs(Clock::now() - m_start);
+    const QString summary = QString("测量 %1 次，检查 %2 项（不通过 %3），强度写入 %4 次合并为 %5 帧，用时 %6 s")
+            .arg(report.measurements).arg(report.checks).arg(report.failedChecks)
+            .arg(report.strengthCalls).arg(report.strengthFrames)
+            .arg(report.durationMs / 1000.0, 0, 'f', 1);
+    if (report.completed) {
+        LOG_INFO("脚本完成: " + summary);
+    } else {
+        LOG_WARNING(QString("脚本中止（%1）: %2").arg(report.error, summary));
+    }
+    emit finished(report);
+}
+
+// 按通道号排序后相邻通道合并为一帧
+bool ScriptRunner::writeStrengths(const QMap<int, int> &values)
+{
+    if (!m_driverSerial->isConnected()) {
+        return false;
+    }
+    auto it = values.constBegin();
+    while (it != values.constEnd()) {
+        const int first = it.key();
+        QVector<quint16> run;
+        for (; it != values.constEnd() && it.key() == first + run.size(); ++it) {
+            run.append(quint16(it.value()));
+        }
+        if (!m_driverSerial->writeData(m_driver->writeLEDStrengths(m_sendAddress, m_receiveAddress,
+                                                                   quint8(first), run))) {
+            return false;
+        }
+        ++m_strengthFrames;
+
+        // 界面按相同值的通道段刷新
+        int start = 0;
+        for (int k = 1; k <= run.size(); ++k) {
+            if (k == run.size() || run.at(k) != run.at(start)) {
+                emit strengthApplied(first + start, k - start, run.at(start));
+                start = k;
+            }
+        }
+    }
+    m_lastDrive = values.constBegin().value();
+    LD_DEBUG(lcProtocol) << "脚本写驱动强度" << values.size() << "个通道";
+    return true;
+}
+
+bool ScriptRunner::writeLight(bool on)
+{
+    return m_driverSerial->isConnected() &&
+           m_driverSerial->writeData(m_driver->writeLEDOnOff(m_sendAddress, m_receiveAddress, on ? 0x0001 : 0x0000));
+}
+
+bool ScriptRunner::applyLoadConstant(int mode, double value)
+{
+    return m_load && m_load->isConnected() && m_load->applyConstant(mode, value);
+}
+
+bool ScriptRunner::setLoadInput(bool on)
+{
+    return m_load && m_load->isConnected() && m_load->setInputOn(on);
+}
+
+// 与特性测试相同：照度计单次测量和负载新读数同时请求，两者到齐或超时后交给脚本
+bool ScriptRunner::beginMeasure(const std::shared_ptr<Measurement> &measurement)
+{
+    if (m_measurement) {
+        return false;
+    }
+    const bool meterRequested = m_meter && m_meter->isConnected() && m_meter->measureOnce();
+    const bool loadRequested = m_load && m_load->isConnected() && m_load->requestSample();
+    if (!m_acquisition.begin(meterRequested, loadRequested,
+                             Config::getValue(ConfigKeys::CHAR_ACQUIRE_TIMEOUT_MS, 3000).toInt())) {
+        return false;
+    }
+    m_measurement = measurement;
+    m_measurement->drive = m_lastDrive;
+    return true;
+}
+
+void ScriptRunner::completeMeasure(const PairedAcquisition::Result &result)
+{
+    std::shared_ptr<Measurement> measurement = std::move(m_measurement);
+    m_measurement.reset();
+    if (!measurement) {
+        return;
+    }
+    measurement->meterOk = result.meterOk;
+    measurement->loadOk = result.loadOk;
+    measurement->meter = result.meter;
+    measurement->load = result.load;
+    DataManager::instance()->addMeasurement(result.toMeasurementData(measurement->drive, Clock::now()));
+
+    emit measured(measurement->meterOk, measurement->meter, measurement->loadOk, measurement->load,
+                  measurement->drive);
+    measurement->done.release();
+}
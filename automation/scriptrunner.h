@@ -0,0 +1,123 @@
+#ifndef SCRIPTRUNNER_H
+#define SCRIPTRUNNER_H
+
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QSemaphore>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include "automation/pairedacquisition.h"
+#include "util/devicestate.h"
+
+class QJSEngine;
+class QThread;
+class SerialUtil;
+class DriverGeneral;
+class LoadBase;
+class MeterBase;
+
+/**
+ * 测试脚本（JavaScript，QJSEngine）
+    脚本在单独的线程中执行，设备操作在脚本看来是同步调用（等待完成后返回），界面线程不会被阻塞：
+      driver.set(first, count, value)   写驱动强度（也可 driver.set(channel, value)、driver.all(value)）
+      driver.light(on)                  LED总开关
+      load.cc(a) / cv(v) / cw(w) / cr(ohm)  负载基础模式和定值；load.input(on) 负载输入开关
+      wait(ms)                          等待稳定
+      measure()                         照度计单次测量 + 负载新读数，返回 {ev, x, y, u, v, tcp, duv, X, Y, Z,
+                                        voltage, current, power, meterOk, loadOk, drive}，同时记入 DataManager
+      check(name, value, min, max)      记录一项检查，返回是否通过（不中止脚本）
+      assert(cond, message)             条件不成立时中止脚本
+      sweep(first, count, start, stop, step, settleMs, fn)   写入 -> 等待 -> 测量，每步调用 fn(value, result)
+      log(...)、elapsed()
+    循环和分支直接用 JavaScript 语句
+    驱动强度写入先在脚本线程中合并，遇到 wait / measure / 负载操作 / 脚本结束时才发送，
+    同一通道只发最后一次的值，相邻通道合并为一帧 0x26
+    设备收发仍在界面线程中进行（与特性测试相同，直接写驱动器串口、调用 MeterBase::measureOnce 和
+    LoadBase::requestSample），脚本线程只通过排队调用与之交互
+ */
+class ScriptRunner : public QObject
+{
+    Q_OBJECT
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Report {
+        bool completed = false;     // 脚本执行完（未中止、无异常）
+        QString error;              // 异常信息（含行号）或中止原因
+        int measurements = 0;
+        int checks = 0;
+        int failedChecks = 0;
+        int strengthCalls = 0;      // 脚本中的强度写入调用
+        int strengthFrames = 0;     // 合并后实际发送的 0x26 帧
+        double durationMs = 0;
+    };
+
+    // 一次 measure() 的结果，由界面线程填写，脚本线程在 done 上等待
+    struct Measurement {
+        QSemaphore done;
+        bool meterOk = false;
+        bool loadOk = false;
+        int drive = -1;
+        MeterState meter;
+        LoadState load;
+    };
+
+    ScriptRunner(SerialUtil *driverSerial, DriverGeneral *driver,
+                 LoadBase *load, MeterBase *meter, QObject *parent = nullptr);
+    ~ScriptRunner();
+
+    void setAddresses(quint8 sendAddress, quint8 receiveAddress);
+    void setChannelCount(int channelCount) { m_channelCount = channelCount; }
+
+    bool start(const QString &source, const QString &fileName);
+    void stop();
+    bool isRunning() const { return m_thread != nullptr; }
+    bool isStopping() const { return m_stopping.load(); }
+
+    // 以下在界面线程中执行，由脚本线程排队调用
+    bool writeStrengths(const QMap<int, int> &values);     // 通道号 -> 强度
+    bool writeLight(bool on);
+    bool applyLoadConstant(int mode, double value);
+    bool setLoadInput(bool on);
+    bool beginMeasure(const std::shared_ptr<Measurement> &measurement);
+
+signals:
+    void output(const QString &line);
+    void strengthApplied(int firstChannel, int channelCount, int value);
+    void measured(bool meterOk, const MeterState &meter, bool loadOk, const LoadState &load, int drive);
+    void finished(const ScriptRunner::Report &report);
+
+private slots:
+    void completeMeasure(const PairedAcquisition::Result &result);
+
+private:
+    void run(const QString &source, const QString &fileName, int channelCount);   // 脚本线程
+    void onThreadFinished();
+
+    SerialUtil *m_driverSerial;
+    DriverGeneral *m_driver;
+    LoadBase *m_load;
+    MeterBase *m_meter;
+    quint8 m_sendAddress = 0x00;
+    quint8 m_receiveAddress = 0xFF;
+    int m_channelCount = 0;
+
+    QThread *m_thread = nullptr;
+    std::atomic<bool> m_stopping{false};
+    QMutex m_mutex;                 // 保护 m_engine 和 m_report
+    QJSEngine *m_engine = nullptr;  // 脚本线程中的引擎，用于停止时中断纯脚本循环
+    Report m_report;                // 脚本线程结束时写入
+    Clock::time_point m_start;
+
+    // 当前的 measure()
+    std::shared_ptr<Measurement> m_measurement;
+    PairedAcquisition m_acquisition;
+    int m_lastDrive = -1;
+    int m_strengthFrames = 0;
+};
+
+Q_DECLARE_METATYPE(ScriptRunner::Report)
+
+#endif // SCRIPTRUNNER_H
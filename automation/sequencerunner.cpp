@@ -0,0 +1,393 @@
+#include "sequencerunner.h"
+#include "automation/devicesession.h"
+#include "util/config.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+#include <QFile>
+#include <QTextStream>
+#include <cmath>
+
+using SteadyClock::toMs;
+
+namespace {
+    const int LoadAckTimeoutMs = 1000;
+}
+
+SequenceRunner::SequenceRunner(DriverSession *driver, LoadSession *load, MeterSession *meter, QObject *parent)
+    : QObject(parent)
+    , m_driver(driver)
+    , m_load(load)
+    , m_meter(meter)
+{
+    qRegisterMetaType<SequenceRunner::Result>("SequenceRunner::Result");
+
+    m_stepTimer.setSingleShot(true);
+    m_stepTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_stepTimer, &QTimer::timeout, this, &SequenceRunner::onStepTimeout);
+    connect(&m_acquisition, &PairedAcquisition::completed, this, &SequenceRunner::recordMeasurement);
+    connect(&m_acquisition, &PairedAcquisition::timedOut, this, [this](const QString &missing) {
+        LOG_WARNING(QString("%1: 读数超时:%2").arg(m_sequence.steps.at(m_index).source, missing));
+    });
+
+    if (m_driver) {
+        connect(m_driver, &DriverSession::ready, this, &SequenceRunner::onDeviceReady);
+        connect(m_driver, &DriverSession::failed, this, &SequenceRunner::onDeviceFailed);
+        connect(m_driver, &DriverSession::disconnected, this, [this]() { abort("驱动器串口断开"); });
+    }
+    if (m_load) {
+        connect(m_load, &LoadSession::ready, this, &SequenceRunner::onDeviceReady);
+        connect(m_load, &LoadSession::failed, this, &SequenceRunner::onDeviceFailed);
+        connect(m_load, &LoadSession::disconnected, this, [this]() { abort("电子负载串口断开"); });
+        connect(m_load, &LoadSession::sampled, &m_acquisition, &PairedAcquisition::loadSampled);
+        connect(m_load, &LoadSession::acknowledged, this, &SequenceRunner::onLoadAcknowledged);
+    }
+    if (m_meter) {
+        connect(m_meter, &MeterSession::ready, this, &SequenceRunner::onDeviceReady);
+        connect(m_meter, &MeterSession::failed, this, &SequenceRunner::onDeviceFailed);
+        connect(m_meter, &MeterSession::disconnected, this, [this]() { abort("照度计串口断开"); });
+        connect(m_meter, &MeterSession::measured, &m_acquisition, &PairedAcquisition::meterMeasured);
+        // 结束未完成的单次测量，下一次可以重新触发
+        connect(&m_acquisition, &PairedAcquisition::meterAbandoned, this, [this]() { m_meter->engine()->stop(); });
+    }
+}
+
+bool SequenceRunner::start(const TestSequence &sequence)
+{
+    if (isRunning()) {
+        return false;
+    }
+    if (sequence.needsDriver() && (sequence.driverPort.isEmpty() || !m_driver)) {
+        LOG_ERROR("序列需要驱动器，但没有指定驱动器串口");
+        return false;
+    }
+    if (sequence.needsLoad() && (sequence.loadPort.isEmpty() || !m_load)) {
+        LOG_ERROR("序列需要电子负载，但没有指定负载串口");
+        return false;
+    }
+    if (sequence.needsMeter() && (sequence.meterPort.isEmpty() || !m_meter)) {
+        LOG_ERROR("序列需要照度计，但没有指定照度计串口");
+        return false;
+    }
+
+    m_sequence = sequence;
+    m_results.clear();
+    m_report = Report();
+    m_index = 0;
+    m_loadMode = 0;
+    m_drive = -1;
+    m_ackPending = false;
+    m_acquireTimeoutMs = Config::getValue(ConfigKeys::CHAR_ACQUIRE_TIMEOUT_MS, 3000).toInt();
+    m_state = State::Opening;
+    m_openStart = Clock::now();
+    LOG_INFO(QString("序列 %1 开始: %2 步").arg(sequence.name).arg(sequence.steps.size()));
+
+    // 三台设备同时握手，打开失败的设备由 failed 信号中止
+    const bool useDriver = m_driver && !sequence.driverPort.isEmpty();
+    const bool useLoad = m_load && !sequence.loadPort.isEmpty();
+    const bool useMeter = m_meter && !sequence.meterPort.isEmpty();
+    m_opening = int(useDriver) + int(useLoad) + int(useMeter);
+    if (useDriver && !m_driver->open(sequence.driverPort)) {
+        return false;
+    }
+    if (useLoad && isRunning() && !m_load->open(sequence.loadPort)) {
+        return false;
+    }
+    if (useMeter && isRunning() && !m_meter->open(sequence.meterPort)) {
+        return false;
+    }
+    if (isRunning() && m_opening == 0) {
+        onDeviceReady();
+    }
+    return isRunning();
+}
+
+void SequenceRunner::stop()
+{
+    abort("已停止");
+}
+
+void SequenceRunner::onDeviceReady()
+{
+    if (m_state != State::Opening || --m_opening > 0) {
+        return;
+    }
+    m_report.openMs = toMs(Clock::now() - m_openStart);
+    m_runStart = Clock::now();
+    m_state = State::Running;
+    LD_DEBUG(lcProtocol) << "序列设备就绪，用时" << m_report.openMs << "ms";
+    runSteps();
+}
+
+void SequenceRunner::onDeviceFailed(const QString &reason)
+{
+    if (m_state == State::Opening) {
+        abort(reason);
+    }
+}
+
+// 连续执行不需要等待的步骤，遇到需要等待的步骤后返回事件循环
+void SequenceRunner::runSteps()
+{
+    while (m_state == State::Running) {
+        if (m_index >= m_sequence.steps.size()) {
+            finish(true);
+            return;
+        }
+        const TestStep &step = m_sequence.steps.at(m_index);
+        emit stepStarted(m_index, step);
+        ++m_report.executed;
+        if (!execute(step)) {
+            return;
+        }
+        ++m_index;
+    }
+}
+
+bool SequenceRunner::execute(const TestStep &step)
+{
+    switch (step.kind) {
+    case TestStep::Strength:
+        if (!m_driver->writeStrength(step.firstChannel, step.channelCount, step.value)) {
+            abort(step.source + ": 写驱动强度失败");
+            return false;
+        }
+        m_drive = step.value;
+        return true;
+
+    case TestStep::Light:
+        if (!m_driver->setLightOn(step.value != 0)) {
+            abort(step.source + ": 写LED开关失败");
+            return false;
+        }
+        return true;
+
+    case TestStep::Wait:
+        m_state = State::Waiting;
+        m_stepTimer.start(step.value);
+        return false;
+
+    case TestStep::Measure:
+        m_row = Result();
+        m_row.step = m_index;
+        m_row.label = step.label.isEmpty() ? QString::number(m_results.size() + 1) : step.label;
+        m_row.drive = m_drive;
+        m_state = State::Waiting;
+        if (!m_acquisition.begin(m_meter && m_meter->isReady() && m_meter->measureOnce(),
+                                 m_load && m_load->isReady() && m_load->requestSample(), m_acquireTimeoutMs)) {
+            abort(step.source + ": 没有可以测量的设备");
+        }
+        return false;
+
+    case TestStep::Check:
+        check(step);
+        return true;
+
+    case TestStep::LoadMode:
+    case TestStep::LoadValue:
+    case TestStep::LoadInput: {
+        QByteArray command;
+        EleLoad_ITPlus *protocol = m_load->protocol();
+        if (step.kind == TestStep::LoadMode) {
+            m_loadMode = step.value;
+            command = protocol->createSetLoadModeCommand(uint8_t(step.value));
+        } else if (step.kind == TestStep::LoadInput) {
+            command = protocol->createLoadStateCommand(uint8_t(step.value));
+        } else {
+            switch (m_loadMode) {
+            case 1: command = protocol->createSetConstantVoltageCommand(float(step.number)); break;
+            case 2: command = protocol->createSetConstantPowerCommand(float(step.number)); break;
+            case 3: command = protocol->createSetConstantResistanceCommand(float(step.number)); break;
+            default: command = protocol->createSetConstantCurrentCommand(float(step.number)); break;
+            }
+        }
+        if (!m_load->sendSetting(command)) {
+            abort(step.source + ": 写负载设置失败");
+            return false;
+        }
+        m_ackPending = true;
+        m_state = State::Waiting;
+        m_stepTimer.start(LoadAckTimeoutMs);
+        return false;
+    }
+    }
+    return true;
+}
+
+void SequenceRunner::check(const TestStep &step)
+{
+    Check result;
+    result.source = step.source;
+    result.field = step.field;
+    result.min = step.min;
+    result.max = step.max;
+    result.value = m_results.isEmpty() ? std::nan("") : fieldValue(m_results.last(), step.field);
+    result.passed = !std::isnan(result.value) && result.value >= step.min && result.value <= step.max;
+
+    ++m_report.checks;
+    if (!result.passed) {
+        ++m_report.failedChecks;
+        LOG_WARNING(QString("%1: %2 = %3 不在 [%4, %5] 内").arg(step.source, step.field)
+                    .arg(result.value).arg(step.min).arg(step.max));
+    }
+    if (!m_results.isEmpty()) {
+        m_results.last().checks.append(result);
+    }
+}
+
+double SequenceRunner::fieldValue(const Result &result, const QString &field) const
+{
+    if (field == "voltage" || field == "current" || field == "power") {
+        if (!result.loadOk) {
+            return std::nan("");
+        }
+        return field == "voltage" ? result.load.voltage : field == "current" ? result.load.current : result.load.power;
+    }
+    if (!result.meterOk) {
+        return std::nan("");
+    }
+    const MeterState &m = result.meter;
+    if (field == "ev") return m.ev;
+    if (field == "x") return m.x;
+    if (field == "y") return m.y;
+    if (field == "u") return m.u;
+    if (field == "v") return m.v;
+    if (field == "tcp") return m.tcp;
+    if (field == "duv") return m.duv;
+    if (field == "X") return m.X;
+    if (field == "Y") return m.Y;
+    if (field == "Z") return m.Z;
+    return std::nan("");
+}
+
+void SequenceRunner::onLoadAcknowledged(quint8 status)
+{
+    if (m_state != State::Waiting || !m_ackPending) {
+        return;
+    }
+    m_ackPending = false;
+    m_stepTimer.stop();
+    if (status != 0x80) {
+        abort(QString("%1: 负载拒绝设置（状态 0x%2）").arg(m_sequence.steps.at(m_index).source)
+              .arg(status, 2, 16, QChar('0')));
+        return;
+    }
+    ++m_index;
+    m_state = State::Running;
+    runSteps();
+}
+
+void SequenceRunner::onStepTimeout()
+{
+    if (m_state != State::Waiting) {
+        return;
+    }
+    if (m_ackPending) {
+        m_ackPending = false;
+        abort(m_sequence.steps.at(m_index).source + ": 负载设置无应答");
+        return;
+    }
+    // 等待步骤结束
+    ++m_index;
+    m_state = State::Running;
+    runSteps();
+}
+
+void SequenceRunner::recordMeasurement(const PairedAcquisition::Result &result)
+{
+    if (m_state != State::Waiting) {
+        return;
+    }
+    m_row.meterOk = result.meterOk;
+    m_row.loadOk = result.loadOk;
+    m_row.meter = result.meter;
+    m_row.load = result.load;
+    const Clock::time_point time = result.time(Clock::now());
+    m_row.elapsedMs = elapsedMs(time);
+    m_row.timestamp = SteadyClock::wallTime(time);
+    m_results.append(m_row);
+    ++m_report.measurements;
+    LD_DEBUG(lcMeter) << "序列测量" << m_row.label << "强度" << m_row.drive
+                      << "照度" << m_row.meter.ev << "电流" << m_row.load.current;
+    emit measured(m_row);
+
+    ++m_index;
+    m_state = State::Running;
+    runSteps();
+}
+
+void SequenceRunner::abort(const QString &reason)
+{
+    if (!isRunning()) {
+        return;
+    }
+    m_report.error = reason;
+    LOG_ERROR("序列中止: " + reason);
+    finish(false);
+}
+
+void SequenceRunner::finish(bool completed)
+{
+    const bool opened = m_state != State::Opening;
+    m_stepTimer.stop();
+    m_state = State::Idle;
+    m_acquisition.cancel();
+    m_ackPending = false;
+
+    m_report.completed = completed;
+    m_report.passed = completed && m_report.failedChecks == 0;
+    m_report.durationMs = opened ? toMs(Clock::now() - m_runStart) : 0;
+    LOG_INFO(QString("序列 %1 %2: %3/%4 步，测量 %5 次，检查 %6 项（不通过 %7），打开设备 %8 ms，执行 %9 ms")
+             .arg(m_sequence.name)
+             .arg(m_report.passed ? "通过" : completed ? "不通过" : "中止")
+             .arg(m_report.executed).arg(m_sequence.steps.size())
+             .arg(m_report.measurements).arg(m_report.checks).arg(m_report.failedChecks)
+             .arg(m_report.openMs, 0, 'f', 0).arg(m_report.durationMs, 0, 'f', 0));
+    emit finished(m_report);
+}
+
+double SequenceRunner::elapsedMs(Clock::time_point time) const
+{
+    return toMs(time - m_runStart);
+}
+
+bool SequenceRunner::writeCsv(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        LOG_ERROR("无法写入结果文件: " + path);
+        return false;
+    }
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+
+    stream << "标签,时间戳,时间(ms),驱动强度,电压(V),电流(A),功率(W),照度(lx),x,y,色温(K),Δuv,检查,判定\n";
+    auto number = [](bool ok, double value, int precision) {
+        return ok ? QString::number(value, 'f', precision) : QString();
+    };
+    for (const Result &r : m_results) {
+        QStringList checks;
+        bool passed = true;
+        for (const Check &c : r.checks) {
+            checks << QString("%1=%2[%3~%4]%5").arg(c.field).arg(c.value).arg(c.min).arg(c.max)
+                      .arg(c.passed ? "" : "×");
+            passed = passed && c.passed;
+        }
+        stream << r.label << ','
+               << r.timestamp.toString("yyyy-MM-dd hh:mm:ss.zzz") << ','
+               << QString::number(r.elapsedMs, 'f', 1) << ','
+               << (r.drive >= 0 ? QString::number(r.drive) : QString()) << ','
+               << number(r.loadOk, r.load.voltage, 3) << ','
+               << number(r.loadOk, r.load.current, 4) << ','
+               << number(r.loadOk, r.load.power, 3) << ','
+               << number(r.meterOk, r.meter.ev, 2) << ','
+               << number(r.meterOk, r.meter.x, 4) << ','
+               << number(r.meterOk, r.meter.y, 4) << ','
+               << number(r.meterOk, r.meter.tcp, 0) << ','
+               << number(r.meterOk, r.meter.duv, 4) << ','
+               << checks.join(' ') << ','
+               << (r.checks.isEmpty() ? QString() : passed ? QString("通过") : QString("不通过")) << '\n';
+    }
+    file.close();
+    LOG_INFO("结果已写入: " + path);
+    return true;
+}
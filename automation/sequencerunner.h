@@ -0,0 +1,129 @@
+#ifndef SEQUENCERUNNER_H
+#define SEQUENCERUNNER_H
+
+#include <QDateTime>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include "automation/pairedacquisition.h"
+#include "automation/testsequence.h"
+#include "util/devicestate.h"
+#include "util/steadyclock.h"
+
+class DriverSession;
+class LoadSession;
+class MeterSession;
+
+/**
+ * 测试序列执行
+    start() 先打开序列用到的设备（串口取自序列的 ports），全部就绪后依次执行步骤
+    不需要等待的步骤（写强度、开关、检查）在同一次调用中连续执行，只有等待、测量和负载设置应答才回到事件循环
+    measure：照度计单次EXT测量和负载新读数（LoadTelemetry::requestSample）并行获取，两者到齐或超时后记录一行
+    check：检查最近一次测量的字段，不通过时继续执行，全部步骤结束后给出总判定
+    设备打开失败、写串口失败、负载设置被拒绝时中止
+ */
+class SequenceRunner : public QObject
+{
+    Q_OBJECT
+public:
+    using Clock = SteadyClock::Clock;
+
+    struct Check {
+        QString source;             // 序列中的位置
+        QString field;
+        double value = 0;           // 读数缺失时为 NaN
+        double min = 0;
+        double max = 0;
+        bool passed = false;
+    };
+
+    // 一次 measure 的结果及其后的检查
+    struct Result {
+        int step = 0;
+        QString label;
+        QDateTime timestamp;
+        double elapsedMs = 0;       // 序列开始到照度计触发（无照度计时为负载应答）
+        int drive = -1;             // 最近一次写入的驱动强度，未写入为 -1
+        bool meterOk = false;
+        bool loadOk = false;
+        MeterState meter;
+        LoadState load;
+        QVector<Check> checks;
+    };
+
+    struct Report {
+        bool completed = false;     // 全部步骤执行完
+        bool passed = false;        // 执行完且所有检查通过
+        QString error;              // 中止原因
+        int executed = 0;           // 已执行的步骤
+        int measurements = 0;
+        int checks = 0;
+        int failedChecks = 0;
+        double durationMs = 0;      // 设备就绪到结束
+        double openMs = 0;          // 打开设备用时
+    };
+
+    SequenceRunner(DriverSession *driver, LoadSession *load, MeterSession *meter, QObject *parent = nullptr);
+
+    bool start(const TestSequence &sequence);
+    void stop();
+    bool isRunning() const { return m_state != State::Idle; }
+
+    const QVector<Result> &results() const { return m_results; }
+    const Report &report() const { return m_report; }
+    bool writeCsv(const QString &path) const;
+
+signals:
+    void stepStarted(int index, const TestStep &step);
+    void measured(const SequenceRunner::Result &result);
+    void finished(const SequenceRunner::Report &report);
+
+private slots:
+    void onDeviceReady();
+    void onDeviceFailed(const QString &reason);
+    void recordMeasurement(const PairedAcquisition::Result &result);
+    void onLoadAcknowledged(quint8 status);
+    void onStepTimeout();
+    void runSteps();
+
+private:
+    enum class State {
+        Idle,
+        Opening,        // 等待设备握手
+        Running,
+        Waiting         // 等待定时、读数或应答
+    };
+
+    bool execute(const TestStep &step);     // 返回false表示需要等待
+    void check(const TestStep &step);
+    void abort(const QString &reason);
+    void finish(bool completed);
+    double fieldValue(const Result &result, const QString &field) const;
+    double elapsedMs(Clock::time_point time) const;
+
+    DriverSession *m_driver;
+    LoadSession *m_load;
+    MeterSession *m_meter;
+
+    QTimer m_stepTimer;         // 等待步骤 / 负载设置应答超时
+    PairedAcquisition m_acquisition;
+    State m_state = State::Idle;
+    TestSequence m_sequence;
+    int m_index = 0;
+    int m_opening = 0;          // 尚未就绪的设备数
+    int m_loadMode = 0;         // 最近一次设置的负载模式（0 CC, 1 CV, 2 CW, 3 CR）
+    int m_drive = -1;
+    int m_acquireTimeoutMs = 3000;
+
+    bool m_ackPending = false;
+    Result m_row;
+
+    Clock::time_point m_openStart;
+    Clock::time_point m_runStart;
+    QVector<Result> m_results;
+    Report m_report;
+};
+
+Q_DECLARE_METATYPE(SequenceRunner::Result)
+
+#endif // SEQUENCERUNNER_H
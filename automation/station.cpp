@@ -0,0 +1,139 @@
+#include "station.h"
+#include "automation/devicesession.h"
+#include "util/errorhandler.h"
+#include <QDateTime>
+#include <QDir>
+
+namespace {
+    const int PublishIntervalMs = 100;
+}
+
+Station::Station(int index, const Ports &ports)
+    : m_index(index)
+    , m_ports(ports)
+{
+}
+
+void Station::initialize()
+{
+    // 工位不用的设备不创建串口
+    m_driver = m_ports.driver.isEmpty() ? nullptr : new DriverSession(this);
+    m_load = m_ports.load.isEmpty() ? nullptr : new LoadSession(this);
+    m_meter = m_ports.meter.isEmpty() ? nullptr : new MeterSession(this);
+    m_runner = new SequenceRunner(m_driver, m_load, m_meter, this);
+
+    connect(m_runner, &SequenceRunner::stepStarted, this, [this](int index, const TestStep &) {
+        onStepStarted(index);
+    });
+    connect(m_runner, &SequenceRunner::measured, this, &Station::onMeasured);
+    connect(m_runner, &SequenceRunner::finished, this, &Station::onFinished);
+    m_lastPublish.start();
+}
+
+void Station::start(TestSequence sequence, const QString &outputDir)
+{
+    if (!m_runner || m_runner->isRunning()) {
+        return;
+    }
+    // 串口以工位配置为准
+    sequence.driverPort = m_ports.driver;
+    sequence.loadPort = m_ports.load;
+    sequence.meterPort = m_ports.meter;
+    m_sequenceName = sequence.name;
+    m_outputDir = outputDir;
+
+    m_status = Status();
+    m_status.state = Status::Opening;
+    m_status.steps = sequence.steps.size();
+    publish(true);
+
+    m_runner->start(sequence);
+    if (m_status.state == Status::Opening && !m_runner->isRunning()) {
+        // 打开设备之前就失败（序列需要的设备没有配置串口），不会有 finished
+        m_status.state = Status::Aborted;
+        m_status.message = "序列需要的设备未配置串口";
+        publish(true);
+    }
+}
+
+void Station::stop()
+{
+    if (m_runner) {
+        m_runner->stop();
+    }
+}
+
+void Station::shutdown()
+{
+    stop();
+    if (m_driver) {
+        m_driver->close();
+    }
+    if (m_load) {
+        m_load->close();
+    }
+    if (m_meter) {
+        m_meter->close();
+    }
+}
+
+void Station::onStepStarted(int index)
+{
+    const bool first = m_status.state != Status::Running;
+    m_status.state = Status::Running;
+    m_status.step = index + 1;
+    publish(first);
+}
+
+void Station::onMeasured(const SequenceRunner::Result &result)
+{
+    ++m_status.measurements;
+    m_status.meterOk = result.meterOk;
+    m_status.loadOk = result.loadOk;
+    m_status.ev = result.meter.ev;
+    m_status.current = result.load.current;
+    publish(false);
+}
+
+void Station::onFinished(const SequenceRunner::Report &report)
+{
+    m_status.step = report.executed;
+    m_status.failedChecks = report.failedChecks;
+    m_status.durationMs = report.durationMs;
+    m_status.state = report.passed ? Status::Passed : report.completed ? Status::Failed : Status::Aborted;
+    m_status.message = report.error;
+
+    if (!m_runner->results().isEmpty()) {
+        QDir().mkpath(m_outputDir);
+        const QString path = QDir(m_outputDir).filePath(
+                    QString("%1_%2_%3.csv").arg(m_ports.name, m_sequenceName,
+                                                QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")));
+        if (m_runner->writeCsv(path) && report.error.isEmpty()) {
+            m_status.message = path;
+        }
+    }
+    LOG_INFO(QString("工位 %1 %2").arg(m_ports.name, stateName(m_status.state)));
+    publish(true);
+}
+
+void Station::publish(bool force)
+{
+    if (!force && m_lastPublish.elapsed() < PublishIntervalMs) {
+        return;
+    }
+    m_lastPublish.restart();
+    emit statusChanged(m_index, m_status);
+}
+
+QString Station::stateName(Status::State state)
+{
+    switch (state) {
+    case Status::Idle: return "空闲";
+    case Status::Opening: return "连接中";
+    case Status::Running: return "运行中";
+    case Status::Passed: return "通过";
+    case Status::Failed: return "不通过";
+    case Status::Aborted: return "中止";
+    }
+    return QString();
+}
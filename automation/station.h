@@ -0,0 +1,89 @@
+#ifndef STATION_H
+#define STATION_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include "automation/sequencerunner.h"
+#include "automation/testsequence.h"
+
+class DriverSession;
+class LoadSession;
+class MeterSession;
+
+/**
+ * 多工位模式中的一个工位：一台驱动器、一台电子负载、一台照度计（可缺省）和一个序列执行器
+    工位对象由 StationPool 移到工作线程，串口收发、帧解码和序列执行都在该线程中进行
+    设备会话和执行器在 initialize() 中创建，保证其定时器属于工作线程
+    状态通过 statusChanged 发给界面线程，步骤推进时最多每 100ms 发一次，状态变化和测量结果立即发出
+ */
+class Station : public QObject
+{
+    Q_OBJECT
+public:
+    struct Ports {
+        QString name;
+        QString driver;
+        QString load;
+        QString meter;
+    };
+
+    struct Status {
+        enum State {
+            Idle,
+            Opening,        // 设备握手
+            Running,
+            Passed,
+            Failed,         // 执行完，有检查不通过
+            Aborted         // 设备或序列错误、手动停止
+        };
+        State state = Idle;
+        int step = 0;
+        int steps = 0;
+        int measurements = 0;
+        int failedChecks = 0;
+        bool meterOk = false;
+        bool loadOk = false;
+        float ev = 0;               // 最近一次测量
+        float current = 0;
+        double durationMs = 0;
+        QString message;            // 中止原因或结果文件
+    };
+
+    Station(int index, const Ports &ports);
+
+    int index() const { return m_index; }
+    const Ports &ports() const { return m_ports; }
+
+    // 以下在工位所在的工作线程中执行
+    void initialize();
+    void start(TestSequence sequence, const QString &outputDir);
+    void stop();
+    void shutdown();                // 停止并关闭串口，工作线程退出前调用
+
+    static QString stateName(Status::State state);
+
+signals:
+    void statusChanged(int index, const Station::Status &status);
+
+private:
+    void onStepStarted(int index);
+    void onMeasured(const SequenceRunner::Result &result);
+    void onFinished(const SequenceRunner::Report &report);
+    void publish(bool force);
+
+    int m_index;
+    Ports m_ports;
+    DriverSession *m_driver = nullptr;
+    LoadSession *m_load = nullptr;
+    MeterSession *m_meter = nullptr;
+    SequenceRunner *m_runner = nullptr;
+
+    Status m_status;
+    QString m_sequenceName;
+    QString m_outputDir;
+    QElapsedTimer m_lastPublish;
+};
+
+Q_DECLARE_METATYPE(Station::Status)
+
+#endif // STATION_H
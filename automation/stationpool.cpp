@@ -0,0 +1,92 @@
+#include "stationpool.h"
+#include "util/errorhandler.h"
+#include <QThread>
+
+StationPool::StationPool(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<Station::Status>("Station::Status");
+}
+
+StationPool::~StationPool()
+{
+    shutdown();
+}
+
+void StationPool::setStations(const QVector<Station::Ports> &stations)
+{
+    shutdown();
+    m_ports = stations;
+    if (stations.isEmpty()) {
+        return;
+    }
+
+    const int threads = qBound(1, QThread::idealThreadCount(), stations.size());
+    for (int t = 0; t < threads; ++t) {
+        auto *thread = new QThread(this);
+        thread->setObjectName(QString("station-%1").arg(t));
+        m_threads.append(thread);
+        thread->start();
+    }
+
+    for (int i = 0; i < stations.size(); ++i) {
+        auto *station = new Station(i, stations.at(i));
+        QThread *thread = m_threads.at(i % threads);
+        station->moveToThread(thread);
+        connect(thread, &QThread::finished, station, &QObject::deleteLater);
+        connect(station, &Station::statusChanged, this, &StationPool::statusChanged);
+        QMetaObject::invokeMethod(station, [station]() { station->initialize(); }, Qt::QueuedConnection);
+        m_stations.append(station);
+    }
+    LOG_INFO(QString("多工位: %1 个工位，%2 个工作线程").arg(stations.size()).arg(threads));
+}
+
+void StationPool::start(int index, const TestSequence &sequence, const QString &outputDir)
+{
+    if (index < 0 || index >= m_stations.size()) {
+        return;
+    }
+    Station *station = m_stations.at(index);
+    QMetaObject::invokeMethod(station, [station, sequence, outputDir]() {
+        station->start(sequence, outputDir);
+    }, Qt::QueuedConnection);
+}
+
+void StationPool::startAll(const TestSequence &sequence, const QString &outputDir)
+{
+    for (int i = 0; i < m_stations.size(); ++i) {
+        start(i, sequence, outputDir);
+    }
+}
+
+void StationPool::stop(int index)
+{
+    if (index < 0 || index >= m_stations.size()) {
+        return;
+    }
+    Station *station = m_stations.at(index);
+    QMetaObject::invokeMethod(station, [station]() { station->stop(); }, Qt::QueuedConnection);
+}
+
+void StationPool::stopAll()
+{
+    for (int i = 0; i < m_stations.size(); ++i) {
+        stop(i);
+    }
+}
+
+// 工作线程从不等待界面线程，这里可以阻塞等待各工位关闭串口（中止的工位照常写出已有结果）
+void StationPool::shutdown()
+{
+    for (Station *station : m_stations) {
+        QMetaObject::invokeMethod(station, [station]() { station->shutdown(); }, Qt::BlockingQueuedConnection);
+    }
+    for (QThread *thread : m_threads) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+    m_threads.clear();
+    m_stations.clear();     // 已在各自线程结束时 deleteLater
+    m_ports.clear();
+}
@@ -0,0 +1,44 @@
+#ifndef STATIONPOOL_H
+#define STATIONPOOL_H
+
+#include <QObject>
+#include <QVector>
+#include "automation/station.h"
+
+class QThread;
+
+/**
+ * 多工位：一个进程中运行 N 个相互独立的工位
+    工位分配到共用的工作线程（线程数 = min(工位数, CPU 核数)，按序号轮流分配），
+    每个工位的串口收发、帧解码和序列执行都在所属线程的事件循环中进行，界面线程只接收状态
+    工位之间不共享设备，一个工位出错或停止不影响其他工位
+ */
+class StationPool : public QObject
+{
+    Q_OBJECT
+public:
+    explicit StationPool(QObject *parent = nullptr);
+    ~StationPool();
+
+    void setStations(const QVector<Station::Ports> &stations);     // 停止并重建全部工位和工作线程
+    int stationCount() const { return m_stations.size(); }
+    int threadCount() const { return m_threads.size(); }
+    const Station::Ports &ports(int index) const { return m_ports.at(index); }
+
+    void start(int index, const TestSequence &sequence, const QString &outputDir);
+    void startAll(const TestSequence &sequence, const QString &outputDir);
+    void stop(int index);
+    void stopAll();
+
+signals:
+    void statusChanged(int index, const Station::Status &status);
+
+private:
+    void shutdown();
+
+    QVector<QThread *> m_threads;
+    QVector<Station *> m_stations;
+    QVector<Station::Ports> m_ports;
+};
+
+#endif // STATIONPOOL_H
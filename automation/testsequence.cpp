@@ -0,0 +1,255 @@
+#include "testsequence.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <cstdlib>
+
+namespace {
+    const int MaxSteps = 100000;
+
+    bool isLoadField(const QString &field)
+    {
+        return field == "voltage" || field == "current" || field == "power";
+    }
+
+    struct Parser {
+        QVector<TestStep> steps;
+        QString error;
+
+        bool fail(const QString &where, const QString &message)
+        {
+            error = where + ": " + message;
+            return false;
+        }
+
+        bool channels(const QJsonObject &json, const QString &where, TestStep &step)
+        {
+            step.firstChannel = json["first"].toInt(1);
+            step.channelCount = json["count"].toInt(1);
+            if (step.firstChannel < 1 || step.channelCount < 1 || step.firstChannel + step.channelCount - 1 > 0xFF) {
+                return fail(where, "通道范围无效");
+            }
+            return true;
+        }
+
+        bool append(const TestStep &step)
+        {
+            if (steps.size() >= MaxSteps) {
+                return fail(step.source, QString("展开后超过 %1 步").arg(MaxSteps));
+            }
+            steps.append(step);
+            return true;
+        }
+
+        bool parseList(const QJsonArray &array, const QString &prefix)
+        {
+            for (int i = 0; i < array.size(); ++i) {
+                if (!parseStep(array.at(i).toObject(), QString("%1[%2]").arg(prefix).arg(i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool parseStep(const QJsonObject &json, const QString &where)
+        {
+            const QString op = json["op"].toString();
+            TestStep step;
+            step.source = where;
+
+            if (op == "strength") {
+                step.kind = TestStep::Strength;
+                step.value = json["value"].toInt(-1);
+                if (step.value < 0 || step.value > 0xFFFF) {
+                    return fail(where, "驱动强度超出 0~65535");
+                }
+                return channels(json, where, step) && append(step);
+            }
+            if (op == "light") {
+                step.kind = TestStep::Light;
+                step.value = json["on"].toBool(true) ? 1 : 0;
+                return append(step);
+            }
+            if (op == "wait") {
+                step.kind = TestStep::Wait;
+                step.value = json["ms"].toInt(-1);
+                if (step.value < 0) {
+                    return fail(where, "缺少等待时间 ms");
+                }
+                return append(step);
+            }
+            if (op == "measure") {
+                step.kind = TestStep::Measure;
+                step.label = json["label"].toString();
+                return append(step);
+            }
+            if (op == "check") {
+                step.kind = TestStep::Check;
+                step.field = json["field"].toString();
+                if (!TestSequence::fieldNames().contains(step.field)) {
+                    return fail(where, "未知字段 " + step.field);
+                }
+                if (json.contains("min")) {
+                    step.min = json["min"].toDouble();
+                }
+                if (json.contains("max")) {
+                    step.max = json["max"].toDouble();
+                }
+                return append(step);
+            }
+            if (op == "load") {
+                static const QStringList modes = {"cc", "cv", "cw", "cr"};
+                const int mode = modes.indexOf(json["mode"].toString().toLower());
+                if (mode < 0) {
+                    return fail(where, "负载模式应为 cc/cv/cw/cr");
+                }
+                step.kind = TestStep::LoadMode;
+                step.value = mode;
+                if (!append(step)) {
+                    return false;
+                }
+                if (json.contains("value")) {
+                    step.kind = TestStep::LoadValue;
+                    step.number = json["value"].toDouble();
+                    return append(step);
+                }
+                return true;
+            }
+            if (op == "input") {
+                step.kind = TestStep::LoadInput;
+                step.value = json["on"].toBool(true) ? 1 : 0;
+                return append(step);
+            }
+            if (op == "sweep") {
+                // 每个强度：写入 -> 稳定 -> 测量（标签为强度值）
+                if (!channels(json, where, step)) {
+                    return false;
+                }
+                const int start = json["start"].toInt(0);
+                const int stop = json["stop"].toInt(-1);
+                const int stride = json["step"].toInt(1);
+                const int settle = json["settleMs"].toInt(100);
+                if (start < 0 || stop < 0 || start > 0xFFFF || stop > 0xFFFF || stride <= 0 || settle < 0) {
+                    return fail(where, "扫描参数无效");
+                }
+                const int direction = stop >= start ? 1 : -1;
+                const int count = std::abs(stop - start) / stride + 1;
+                for (int k = 0; k < count; ++k) {
+                    const int value = start + direction * k * stride;
+                    TestStep write = step;
+                    write.kind = TestStep::Strength;
+                    write.value = value;
+                    TestStep wait;
+                    wait.kind = TestStep::Wait;
+                    wait.value = settle;
+                    wait.source = where;
+                    TestStep measure;
+                    measure.kind = TestStep::Measure;
+                    measure.label = QString::number(value);
+                    measure.source = where;
+                    if (!append(write) || !append(wait) || !append(measure)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            if (op == "repeat") {
+                const int times = json["times"].toInt(1);
+                if (times < 0) {
+                    return fail(where, "重复次数无效");
+                }
+                for (int t = 0; t < times; ++t) {
+                    if (!parseList(json["steps"].toArray(), where + ".steps")) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            return fail(where, op.isEmpty() ? QString("缺少 op") : "未知操作 " + op);
+        }
+    };
+}
+
+TestSequence TestSequence::fromFile(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = "无法读取序列文件 " + path;
+        }
+        return TestSequence();
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (error) {
+            *error = QString("序列文件格式错误（偏移 %1）: %2").arg(parseError.offset).arg(parseError.errorString());
+        }
+        return TestSequence();
+    }
+    TestSequence sequence = fromJson(doc.object(), error);
+    if (sequence.name.isEmpty()) {
+        sequence.name = QFileInfo(path).completeBaseName();
+    }
+    return sequence;
+}
+
+TestSequence TestSequence::fromJson(const QJsonObject &json, QString *error)
+{
+    TestSequence sequence;
+    sequence.name = json["name"].toString();
+    const QJsonObject ports = json["ports"].toObject();
+    sequence.driverPort = ports["driver"].toString();
+    sequence.loadPort = ports["load"].toString();
+    sequence.meterPort = ports["meter"].toString();
+
+    Parser parser;
+    if (!parser.parseList(json["steps"].toArray(), "steps")) {
+        if (error) {
+            *error = parser.error;
+        }
+        return TestSequence();
+    }
+    sequence.steps = parser.steps;
+    if (error) {
+        error->clear();
+    }
+    return sequence;
+}
+
+QStringList TestSequence::fieldNames()
+{
+    return {"ev", "x", "y", "u", "v", "tcp", "duv", "X", "Y", "Z", "voltage", "current", "power"};
+}
+
+bool TestSequence::needsDriver() const
+{
+    for (const TestStep &step : steps) {
+        if (step.kind == TestStep::Strength || step.kind == TestStep::Light) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TestSequence::needsLoad() const
+{
+    for (const TestStep &step : steps) {
+        if (step.kind == TestStep::LoadMode || step.kind == TestStep::LoadValue || step.kind == TestStep::LoadInput ||
+            (step.kind == TestStep::Check && isLoadField(step.field))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TestSequence::needsMeter() const
+{
+    for (const TestStep &step : steps) {
+        if (step.kind == TestStep::Check && !isLoadField(step.field)) {
+            return true;
+        }
+    }
+    return false;
+}
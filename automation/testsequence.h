@@ -0,0 +1,72 @@
+#ifndef TESTSEQUENCE_H
+#define TESTSEQUENCE_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <limits>
+
+/**
+ * 测试序列（JSON 文件）
+    {
+      "name": "LD-8 出厂测试",
+      "ports": { "driver": "COM3", "load": "COM4", "meter": "COM5" },   // 不用的设备省略
+      "steps": [
+        { "op": "light", "on": true },
+        { "op": "strength", "first": 1, "count": 8, "value": 128 },
+        { "op": "wait", "ms": 200 },
+        { "op": "measure", "label": "128" },
+        { "op": "check", "field": "ev", "min": 300, "max": 500 },
+        { "op": "load", "mode": "cc", "value": 0.5 },
+        { "op": "input", "on": true },
+        { "op": "sweep", "first": 1, "count": 8, "start": 0, "stop": 255, "step": 16, "settleMs": 100 },
+        { "op": "repeat", "times": 3, "steps": [ ... ] }
+      ]
+    }
+    sweep 和 repeat 在解析时展开为基本步骤，运行时只有 Step::Kind 中的几种
+    check 检查最近一次 measure 的读数，字段见 fieldNames()
+ */
+struct TestStep {
+    enum Kind {
+        Strength,       // 写驱动强度
+        Light,          // LED总开关
+        Wait,
+        Measure,        // 照度计单次测量 + 负载读数，记录一行结果
+        Check,          // 检查最近一次测量
+        LoadMode,       // 负载模式（0 CC, 1 CV, 2 CW, 3 CR）
+        LoadValue,      // 当前模式的设定值
+        LoadInput       // 负载输入开关
+    };
+
+    Kind kind = Wait;
+    int firstChannel = 1;
+    int channelCount = 1;
+    int value = 0;              // 驱动强度 / 等待时间(ms) / 负载模式 / 开关
+    double number = 0;          // 负载设定值
+    QString label;
+    QString field;
+    double min = -std::numeric_limits<double>::infinity();
+    double max = std::numeric_limits<double>::infinity();
+    QString source;             // 所在位置，如 "steps[3].steps[1]"，用于报错
+};
+
+class TestSequence
+{
+public:
+    QString name;
+    QString driverPort;
+    QString loadPort;
+    QString meterPort;
+    QVector<TestStep> steps;
+
+    static TestSequence fromFile(const QString &path, QString *error);
+    static TestSequence fromJson(const QJsonObject &json, QString *error);
+    static QStringList fieldNames();            // check 可用的字段
+
+    bool needsDriver() const;
+    bool needsLoad() const;
+    bool needsMeter() const;
+};
+
+#endif // TESTSEQUENCE_H
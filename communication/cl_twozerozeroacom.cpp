@@ -1,9 +1,10 @@
 #include "cl_twozerozeroacom.h"
-#include <QDebug>
-#include <cmath>
+#include "clblockcodec.h"
+#include "util/logcategories.h"
+#include <cstring>
 
-CL_TwoZeroZeroACOM::CL_TwoZeroZeroACOM(QWidget *parent) 
-    : QWidget(parent)
+CL_TwoZeroZeroACOM::CL_TwoZeroZeroACOM(QObject *parent) 
+    : QObject(parent)
 {}
 
 // Short通讯模式，获取设置指令的响应结果
@@ -19,15 +20,20 @@ CL_TwoZeroZeroACOM::ShortMeasurementData CL_TwoZeroZeroACOM::handleReceivedSetti
 // Long通讯模式，处理接收到的数据
 CL_TwoZeroZeroACOM::MeasurementData CL_TwoZeroZeroACOM::handleReceivedMeasurementData(const QByteArray &data)
 {
-    MeasurementData receivedData;
-    receivedData.registerCode = data.mid(3,2);
-    receivedData.fixedValue = data.at(5);
-    receivedData.err = data.at(6);
-    receivedData.rng = data.at(7);
-    receivedData.ba = data.at(8);
-    receivedData.data1 = parseLongDataBlock(data.mid(9,6));
-    receivedData.data2 = parseLongDataBlock(data.mid(15,6));
-    receivedData.data3 = parseLongDataBlock(data.mid(21,6));
+    // STX(1) 受光部(2) 功能码(2) 状态(4) 数据块(3×6)
+    MeasurementData receivedData{};
+    if(data.size() < 9 + 3 * ClBlockCodec::LongBlockSize) {
+        return receivedData;
+    }
+    const char *p = data.constData();
+    receivedData.registerCode = QString::fromLatin1(p + 3, 2);
+    receivedData.fixedValue = p[5];
+    receivedData.err = p[6];
+    receivedData.rng = p[7];
+    receivedData.ba = p[8];
+    receivedData.data1 = ClBlockCodec::parseLong(p + 9);
+    receivedData.data2 = ClBlockCodec::parseLong(p + 15);
+    receivedData.data3 = ClBlockCodec::parseLong(p + 21);
 
     return receivedData;
 }
@@ -35,15 +41,20 @@ CL_TwoZeroZeroACOM::MeasurementData CL_TwoZeroZeroACOM::handleReceivedMeasuremen
 // special通讯模式，处理接收到的测量数据
 CL_TwoZeroZeroACOM::MeasurementData CL_TwoZeroZeroACOM::handleReceivedMeasurementDataSpecial(const QByteArray &data)
 {
-    MeasurementData receivedData;
-    receivedData.registerCode = data.mid(3,2);
-    receivedData.fixedValue = data.at(5);
-    receivedData.err = data.at(6);
-    receivedData.rng = data.at(7);
-    receivedData.ba = data.at(8);
-    receivedData.data1 = parseSpecialDataBlock(data.mid(9,8));
-    receivedData.data2 = parseSpecialDataBlock(data.mid(17,8));
-    receivedData.data3 = parseSpecialDataBlock(data.mid(25,8));
+    // STX(1) 受光部(2) 功能码(2) 状态(4) 数据块(3×8)
+    MeasurementData receivedData{};
+    if(data.size() < 9 + 3 * ClBlockCodec::SpecialBlockSize) {
+        return receivedData;
+    }
+    const char *p = data.constData();
+    receivedData.registerCode = QString::fromLatin1(p + 3, 2);
+    receivedData.fixedValue = p[5];
+    receivedData.err = p[6];
+    receivedData.rng = p[7];
+    receivedData.ba = p[8];
+    receivedData.data1 = ClBlockCodec::parseSpecial(p + 9);
+    receivedData.data2 = ClBlockCodec::parseSpecial(p + 17);
+    receivedData.data3 = ClBlockCodec::parseSpecial(p + 25);
 
     return receivedData;
 }
@@ -51,124 +62,53 @@ CL_TwoZeroZeroACOM::MeasurementData CL_TwoZeroZeroACOM::handleReceivedMeasuremen
 // 解析长报文的数据块
 float CL_TwoZeroZeroACOM::parseLongDataBlock(const QByteArray &block)
 {
-    if(block.size() != 6) return 0.0f;  // 确保数据块长度正确
-
-    // 解析符号
-    char signChar = block.at(0);
-    int sign = (signChar == '-') ? -1 : 1;
-
-    // 解析有效数据
-    QString valueStr = block.mid(1,4).trimmed();    // 提取并去除空格
-    float value = valueStr.toFloat();
-
-    // 解析指数并计算结果
-    char exponentChar = block.at(5);
-    int exponent = exponentChar - '0';   // 转换为0-9的整数
-    float multiplier = std::pow(10,exponent - 4);   // 10的(exponent - 4)次方
-
-    return sign * value * multiplier;
+    if(block.size() != ClBlockCodec::LongBlockSize) return 0.0f;  // 确保数据块长度正确
+    return ClBlockCodec::parseLong(block.constData());
 }
 
-// 封装特殊报文
-QByteArray createSpecialFormatMessage(float value1, float value2, float value3)
+// 封装特殊报文的数据部分：3个数据块，每个8字节
+QByteArray CL_TwoZeroZeroACOM::createSpecialFormatMessage(float value1, float value2, float value3)
 {
-    QByteArray message;
-    message.append(0x02);   // STX
-
-    // 将每个浮点值转化为8字节的ASCII字符表示
-    auto floatToAscii = [](float val) -> QByteArray {
-        union{
-            float f;
-            uint32_t i;
-        } converter;
-        converter.f = val;
-        QByteArray result;
-        result.append(QString::number((converter.i >> 31) & 0x1, 16).toUpper().toLatin1()); // 符号位
-        result.append(QString::number((converter.i >> 23) & 0xFF, 16).rightJustified(2,'0').toUpper().toLatin1());  // 指数
-        result.append(QString::number(converter.i & 0x7FFFFF, 16).rightJustified(6,'0').toUpper().toLatin1());    // 尾数
-        return  result;
-    };
-
-    message.append(floatToAscii(value1));
-    message.append(floatToAscii(value2));
-    message.append(floatToAscii(value3));
-
+    QByteArray message(3 * ClBlockCodec::SpecialBlockSize, Qt::Uninitialized);
+    char *p = message.data();
+    ClBlockCodec::formatSpecial(value1, p);
+    ClBlockCodec::formatSpecial(value2, p + ClBlockCodec::SpecialBlockSize);
+    ClBlockCodec::formatSpecial(value3, p + 2 * ClBlockCodec::SpecialBlockSize);
     return message;
 }
 
 // 解析特殊报文的数据块
 float CL_TwoZeroZeroACOM::parseSpecialDataBlock(const QByteArray &block)
 {
-    if(block.size() != 8) return 0.0f;
-
-    // 符号位
-    int sign = (block[0] == '1') ? -1 : 1;
-
-    // 指数部分（第2、3位）
-    int exponent = block.mid(1,2).toInt(nullptr,16);
-
-    // 尾数部分（第4-8位）
-    int mantissa = block.mid(3,5).toInt(nullptr,16);
-
-    // 构建浮点数
-    float result = sign * mantissa * std::pow(2,exponent -127); // 2的(exponent - 127)次方
-    return  result;
+    if(block.size() != ClBlockCodec::SpecialBlockSize) return 0.0f;
+    return ClBlockCodec::parseSpecial(block.constData());
 }
 
-// 封装数据报文
+// 封装数据报文：STX + 数据 + ETX + BCC(2) + CRLF，一次分配
 QByteArray CL_TwoZeroZeroACOM::createMessage(const QByteArray &data)
 {
-    QByteArray sendData;
-    // 序列化数据
-
-    QDataStream stream(&sendData, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::BigEndian);    // 设置数据流为大端序
-
-    // STX 固定02h
-    stream << quint8(0x02);
-
-    // 数据
-    stream.writeRawData(data.constData(),data.size());
-
-    // ETX 固定03h
-    stream << quint8(0x03);
-
-    // BBC校验
-    QByteArray dataToXOR;
-    dataToXOR.append(data);
-    dataToXOR.append(0x03);
-    QString bcc = calculateBCC(dataToXOR);
-//    qDebug() << "bccbccbccbccbccbccbcc:" << bcc.toUtf8().toHex();
-    stream << quint8(bcc.toUtf8().at(0));
-    stream << quint8(bcc.toUtf8().at(1));
-
-    // 结尾CRLF
-    stream << quint8(0x0D);
-    stream << quint8(0x0A);
-
-    qDebug() << "发送的报文为：" << sendData.toHex();
+    const int size = data.size();
+    QByteArray sendData(size + 6, Qt::Uninitialized);
+    char *p = sendData.data();
+
+    p[0] = 0x02;                                        // STX 固定02h
+    std::memcpy(p + 1, data.constData(), size_t(size)); // 数据
+    p[size + 1] = 0x03;                                 // ETX 固定03h
+    // BCC校验：数据和ETX的异或
+    ClBlockCodec::formatHexByte(ClBlockCodec::bcc(data.constData(), size) ^ 0x03, p + size + 2);
+    p[size + 4] = 0x0D;                                 // 结尾CRLF
+    p[size + 5] = 0x0A;
+
+    LD_TRACE(lcProtocol) << "CL-200A 发送报文:" << sendData.toHex();
     return sendData;
 }
 
 // 计算校验位
 QString CL_TwoZeroZeroACOM::calculateBCC(const QByteArray &data)
 {
-    quint8 bcc = 0;
-
-    // 对QByteArray中的每个字节进行异或操作
-    for(char byte : data){
-        bcc ^= static_cast<quint8>(byte);
-    }
-
-    // 提取高低4位
-    char highNibble = (bcc >> 4) < 10 ? (bcc >> 4) + '0' : (bcc >> 4) - 10 + 'A';
-    char lowNibble = (bcc & 0x0F) < 10 ? (bcc & 0x0F) + '0' : (bcc & 0x0F) - 10 + 'A';
-
-    QString bccResult;
-    bccResult.append(highNibble);
-    bccResult.append(lowNibble);
-
-    return bccResult;
+    char bcc[2];
+    ClBlockCodec::formatHexByte(ClBlockCodec::bcc(data.constData(), data.size()), bcc);
+    return QString::fromLatin1(bcc, 2);
 }
 
 // 读取测量数据
@@ -1,13 +1,15 @@
 #ifndef CL_TWOZEROZEROACOM_H
 #define CL_TWOZEROZEROACOM_H
 
-#include <QWidget>
+#include <QObject>
+#include <QByteArray>
+#include <QString>
 
-class CL_TwoZeroZeroACOM : public QWidget
+class CL_TwoZeroZeroACOM : public QObject
 {
     Q_OBJECT
 public:
-    explicit CL_TwoZeroZeroACOM(QWidget *parent = nullptr);
+    explicit CL_TwoZeroZeroACOM(QObject *parent = nullptr);
 
     
     // 结构体，存放解析接收数据的结果（长报文，读取测量状态和数据）
@@ -34,9 +36,10 @@ public:
     ShortMeasurementData handleReceivedSettingResult(const QByteArray &data);   // Short通讯模式，获取设置指令的响应结果
     MeasurementData handleReceivedMeasurementData(const QByteArray &data);  // Long通讯模式，处理接收到的测量数据
     MeasurementData handleReceivedMeasurementDataSpecial(const QByteArray &data);  // special通讯模式，处理接收到的测量数据
-    float parseLongDataBlock(const QByteArray &block);   // 解析长报文的数据块
-    QByteArray createSpecialFormatMessage(float value1, float value2, float value3);    // 封装特殊报文
-    float parseSpecialDataBlock(const QByteArray &block);   // 解析特殊报文的数据块
+    // 数据块编解码见 clblockcodec.h
+    static float parseLongDataBlock(const QByteArray &block);   // 解析长报文的数据块
+    static QByteArray createSpecialFormatMessage(float value1, float value2, float value3);    // 封装特殊报文的数据部分（3×8字节）
+    static float parseSpecialDataBlock(const QByteArray &block);   // 解析特殊报文的数据块（IEEE-754 单精度，8位十六进制）
 
     QByteArray createMessage(const QByteArray &data);   // 封装数据报文
 
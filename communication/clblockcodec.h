@@ -0,0 +1,105 @@
+#ifndef CLBLOCKCODEC_H
+#define CLBLOCKCODEC_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * CL-200A 报文数据块编解码
+ *  直接在字节上操作，不构造 QString/QByteArray，不调用 pow，解析过程中没有堆分配
+ *  长格式数据块（6字节）：符号 + 4位有效数字（允许前后空格）+ 指数字符，值 = 有效数字 × 10^(指数-4)
+ *  特殊格式数据块（8字节）：IEEE-754 单精度浮点数的32位，按大写十六进制输出
+ *  BCC：STX 之后到 ETX（含）所有字节的异或，以两位大写十六进制发送
+ */
+namespace ClBlockCodec {
+    constexpr int LongBlockSize = 6;
+    constexpr int SpecialBlockSize = 8;
+
+    // 10^(指数-4)，指数 0~9；按单精度相乘，结果与原先 std::pow 的实现逐位一致
+    constexpr float Pow10[10] = { 1e-4f, 1e-3f, 1e-2f, 1e-1f, 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f };
+
+    constexpr char HexDigits[] = "0123456789ABCDEF";
+
+    // 十六进制字符 -> 0~15，非法字符返回 -1
+    inline int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    // 一个字节写成两位大写十六进制
+    inline void formatHexByte(std::uint8_t value, char *out)
+    {
+        out[0] = HexDigits[value >> 4];
+        out[1] = HexDigits[value & 0x0F];
+    }
+
+    inline std::uint8_t bcc(const char *data, int size)
+    {
+        std::uint8_t result = 0;
+        for (int i = 0; i < size; ++i) {
+            result ^= std::uint8_t(data[i]);
+        }
+        return result;
+    }
+
+    // 长格式数据块，格式错误返回 0
+    inline float parseLong(const char *block)
+    {
+        const int sign = block[0] == '-' ? -1 : 1;
+
+        // 有效数字：去掉前后空格后必须全部是数字
+        int begin = 1;
+        int end = 5;
+        while (begin < end && block[begin] == ' ') {
+            ++begin;
+        }
+        while (end > begin && block[end - 1] == ' ') {
+            --end;
+        }
+        int mantissa = 0;
+        for (int i = begin; i < end; ++i) {
+            const char c = block[i];
+            if (c < '0' || c > '9') {
+                return 0.0f;
+            }
+            mantissa = mantissa * 10 + (c - '0');
+        }
+
+        const int exponent = block[5] - '0';
+        if (exponent < 0 || exponent > 9) {
+            return 0.0f;
+        }
+        return float(sign) * float(mantissa) * Pow10[exponent];
+    }
+
+    // 特殊格式数据块，格式错误返回 0
+    inline float parseSpecial(const char *block)
+    {
+        std::uint32_t bits = 0;
+        for (int i = 0; i < SpecialBlockSize; ++i) {
+            const int digit = hexValue(block[i]);
+            if (digit < 0) {
+                return 0.0f;
+            }
+            bits = (bits << 4) | std::uint32_t(digit);
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    inline void formatSpecial(float value, char *block)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = SpecialBlockSize - 1; i >= 0; --i) {
+            block[i] = HexDigits[bits & 0x0F];
+            bits >>= 4;
+        }
+    }
+}
+
+#endif // CLBLOCKCODEC_H
@@ -3,6 +3,7 @@
 #include <QIODevice>
 #include <QDataStream>
 #include <QDebug>
+#include "util/logcategories.h"
 
 DriverGeneral::DriverGeneral(QObject *parent)
     :QObject(parent)
@@ -40,7 +41,7 @@ QByteArray DriverGeneral::makeCommand(quint8 commandLength, quint8 actionCategor
     sendData.append(static_cast<char>((crcCode >> 8) & 0xFF));  // 高字节
     sendData.append(static_cast<char>(crcCode & 0xFF));        // 低字节
     
-    qDebug() << "Send driverGeneral data is : " << sendData.toHex();
+    LD_TRACE(lcProtocol) << "Send driverGeneral data is : " << sendData.toHex();
     return sendData;
 }
 
@@ -132,6 +133,23 @@ QByteArray DriverGeneral::writeLEDStrength(quint8 sendAddress, quint8 receiveAdd
     return makeCommand(conLength, 0x80, sendAddress, receiveAddress, 0x26, data);
 }
 
+QByteArray DriverGeneral::writeLEDStrengths(quint8 sendAddress, quint8 receiveAddress,
+                                            quint8 startRegister, const QVector<quint16> &values)
+{
+    QByteArray valuedata(values.size() * 2, Qt::Uninitialized);
+    for (int c = 0; c < values.size(); ++c) {
+        valuedata[2 * c] = char(values.at(c) >> 8);        // 大端序
+        valuedata[2 * c + 1] = char(values.at(c) & 0xFF);
+    }
+    return writeLEDStrength(sendAddress, receiveAddress, startRegister, quint8(values.size()), valuedata);
+}
+
+QByteArray DriverGeneral::writeUniformLEDStrength(quint8 sendAddress, quint8 receiveAddress,
+                                                  quint8 startRegister, quint8 registerCount, quint16 value)
+{
+    return writeLEDStrengths(sendAddress, receiveAddress, startRegister, QVector<quint16>(registerCount, value));
+}
+
 QByteArray DriverGeneral::writeLEDModel(quint8 sendAddress, quint8 receiveAddress,
                                         quint16 LEDModel)
 {
@@ -3,6 +3,8 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QVector>
+#include "util/devicestate.h"
 
 class DriverGeneral : public QObject
 {
@@ -69,6 +71,11 @@ public:
     QByteArray writeLEDStrength(quint8 sendAddress, quint8 receiveAddress,
                                 quint8 startRegister, quint8 registerCount,
                                 QByteArray valuedata);   // 0x26
+    QByteArray writeLEDStrengths(quint8 sendAddress, quint8 receiveAddress,
+                                 quint8 startRegister, const QVector<quint16> &values);   // 0x26，各通道依次取值
+    QByteArray writeUniformLEDStrength(quint8 sendAddress, quint8 receiveAddress,
+                                       quint8 startRegister, quint8 registerCount,
+                                       quint16 value);   // 0x26，各通道同一个值
     QByteArray writeLEDModel(quint8 sendAddress, quint8 receiveAddress,
                              quint16 LEDModel);   // 0x50
     QByteArray writeLEDWorkTime(quint8 sendAddress, quint8 receiveAddress,
@@ -90,12 +97,17 @@ public:
     // CRC校验
     static quint16 calculateCRC16(const QByteArray &data);
 
+    // 驱动器状态快照：接收方解码响应后写入，任意线程可读
+    const DeviceState<DriverState> &state() const { return m_state; }
+    DeviceState<DriverState> &state() { return m_state; }
 
 private:
     static const quint16 STX = 0x4C44;  // 起始字符
     static const char W_COM = 0x80;     // 写指令
     static const char R_COM = 0x81;     // 读指令
 
+    DeviceState<DriverState> m_state;
+
 };
 
 #endif // DRIVERGENERAL_H
@@ -1,10 +1,174 @@
 #include "eleload_itplus.h"
+#include "fieldcodec.h"
 #include <QDebug>
+#include <array>
+
+// 报文字段表：每个参数的偏移、宽度和倍率只在这里描述一次
+namespace ITPlusFields {
+    constexpr long VoltageScale = 1000;         // 1mV
+    constexpr long CurrentScale = 10000;        // 0.1mA
+    constexpr long PowerScale = 1000;           // 1mW
+    constexpr long ResistanceScale = 1000;      // 1mΩ
+    constexpr long TimeScale = 10;              // 0.1ms（物理值单位为ms）
+
+    // 单个设定值（0x22~0x31），紧跟功能码
+    using Voltage = ScaledField<3, 4, VoltageScale>;
+    using Current = ScaledField<3, 4, CurrentScale>;
+    using Power = ScaledField<3, 4, PowerScale>;
+    using Resistance = ScaledField<3, 4, ResistanceScale>;
+    using Byte = ScaledField<3, 1>;             // 模式、状态等单字节参数
+    using Word = ScaledField<3, 2>;             // LIST步数等双字节参数
+
+    // 动态参数（0x32~0x39）：值A(4) 时间A(2) 值B(4) 时间B(2) 模式(1)
+    template<long Scale>
+    struct Dynamic {
+        using ValueA = ScaledField<3, 4, Scale>;
+        using TimeA = ScaledField<ValueA::end, 2, TimeScale>;
+        using ValueB = ScaledField<TimeA::end, 4, Scale>;
+        using TimeB = ScaledField<ValueB::end, 2, TimeScale>;
+        using Mode = ScaledField<TimeB::end, 1>;
+    };
+    static_assert(Dynamic<1>::TimeA::offset == 7 && Dynamic<1>::ValueB::offset == 9 &&
+                  Dynamic<1>::TimeB::offset == 13 && Dynamic<1>::Mode::offset == 15,
+                  "dynamic parameter layout");
+
+    // LIST步骤（0x40~0x47）：步号(2) 设定值(4) 驻留时间(2)
+    template<long Scale>
+    struct ListStepFields {
+        using Index = ScaledField<3, 2>;
+        using Value = ScaledField<Index::end, 4, Scale>;
+        using Dwell = ScaledField<Value::end, 2, TimeScale>;
+    };
+
+    // 输入参数（0x5F）
+    namespace Input {
+        using Voltage = ScaledField<3, 4, VoltageScale>;
+        using Current = ScaledField<7, 4, CurrentScale>;
+        using Power = ScaledField<11, 4, PowerScale>;
+        using HandleState = ScaledField<15, 1>;
+        using SelState = ScaledField<16, 2>;
+        using Temperature = ScaledField<20, 1>;
+        using WorkMode = ScaledField<21, 1>;
+        using ListStep = ScaledField<22, 1>;
+        using ListCycle = ScaledField<23, 2>;
+    }
+    static_assert(Input::ListCycle::end < EleLoad_ITPlus::CommandLength, "input parameters fit in a frame");
+
+    // 编译期往返校验：四舍五入、饱和
+    template<typename Field>
+    constexpr double roundTrip(double value)
+    {
+        std::uint8_t frame[EleLoad_ITPlus::CommandLength] = {};
+        Field::encode(frame, value);
+        return Field::decode(frame);
+    }
+    static_assert(Current::toRaw(1.2) == 12000, "rounds instead of truncating");
+    static_assert(roundTrip<Current>(1.2345) == 1.2345, "current round trip");
+    static_assert(roundTrip<Voltage>(150.0) == 150.0, "voltage round trip");
+    static_assert(roundTrip<Dynamic<CurrentScale>::TimeA>(6553.5) == 6553.5, "time round trip");
+    static_assert(roundTrip<Dynamic<CurrentScale>::TimeA>(7000.0) == 6553.5, "time saturates");
+    static_assert(roundTrip<Voltage>(-1.0) == 0.0, "negative value clamps to zero");
+}
+
+namespace {
+    uint8_t *frameData(QByteArray &command)
+    {
+        return reinterpret_cast<uint8_t *>(command.data());
+    }
+
+    const uint8_t *frameData(const QByteArray &data)
+    {
+        return reinterpret_cast<const uint8_t *>(data.constData());
+    }
+
+    // 响应解码函数，frame 已通过校验
+    using ResponseDecoder = void (*)(EleLoad_ITPlus &protocol, const QByteArray &frame);
+
+    struct ResponseEntry {
+        uint8_t functionCode;
+        ResponseDecoder decode;
+    };
+
+    constexpr ResponseEntry ResponseTable[] = {
+        { 0x12, [](EleLoad_ITPlus &p, const QByteArray &f) { emit p.setResponseReceived(uint8_t(f[3])); } },
+        { 0x23, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              const float value = p.analyseMaxVoltage(f);
+              p.state().update([value](LoadState &s) { s.maxVoltage = value; });
+              emit p.maxVoltageReceived(value); } },
+        { 0x25, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              const float value = p.analyseMaxCurrent(f);
+              p.state().update([value](LoadState &s) { s.maxCurrent = value; });
+              emit p.maxCurrentReceived(value); } },
+        { 0x27, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              const float value = p.analyseMaxPower(f);
+              p.state().update([value](LoadState &s) { s.maxPower = value; });
+              emit p.maxPowerReceived(value); } },
+        { 0x29, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              const uint8_t mode = p.analyseLoadMode(f);
+              p.state().update([mode](LoadState &s) { s.loadMode = mode; });
+              emit p.loadModeReceived(mode); } },
+        { 0x2B, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              emit p.constantValueReceived(EleLoad_ITPlus::Mode::CC, p.analyseConstantCurrent(f)); } },
+        { 0x2D, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              emit p.constantValueReceived(EleLoad_ITPlus::Mode::CV, p.analyseConstantVoltage(f)); } },
+        { 0x2F, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              emit p.constantValueReceived(EleLoad_ITPlus::Mode::CW, p.analyseConstantPower(f)); } },
+        { 0x31, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              emit p.constantValueReceived(EleLoad_ITPlus::Mode::CR, p.analyseConstantResistance(f)); } },
+        { 0x33, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              emit p.dynamicParamsReceived(EleLoad_ITPlus::Mode::CC, p.analyseDynamicCurrentParams(f)); } },
+        { 0x35, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              emit p.dynamicParamsReceived(EleLoad_ITPlus::Mode::CV, p.analyseDynamicVoltageParams(f)); } },
+        { 0x37, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              emit p.dynamicParamsReceived(EleLoad_ITPlus::Mode::CW, p.analyseDynamicPowerParams(f)); } },
+        { 0x39, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              emit p.dynamicParamsReceived(EleLoad_ITPlus::Mode::CR, p.analyseDynamicResistanceParams(f)); } },
+        { 0x5E, [](EleLoad_ITPlus &p, const QByteArray &f) { emit p.workModelReceived(p.analyseWorkModel(f)); } },
+        { 0x5F, [](EleLoad_ITPlus &p, const QByteArray &f) {
+              EleLoad_ITPlus::InputParams params = p.analyseInputParams(f);
+              params.time = p.receivedAt();
+              p.state().update([&params](LoadState &s) {
+                  s.voltage = params.voltage;
+                  s.current = params.current;
+                  s.power = params.power;
+                  s.temperature = params.radiatorTemperature;
+                  s.remote = params.handleStateRegister.rem;
+                  s.output = params.handleStateRegister.out;
+                  s.time = params.time;
+                  ++s.samples;
+              });
+              emit p.inputParamsReceived(params); } },
+        { 0x6A, [](EleLoad_ITPlus &p, const QByteArray &f) { emit p.productMessageReceived(p.analyseProductMessage(f)); } },
+    };
+
+    constexpr int ResponseCount = int(sizeof(ResponseTable) / sizeof(ResponseTable[0]));
+    static_assert(ResponseCount < 128, "response index is int8_t");
+
+    // 功能码 -> 表项下标，-1 表示无需处理；编译期生成，分发时 O(1) 查表
+    constexpr std::array<int8_t, 256> buildResponseIndex()
+    {
+        std::array<int8_t, 256> index{};
+        for (auto &entry : index) {
+            entry = -1;
+        }
+        for (int i = 0; i < ResponseCount; ++i) {
+            index[ResponseTable[i].functionCode] = int8_t(i);
+        }
+        return index;
+    }
+
+    constexpr std::array<int8_t, 256> ResponseIndex = buildResponseIndex();
+}
 
 EleLoad_ITPlus::EleLoad_ITPlus(uint8_t loadAddress, QObject *parent)
     : Protocol(parent)
     , m_loadAddress(loadAddress)
 {
+    // 允许跨线程（队列连接）传递解码结果
+    qRegisterMetaType<EleLoad_ITPlus::Mode>("EleLoad_ITPlus::Mode");
+    qRegisterMetaType<EleLoad_ITPlus::DynamicParams>("EleLoad_ITPlus::DynamicParams");
+    qRegisterMetaType<EleLoad_ITPlus::InputParams>("EleLoad_ITPlus::InputParams");
+    qRegisterMetaType<EleLoad_ITPlus::ProductMessage>("EleLoad_ITPlus::ProductMessage");
 }
 
 QByteArray EleLoad_ITPlus::makeReadCommand(int address, int count)
@@ -34,21 +198,45 @@ bool EleLoad_ITPlus::parseResponse(const QByteArray &response, QByteArray &data)
 // 计算校验和
 uint8_t EleLoad_ITPlus::calculateChecksum(const QByteArray &data)
 {
-    uint8_t checksum = 0;
-    for(int i = 0; i < data.size()-1; ++i) {
-        checksum += static_cast<uint8_t>(data[i]);
-    }
-    return checksum;
+    return checksum(reinterpret_cast<const uint8_t *>(data.constData()), data.size());
 }
 
 // 校验接收报文是否准确
 bool EleLoad_ITPlus::validateResponse(const QByteArray &data)
 {
-    if (data.size() != CommandLength || 
-        (data[0] & 0xFF) != SyncHeader || 
-        calculateChecksum(data) != static_cast<uint8_t>(data[data.size() - 1])) {
+    return validateFrame(reinterpret_cast<const uint8_t *>(data.constData()), data.size());
+}
+
+// 校验和：除最后一个字节外所有字节之和
+uint8_t EleLoad_ITPlus::checksum(const uint8_t *frame, int size)
+{
+    uint8_t sum = 0;
+    for (int i = 0; i < size - 1; ++i) {
+        sum += frame[i];
+    }
+    return sum;
+}
+
+bool EleLoad_ITPlus::validateFrame(const uint8_t *frame, int size)
+{
+    return size == CommandLength &&
+           frame[0] == SyncHeader &&
+           checksum(frame, size) == frame[size - 1];
+}
+
+// 响应分发
+bool EleLoad_ITPlus::dispatchResponse(const QByteArray &frame, std::chrono::steady_clock::time_point receivedAt)
+{
+    if (!validateResponse(frame)) {
+        emit error("响应数据校验失败");
+        return false;
+    }
+    const int index = ResponseIndex[uint8_t(frame[2])];
+    if (index < 0) {
         return false;
     }
+    m_receivedAt = receivedAt;
+    ResponseTable[index].decode(*this, frame);
     return true;
 }
 
@@ -88,7 +276,7 @@ QByteArray EleLoad_ITPlus::createGetMessage(uint8_t action)
 // 最大值设置命令
 QByteArray EleLoad_ITPlus::createSetMaxVoltageCommand(float voltage)
 {
-    return createSetValueCommand(0x22, voltage, 1000.0f);
+    return createSetValueCommand<ITPlusFields::Voltage>(0x22, voltage);
 }
 
 QByteArray EleLoad_ITPlus::createGetMaxVoltageCommand()
@@ -98,7 +286,162 @@ QByteArray EleLoad_ITPlus::createGetMaxVoltageCommand()
 
 float EleLoad_ITPlus::analyseMaxVoltage(const QByteArray &data)
 {
-    return analyseValue(data, 1000.0f);
+    return analyseValue<ITPlusFields::Voltage>(data);
+}
+
+// LIST模式
+namespace {
+    // LIST步骤设置命令的功能码，读取命令为其+1
+    uint8_t listStepCode(EleLoad_ITPlus::Mode mode)
+    {
+        switch (mode) {
+        case EleLoad_ITPlus::Mode::CC: return 0x40;
+        case EleLoad_ITPlus::Mode::CV: return 0x42;
+        case EleLoad_ITPlus::Mode::CW: return 0x44;
+        case EleLoad_ITPlus::Mode::CR: return 0x46;
+        }
+        return 0x40;
+    }
+
+    // LIST模式字节：与负载模式（0x28）相同，0 CC, 1 CV, 2 CW, 3 CR
+    uint8_t listModeByte(EleLoad_ITPlus::Mode mode)
+    {
+        switch (mode) {
+        case EleLoad_ITPlus::Mode::CC: return 0;
+        case EleLoad_ITPlus::Mode::CV: return 1;
+        case EleLoad_ITPlus::Mode::CW: return 2;
+        case EleLoad_ITPlus::Mode::CR: return 3;
+        }
+        return 0;
+    }
+}
+
+QByteArray EleLoad_ITPlus::createSetListModeCommand(Mode mode)
+{
+    return createCommand(0x3A, QByteArray(1, char(listModeByte(mode))));
+}
+
+QByteArray EleLoad_ITPlus::createGetListModeCommand()
+{
+    return createGetMessage(0x3B);
+}
+
+QByteArray EleLoad_ITPlus::createSetListRepeatCommand(bool repeat)
+{
+    return createCommand(0x3C, QByteArray(1, char(repeat ? 1 : 0)));
+}
+
+QByteArray EleLoad_ITPlus::createGetListRepeatCommand()
+{
+    return createGetMessage(0x3D);
+}
+
+QByteArray EleLoad_ITPlus::createSetListStepCountCommand(uint16_t count)
+{
+    QByteArray command = createCommand(0x3E);
+    ITPlusFields::Word::encodeRaw(frameData(command), count);
+    command[CommandLength - 1] = calculateChecksum(command);
+    return command;
+}
+
+QByteArray EleLoad_ITPlus::createGetListStepCountCommand()
+{
+    return createGetMessage(0x3F);
+}
+
+QByteArray EleLoad_ITPlus::createSetListStepCommand(Mode mode, uint16_t step, const ListStep &value)
+{
+    using ITPlusFields::ListStepFields;
+    const uint8_t code = listStepCode(mode);
+    switch (mode) {
+    case Mode::CC: return createListStepCommand<ListStepFields<ITPlusFields::CurrentScale>>(code, step, value);
+    case Mode::CV: return createListStepCommand<ListStepFields<ITPlusFields::VoltageScale>>(code, step, value);
+    case Mode::CW: return createListStepCommand<ListStepFields<ITPlusFields::PowerScale>>(code, step, value);
+    case Mode::CR: return createListStepCommand<ListStepFields<ITPlusFields::ResistanceScale>>(code, step, value);
+    }
+    return QByteArray();
+}
+
+QByteArray EleLoad_ITPlus::createGetListStepCommand(Mode mode, uint16_t step)
+{
+    QByteArray command = createCommand(listStepCode(mode) + 1);
+    ITPlusFields::Word::encodeRaw(frameData(command), step);
+    command[CommandLength - 1] = calculateChecksum(command);
+    return command;
+}
+
+QByteArray EleLoad_ITPlus::createSetListNameCommand(const QString &name)
+{
+    return createCommand(0x48, name.toLatin1().left(10));
+}
+
+QByteArray EleLoad_ITPlus::createGetListNameCommand()
+{
+    return createGetMessage(0x49);
+}
+
+QByteArray EleLoad_ITPlus::createSetListPartitionCommand(uint8_t partition)
+{
+    return createCommand(0x4A, QByteArray(1, char(partition)));
+}
+
+QByteArray EleLoad_ITPlus::createGetListPartitionCommand()
+{
+    return createGetMessage(0x4B);
+}
+
+QByteArray EleLoad_ITPlus::createSaveListCommand(uint8_t area)
+{
+    return createCommand(0x4C, QByteArray(1, char(area)));
+}
+
+QByteArray EleLoad_ITPlus::createRecallListCommand(uint8_t area)
+{
+    return createCommand(0x4D, QByteArray(1, char(area)));
+}
+
+QByteArray EleLoad_ITPlus::createSetTriggerSourceCommand(uint8_t source)
+{
+    return createCommand(0x58, QByteArray(1, char(source)));
+}
+
+QByteArray EleLoad_ITPlus::createGetTriggerSourceCommand()
+{
+    return createGetMessage(0x59);
+}
+
+QVector<QByteArray> EleLoad_ITPlus::createListProgram(Mode mode, const QVector<ListStep> &steps,
+                                                      int repeatCount, uint8_t area)
+{
+    // 仪器只支持单次/连续，有限次重复时展开步骤
+    QVector<ListStep> program;
+    const int copies = repeatCount > 1 ? repeatCount : 1;
+    for (int i = 0; i < copies; ++i) {
+        program += steps;
+    }
+    if (program.size() < 2 || program.size() > MaxListSteps) {
+        emit error(QString("LIST步数 %1 超出范围 (2 ~ %2)").arg(program.size()).arg(MaxListSteps));
+        return {};
+    }
+    for (const ListStep &step : program) {
+        if (step.value < 0 || step.dwellMs < 0.1f || step.dwellMs > 6553.5f) {
+            emit error("LIST步骤参数越界");
+            return {};
+        }
+    }
+
+    QVector<QByteArray> commands;
+    commands << createSetListModeCommand(mode)
+             << createSetListRepeatCommand(repeatCount == 0)
+             << createSetListStepCountCommand(uint16_t(program.size()));
+    for (int i = 0; i < program.size(); ++i) {
+        commands << createSetListStepCommand(mode, uint16_t(i + 1), program.at(i));
+    }
+    commands << createSaveListCommand(area)
+             << createRecallListCommand(area)
+             << createSetTriggerSourceCommand(2)     // 总线触发，由 createBusTriggerSignal 启动
+             << createSetWorkModel(0x03);            // 工作模式：LIST
+    return commands;
 }
 
 // 解析操作状态寄存器
@@ -124,43 +467,20 @@ EleLoad_ITPlus::InputParams EleLoad_ITPlus::analyseInputParams(const QByteArray
         return params;
     }
 
-    // 解析电压值（4字节，小端序）
-    uint32_t voltage = static_cast<uint8_t>(data[3]) |
-                      (static_cast<uint8_t>(data[4]) << 8) |
-                      (static_cast<uint8_t>(data[5]) << 16) |
-                      (static_cast<uint8_t>(data[6]) << 24);
-    params.voltage = voltage / 1000.0f;
-
-    // 解析电流值
-    uint32_t current = static_cast<uint8_t>(data[7]) |
-                      (static_cast<uint8_t>(data[8]) << 8) |
-                      (static_cast<uint8_t>(data[9]) << 16) |
-                      (static_cast<uint8_t>(data[10]) << 24);
-    params.current = current / 10000.0f;
-
-    // 解析功率值
-    uint32_t power = static_cast<uint8_t>(data[11]) |
-                    (static_cast<uint8_t>(data[12]) << 8) |
-                    (static_cast<uint8_t>(data[13]) << 16) |
-                    (static_cast<uint8_t>(data[14]) << 24);
-    params.power = power / 1000.0f;
-
-    // 解析状态寄存器
-    params.handleStateRegister = parseHandleState(static_cast<uint8_t>(data[15]));
-    
-    // 解析查询状态寄存器
-    params.selStateRegister = static_cast<uint8_t>(data[16]) |
-                             (static_cast<uint8_t>(data[17]) << 8);
-
-    // 解析其他参数
-    params.radiatorTemperature = static_cast<uint8_t>(data[20]);
-    params.workMode = static_cast<uint8_t>(data[21]);
-    params.listStep = static_cast<uint8_t>(data[22]);
-    params.listCycleIndex = static_cast<uint8_t>(data[23]) |
-                           (static_cast<uint8_t>(data[24]) << 8);
-
-    // 设置当前时间
-    params.time = std::chrono::system_clock::now();
+    namespace Input = ITPlusFields::Input;
+    const uint8_t *frame = frameData(data);
+    params.voltage = float(Input::Voltage::decode(frame));
+    params.current = float(Input::Current::decode(frame));
+    params.power = float(Input::Power::decode(frame));
+    params.handleStateRegister = parseHandleState(uint8_t(Input::HandleState::decodeRaw(frame)));
+    params.selStateRegister = uint16_t(Input::SelState::decodeRaw(frame));
+    params.radiatorTemperature = uint8_t(Input::Temperature::decodeRaw(frame));
+    params.workMode = uint8_t(Input::WorkMode::decodeRaw(frame));
+    params.listStep = uint8_t(Input::ListStep::decodeRaw(frame));
+    params.listCycleIndex = uint16_t(Input::ListCycle::decodeRaw(frame));
+
+    // 单独调用时以解析时刻代替接收时刻，经 dispatchResponse 分发时会被接收时刻覆盖
+    params.time = std::chrono::steady_clock::now();
 
     return params;
 }
@@ -193,7 +513,7 @@ EleLoad_ITPlus::ProductMessage EleLoad_ITPlus::analyseProductMessage(const QByte
 // 最大电流设置命令
 QByteArray EleLoad_ITPlus::createSetMaxCurrentCommand(float current)
 {
-    return createSetValueCommand(0x24, current, 10000.0f);
+    return createSetValueCommand<ITPlusFields::Current>(0x24, current);
 }
 
 QByteArray EleLoad_ITPlus::createGetMaxCurrentCommand()
@@ -203,13 +523,13 @@ QByteArray EleLoad_ITPlus::createGetMaxCurrentCommand()
 
 float EleLoad_ITPlus::analyseMaxCurrent(const QByteArray &data)
 {
-    return analyseValue(data, 10000.0f);
+    return analyseValue<ITPlusFields::Current>(data);
 }
 
 // 最大功率设置命令
 QByteArray EleLoad_ITPlus::createSetMaxPowerCommand(float power)
 {
-    return createSetValueCommand(0x26, power, 1000.0f);
+    return createSetValueCommand<ITPlusFields::Power>(0x26, power);
 }
 
 QByteArray EleLoad_ITPlus::createGetMaxPowerCommand()
@@ -219,7 +539,7 @@ QByteArray EleLoad_ITPlus::createGetMaxPowerCommand()
 
 float EleLoad_ITPlus::analyseMaxPower(const QByteArray &data)
 {
-    return analyseValue(data, 1000.0f);
+    return analyseValue<ITPlusFields::Power>(data);
 }
 
 // 设置负载模式,mode = 0 为CC, 1 为输出CV, 2 为CW, 3 为CR
@@ -237,7 +557,7 @@ QByteArray EleLoad_ITPlus::createSetLoadModeCommand(uint8_t mode) {
 QByteArray EleLoad_ITPlus::createSetDynamicCurrentParamsCommand(
     float currentA, float timeA, float currentB, float timeB, uint8_t mode)
 {
-    return createDynamicParamsCommand(0x32, currentA, timeA, currentB, timeB, mode, 10000.0f);
+    return createDynamicParamsCommand<ITPlusFields::Dynamic<ITPlusFields::CurrentScale>>(0x32, currentA, timeA, currentB, timeB, mode);
 }
 
 QByteArray EleLoad_ITPlus::createGetDynamicCurrentParamsCommand()
@@ -247,7 +567,7 @@ QByteArray EleLoad_ITPlus::createGetDynamicCurrentParamsCommand()
 
 EleLoad_ITPlus::DynamicParams EleLoad_ITPlus::analyseDynamicCurrentParams(const QByteArray &data)
 {
-    return analyseDynamicParams(data, 10000.0f);
+    return analyseDynamicParams<ITPlusFields::Dynamic<ITPlusFields::CurrentScale>>(data);
 }
 
 // 触发相关命令
@@ -310,7 +630,7 @@ QByteArray EleLoad_ITPlus::createGetProductMessage()
 
 QByteArray EleLoad_ITPlus::createSetConstantPowerCommand(float power)
 {
-    return createSetValueCommand(0x24, power, 1000.0f);
+    return createSetValueCommand<ITPlusFields::Power>(0x2E, power);
 }
 
 QByteArray EleLoad_ITPlus::createGetConstantPowerCommand()
@@ -321,19 +641,7 @@ QByteArray EleLoad_ITPlus::createGetConstantPowerCommand()
 // 定值设置命令
 QByteArray EleLoad_ITPlus::createSetConstantCurrentCommand(float current)
 {
-    uint32_t sendCurrent = static_cast<uint32_t>(current * 10000); // 0.1mA units
-    QByteArray command(CommandLength, 0x00);
-    command[0] = SyncHeader;
-    command[1] = m_loadAddress;
-    command[2] = 0x2A;
-
-    command[3] = static_cast<uint8_t>(sendCurrent & 0xFF);
-    command[4] = static_cast<uint8_t>((sendCurrent >> 8) & 0xFF);
-    command[5] = static_cast<uint8_t>((sendCurrent >> 16) & 0xFF);
-    command[6] = static_cast<uint8_t>((sendCurrent >> 24) & 0xFF);
-
-    command[CommandLength - 1] = calculateChecksum(command);
-    return command;
+    return createSetValueCommand<ITPlusFields::Current>(0x2A, current);
 }
 
 QByteArray EleLoad_ITPlus::createGetConstantCurrentCommand()
@@ -343,24 +651,12 @@ QByteArray EleLoad_ITPlus::createGetConstantCurrentCommand()
 
 float EleLoad_ITPlus::analyseConstantCurrent(const QByteArray &data)
 {
-    return analyseValue(data, 10000.0f);
+    return analyseValue<ITPlusFields::Current>(data);
 }
 
 QByteArray EleLoad_ITPlus::createSetConstantVoltageCommand(float voltage)
 {
-    uint32_t sendVoltage = static_cast<uint32_t>(voltage * 1000); // 1mV units
-    QByteArray command(CommandLength, 0x00);
-    command[0] = SyncHeader;
-    command[1] = m_loadAddress;
-    command[2] = 0x2C;
-
-    command[3] = static_cast<uint8_t>(sendVoltage & 0xFF);
-    command[4] = static_cast<uint8_t>((sendVoltage >> 8) & 0xFF);
-    command[5] = static_cast<uint8_t>((sendVoltage >> 16) & 0xFF);
-    command[6] = static_cast<uint8_t>((sendVoltage >> 24) & 0xFF);
-
-    command[CommandLength - 1] = calculateChecksum(command);
-    return command;
+    return createSetValueCommand<ITPlusFields::Voltage>(0x2C, voltage);
 }
 
 QByteArray EleLoad_ITPlus::createGetConstantVoltageCommand()
@@ -370,24 +666,12 @@ QByteArray EleLoad_ITPlus::createGetConstantVoltageCommand()
 
 float EleLoad_ITPlus::analyseConstantVoltage(const QByteArray &data)
 {
-    return analyseValue(data, 1000.0f);
+    return analyseValue<ITPlusFields::Voltage>(data);
 }
 
 QByteArray EleLoad_ITPlus::createSetConstantResistanceCommand(float resistance)
 {
-    uint32_t sendResistance = static_cast<uint32_t>(resistance * 1000); // 1mΩ units
-    QByteArray command(CommandLength, 0x00);
-    command[0] = SyncHeader;
-    command[1] = m_loadAddress;
-    command[2] = 0x30;
-
-    command[3] = static_cast<uint8_t>(sendResistance & 0xFF);
-    command[4] = static_cast<uint8_t>((sendResistance >> 8) & 0xFF);
-    command[5] = static_cast<uint8_t>((sendResistance >> 16) & 0xFF);
-    command[6] = static_cast<uint8_t>((sendResistance >> 24) & 0xFF);
-
-    command[CommandLength - 1] = calculateChecksum(command);
-    return command;
+    return createSetValueCommand<ITPlusFields::Resistance>(0x30, resistance);
 }
 
 QByteArray EleLoad_ITPlus::createGetConstantResistanceCommand()
@@ -397,14 +681,14 @@ QByteArray EleLoad_ITPlus::createGetConstantResistanceCommand()
 
 float EleLoad_ITPlus::analyseConstantResistance(const QByteArray &data)
 {
-    return analyseValue(data, 1000.0f);
+    return analyseValue<ITPlusFields::Resistance>(data);
 }
 
 // 动态电压参数命令
 QByteArray EleLoad_ITPlus::createSetDynamicVoltageParamsCommand(
     float voltageA, float timeA, float voltageB, float timeB, uint8_t mode)
 {
-    return createDynamicParamsCommand(0x34, voltageA, timeA, voltageB, timeB, mode, 1000.0f);
+    return createDynamicParamsCommand<ITPlusFields::Dynamic<ITPlusFields::VoltageScale>>(0x34, voltageA, timeA, voltageB, timeB, mode);
 }
 
 QByteArray EleLoad_ITPlus::createGetDynamicVoltageParamsCommand()
@@ -414,46 +698,14 @@ QByteArray EleLoad_ITPlus::createGetDynamicVoltageParamsCommand()
 
 EleLoad_ITPlus::DynamicParams EleLoad_ITPlus::analyseDynamicVoltageParams(const QByteArray &data)
 {
-    return analyseDynamicParams(data, 1000.0f);
+    return analyseDynamicParams<ITPlusFields::Dynamic<ITPlusFields::VoltageScale>>(data);
 }
 
 // 动态功率参数命令
 QByteArray EleLoad_ITPlus::createSetDynamicPowerParamsCommand(
     float powerA, float timeA, float powerB, float timeB, uint8_t mode)
 {
-    QByteArray command(CommandLength, 0x00);
-    command[0] = SyncHeader;
-    command[1] = m_loadAddress;
-    command[2] = 0x36;
-
-    // 设置功率A值（4字节）
-    uint32_t sendPowerA = static_cast<uint32_t>(powerA * 1000);
-    command[3] = static_cast<uint8_t>(sendPowerA & 0xFF);
-    command[4] = static_cast<uint8_t>((sendPowerA >> 8) & 0xFF);
-    command[5] = static_cast<uint8_t>((sendPowerA >> 16) & 0xFF);
-    command[6] = static_cast<uint8_t>((sendPowerA >> 24) & 0xFF);
-
-    // 设置时间A值（2字节）
-    uint16_t sendTimeA = static_cast<uint16_t>(timeA * 10000);
-    command[7] = static_cast<uint8_t>(sendTimeA & 0xFF);
-    command[8] = static_cast<uint8_t>((sendTimeA >> 8) & 0xFF);
-
-    // 设置功率B值（4字节）
-    uint32_t sendPowerB = static_cast<uint32_t>(powerB * 1000);
-    command[9] = static_cast<uint8_t>(sendPowerB & 0xFF);
-    command[10] = static_cast<uint8_t>((sendPowerB >> 8) & 0xFF);
-    command[11] = static_cast<uint8_t>((sendPowerB >> 16) & 0xFF);
-    command[12] = static_cast<uint8_t>((sendPowerB >> 24) & 0xFF);
-
-    // 设置时间B值（2字节）
-    uint16_t sendTimeB = static_cast<uint16_t>(timeB * 10000);
-    command[13] = static_cast<uint8_t>(sendTimeB & 0xFF);
-    command[14] = static_cast<uint8_t>((sendTimeB >> 8) & 0xFF);
-
-    command[15] = mode;
-
-    command[CommandLength - 1] = calculateChecksum(command);
-    return command;
+    return createDynamicParamsCommand<ITPlusFields::Dynamic<ITPlusFields::PowerScale>>(0x36, powerA, timeA, powerB, timeB, mode);
 }
 
 QByteArray EleLoad_ITPlus::createGetDynamicPowerParamsCommand()
@@ -463,46 +715,14 @@ QByteArray EleLoad_ITPlus::createGetDynamicPowerParamsCommand()
 
 EleLoad_ITPlus::DynamicParams EleLoad_ITPlus::analyseDynamicPowerParams(const QByteArray &data)
 {
-    return analyseDynamicParams(data, 1000.0f);
+    return analyseDynamicParams<ITPlusFields::Dynamic<ITPlusFields::PowerScale>>(data);
 }
 
 // 动态电阻参数命令
 QByteArray EleLoad_ITPlus::createSetDynamicResistanceParamsCommand(
     float resistanceA, float timeA, float resistanceB, float timeB, uint8_t mode)
 {
-    QByteArray command(CommandLength, 0x00);
-    command[0] = SyncHeader;
-    command[1] = m_loadAddress;
-    command[2] = 0x38;
-
-    // 设置电阻A值（4字节）
-    uint32_t sendResistanceA = static_cast<uint32_t>(resistanceA * 1000);
-    command[3] = static_cast<uint8_t>(sendResistanceA & 0xFF);
-    command[4] = static_cast<uint8_t>((sendResistanceA >> 8) & 0xFF);
-    command[5] = static_cast<uint8_t>((sendResistanceA >> 16) & 0xFF);
-    command[6] = static_cast<uint8_t>((sendResistanceA >> 24) & 0xFF);
-
-    // 设置时间A值（2字节）
-    uint16_t sendTimeA = static_cast<uint16_t>(timeA * 10000);
-    command[7] = static_cast<uint8_t>(sendTimeA & 0xFF);
-    command[8] = static_cast<uint8_t>((sendTimeA >> 8) & 0xFF);
-
-    // 设置电阻B值（4字节）
-    uint32_t sendResistanceB = static_cast<uint32_t>(resistanceB * 1000);
-    command[9] = static_cast<uint8_t>(sendResistanceB & 0xFF);
-    command[10] = static_cast<uint8_t>((sendResistanceB >> 8) & 0xFF);
-    command[11] = static_cast<uint8_t>((sendResistanceB >> 16) & 0xFF);
-    command[12] = static_cast<uint8_t>((sendResistanceB >> 24) & 0xFF);
-
-    // 设置时间B值（2字节）
-    uint16_t sendTimeB = static_cast<uint16_t>(timeB * 10000);
-    command[13] = static_cast<uint8_t>(sendTimeB & 0xFF);
-    command[14] = static_cast<uint8_t>((sendTimeB >> 8) & 0xFF);
-
-    command[15] = mode;
-
-    command[CommandLength - 1] = calculateChecksum(command);
-    return command;
+    return createDynamicParamsCommand<ITPlusFields::Dynamic<ITPlusFields::ResistanceScale>>(0x38, resistanceA, timeA, resistanceB, timeB, mode);
 }
 
 QByteArray EleLoad_ITPlus::createGetDynamicResistanceParamsCommand()
@@ -512,7 +732,7 @@ QByteArray EleLoad_ITPlus::createGetDynamicResistanceParamsCommand()
 
 EleLoad_ITPlus::DynamicParams EleLoad_ITPlus::analyseDynamicResistanceParams(const QByteArray &data)
 {
-    return analyseDynamicParams(data, 1000.0f);
+    return analyseDynamicParams<ITPlusFields::Dynamic<ITPlusFields::ResistanceScale>>(data);
 }
 
 // 创建通用命令
@@ -531,105 +751,71 @@ QByteArray EleLoad_ITPlus::createCommand(uint8_t cmd, const QByteArray &data)
     return command;
 }
 
-// 值转换模板函数
-template<typename T>
-uint32_t EleLoad_ITPlus::valueToRaw(T value, float scale)
-{
-    return static_cast<uint32_t>(value * scale);
-}
-
-template<typename T>
-T EleLoad_ITPlus::rawToValue(const QByteArray &data, int offset, float scale)
+// 单个设定值命令
+template<typename Field>
+QByteArray EleLoad_ITPlus::createSetValueCommand(uint8_t cmd, float value)
 {
-    uint32_t raw = static_cast<uint8_t>(data[offset]) |
-                   (static_cast<uint8_t>(data[offset + 1]) << 8) |
-                   (static_cast<uint8_t>(data[offset + 2]) << 16) |
-                   (static_cast<uint8_t>(data[offset + 3]) << 24);
-    return static_cast<T>(raw) / scale;
+    QByteArray command = createCommand(cmd);
+    Field::encode(frameData(command), value);
+    command[CommandLength - 1] = calculateChecksum(command);
+    return command;
 }
 
-// 通用的设置值命令
-QByteArray EleLoad_ITPlus::createSetValueCommand(uint8_t cmd, float value, float scale)
+// 单个设定值解析
+template<typename Field>
+float EleLoad_ITPlus::analyseValue(const QByteArray &data)
 {
-    uint32_t rawValue = valueToRaw(value, scale);
-    QByteArray data(4, 0x00);
-    data[0] = static_cast<char>(rawValue & 0xFF);
-    data[1] = static_cast<char>((rawValue >> 8) & 0xFF);
-    data[2] = static_cast<char>((rawValue >> 16) & 0xFF);
-    data[3] = static_cast<char>((rawValue >> 24) & 0xFF);
-    return createCommand(cmd, data);
+    if (!validateResponse(data)) {
+        return -1.0f;
+    }
+    return float(Field::decode(frameData(data)));
 }
 
-// 通用的动态参数命令
+// 动态参数命令
+template<typename Fields>
 QByteArray EleLoad_ITPlus::createDynamicParamsCommand(uint8_t cmd, float valueA, float timeA,
-                                                     float valueB, float timeB, uint8_t mode,
-                                                     float scale)
-{
-    QByteArray data(13, 0x00);
-    
-    // 设置值A
-    uint32_t rawValueA = valueToRaw(valueA, scale);
-    data[0] = static_cast<char>(rawValueA & 0xFF);
-    data[1] = static_cast<char>((rawValueA >> 8) & 0xFF);
-    data[2] = static_cast<char>((rawValueA >> 16) & 0xFF);
-    data[3] = static_cast<char>((rawValueA >> 24) & 0xFF);
-    
-    // 设置时间A
-    uint16_t rawTimeA = valueToRaw(timeA, 10000.0f);
-    data[4] = static_cast<char>(rawTimeA & 0xFF);
-    data[5] = static_cast<char>((rawTimeA >> 8) & 0xFF);
-    
-    // 设置值B
-    uint32_t rawValueB = valueToRaw(valueB, scale);
-    data[6] = static_cast<char>(rawValueB & 0xFF);
-    data[7] = static_cast<char>((rawValueB >> 8) & 0xFF);
-    data[8] = static_cast<char>((rawValueB >> 16) & 0xFF);
-    data[9] = static_cast<char>((rawValueB >> 24) & 0xFF);
-    
-    // 设置时间B
-    uint16_t rawTimeB = valueToRaw(timeB, 10000.0f);
-    data[10] = static_cast<char>(rawTimeB & 0xFF);
-    data[11] = static_cast<char>((rawTimeB >> 8) & 0xFF);
-    
-    // 设置模式
-    data[12] = mode;
-    
-    return createCommand(cmd, data);
+                                                      float valueB, float timeB, uint8_t mode)
+{
+    QByteArray command = createCommand(cmd);
+    uint8_t *frame = frameData(command);
+    Fields::ValueA::encode(frame, valueA);
+    Fields::TimeA::encode(frame, timeA);
+    Fields::ValueB::encode(frame, valueB);
+    Fields::TimeB::encode(frame, timeB);
+    Fields::Mode::encode(frame, mode);
+    command[CommandLength - 1] = calculateChecksum(command);
+    return command;
 }
 
-// 通用的动态参数解析函数
-EleLoad_ITPlus::DynamicParams EleLoad_ITPlus::analyseDynamicParams(const QByteArray &data, float scale)
+// 动态参数解析
+template<typename Fields>
+EleLoad_ITPlus::DynamicParams EleLoad_ITPlus::analyseDynamicParams(const QByteArray &data)
 {
     DynamicParams params{};
     if (!validateResponse(data)) {
         return params;
     }
 
-    // 解析值A
-    params.valueA = rawToValue<float>(data, 3, scale);
-    
-    // 解析时间A
-    params.timeA = rawToValue<float>(data, 7, 10000.0f);
-    
-    // 解析值B
-    params.valueB = rawToValue<float>(data, 9, scale);
-    
-    // 解析时间B
-    params.timeB = rawToValue<float>(data, 13, 10000.0f);
-    
-    // 解析模式
-    params.mode = data[15];
-
+    const uint8_t *frame = frameData(data);
+    params.valueA = float(Fields::ValueA::decode(frame));
+    params.timeA = float(Fields::TimeA::decode(frame));
+    params.valueB = float(Fields::ValueB::decode(frame));
+    params.timeB = float(Fields::TimeB::decode(frame));
+    params.mode = uint8_t(Fields::Mode::decodeRaw(frame));
     return params;
 }
 
-// 通用的值解析函数
-float EleLoad_ITPlus::analyseValue(const QByteArray &data, float scale)
+// LIST步骤命令
+template<typename Fields>
+QByteArray EleLoad_ITPlus::createListStepCommand(uint8_t cmd, uint16_t step, const ListStep &value)
 {
-    if (!validateResponse(data)) {
-        return -1.0f;
-    }
-    return rawToValue<float>(data, 3, scale);
+    QByteArray command = createCommand(cmd);
+    uint8_t *frame = frameData(command);
+    Fields::Index::encodeRaw(frame, step);
+    Fields::Value::encode(frame, value.value);
+    Fields::Dwell::encode(frame, value.dwellMs);
+    command[CommandLength - 1] = calculateChecksum(command);
+    return command;
 }
 
 // 获取负载FIXED模式
@@ -650,15 +836,7 @@ uint8_t EleLoad_ITPlus::analyseLoadMode(const QByteArray &data)
 // 解析定功率值
 float EleLoad_ITPlus::analyseConstantPower(const QByteArray &data)
 {
-    if (!validateResponse(data)) {
-        return 0.0f;
-    }
-    
-    uint32_t recvPower = (static_cast<uint8_t>(data[3]) |
-                         static_cast<uint8_t>(data[4]) << 8 |
-                         static_cast<uint8_t>(data[5]) << 16 |
-                         static_cast<uint8_t>(data[6]) << 24);
-    return recvPower / 1000.0f;  // 转换为W
+    return analyseValue<ITPlusFields::Power>(data);
 }
 
 
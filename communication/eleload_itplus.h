@@ -2,7 +2,9 @@
 #define ELELOAD_ITPLUS_H
 
 #include "protocol.h"
+#include "util/devicestate.h"
 #include <QObject>
+#include <QVector>
 #include <chrono>
 
 class EleLoad_ITPlus : public Protocol
@@ -11,6 +13,9 @@ class EleLoad_ITPlus : public Protocol
 public:
     explicit EleLoad_ITPlus(uint8_t loadAddress = 0xFF, QObject *parent = nullptr);
 
+    static const uint8_t SyncHeader = 0xAA;
+    static const int CommandLength = 26;
+
     // 工作模式
     enum class Mode {
         CC,     // 恒流模式
@@ -18,6 +23,7 @@ public:
         CR,     // 恒阻模式
         CW      // 恒功率模式
     };
+    Q_ENUM(Mode)
 
     // 量程
     enum class Range {
@@ -33,9 +39,9 @@ public:
     // 动态参数结构体
     struct DynamicParams {
         float valueA;
-        float timeA;
+        float timeA;        // ms，报文单位0.1ms
         float valueB;
-        float timeB;
+        float timeB;        // ms
         uint8_t mode;
     };
 
@@ -62,7 +68,7 @@ public:
         uint8_t workMode;
         uint8_t listStep;
         uint16_t listCycleIndex;
-        std::chrono::system_clock::time_point time;
+        std::chrono::steady_clock::time_point time;     // 接收时刻（单调时钟）
     };
 
     // 产品信息结构体
@@ -156,37 +162,93 @@ public:
     QByteArray createAnalogKeyboardPress(uint8_t keyboard);
     QByteArray createNewTriggerSignal();
 
+    // LIST（序列）模式：步骤保存在仪器中，由仪器按自身时钟执行（驻留时间分辨率0.1ms）
+    struct ListStep {
+        float value;        // 设定值（A / V / W / Ω，由LIST模式决定）
+        float dwellMs;      // 驻留时间，0.1 ~ 6553.5 ms
+    };
+    static const int MaxListSteps = 84;     // 存储区不分区时单个LIST文件的最大步数
+
+    QByteArray createSetListModeCommand(Mode mode);                     // 0x3A
+    QByteArray createGetListModeCommand();                              // 0x3B
+    QByteArray createSetListRepeatCommand(bool repeat);                 // 0x3C 单次/连续
+    QByteArray createGetListRepeatCommand();                            // 0x3D
+    QByteArray createSetListStepCountCommand(uint16_t count);           // 0x3E
+    QByteArray createGetListStepCountCommand();                         // 0x3F
+    QByteArray createSetListStepCommand(Mode mode, uint16_t step, const ListStep &value);  // 0x40/0x42/0x44/0x46
+    QByteArray createGetListStepCommand(Mode mode, uint16_t step);      // 0x41/0x43/0x45/0x47
+    QByteArray createSetListNameCommand(const QString &name);           // 0x48（最多10个ASCII字符）
+    QByteArray createGetListNameCommand();                              // 0x49
+    QByteArray createSetListPartitionCommand(uint8_t partition);        // 0x4A 存储区分区数 1/2/4/8
+    QByteArray createGetListPartitionCommand();                         // 0x4B
+    QByteArray createSaveListCommand(uint8_t area);                     // 0x4C
+    QByteArray createRecallListCommand(uint8_t area);                   // 0x4D
+    QByteArray createSetTriggerSourceCommand(uint8_t source);           // 0x58 0面板 1外部 2总线
+    QByteArray createGetTriggerSourceCommand();                         // 0x59
+
+    // 生成上传整个LIST程序的命令序列（逐条发送，每条等待设置响应）
+    // repeatCount: 0 连续循环，1 执行一次，N>1 时把步骤展开N遍（仪器只支持单次/连续）
+    // 步数超出 MaxListSteps 或参数越界时返回空列表
+    QVector<QByteArray> createListProgram(Mode mode, const QVector<ListStep> &steps,
+                                          int repeatCount, uint8_t area = 1);
+
     // 辅助函数
     HandleStateRegister parseHandleState(uint8_t handleStateRegister);
     uint8_t calculateChecksum(const QByteArray &data);
     bool validateResponse(const QByteArray &data);
+    // 原始帧校验（不构造QByteArray），供 FixedFrameDecoder 使用，规则与 validateResponse 相同
+    static uint8_t checksum(const uint8_t *frame, int size);
+    static bool validateFrame(const uint8_t *frame, int size);
+
+    // 响应分发：按功能码查表解码，并发出对应的类型化信号
+    // receivedAt 为数据到达串口的时刻，写入 InputParams::time；校验失败或功能码无需处理时返回false
+    bool dispatchResponse(const QByteArray &frame,
+                          std::chrono::steady_clock::time_point receivedAt = std::chrono::steady_clock::now());
+    std::chrono::steady_clock::time_point receivedAt() const { return m_receivedAt; }   // 当前分发的响应的接收时刻
+
+    // 负载状态快照：dispatchResponse 解码后更新，任意线程可读
+    const DeviceState<LoadState> &state() const { return m_state; }
+    DeviceState<LoadState> &state() { return m_state; }
+
+signals:
+    void setResponseReceived(uint8_t status);           // 0x12 设置指令响应（0x80成功）
+    void maxVoltageReceived(float voltage);             // 0x23
+    void maxCurrentReceived(float current);             // 0x25
+    void maxPowerReceived(float power);                 // 0x27
+    void loadModeReceived(uint8_t mode);                // 0x29 负载模式（0 CC, 1 CV, 2 CW, 3 CR）
+    void constantValueReceived(EleLoad_ITPlus::Mode mode, float value);     // 0x2B/0x2D/0x2F/0x31
+    void dynamicParamsReceived(EleLoad_ITPlus::Mode mode,
+                               const EleLoad_ITPlus::DynamicParams &params); // 0x33/0x35/0x37/0x39
+    void workModelReceived(uint8_t model);              // 0x5E 工作模式
+    void inputParamsReceived(const EleLoad_ITPlus::InputParams &params);    // 0x5F
+    void productMessageReceived(const EleLoad_ITPlus::ProductMessage &message); // 0x6A
 
 private:
     uint8_t m_loadAddress;
-    static const uint8_t SyncHeader = 0xAA;
-    static const int CommandLength = 26;
+    std::chrono::steady_clock::time_point m_receivedAt;
+    DeviceState<LoadState> m_state;
 
     // 辅助函数
     QByteArray createCommand(uint8_t cmd, const QByteArray &data = QByteArray());
     
-    // 通用的数值转换函数
-    template<typename T>
-    static uint32_t valueToRaw(T value, float scale);
-    
-    template<typename T>
-    static T rawToValue(const QByteArray &data, int offset, float scale);
-    
-    // 通用的动态参数命令创建函数
+    // 按 ITPlusFields 中的字段描述打包/解析（字段类型见 fieldcodec.h）
+    template<typename Field>
+    QByteArray createSetValueCommand(uint8_t cmd, float value);
+    template<typename Field>
+    float analyseValue(const QByteArray &data);
+
+    template<typename Fields>
     QByteArray createDynamicParamsCommand(uint8_t cmd, float valueA, float timeA,
-                                        float valueB, float timeB, uint8_t mode,
-                                        float scale);
-    
-    // 通用的动态参数解析函数
-    DynamicParams analyseDynamicParams(const QByteArray &data, float scale);
-    
-    // 通用的设置/获取值命令
-    QByteArray createSetValueCommand(uint8_t cmd, float value, float scale);
-    float analyseValue(const QByteArray &data, float scale);
+                                          float valueB, float timeB, uint8_t mode);
+    template<typename Fields>
+    DynamicParams analyseDynamicParams(const QByteArray &data);
+
+    template<typename Fields>
+    QByteArray createListStepCommand(uint8_t cmd, uint16_t step, const ListStep &value);
 };
 
+Q_DECLARE_METATYPE(EleLoad_ITPlus::DynamicParams)
+Q_DECLARE_METATYPE(EleLoad_ITPlus::InputParams)
+Q_DECLARE_METATYPE(EleLoad_ITPlus::ProductMessage)
+
 #endif // ELELOAD_ITPLUS_H
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef FIELDCODEC_H
+#define FIELDCODEC_H
+
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * 定长报文中的小端序定标字段
+ *  每个字段在编译期描述一次：偏移、宽度（1/2/4字节）、倍率、是否有符号
+ *    报文值 = 物理值 × Scale，编码时四舍五入并限制在字段可表示的范围内（不会因负数或溢出回绕）
+ *  encode/decode 直接读写帧缓冲区，全部为 constexpr，可在 static_assert 中做往返校验
+ *
+ *  用法：
+ *    using Voltage = ScaledField<3, 4, 1000>;     // 第3字节起4字节，1mV
+ *    Voltage::encode(frame, 12.5);
+ *    double v = Voltage::decode(frame);
+ */
+template<int Offset, int Width, long Scale = 1, bool Signed = false>
+struct ScaledField
+{
+    static_assert(Offset >= 0, "Offset must not be negative");
+    static_assert(Width == 1 || Width == 2 || Width == 4, "Width must be 1, 2 or 4 bytes");
+    static_assert(Scale > 0, "Scale must be positive");
+
+    static constexpr int offset = Offset;
+    static constexpr int width = Width;
+    static constexpr long scale = Scale;
+    static constexpr int end = Offset + Width;      // 下一个字段的偏移
+
+    // 字段可表示的原始值范围
+    static constexpr std::int64_t rawMin = Signed ? -(std::int64_t(1) << (8 * Width - 1)) : 0;
+    static constexpr std::int64_t rawMax = Signed ? (std::int64_t(1) << (8 * Width - 1)) - 1
+                                                  : (std::int64_t(1) << (8 * Width)) - 1;
+
+    // 物理值 -> 原始值（四舍五入，饱和）
+    static constexpr std::int64_t toRaw(double value)
+    {
+        const double scaled = value * double(Scale);
+        if (!(scaled == scaled)) {          // NaN
+            return 0;
+        }
+        if (scaled <= double(rawMin)) {
+            return rawMin;
+        }
+        if (scaled >= double(rawMax)) {
+            return rawMax;
+        }
+        return scaled < 0 ? std::int64_t(scaled - 0.5) : std::int64_t(scaled + 0.5);
+    }
+
+    static constexpr double fromRaw(std::int64_t raw)
+    {
+        return double(raw) / double(Scale);
+    }
+
+    static constexpr void encodeRaw(std::uint8_t *frame, std::int64_t raw)
+    {
+        const std::uint32_t bits = std::uint32_t(raw);
+        for (int i = 0; i < Width; ++i) {
+            frame[Offset + i] = std::uint8_t(bits >> (8 * i));
+        }
+    }
+
+    static constexpr std::int64_t decodeRaw(const std::uint8_t *frame)
+    {
+        std::uint32_t bits = 0;
+        for (int i = 0; i < Width; ++i) {
+            bits |= std::uint32_t(frame[Offset + i]) << (8 * i);
+        }
+        if (Signed && (bits & (std::uint32_t(1) << (8 * Width - 1)))) {
+            return std::int64_t(bits) - (std::int64_t(1) << (8 * Width));
+        }
+        return std::int64_t(bits);
+    }
+
+    static constexpr void encode(std::uint8_t *frame, double value)
+    {
+        encodeRaw(frame, toRaw(value));
+    }
+
+    static constexpr double decode(const std::uint8_t *frame)
+    {
+        return fromRaw(decodeRaw(frame));
+    }
+};
+
+#endif // FIELDCODEC_H
@@ -0,0 +1,155 @@
+#ifndef FIXEDFRAMEDECODER_H
+#define FIXEDFRAMEDECODER_H
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * 定长报文流式解码器
+ *  接收数据写入环形缓冲区，不做 QByteArray 的 remove/left 拷贝
+ *  decode() 依次取出以同步头开始、校验通过的完整帧，以指针（视图）形式交给回调
+ *    帧在缓冲区内连续时直接指向缓冲区，跨越缓冲区末尾时拼接到内部的一帧临时区
+ *    帧指针只在回调期间有效，回调中不能调用 append()
+ *  同步头错误时跳到下一个同步头；同步头正确但校验失败时只丢弃一个字节重新同步，
+ *  避免把真正的帧头当作坏帧的一部分一起丢掉
+ *  缓冲区满时丢弃最旧的数据
+ *
+ *  FrameSize  帧长度
+ *  Capacity   环形缓冲区大小，必须是2的幂且不小于两帧
+ */
+template<int FrameSize, int Capacity = 4096>
+class FixedFrameDecoder
+{
+    static_assert(FrameSize > 0, "FrameSize must be positive");
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(Capacity >= 2 * FrameSize, "Capacity must hold at least two frames");
+
+public:
+    // 校验函数：frame 指向完整一帧，size 为帧长度
+    using Validator = bool (*)(const std::uint8_t *frame, int size);
+
+    struct Statistics {
+        std::uint64_t frames = 0;          // 校验通过的帧
+        std::uint64_t badFrames = 0;       // 同步头正确但校验失败的次数
+        std::uint64_t skippedBytes = 0;    // 重新同步丢弃的字节
+        std::uint64_t overflowBytes = 0;   // 缓冲区满丢弃的字节
+    };
+
+    FixedFrameDecoder(std::uint8_t syncByte, Validator validator)
+        : m_sync(syncByte)
+        , m_validator(validator)
+    {
+    }
+
+    FixedFrameDecoder(const FixedFrameDecoder &) = delete;
+    FixedFrameDecoder &operator=(const FixedFrameDecoder &) = delete;
+
+    // 追加接收数据
+    void append(const char *data, int size)
+    {
+        if (size <= 0) {
+            return;
+        }
+        if (size > Capacity) {
+            m_stats.overflowBytes += std::uint64_t(size - Capacity);
+            data += size - Capacity;
+            size = Capacity;
+        }
+        const int overflow = available() + size - Capacity;
+        if (overflow > 0) {
+            m_read += std::uint32_t(overflow);
+            m_stats.overflowBytes += std::uint64_t(overflow);
+        }
+
+        const std::uint32_t offset = m_write & Mask;
+        const int first = size < int(Capacity - offset) ? size : int(Capacity - offset);
+        std::memcpy(m_ring + offset, data, size_t(first));
+        std::memcpy(m_ring, data + first, size_t(size - first));
+        m_write += std::uint32_t(size);
+    }
+
+    // 取出所有完整帧，对每一帧调用 handler(const std::uint8_t *frame)，返回帧数
+    template<typename Handler>
+    int decode(Handler &&handler)
+    {
+        int count = 0;
+        while (available() >= FrameSize) {
+            const std::uint32_t offset = m_read & Mask;
+            if (m_ring[offset] != m_sync) {
+                skipToSync();
+                continue;
+            }
+
+            const std::uint8_t *frame = view(offset);
+            if (!m_validator(frame, FrameSize)) {
+                ++m_stats.badFrames;
+                ++m_stats.skippedBytes;
+                ++m_read;
+                continue;
+            }
+
+            // 先移动读位置，回调中 clear() 不会破坏读写位置；帧数据在下一次 append() 前不会被覆盖
+            m_read += FrameSize;
+            ++m_stats.frames;
+            ++count;
+            handler(frame);
+        }
+        return count;
+    }
+
+    int available() const { return int(m_write - m_read); }
+    const Statistics &statistics() const { return m_stats; }
+
+    void clear()
+    {
+        m_read = m_write = 0;
+    }
+
+private:
+    static constexpr std::uint32_t Mask = Capacity - 1;
+
+    // 返回从 offset 开始的一帧的连续视图
+    const std::uint8_t *view(std::uint32_t offset)
+    {
+        if (offset + FrameSize <= std::uint32_t(Capacity)) {
+            return m_ring + offset;
+        }
+        const int first = int(Capacity - offset);
+        std::memcpy(m_scratch, m_ring + offset, size_t(first));
+        std::memcpy(m_scratch + first, m_ring, size_t(FrameSize - first));
+        return m_scratch;
+    }
+
+    // 丢弃数据直到下一个同步头（找不到则全部丢弃）
+    void skipToSync()
+    {
+        int remaining = available();
+        int skipped = 0;
+        while (remaining > 0) {
+            const std::uint32_t offset = m_read & Mask;
+            const int span = remaining < int(Capacity - offset) ? remaining : int(Capacity - offset);
+            const void *hit = std::memchr(m_ring + offset, m_sync, size_t(span));
+            if (hit) {
+                const int n = int(static_cast<const std::uint8_t *>(hit) - (m_ring + offset));
+                m_read += std::uint32_t(n);
+                skipped += n;
+                break;
+            }
+            m_read += std::uint32_t(span);
+            skipped += span;
+            remaining -= span;
+        }
+        m_stats.skippedBytes += std::uint64_t(skipped);
+    }
+
+    const std::uint8_t m_sync;
+    const Validator m_validator;
+    // 读写位置单调递增，取低位作为缓冲区下标，回绕由无符号溢出自然处理
+    std::uint32_t m_read = 0;
+    std::uint32_t m_write = 0;
+    std::uint8_t m_ring[Capacity];
+    std::uint8_t m_scratch[FrameSize];
+    Statistics m_stats;
+};
+
+#endif // FIXEDFRAMEDECODER_H
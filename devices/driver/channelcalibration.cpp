@@ -0,0 +1,311 @@
+#include "channelcalibration.h"
+#include "util/errorhandler.h"
+#include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const QString CALIBRATION_PATH = "calibration";
+}
+
+bool CalibrationCurve::build(QVector<QPointF> points)
+{
+    m_points.clear();
+    m_table.clear();
+    m_maxPhysical = 0;
+    m_gridScale = 0;
+
+    // 按强度排序，同一强度的多个读数取平均
+    std::sort(points.begin(), points.end(), [](const QPointF &a, const QPointF &b) {
+        return a.x() < b.x();
+    });
+    QVector<QPointF> merged;
+    merged.reserve(points.size() + 1);
+    for (int i = 0; i < points.size();) {
+        const double x = points.at(i).x();
+        double sum = 0;
+        int n = 0;
+        for (; i < points.size() && points.at(i).x() == x; ++i) {
+            if (std::isfinite(points.at(i).y())) {
+                sum += points.at(i).y();
+                ++n;
+            }
+        }
+        if (n > 0 && x >= 0 && x <= 0xFFFF) {
+            merged.append(QPointF(x, qMax(0.0, sum / n)));
+        }
+    }
+    if (merged.size() < 2) {
+        return false;
+    }
+    if (merged.first().x() > 0) {
+        merged.prepend(QPointF(0, 0));
+    }
+
+    // 物理量单调不减
+    for (int i = 1; i < merged.size(); ++i) {
+        if (merged.at(i).y() < merged.at(i - 1).y()) {
+            merged[i].setY(merged.at(i - 1).y());
+        }
+    }
+    const double maxPhysical = merged.last().y();
+    if (!(maxPhysical > 0)) {
+        return false;
+    }
+
+    // 在物理量均匀网格上求反函数，网格和标定点都单调，双指针一次扫过
+    QVector<float> table(GridSize);
+    int seg = 0;
+    for (int i = 0; i < GridSize; ++i) {
+        const double y = maxPhysical * i / (GridSize - 1);
+        while (seg + 2 < merged.size() && merged.at(seg + 1).y() < y) {
+            ++seg;
+        }
+        const QPointF &p0 = merged.at(seg);
+        const QPointF &p1 = merged.at(seg + 1);
+        double x;
+        if (y <= p0.y() || p1.y() <= p0.y()) {
+            x = p0.x();     // 平台段取能达到该值的最小强度
+        } else if (y >= p1.y()) {
+            x = p1.x();
+        } else {
+            x = p0.x() + (p1.x() - p0.x()) * (y - p0.y()) / (p1.y() - p0.y());
+        }
+        table[i] = float(x);
+    }
+
+    m_points = merged;
+    m_table = table;
+    m_maxPhysical = maxPhysical;
+    m_gridScale = (GridSize - 1) / maxPhysical;
+    return true;
+}
+
+double CalibrationCurve::toPhysical(int value) const
+{
+    if (m_points.isEmpty()) {
+        return 0;
+    }
+    if (value <= m_points.first().x()) {
+        return m_points.first().y();
+    }
+    if (value >= m_points.last().x()) {
+        return m_points.last().y();
+    }
+    auto it = std::lower_bound(m_points.constBegin(), m_points.constEnd(), double(value),
+                               [](const QPointF &p, double x) { return p.x() < x; });
+    const QPointF &p1 = *it;
+    const QPointF &p0 = *(it - 1);
+    return p0.y() + (p1.y() - p0.y()) * (value - p0.x()) / (p1.x() - p0.x());
+}
+
+QJsonObject CalibrationCurve::toJson() const
+{
+    QJsonArray points;
+    for (const QPointF &p : m_points) {
+        points.append(QJsonArray{p.x(), p.y()});
+    }
+    QJsonObject json;
+    json["points"] = points;
+    return json;
+}
+
+// 文件中只保存标定点，网格在加载时重新生成
+CalibrationCurve CalibrationCurve::fromJson(const QJsonObject &json)
+{
+    QVector<QPointF> points;
+    const QJsonArray array = json["points"].toArray();
+    points.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        const QJsonArray pair = value.toArray();
+        if (pair.size() == 2) {
+            points.append(QPointF(pair.at(0).toDouble(), pair.at(1).toDouble()));
+        }
+    }
+    CalibrationCurve curve;
+    curve.build(points);
+    return curve;
+}
+
+QString ChannelCalibration::unitName(Unit unit)
+{
+    switch (unit) {
+    case Current:
+        return "电流(mA)";
+    case Illuminance:
+        return "照度(lx)";
+    default:
+        return "通道值";
+    }
+}
+
+QString ChannelCalibration::unitKey(Unit unit)
+{
+    switch (unit) {
+    case Current:
+        return "current_mA";
+    case Illuminance:
+        return "illuminance_lx";
+    default:
+        return "register";
+    }
+}
+
+QString ChannelCalibration::unitSuffix(Unit unit)
+{
+    switch (unit) {
+    case Current:
+        return " mA";
+    case Illuminance:
+        return " lx";
+    default:
+        return QString();
+    }
+}
+
+QString ChannelCalibration::driverId(int channelCount, quint8 address)
+{
+    return QString("driver%1ch_%2").arg(channelCount)
+        .arg(QString("%1").arg(address, 2, 16, QChar('0')).toUpper());
+}
+
+void ChannelCalibration::reset(const QString &driverId, int channelCount)
+{
+    m_driverId = driverId;
+    m_channelCount = channelCount;
+    for (int u = 0; u < UnitCount; ++u) {
+        m_curves[u] = QVector<CalibrationCurve>(u == Register ? 0 : channelCount);
+    }
+}
+
+void ChannelCalibration::setCurve(Unit unit, int channel, const CalibrationCurve &curve)
+{
+    if (unit <= Register || unit >= UnitCount || channel < 1 || channel > m_channelCount) {
+        return;
+    }
+    m_curves[unit][channel - 1] = curve;
+}
+
+const CalibrationCurve *ChannelCalibration::curve(Unit unit, int channel) const
+{
+    if (unit <= Register || unit >= UnitCount || channel < 1 || channel > m_curves[unit].size()) {
+        return nullptr;
+    }
+    const CalibrationCurve &c = m_curves[unit].at(channel - 1);
+    return c.isValid() ? &c : nullptr;
+}
+
+bool ChannelCalibration::hasUnit(Unit unit) const
+{
+    return maxPhysical(unit) > 0;
+}
+
+double ChannelCalibration::maxPhysical(Unit unit) const
+{
+    if (unit <= Register || unit >= UnitCount) {
+        return 0;
+    }
+    double result = 0;
+    for (const CalibrationCurve &c : m_curves[unit]) {
+        if (c.isValid()) {
+            result = qMax(result, c.maxPhysical());
+        }
+    }
+    return result;
+}
+
+quint16 ChannelCalibration::toRegister(Unit unit, int channel, double physical) const
+{
+    const CalibrationCurve *c = curve(unit, channel);
+    if (!c) {
+        return quint16(qBound(0L, std::lround(physical), 0xFFFFL));
+    }
+    return c->toRegister(physical);
+}
+
+double ChannelCalibration::toPhysical(Unit unit, int channel, int value) const
+{
+    const CalibrationCurve *c = curve(unit, channel);
+    return c ? c->toPhysical(value) : double(value);
+}
+
+QString ChannelCalibration::filePath() const
+{
+    return QApplication::applicationDirPath() + "/" + CALIBRATION_PATH + "/" + m_driverId + ".json";
+}
+
+bool ChannelCalibration::load()
+{
+    QFile file(filePath());
+    if (!file.exists()) {
+        return false;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_WARNING(QString("无法读取标定文件: %1").arg(file.fileName()));
+        return false;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+    if (!doc.isObject()) {
+        LOG_WARNING(QString("标定文件格式错误: %1").arg(file.fileName()));
+        return false;
+    }
+
+    const QJsonObject units = doc.object()["units"].toObject();
+    int loaded = 0;
+    for (int u = Register + 1; u < UnitCount; ++u) {
+        const QJsonObject channels = units[unitKey(Unit(u))].toObject();
+        for (auto it = channels.constBegin(); it != channels.constEnd(); ++it) {
+            const int channel = it.key().toInt();
+            const CalibrationCurve c = CalibrationCurve::fromJson(it.value().toObject());
+            if (c.isValid() && channel >= 1 && channel <= m_channelCount) {
+                m_curves[u][channel - 1] = c;
+                ++loaded;
+            }
+        }
+    }
+    LOG_INFO(QString("已加载标定 %1：%2 条曲线").arg(m_driverId).arg(loaded));
+    return loaded > 0;
+}
+
+bool ChannelCalibration::save() const
+{
+    QDir dir(QApplication::applicationDirPath() + "/" + CALIBRATION_PATH);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        LOG_ERROR(QString("无法创建标定目录: %1").arg(dir.path()));
+        return false;
+    }
+
+    QJsonObject units;
+    for (int u = Register + 1; u < UnitCount; ++u) {
+        QJsonObject channels;
+        for (int c = 0; c < m_curves[u].size(); ++c) {
+            if (m_curves[u].at(c).isValid()) {
+                channels[QString::number(c + 1)] = m_curves[u].at(c).toJson();
+            }
+        }
+        if (!channels.isEmpty()) {
+            units[unitKey(Unit(u))] = channels;
+        }
+    }
+    QJsonObject root;
+    root["driver"] = m_driverId;
+    root["channels"] = m_channelCount;
+    root["updated"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["units"] = units;
+
+    QFile file(filePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_ERROR(QString("无法写入标定文件: %1").arg(file.fileName()));
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    file.close();
+    LOG_INFO(QString("标定已保存: %1").arg(file.fileName()));
+    return true;
+}
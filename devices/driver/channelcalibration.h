@@ -0,0 +1,98 @@
+#ifndef CHANNELCALIBRATION_H
+#define CHANNELCALIBRATION_H
+
+#include <QJsonObject>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+/**
+ * 单通道标定曲线（物理量 -> 驱动强度）
+    由 (强度, 物理量) 点生成：点按强度排序，物理量强制单调不减（测量噪声造成的回落取前一点的值），
+      最小强度大于0时补一个原点（强度0视为关断）
+    反函数预先插值到物理量的均匀网格上（GridSize 个节点，覆盖 0 ~ 最大物理量），
+      toRegister 只做一次乘法、一次取整和一次线性插值，与标定点数无关，可以放在发送路径上
+    物理量超出标定范围时取最大标定强度，不外推
+    toPhysical（界面显示用）在标定点上二分查找
+ */
+class CalibrationCurve
+{
+public:
+    static const int GridSize = 1024;
+
+    bool build(QVector<QPointF> points);    // x：驱动强度，y：物理量；有效点不足两个或物理量全为0时返回false
+    bool isValid() const { return m_table.size() == GridSize; }
+
+    double maxPhysical() const { return m_maxPhysical; }
+    const QVector<QPointF> &points() const { return m_points; }
+
+    inline quint16 toRegister(double physical) const;
+    double toPhysical(int value) const;
+
+    QJsonObject toJson() const;
+    static CalibrationCurve fromJson(const QJsonObject &json);
+
+private:
+    QVector<QPointF> m_points;      // 排序、单调化之后的标定点
+    QVector<float> m_table;         // 第 i 个节点：物理量 i / m_gridScale 对应的强度
+    double m_maxPhysical = 0;
+    double m_gridScale = 0;         // (GridSize - 1) / m_maxPhysical
+};
+
+inline quint16 CalibrationCurve::toRegister(double physical) const
+{
+    if (m_table.isEmpty()) {
+        return 0;
+    }
+    const double pos = qBound(0.0, physical * m_gridScale, double(GridSize - 1));
+    const int i = qMin(int(pos), GridSize - 2);
+    const float low = m_table.at(i);
+    const float high = m_table.at(i + 1);
+    return quint16(low + (high - low) * float(pos - i) + 0.5f);
+}
+
+/**
+ * 驱动器的通道标定集
+    每个物理单位（电流、照度）每个通道一条曲线，由特性测试结果生成
+    按驱动器（通道数 + 从机地址）分文件保存在程序目录的 calibration/ 下
+    Register 单位表示直接使用驱动强度，不查表
+ */
+class ChannelCalibration
+{
+public:
+    enum Unit {
+        Register = 0,
+        Current,            // mA
+        Illuminance,        // lx
+        UnitCount
+    };
+
+    static QString unitName(Unit unit);         // 界面显示
+    static QString unitKey(Unit unit);          // 文件中的键
+    static QString unitSuffix(Unit unit);       // 数值框后缀，Register 为空
+    static QString driverId(int channelCount, quint8 address);
+
+    void reset(const QString &driverId, int channelCount);     // 清空并切换到另一台驱动器
+    QString driverId() const { return m_driverId; }
+
+    void setCurve(Unit unit, int channel, const CalibrationCurve &curve);   // 通道号从1开始
+    const CalibrationCurve *curve(Unit unit, int channel) const;            // 无标定时返回nullptr
+    bool hasUnit(Unit unit) const;
+    double maxPhysical(Unit unit) const;        // 各通道最大标定物理量中的最大值
+
+    // 无标定的通道按强度原样输出
+    quint16 toRegister(Unit unit, int channel, double physical) const;
+    double toPhysical(Unit unit, int channel, int value) const;
+
+    bool load();
+    bool save() const;
+
+private:
+    QString filePath() const;
+
+    QString m_driverId;
+    int m_channelCount = 0;
+    QVector<CalibrationCurve> m_curves[UnitCount];     // 下标为通道号-1，Register 不使用
+};
+
+#endif // CHANNELCALIBRATION_H
@@ -1,6 +1,7 @@
 #include "driverwidget.h"
 #include <QHeaderView>
 #include <QSerialPortInfo>
+#include <cmath>
 
 DriverWidget::DriverWidget(int channelCount, QWidget *parent)
     : QWidget(parent)
@@ -11,20 +12,25 @@ DriverWidget::DriverWidget(int channelCount, QWidget *parent)
     , m_dataChanged(false)
     , m_sendAddress(0x00)          // 默认发送地址
     , m_receiveAddress(0xFF)       // 默认接收地址
-    , m_scanTimer(new QTimer(this))
     , m_connectionTimeoutTimer(new QTimer(this))
     , m_connectionPending(false)
 {
     m_dataSendTimer->setSingleShot(true);
     m_dataSendTimer->setInterval(50); // 50ms防抖
     
+    m_sweep = new SweepEngine(m_serial, m_driverGeneral, this);
+    m_reconnect = new ReconnectSupervisor(m_serial, this);
+
     m_connectionTimeoutTimer->setSingleShot(true);
     m_connectionTimeoutTimer->setInterval(3000); // 3秒超时
     
     connect(m_connectionTimeoutTimer, &QTimer::timeout, this, &DriverWidget::handleConnectionTimeout);
     
+    m_registerValues.fill(0, m_channelCount);
+
     initUI();
     setupConnections();
+    loadCalibration();
 }
 
 void DriverWidget::initUI()
@@ -222,7 +228,8 @@ void DriverWidget::initUI()
     // 控制目标
     auto *targetLayout = new QHBoxLayout();
     m_sliderTargetCombo = new QComboBox(this);
-    m_sliderTargetCombo->addItem("通道值");
+    m_sliderTargetCombo->addItem(ChannelCalibration::unitName(ChannelCalibration::Register),
+                                 int(ChannelCalibration::Register));
     targetLayout->addWidget(new QLabel("控制目标:"));
     targetLayout->addWidget(m_sliderTargetCombo);
     sliderLayout->addLayout(targetLayout);
@@ -284,8 +291,9 @@ void DriverWidget::setupConnections()
         m_driverGeneral = new DriverGeneral(this);
     }
     
-    // 连接扫描定时器
-    connect(m_scanTimer, &QTimer::timeout, this, &DriverWidget::onScanTimeout);
+    // 连接扫描引擎
+    connect(m_sweep, &SweepEngine::stepSent, this, &DriverWidget::onSweepStep);
+    connect(m_sweep, &SweepEngine::finished, this, &DriverWidget::onSweepFinished);
     
     // 连接滑条信号
     connect(m_masterSlider, &QSlider::valueChanged,
@@ -304,6 +312,9 @@ void DriverWidget::setupConnections()
                 this, [this, i](int value) { onChannelValueChanged(i, value); });
     }
 
+    connect(m_sliderTargetCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &DriverWidget::onControlUnitChanged);
+
     connect(m_stopScanBtn, &QPushButton::clicked, this, &DriverWidget::stopScan);
 
     // LED开关按钮 - 更新使用协议命令
@@ -334,6 +345,26 @@ void DriverWidget::setupConnections()
     connect(m_serial, &SerialUtil::portDisconnected, this, [this]() {
         emit serialDisconnected();
     });
+
+    // 意外断开后自动重连：重新发送初始化命令握手，成功后重放 LED 开关和当前强度
+    connect(m_reconnect, &ReconnectSupervisor::connectionLost, this, [this]() {
+        m_dataSendTimer->stop();
+        emit serialRecovering();
+    });
+    connect(m_reconnect, &ReconnectSupervisor::reopened, this, [this]() {
+        m_connectionPending = true;
+        m_receiveAddress = 0xFF;
+        sendInitCommand();
+    });
+    connect(m_reconnect, &ReconnectSupervisor::recovered, this, [this](qint64 downtimeMs) {
+        sendWriteLEDStatusCommand(m_ledStatus);
+        sendData();
+        m_dataChanged = false;
+        emit serialRecovered(downtimeMs, m_reconnect->statistics().recoveries);
+    });
+    connect(m_reconnect, &ReconnectSupervisor::gaveUp, this, [this]() {
+        m_connectionPending = false;
+    });
     
     // 数据发送定时器
     connect(m_dataSendTimer, &QTimer::timeout, this, &DriverWidget::onDataSendTimerTimeout);
@@ -355,6 +386,7 @@ void DriverWidget::setupConnections()
             
             // 更新当前接收地址
             m_receiveAddress = newAddress;
+            loadCalibration();
         }
         
         emit settingsChanged();
@@ -381,9 +413,7 @@ void DriverWidget::setupConnections()
 // 析构函数实现
 DriverWidget::~DriverWidget()
 {
-    if (m_scanTimer->isActive()) {
-        m_scanTimer->stop();
-    }
+    m_sweep->stop();
     
     if (m_dataSendTimer->isActive()) {
         m_dataSendTimer->stop();
@@ -395,8 +425,12 @@ DriverWidget::~DriverWidget()
 // 修改总控滑条值改变函数
 void DriverWidget::onMasterValueChanged(int value)
 {
-    // 更新所有单控滑条
+    // 更新所有单控滑条，控制目标为物理量时逐通道查表换算为驱动强度
+    const ChannelCalibration::Unit unit = controlUnit();
     for (int i = 0; i < m_channelSliders.size(); ++i) {
+        m_registerValues[i] = unit == ChannelCalibration::Register
+            ? value : m_calibration.toRegister(unit, i + 1, value);
+
         m_channelSliders[i]->blockSignals(true); // 阻止发送信号
         m_channelSliders[i]->setValue(value);
         m_channelSliders[i]->blockSignals(false);
@@ -411,19 +445,15 @@ void DriverWidget::onMasterValueChanged(int value)
     
     // 不使用scheduleSendData，直接发送所有通道数据
     if (isConnected() && m_driverGeneral) {
-        sendAllChannelsData(value);
+        sendAllChannelsData();
     }
     
     // 发送通道值变化信号
-    QVector<int> values;
-    for (int i = 0; i < m_channelCount; ++i) {
-        values.append(value);
-    }
-    emit channelValuesChanged(values);
+    emit channelValuesChanged(m_registerValues);
 }
 
 // 添加发送所有通道数据的方法
-void DriverWidget::sendAllChannelsData(int value)
+void DriverWidget::sendAllChannelsData()
 {
     if (!isConnected() || !m_driverGeneral) {
         return;
@@ -436,7 +466,7 @@ void DriverWidget::sendAllChannelsData(int value)
     // 构建所有通道的数据
     QByteArray valueData;
     for (int i = 0; i < m_channelCount; ++i) {
-        quint16 channelValue = static_cast<quint16>(value);
+        quint16 channelValue = static_cast<quint16>(m_registerValues[i]);
         // 添加高字节和低字节（大端序）
         valueData.append(static_cast<char>((channelValue >> 8) & 0xFF));
         valueData.append(static_cast<char>(channelValue & 0xFF));
@@ -454,6 +484,11 @@ void DriverWidget::onChannelValueChanged(int index, int value)
         return;
     }
     
+    // 控制目标为物理量时查表换算为驱动强度
+    const ChannelCalibration::Unit unit = controlUnit();
+    m_registerValues[index] = unit == ChannelCalibration::Register
+        ? value : m_calibration.toRegister(unit, index + 1, value);
+
     // 更新数值框
     m_channelValueSpins[index]->blockSignals(true);
     m_channelValueSpins[index]->setValue(value);
@@ -466,53 +501,48 @@ void DriverWidget::onChannelValueChanged(int index, int value)
     scheduleSendData();
     
     // 发送通道值变化信号
-    QVector<int> values;
-    for (int i = 0; i < m_channelCount; ++i) {
-        values.append(m_channelValueSpins[i]->value());
-    }
-    emit channelValuesChanged(values);
+    emit channelValuesChanged(m_registerValues);
 }
 
-// 扫描定时器处理
-void DriverWidget::onScanTimeout()
+// 扫描每发送一步，同步界面（帧已由扫描引擎发出，这里不再发送）
+void DriverWidget::onSweepStep(int index, int range, int value)
 {
-    int currentValue = m_startValueBox->value();  // 使用起始值
-    int stepValue = m_stepValueBox->value();
-    int endValue = m_endValueBox->value();
-    int startReg = m_startRegBox->value() - 1;  // 转换为0基索引
-    int regCount = m_regCountBox->value();
-    
-    // 根据扫描方向更新值
-    if (m_scanTimer->property("isIncrease").toBool()) {
-        currentValue += stepValue;
-        if (currentValue > endValue) {
-            stopScan();
-            return;
-        }
-    } else {
-        currentValue -= stepValue;
-        if (currentValue < endValue) {
-            stopScan();
-            return;
-        }
-    }
-    
-    // 更新指定范围的通道值
-    for (int i = startReg; i < startReg + regCount && i < m_channelCount; ++i) {
+    Q_UNUSED(index)
+    Q_UNUSED(range)
+
+    showStrength(m_startRegBox->value(), m_regCountBox->value(), value);
+}
+
+// 按已发送的强度更新滑条、数值框和参数表
+void DriverWidget::showStrength(int firstChannel, int channelCount, int value)
+{
+    int startReg = firstChannel - 1;  // 转换为0基索引
+
+    for (int i = startReg; i < startReg + channelCount && i < m_channelCount; ++i) {
         if (i >= 0 && i < m_channelSliders.size()) {
-            m_channelSliders[i]->setValue(currentValue);
-            m_channelValueSpins[i]->setValue(currentValue);
+            m_registerValues[i] = value;
+            const int shown = displayValue(i);
+            m_channelSliders[i]->blockSignals(true);
+            m_channelValueSpins[i]->blockSignals(true);
+            m_channelSliders[i]->setValue(shown);
+            m_channelValueSpins[i]->setValue(shown);
+            m_channelSliders[i]->blockSignals(false);
+            m_channelValueSpins[i]->blockSignals(false);
         }
     }
-    
-    // 更新起始值
-    m_startValueBox->setValue(currentValue);
-    
-    // 更新参数表
+
     updateParamTable();
-    
-    // 发送更新后的通道值
-    scheduleSendData();
+
+    emit channelValuesChanged(m_registerValues);
+}
+
+// 扫描结束（走完、被停止或发送失败）
+void DriverWidget::onSweepFinished(const SweepEngine::Report &report)
+{
+    if (report.completed) {
+        m_startValueBox->setValue(m_endValueBox->value());
+    }
+    stopScan();
 }
 
 // 更新参数表
@@ -526,14 +556,122 @@ void DriverWidget::updateParamTable()
             m_paramTable->setItem(i, 0, channelItem);
         }
         
-        // 设置通道值
+        // 设置通道值（驱动强度，有标定时附带物理量）
         QTableWidgetItem* valueItem = m_paramTable->item(i, 1);
         if (!valueItem) {
             valueItem = new QTableWidgetItem();
             m_paramTable->setItem(i, 1, valueItem);
         }
-        valueItem->setText(QString::number(m_channelValueSpins[i]->value()));
+        const ChannelCalibration::Unit unit = controlUnit();
+        if (unit != ChannelCalibration::Register && m_calibration.curve(unit, i + 1)) {
+            valueItem->setText(QString("%1 (%2)").arg(m_registerValues[i])
+                               .arg(m_channelValueSpins[i]->value()));
+        } else {
+            valueItem->setText(QString::number(m_registerValues[i]));
+        }
+    }
+}
+
+int DriverWidget::channelValue(int channel) const
+{
+    if (channel < 1 || channel > m_registerValues.size()) {
+        return 0;
+    }
+    return m_registerValues[channel - 1];
+}
+
+ChannelCalibration::Unit DriverWidget::controlUnit() const
+{
+    return ChannelCalibration::Unit(m_sliderTargetCombo->currentData().toInt());
+}
+
+int DriverWidget::displayValue(int index) const
+{
+    const ChannelCalibration::Unit unit = controlUnit();
+    if (unit == ChannelCalibration::Register) {
+        return m_registerValues[index];
+    }
+    return int(std::lround(m_calibration.toPhysical(unit, index + 1, m_registerValues[index])));
+}
+
+// 按通道数和当前从机地址加载标定，地址未变时不重复加载
+void DriverWidget::loadCalibration()
+{
+    const QString id = ChannelCalibration::driverId(m_channelCount, m_receiveAddress);
+    if (id == m_calibration.driverId()) {
+        return;
+    }
+    m_calibration.reset(id, m_channelCount);
+    m_calibration.load();
+    refreshCalibrationUnits();
+}
+
+// 控制目标只列出有标定的单位，当前单位失去标定时回到通道值
+void DriverWidget::refreshCalibrationUnits()
+{
+    const ChannelCalibration::Unit current = controlUnit();
+    m_sliderTargetCombo->blockSignals(true);
+    m_sliderTargetCombo->clear();
+    for (int u = ChannelCalibration::Register; u < ChannelCalibration::UnitCount; ++u) {
+        const ChannelCalibration::Unit unit = ChannelCalibration::Unit(u);
+        if (unit == ChannelCalibration::Register || m_calibration.hasUnit(unit)) {
+            m_sliderTargetCombo->addItem(ChannelCalibration::unitName(unit), u);
+        }
+    }
+    m_sliderTargetCombo->setCurrentIndex(qMax(0, m_sliderTargetCombo->findData(int(current))));
+    m_sliderTargetCombo->blockSignals(false);
+    onControlUnitChanged();
+}
+
+// 切换控制目标：滑条范围改为该单位的标定范围，按当前驱动强度换算显示，不发送
+void DriverWidget::onControlUnitChanged()
+{
+    const ChannelCalibration::Unit unit = controlUnit();
+    const int maximum = unit == ChannelCalibration::Register
+        ? 255 : int(std::ceil(m_calibration.maxPhysical(unit)));
+
+    m_masterSlider->blockSignals(true);
+    m_masterValueEdit->blockSignals(true);
+    m_masterSlider->setRange(0, maximum);
+    m_masterValueEdit->setRange(0, maximum);
+    m_masterValueEdit->setSuffix(ChannelCalibration::unitSuffix(unit));
+    m_masterSlider->blockSignals(false);
+    m_masterValueEdit->blockSignals(false);
+
+    for (int i = 0; i < m_channelSliders.size(); ++i) {
+        const int shown = displayValue(i);
+        m_channelSliders[i]->blockSignals(true);
+        m_channelValueSpins[i]->blockSignals(true);
+        m_channelSliders[i]->setRange(0, maximum);
+        m_channelValueSpins[i]->setRange(0, maximum);
+        m_channelValueSpins[i]->setSuffix(ChannelCalibration::unitSuffix(unit));
+        m_channelSliders[i]->setValue(shown);
+        m_channelValueSpins[i]->setValue(shown);
+        m_channelSliders[i]->blockSignals(false);
+        m_channelValueSpins[i]->blockSignals(false);
     }
+    if (!m_channelSliders.isEmpty()) {
+        m_masterSlider->blockSignals(true);
+        m_masterValueEdit->blockSignals(true);
+        m_masterSlider->setValue(m_channelSliders.first()->value());
+        m_masterValueEdit->setValue(m_channelSliders.first()->value());
+        m_masterSlider->blockSignals(false);
+        m_masterValueEdit->blockSignals(false);
+    }
+
+    updateParamTable();
+}
+
+SweepEngine::Range DriverWidget::scanRange() const
+{
+    SweepEngine::Range range;
+    range.firstChannel = m_startRegBox->value();
+    range.channelCount = qMin(m_regCountBox->value(), m_channelCount - range.firstChannel + 1);
+    range.start = m_startValueBox->value();
+    range.stop = m_endValueBox->value();
+    range.step = m_stepValueBox->value();
+    range.dwellMs = m_intervalBox->value();
+    return range;
 }
 
 // 开始扫描
@@ -552,12 +690,12 @@ void DriverWidget::startScan(bool isIncrease)
         return;
     }
     
-    // 设置扫描方向
-    m_scanTimer->setProperty("isIncrease", isIncrease);
-    
-    // 设置扫描间隔
-    m_scanTimer->setInterval(m_intervalBox->value());
-    
+    // 按界面参数生成扫描计划
+    m_sweep->setAddresses(m_sendAddress, m_receiveAddress);
+    if (!m_sweep->prepare({ scanRange() }) || !m_sweep->start()) {
+        return;
+    }
+
     // 禁用相关控件
     m_increaseBtn->setEnabled(false);
     m_decreaseBtn->setEnabled(false);
@@ -568,17 +706,12 @@ void DriverWidget::startScan(bool isIncrease)
     
     // 启用停止按钮
     m_stopScanBtn->setEnabled(true);
-    
-    // 启动定时器
-    m_scanTimer->start();
 }
 
 // 停止扫描
 void DriverWidget::stopScan()
 {
-    if (m_scanTimer) {
-        m_scanTimer->stop();  // 确保定时器停止
-    }
+    m_sweep->stop();  // 已结束时不会重复触发
     
     // 启用相关控件
     m_increaseBtn->setEnabled(true);
@@ -600,7 +733,8 @@ bool DriverWidget::isConnected() const
 
 void DriverWidget::connectToPort(const QString &portName)
 {
-    // 如果正在处理连接，先取消
+    // 如果正在处理连接或自动重连，先取消
+    m_reconnect->cancel();
     if (m_connectionPending) {
         m_connectionTimeoutTimer->stop();
         m_connectionPending = false;
@@ -627,6 +761,14 @@ void DriverWidget::connectToPort(const QString &portName)
 
 void DriverWidget::disconnectPort()
 {
+    if (m_reconnect->isRecovering()) {
+        // 正在自动重连时串口可能未打开，也要通知断开
+        m_reconnect->cancel();
+        m_connectionPending = false;
+        m_serial->disconnectPort();
+        emit serialDisconnected();
+        return;
+    }
     if (m_serial && m_serial->isConnected()) {
         m_serial->disconnectPort();
         emit serialDisconnected();  // 确保发送断开信号
@@ -738,6 +880,8 @@ void DriverWidget::handleSerialData(const QByteArray &data)
     
     // 提取数据部分
     QByteArray payload = data.mid(7, len - 3); // 去掉len, action, sender, receiver, function后剩余的数据
+    DeviceState<DriverState> &state = m_driverGeneral->state();
+    const auto receivedAt = std::chrono::steady_clock::now();
     
     // 如果正在等待连接响应，且收到初始化响应
     if (m_connectionPending && function == 0x08) {
@@ -747,9 +891,15 @@ void DriverWidget::handleSerialData(const QByteArray &data)
         // 更新接收地址
         m_receiveAddress = sender;
         m_addressEdit->setText(QString::number(m_receiveAddress, 16).toUpper());
-        
-        // 通知连接成功
-        emit serialConnected(m_pendingPortName);
+        if (m_reconnect->isRecovering()) {
+            // 自动重连的握手：不重复通知连接，由 recovered 重放强度
+            m_reconnect->handshakeSucceeded();
+        } else {
+            loadCalibration();
+            
+            // 通知连接成功
+            emit serialConnected(m_pendingPortName);
+        }
         
         // 获取设备状态
         sendReadLEDStatusCommand();
@@ -761,6 +911,12 @@ void DriverWidget::handleSerialData(const QByteArray &data)
     switch (function) {
         case 0x08: { // 初始化响应
             DriverGeneral::DriverMessage message = m_driverGeneral->parseInit(payload);
+            state.update([&](DriverState &s) {
+                s.channelCount = message.ChannelCount;
+                s.ratedVoltage = message.maxV / 100.0f;
+                s.ratedCurrent = message.maxA / 100.0f;
+                s.time = receivedAt;
+            });
             // 更新UI显示
             m_ratedVoltageLabel->setText(QString("%1V").arg(message.maxV / 100.0));
             m_ratedCurrentLabel->setText(QString("%1A").arg(message.maxA / 100.0));
@@ -770,10 +926,16 @@ void DriverWidget::handleSerialData(const QByteArray &data)
             char newAddress = m_driverGeneral->parseWrite1Byte(payload);
             m_addressEdit->setText(QString::number(newAddress, 16).toUpper());
             m_receiveAddress = static_cast<quint8>(newAddress);
+            loadCalibration();
             break;
         }
         case 0x1C: { // 温度响应
             DriverGeneral::Temperatures temps = m_driverGeneral->parseTemperature(payload);
+            state.update([&](DriverState &s) {
+                s.ledTemperature = temps.LEDTemperature / 100.0f;
+                s.pcbTemperature = temps.PCBTemperature / 100.0f;
+                s.time = receivedAt;
+            });
             // 更新温度显示
             m_ledTempLabel->setText(QString("%1℃").arg(temps.LEDTemperature / 100.0));
             m_pcbTempLabel->setText(QString("%1℃").arg(temps.PCBTemperature / 100.0));
@@ -784,6 +946,10 @@ void DriverWidget::handleSerialData(const QByteArray &data)
                 quint16 ledStatus = m_driverGeneral->parseWrite2Byte(payload);
                 // 更新LED状态显示
                 m_ledStatus = (ledStatus == 0x0001);
+                state.update([&](DriverState &s) {
+                    s.ledOn = m_ledStatus;
+                    s.time = receivedAt;
+                });
                 m_ledStatusLabel->setText(m_ledStatus ? "开启" : "关闭");
                 m_ledSwitch->setText(m_ledStatus ? "关闭LED" : "打开LED");
                 m_ledSwitch->setStyleSheet(m_ledStatus ? 
@@ -795,6 +961,15 @@ void DriverWidget::handleSerialData(const QByteArray &data)
         case 0x26: { // LED强度响应
             if (action == 0x81) { // 读响应
                 DriverGeneral::ChannelValue channelValues = m_driverGeneral->parseChannelValue(payload);
+                state.update([&](DriverState &s) {
+                    for (int i = 0; i < channelValues.chValue.size(); ++i) {
+                        const int channel = channelValues.startRegister - 1 + i;
+                        if (channel >= 0 && channel < DriverState::MaxChannels) {
+                            s.strength[channel] = channelValues.chValue.at(i);
+                        }
+                    }
+                    s.time = receivedAt;
+                });
                 // 更新通道值显示
                 for (int i = 0; i < channelValues.chValue.size(); ++i) {
                     int channelIndex = channelValues.startRegister - 1 + i;
@@ -809,18 +984,24 @@ void DriverWidget::handleSerialData(const QByteArray &data)
         }
         case 0x50: { // LED模式响应
             quint16 ledMode = m_driverGeneral->parseWrite2Byte(payload);
+            state.update([&](DriverState &s) { s.ledMode = ledMode; s.time = receivedAt; });
             // 更新模式显示
             m_modeCombo->setCurrentIndex(ledMode);
             break;
         }
         case 0x52: { // LED工作时间响应
             quint32 ledTime = m_driverGeneral->parseWrite4Byte(payload);
+            state.update([&](DriverState &s) { s.workTime = ledTime; s.time = receivedAt; });
             m_ledTimeEdit->setValue(static_cast<int>(ledTime));
             break;
         }
         case 0x56: { // 电压电流响应
             DriverGeneral::CurrentPower power = m_driverGeneral->parsePower(payload);
-            // 这里可以添加UI组件来显示当前电压电流
+            state.update([&](DriverState &s) {
+                s.voltage = power.nowVoltage;
+                s.current = power.nowCurrent;
+                s.time = receivedAt;
+            });
             break;
         }
         case 0x5E: { // 最大电压电流响应
@@ -886,12 +1067,13 @@ QJsonObject DriverWidget::getSettings() const
     settings["maxVoltage"] = m_maxVoltageEdit->value();
     settings["maxCurrent"] = m_maxCurrentEdit->value();
     
-    // 保存通道值
+    // 保存通道值（驱动强度）和控制目标
     QJsonArray channelValues;
     for (int i = 0; i < m_channelCount; ++i) {
-        channelValues.append(m_channelValueSpins[i]->value());
+        channelValues.append(m_registerValues[i]);
     }
     settings["channelValues"] = channelValues;
+    settings["controlUnit"] = ChannelCalibration::unitKey(controlUnit());
     
     return settings;
 }
@@ -941,14 +1123,24 @@ void DriverWidget::applySettings(const QJsonObject &settings)
     if (settings.contains("channelValues")) {
         QJsonArray channelValues = settings["channelValues"].toArray();
         for (int i = 0; i < qMin(channelValues.size(), m_channelCount); ++i) {
-            int value = channelValues[i].toInt();
-            m_channelSliders[i]->setValue(value);
-            m_channelValueSpins[i]->setValue(value);
+            m_registerValues[i] = channelValues[i].toInt();
         }
     }
-    
-    // 更新参数表
-    updateParamTable();
+
+    // 恢复控制目标（没有该单位的标定时保持通道值），按驱动强度刷新滑条和参数表
+    int unitIndex = 0;
+    for (int u = ChannelCalibration::Register; u < ChannelCalibration::UnitCount; ++u) {
+        if (settings["controlUnit"].toString() == ChannelCalibration::unitKey(ChannelCalibration::Unit(u))) {
+            unitIndex = qMax(0, m_sliderTargetCombo->findData(u));
+        }
+    }
+    m_sliderTargetCombo->blockSignals(true);
+    m_sliderTargetCombo->setCurrentIndex(unitIndex);
+    m_sliderTargetCombo->blockSignals(false);
+    onControlUnitChanged();
+
+    scheduleSendData();
+    emit channelValuesChanged(m_registerValues);
 }
 
 // 初始化驱动器连接
@@ -1054,7 +1246,7 @@ void DriverWidget::sendWriteLEDStrengthCommand()
     QByteArray valueData;
     for (int i = startReg - 1; i < startReg - 1 + regCount && i < m_channelCount; ++i) {
         if (i >= 0 && i < m_channelValueSpins.size()) {
-            quint16 value = static_cast<quint16>(m_channelValueSpins[i]->value());
+            quint16 value = static_cast<quint16>(m_registerValues[i]);
             // 添加高字节和低字节（大端序）
             valueData.append(static_cast<char>((value >> 8) & 0xFF));
             valueData.append(static_cast<char>(value & 0xFF));
@@ -21,7 +21,10 @@
 #include <QJsonArray>
 #include <QMessageBox>
 #include "serial/serialutil.h"
+#include "serial/reconnectsupervisor.h"
 #include "communication/drivergeneral.h"
+#include "devices/driver/sweepengine.h"
+#include "devices/driver/channelcalibration.h"
 
 class DriverWidget : public QWidget
 {
@@ -40,11 +43,30 @@ public:
     // 应用设置
     void applySettings(const QJsonObject &settings);
 
+    // 驱动器状态快照（由响应解码更新，任意线程可读）
+    const DeviceState<DriverState> &state() const { return m_driverGeneral->state(); }
+
+    // 供自动化流程直接收发（特性测试等）
+    SerialUtil *serialPort() const { return m_serial; }
+    DriverGeneral *protocol() const { return m_driverGeneral; }
+    quint8 sendAddress() const { return m_sendAddress; }
+    quint8 receiveAddress() const { return m_receiveAddress; }
+    SweepEngine::Range scanRange() const;       // 扫描区的通道范围、起止值、步长和间隔
+    void showStrength(int firstChannel, int channelCount, int value);   // 只更新界面，不发送
+    int channelValue(int channel) const;        // 通道当前的驱动强度（通道号从1开始）
+    int channelCount() const { return m_channelCount; }
+
+    // 通道标定（物理量 -> 驱动强度），按从机地址加载
+    ChannelCalibration &calibration() { return m_calibration; }
+    void refreshCalibrationUnits();             // 标定更新后刷新控制目标
+
 signals:
     void settingsChanged();        // 设置发生变化时发出信号
     void serialConnected(const QString &portName);
     void serialDisconnected();
     void serialError(const QString &error);
+    void serialRecovering();                                    // 意外断开，正在自动重连
+    void serialRecovered(qint64 downtimeMs, int recoveries);    // 自动重连成功，强度已重放
     void channelValuesChanged(const QVector<int>& values); // 通道值变化信号
 
 private:
@@ -92,7 +114,7 @@ private:
     QPushButton* m_increaseBtn;    // 递增按钮
     QPushButton* m_decreaseBtn;    // 递减按钮
     QPushButton* m_stopScanBtn;    // 停止扫描按钮
-    QTimer* m_scanTimer;           // 扫描定时器
+    SweepEngine* m_sweep;          // 强度扫描（预生成帧，按截止时间发送）
     
     // 参数表控件
     QTableWidget* m_paramTable;    // 参数表格
@@ -102,16 +124,22 @@ private:
     QSlider* m_masterSlider;           // 总控滑条
     QSpinBox* m_masterValueEdit;       // 总控数值
     QVector<QSlider*> m_channelSliders;      // 单控滑条列表
-    QVector<QSpinBox*> m_channelValueSpins;  // 单控数值列表
+    QVector<QSpinBox*> m_channelValueSpins;  // 单控数值列表（按控制目标的单位显示）
+    QVector<int> m_registerValues;           // 各通道的驱动强度，发送时直接使用
+    ChannelCalibration m_calibration;        // 当前驱动器的通道标定
 
     QTimer* m_connectionTimeoutTimer;  // 连接超时定时器
     bool m_connectionPending;          // 连接状态正在等待
     QString m_pendingPortName;         // 待连接的端口名称
+    ReconnectSupervisor* m_reconnect;  // 意外断开后自动重连
 
 private:
     void initUI();                 // 初始化界面
     void setupConnections();       // 建立信号槽连接
     void updateParamTable();       // 更新参数表
+    void loadCalibration();        // 按通道数和从机地址加载标定
+    ChannelCalibration::Unit controlUnit() const;   // 控制目标的单位
+    int displayValue(int index) const;             // 通道的驱动强度换算为控制目标的单位
     void startScan(bool isIncrease); // 开始扫描
     void stopScan();              // 停止扫描
     
@@ -140,12 +168,14 @@ private:
     void sendData();                                // 实际发送数据
     
     // 添加新方法
-    void sendAllChannelsData(int value);
+    void sendAllChannelsData();
 
 private slots:
     void onMasterValueChanged(int value);           // 总控值改变
     void onChannelValueChanged(int index, int value); // 单控值改变
-    void onScanTimeout();                           // 扫描定时器超时
+    void onControlUnitChanged();                    // 控制目标切换
+    void onSweepStep(int index, int range, int value);    // 扫描已发送一步
+    void onSweepFinished(const SweepEngine::Report &report); // 扫描结束
     void onDataSendTimerTimeout();                  // 数据发送定时器超时
     void onSerialPortError(QSerialPort::SerialPortError error); // 串口错误处理
     void handleConnectionTimeout();                 // 连接超时处理
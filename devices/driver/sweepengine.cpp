@@ -0,0 +1,209 @@
+#include "sweepengine.h"
+#include "communication/drivergeneral.h"
+#include "serial/serialutil.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+#include "util/steadyclock.h"
+#include <algorithm>
+#include <cmath>
+
+using SteadyClock::toMs;
+
+namespace {
+    const int MaxRegisterValue = 0xFFFF;
+    const int MaxPlannedFrames = 100000;
+}
+
+SweepEngine::SweepEngine(SerialUtil *serial, DriverGeneral *protocol, QObject *parent)
+    : QObject(parent)
+    , m_serial(serial)
+    , m_protocol(protocol)
+{
+    qRegisterMetaType<SweepEngine::Report>("SweepEngine::Report");
+
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &SweepEngine::onDeadline);
+}
+
+void SweepEngine::setAddresses(quint8 sendAddress, quint8 receiveAddress)
+{
+    m_sendAddress = sendAddress;
+    m_receiveAddress = receiveAddress;
+}
+
+int SweepEngine::stepCount(const Range &range)
+{
+    if (range.step <= 0) {
+        return 0;
+    }
+    return std::abs(range.stop - range.start) / range.step + 1;
+}
+
+int SweepEngine::valueAt(const Range &range, int step)
+{
+    const int direction = range.stop >= range.start ? 1 : -1;
+    return range.start + direction * step * range.step;
+}
+
+bool SweepEngine::prepare(const QVector<Range> &ranges)
+{
+    if (m_running || ranges.isEmpty()) {
+        return false;
+    }
+
+    int total = 0;
+    for (const Range &range : ranges) {
+        if (range.firstChannel < 1 || range.channelCount < 1 || range.firstChannel + range.channelCount - 1 > 0xFF ||
+            range.step <= 0 || range.dwellMs < 0 ||
+            range.start < 0 || range.start > MaxRegisterValue || range.stop < 0 || range.stop > MaxRegisterValue) {
+            LOG_WARNING(QString("扫描参数无效: 通道 %1+%2 %3→%4 步长 %5 驻留 %6ms")
+                        .arg(range.firstChannel).arg(range.channelCount)
+                        .arg(range.start).arg(range.stop).arg(range.step).arg(range.dwellMs));
+            return false;
+        }
+        total += stepCount(range);
+    }
+    if (total > MaxPlannedFrames) {
+        LOG_WARNING(QString("扫描计划 %1 帧超出上限 %2").arg(total).arg(MaxPlannedFrames));
+        return false;
+    }
+
+    QVector<Step> steps;
+    steps.reserve(total);
+    qint64 endNs = 0;
+    for (int r = 0; r < ranges.size(); ++r) {
+        const Range &range = ranges.at(r);
+        const qint64 dwellNs = qint64(range.dwellMs) * 1000000;
+        const int count = stepCount(range);
+
+        // 同一范围内所有通道写同一个值
+        for (int k = 0; k < count; ++k) {
+            const quint16 value = quint16(valueAt(range, k));
+            Step step;
+            step.offsetNs = k * dwellNs;
+            step.range = r;
+            step.value = value;
+            step.frame = m_protocol->writeUniformLEDStrength(m_sendAddress, m_receiveAddress,
+                                                             quint8(range.firstChannel), quint8(range.channelCount),
+                                                             value);
+            steps.append(step);
+        }
+        endNs = qMax(endNs, count * dwellNs);
+    }
+
+    // 按计划时刻排序，同一时刻保持范围顺序
+    std::stable_sort(steps.begin(), steps.end(), [](const Step &a, const Step &b) {
+        return a.offsetNs < b.offsetNs;
+    });
+
+    m_steps = steps;
+    m_endNs = endNs;
+    LD_DEBUG(lcProtocol) << "扫描计划" << m_steps.size() << "帧，预计" << plannedDurationMs() << "ms";
+    return true;
+}
+
+bool SweepEngine::start()
+{
+    if (m_running || m_steps.isEmpty()) {
+        return false;
+    }
+    if (!m_serial->isConnected()) {
+        LOG_ERROR("扫描开始失败：驱动器串口未连接");
+        return false;
+    }
+
+    m_report = Report();
+    m_report.planned = m_steps.size();
+    m_report.timings.reserve(m_steps.size());
+    m_next = 0;
+    m_running = true;
+    m_start = Clock::now();
+    m_timer.start(0);       // 第一帧在事件循环中发出，调用方先完成自己的状态设置
+    return true;
+}
+
+void SweepEngine::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    finish(false);
+}
+
+void SweepEngine::onDeadline()
+{
+    schedule();
+}
+
+// 发送所有已到时刻的帧，然后把定时器设到下一个截止时间
+void SweepEngine::schedule()
+{
+    if (!m_running) {
+        return;
+    }
+
+    qint64 elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count();
+    while (m_next < m_steps.size() && m_steps.at(m_next).offsetNs <= elapsedNs) {
+        const Step &step = m_steps.at(m_next);
+        if (!m_serial->writeData(step.frame)) {
+            LOG_ERROR(QString("扫描第 %1 帧发送失败").arg(m_next));
+            finish(false);
+            return;
+        }
+        const Clock::time_point sentAt = Clock::now();
+
+        StepTiming timing;
+        timing.index = m_next;
+        timing.range = step.range;
+        timing.value = step.value;
+        timing.plannedMs = double(step.offsetNs) / 1e6;
+        timing.actualMs = toMs(sentAt - m_start);
+        m_report.timings.append(timing);
+        ++m_report.sent;
+
+        emit stepSent(m_next, step.range, step.value);
+        ++m_next;
+        elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count();
+    }
+
+    const qint64 deadlineNs = m_next < m_steps.size() ? m_steps.at(m_next).offsetNs : m_endNs;
+    if (m_next >= m_steps.size() && elapsedNs >= deadlineNs) {
+        finish(true);
+        return;
+    }
+    // 截止时间向下取整到毫秒，到点后再按实际时间判断，不会提前发送
+    m_timer.start(int(qMax<qint64>(0, (deadlineNs - elapsedNs) / 1000000)));
+}
+
+void SweepEngine::finish(bool completed)
+{
+    m_timer.stop();
+    m_running = false;
+
+    Report &report = m_report;
+    report.completed = completed;
+    report.durationMs = toMs(Clock::now() - m_start);
+    if (!report.timings.isEmpty()) {
+        double sum = 0;
+        double sumSq = 0;
+        for (const StepTiming &timing : report.timings) {
+            const double late = timing.actualMs - timing.plannedMs;
+            sum += late;
+            sumSq += late * late;
+            report.maxLateMs = qMax(report.maxLateMs, late);
+        }
+        const double n = double(report.timings.size());
+        report.meanLateMs = sum / n;
+        report.jitterMs = std::sqrt(qMax(0.0, sumSq / n - report.meanLateMs * report.meanLateMs));
+    }
+
+    LOG_INFO(QString("扫描%1: %2/%3 帧，用时 %4 ms，平均延迟 %5 ms，最大 %6 ms，抖动 %7 ms")
+             .arg(completed ? "完成" : "停止")
+             .arg(report.sent).arg(report.planned)
+             .arg(report.durationMs, 0, 'f', 1)
+             .arg(report.meanLateMs, 0, 'f', 2)
+             .arg(report.maxLateMs, 0, 'f', 2)
+             .arg(report.jitterMs, 0, 'f', 2));
+    emit finished(report);
+}
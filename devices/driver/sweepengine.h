@@ -0,0 +1,109 @@
+#ifndef SWEEPENGINE_H
+#define SWEEPENGINE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <chrono>
+
+class SerialUtil;
+class DriverGeneral;
+
+/**
+ * 驱动器强度扫描
+    开始前按扫描计划用 DriverGeneral 生成全部 LED 强度写入帧（0x26），运行时只按时刻表发送，不读写界面控件
+    每个通道范围有各自的起始值、终止值、步长和驻留时间，各范围同时开始，按各自的节拍变化；
+      同一时刻的多个帧连续发送
+    时刻表以开始时刻为基准的绝对截止时间（单调时钟），定时器误差不会累积；
+      帧直接写串口（SerialUtil::writeData），不经过50ms发送队列
+    记录每一步计划时刻和实际发送时刻，结束时给出延迟统计
+    引擎不依赖界面，在串口所在线程运行
+ */
+class SweepEngine : public QObject
+{
+    Q_OBJECT
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 一个通道范围的扫描参数
+    struct Range {
+        int firstChannel = 1;       // 起始通道（寄存器号，从1开始）
+        int channelCount = 1;
+        int start = 0;
+        int stop = 0;               // 终止值（包含；步长走不到时停在最后一个不越过的值）
+        int step = 1;               // 步长（正数，方向由起止值决定）
+        int dwellMs = 100;          // 每一步的驻留时间
+    };
+
+    // 计划中的一帧
+    struct Step {
+        qint64 offsetNs = 0;        // 相对开始时刻的计划发送时间
+        int range = 0;              // 所属范围
+        int value = 0;              // 写入的强度值
+        QByteArray frame;
+    };
+
+    // 一帧的计划和实际发送时刻
+    struct StepTiming {
+        int index = 0;
+        int range = 0;
+        int value = 0;
+        double plannedMs = 0;       // 相对开始时刻
+        double actualMs = 0;
+    };
+
+    struct Report {
+        int planned = 0;            // 计划帧数
+        int sent = 0;               // 实际发送帧数
+        bool completed = false;     // 是否走完全部计划（被停止或发送失败为false）
+        double durationMs = 0;
+        double meanLateMs = 0;      // 实际相对计划的平均延迟
+        double maxLateMs = 0;
+        double jitterMs = 0;        // 延迟标准差
+        QVector<StepTiming> timings;
+    };
+
+    SweepEngine(SerialUtil *serial, DriverGeneral *protocol, QObject *parent = nullptr);
+
+    void setAddresses(quint8 sendAddress, quint8 receiveAddress);
+
+    // 生成全部写入帧，参数无效时返回false（不改变当前计划）
+    bool prepare(const QVector<Range> &ranges);
+    const QVector<Step> &plan() const { return m_steps; }
+    double plannedDurationMs() const { return double(m_endNs) / 1e6; }
+
+    bool start();       // 按已生成的计划开始发送
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    static int stepCount(const Range &range);      // 该范围的步数（含起始值）
+    static int valueAt(const Range &range, int step);
+
+signals:
+    void stepSent(int index, int range, int value);     // 已发送计划中的第 index 帧
+    void finished(const SweepEngine::Report &report);
+
+private slots:
+    void onDeadline();
+
+private:
+    void schedule();
+    void finish(bool completed);
+
+    SerialUtil *m_serial;
+    DriverGeneral *m_protocol;
+    quint8 m_sendAddress = 0x00;
+    quint8 m_receiveAddress = 0xFF;
+
+    QTimer m_timer;
+    QVector<Step> m_steps;
+    qint64 m_endNs = 0;             // 最后一步驻留结束的时刻
+    int m_next = 0;
+    bool m_running = false;
+    Clock::time_point m_start;
+    Report m_report;
+};
+
+Q_DECLARE_METATYPE(SweepEngine::Report)
+
+#endif // SWEEPENGINE_H
@@ -10,6 +10,9 @@
 #include <QDebug>
 #include <QButtonGroup>
 #include <QJsonObject>
+#include <QSignalBlocker>
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
 
 IT8512Plus_Widget::IT8512Plus_Widget(EleLoad_ITPlus *protocol, QWidget *parent)
     : LoadBase(parent)
@@ -17,26 +20,111 @@ IT8512Plus_Widget::IT8512Plus_Widget(EleLoad_ITPlus *protocol, QWidget *parent)
 {
     // 创建串口对象
     m_serial = new SerialUtil(this);
+    // 状态轮询（先于界面连接协议信号，收到应答后先发出下一次查询再更新界面）
+    m_telemetry = new LoadTelemetry(m_serial, m_protocol, this);
+    // 设定值写入（合并连续修改并回读校验）
+    m_setpoints = new SetpointManager(m_serial, m_protocol, this);
+    // 意外断开后自动重连（重新进入远程模式并重放设定值）
+    m_reconnect = new ReconnectSupervisor(m_serial, this);
     
     // 连接串口信号
     connect(m_serial, &SerialUtil::dataReceived,
             this, &IT8512Plus_Widget::handleSerialData);
     connect(m_serial, &SerialUtil::portDisconnected,
             this, [this]() {
+                m_isConnecting = false;
                 emit serialDisconnected();
-                m_statusTimer->stop();
+                m_listEditor->cancelUpload();
+                m_telemetry->stop();
+                m_setpoints->clear();
+                abortRestore();
+                m_protocol->state().reset();
             });
+    connect(m_reconnect, &ReconnectSupervisor::connectionLost, this, [this]() {
+        // 恢复过程中再次断开时保留第一次断开前的状态
+        if (m_restoreStep == RestoreStep::None) {
+            m_restoreState = m_protocol->state().snapshot();
+        }
+        m_listEditor->cancelUpload();
+        m_telemetry->stop();
+        m_setpoints->clear();
+        abortRestore();
+        emit serialRecovering();
+    });
+    connect(m_reconnect, &ReconnectSupervisor::reopened, this, [this]() {
+        m_decoder.clear();
+        m_isConnecting = true;      // 与连接时相同，等待远程模式命令的应答
+        m_serial->enqueueData(m_protocol->createControlModeCommand(0x01));
+    });
+    connect(m_reconnect, &ReconnectSupervisor::recovered, this, &IT8512Plus_Widget::restoreState);
+    connect(m_setpoints, &SetpointManager::replayFinished, this, [this](bool confirmed) {
+        if (m_restoreStep == RestoreStep::Setpoints) {
+            restoreInput(confirmed);
+        }
+    });
+    // 恢复过程中的模式/输入命令无应答
+    m_restoreTimer = new QTimer(this);
+    m_restoreTimer->setSingleShot(true);
+    m_restoreTimer->setInterval(2000);
+    connect(m_restoreTimer, &QTimer::timeout, this, [this]() {
+        LOG_WARNING("电子负载恢复状态时设置命令无应答");
+        m_restoreOk = false;
+        if (m_restoreStep == RestoreStep::Modes) {
+            m_restoreStep = RestoreStep::Setpoints;
+            m_setpoints->replay();
+        } else if (m_restoreStep == RestoreStep::Input) {
+            finishRestore();
+        }
+    });
+
+    // 协议层解码后的响应
+    connect(m_protocol, &EleLoad_ITPlus::setResponseReceived,
+            this, &IT8512Plus_Widget::handleSetCommandResponse);
+    connect(m_protocol, &EleLoad_ITPlus::maxVoltageReceived,
+            this, &IT8512Plus_Widget::handleMaxVoltageResponse);
+    connect(m_protocol, &EleLoad_ITPlus::maxCurrentReceived,
+            this, &IT8512Plus_Widget::handleMaxCurrentResponse);
+    connect(m_protocol, &EleLoad_ITPlus::maxPowerReceived,
+            this, &IT8512Plus_Widget::handleMaxPowerResponse);
+    connect(m_protocol, &EleLoad_ITPlus::loadModeReceived,
+            this, &IT8512Plus_Widget::handleWorkModeResponse);
+    connect(m_protocol, &EleLoad_ITPlus::productMessageReceived,
+            this, &IT8512Plus_Widget::handleProductInfoResponse);
+    connect(m_protocol, &EleLoad_ITPlus::constantValueReceived,
+            this, &IT8512Plus_Widget::handleConstantValueResponse);
+    connect(m_protocol, &EleLoad_ITPlus::dynamicParamsReceived,
+            this, &IT8512Plus_Widget::handleDynamicValueResponse);
             
     setupUi();
     initConnections();
 
-    // 创建状态更新定时器
-    m_statusTimer = new QTimer(this);
-    m_statusTimer->setInterval(1000); // 1秒更新一次
-    connect(m_statusTimer, &QTimer::timeout, this, &IT8512Plus_Widget::updateStatus);
+    connect(m_telemetry, &LoadTelemetry::statisticsUpdated,
+            this, [this](const LoadTelemetry::Statistics &stats) {
+                m_telemetryLabel->setText(QString("%1 Hz  抖动 %2 ms  丢失 %3")
+                                          .arg(stats.rateHz, 0, 'f', 1)
+                                          .arg(stats.jitterMs, 0, 'f', 1)
+                                          .arg(stats.missed));
+            });
+    connect(m_telemetry, &LoadTelemetry::freshSample, this, [this]() {
+        emit sampleAcquired(m_protocol->state().snapshot());
+    });
+    connect(m_setpoints, &SetpointManager::statisticsChanged, this, [this]() {
+        const SetpointManager::Statistics &stats = m_setpoints->statistics();
+        m_setpointLabel->setText(QString("%1 次  平均 %2 ms  不一致 %3  超时 %4")
+                                 .arg(stats.confirmed)
+                                 .arg(stats.meanLatencyMs, 0, 'f', 1)
+                                 .arg(stats.mismatched)
+                                 .arg(stats.timedOut));
+    });
     
     // 初始化提示音
     m_alertSound = new QSound(":/sounds/dingding.wav", this);
+
+    // 状态显示按固定刷新率读取快照，与轮询速率无关
+    m_displayTimer = new QTimer(this);
+    m_displayTimer->setInterval(100);
+    connect(m_displayTimer, &QTimer::timeout, this, &IT8512Plus_Widget::refreshStatus);
+    m_displayTimer->start();
 }
 
 void IT8512Plus_Widget::setupUi()
@@ -107,6 +195,14 @@ void IT8512Plus_Widget::setupUi()
     m_powerLabel = new QLabel("0.000", statusGroup);
     statusLayout->addWidget(m_powerLabel, 5, 1);
 
+    statusLayout->addWidget(new QLabel("采样率:"), 6, 0);
+    m_telemetryLabel = new QLabel("-", statusGroup);
+    statusLayout->addWidget(m_telemetryLabel, 6, 1);
+
+    statusLayout->addWidget(new QLabel("设定确认:"), 7, 0);
+    m_setpointLabel = new QLabel("-", statusGroup);
+    statusLayout->addWidget(m_setpointLabel, 7, 1);
+
     // 在状态显示区添加工作模式选择
     auto *workModeBox = new QGroupBox("工作模式选择", this);
     auto *workModeLayout = new QHBoxLayout(workModeBox);
@@ -226,6 +322,10 @@ void IT8512Plus_Widget::setupUi()
     modeLayout->addWidget(m_basicModeGroup);
     modeLayout->addWidget(m_dynamicModeGroup);
 
+    // LIST序列
+    m_listEditor = new ListSequenceEditor(m_serial, m_protocol, modeGroup);
+    modeLayout->addWidget(m_listEditor);
+
     // 组装布局
     topLayout->addWidget(infoGroup);
     topLayout->addWidget(basicGroup);
@@ -247,16 +347,16 @@ void IT8512Plus_Widget::initConnections()
     connect(m_setMCurrentSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
             this, [this](double value) {
         if (isConnected()) {
-            QByteArray cmd = m_protocol->createSetMaxCurrentCommand(value);
-            m_serial->enqueueData(cmd);
+            m_setpoints->submit(0x25, m_protocol->createSetMaxCurrentCommand(value),
+                                m_protocol->createGetMaxCurrentCommand(), {float(value)});
         }
     });
 
     connect(m_setMPowerSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
             this, [this](double value) {
         if (isConnected()) {
-            QByteArray cmd = m_protocol->createSetMaxPowerCommand(value);
-            m_serial->enqueueData(cmd);
+            m_setpoints->submit(0x27, m_protocol->createSetMaxPowerCommand(value),
+                                m_protocol->createGetMaxPowerCommand(), {float(value)});
         }
     });
 
@@ -301,6 +401,16 @@ void IT8512Plus_Widget::initConnections()
     // 添加工作模式选择的信号处理
     connect(m_workModeSelect, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &IT8512Plus_Widget::onWorkModeSelectChanged);
+
+    // LIST 上传期间的 0x12 应答都归 ListUploader，暂停设定值写入并禁用会发送设置命令的控件
+    connect(m_listEditor, &ListSequenceEditor::uploadingChanged, this, [this](bool uploading) {
+        m_setpoints->setHeld(uploading);
+        m_controlModeBtn->setEnabled(!uploading);
+        m_outputStateBtn->setEnabled(!uploading);
+        m_workModeSelect->setEnabled(!uploading);
+        m_basicModeGroup->setEnabled(!uploading);
+        m_dynamicModeGroup->setEnabled(!uploading);
+    });
 }
 
 void IT8512Plus_Widget::updateDeviceInfo()
@@ -324,20 +434,9 @@ void IT8512Plus_Widget::updateDeviceInfo()
     m_serial->enqueueData(m_protocol->createGetDynamicCurrentParamsCommand());
 }
 
-void IT8512Plus_Widget::updateStatus()
-{
-    if (!isConnected()) {
-        m_statusTimer->stop();  // 如果连接断开，停止定时器
-        return;
-    }
-    
-    QByteArray cmd = m_protocol->createGetInputCommand();
-    m_serial->enqueueData(cmd);
-}
-
 void IT8512Plus_Widget::onControlModeChanged()
 {
-    if (!isConnected()) return;
+    if (!isConnected() || m_listEditor->isUploading()) return;
 
     // 切换控制模式
     QByteArray cmd = m_protocol->createControlModeCommand(m_isRemoteMode ? 0 : 1);
@@ -346,16 +445,61 @@ void IT8512Plus_Widget::onControlModeChanged()
 
 void IT8512Plus_Widget::onOutputStateChanged()
 {
-    if (!isConnected()) return;
+    if (!isConnected() || m_listEditor->isUploading()) return;
 
     // 切换输出状态
     QByteArray cmd = m_protocol->createLoadStateCommand(m_isOutput ? 0 : 1);
     m_serial->enqueueData(cmd);
 }
 
+// 与在界面上选择基础模式、类型并修改定值相同，定值经 SetpointManager 发送并回读校验
+bool IT8512Plus_Widget::applyConstant(int mode, double value)
+{
+    if (!isConnected() || mode < 0 || mode > 3) return false;
+    if (m_listEditor->isUploading()) {
+        LOG_WARNING("LIST程序上传中，暂不发送负载设置命令");
+        return false;
+    }
+
+    if (m_workModeSelect->currentIndex() != 0) {
+        m_workModeSelect->setCurrentIndex(0);
+    }
+    QRadioButton *radios[] = { m_ccModeRadio, m_cvModeRadio, m_cwModeRadio, m_crModeRadio };
+    radios[mode]->setChecked(true);     // 不发出 buttonClicked，模式命令在下面发送
+    static const char *types[] = { "CC", "CV", "CW", "CR" };
+    m_workTypeLabel->setText(types[mode]);
+    updateInputLimits();
+
+    {
+        QSignalBlocker blocker(m_valueSpinBox);
+        m_valueSpinBox->setValue(value);
+    }
+    if (qAbs(m_valueSpinBox->value() - value) > 1e-6) {
+        LOG_WARNING(QString("负载定值 %1 超出界面设定范围").arg(value));
+        return false;
+    }
+
+    m_serial->enqueueData(m_protocol->createSetWorkModel(0x00));
+    m_serial->enqueueData(m_protocol->createSetLoadModeCommand(uint8_t(mode)));
+    onValueSettingChanged();
+    return true;
+}
+
+bool IT8512Plus_Widget::setInputOn(bool on)
+{
+    if (!isConnected()) return false;
+    if (m_listEditor->isUploading()) {
+        LOG_WARNING("LIST程序上传中，暂不发送负载设置命令");
+        return false;
+    }
+
+    m_serial->enqueueData(m_protocol->createLoadStateCommand(on ? 1 : 0));
+    return true;
+}
+
 void IT8512Plus_Widget::onWorkModeChanged()
 {
-    if (!isConnected()) return;
+    if (!isConnected() || m_listEditor->isUploading()) return;
 
     // 判断当前工作模式
     bool isDynamic = !m_isBasicMode;
@@ -370,12 +514,6 @@ void IT8512Plus_Widget::onWorkModeChanged()
         QByteArray cmd = m_protocol->createSetWorkModel(mode);
         m_serial->enqueueData(cmd);
 
-        // 暂时阻断信号连接
-        m_value1SpinBox->blockSignals(true);
-        m_time1SpinBox->blockSignals(true);
-        m_value2SpinBox->blockSignals(true);
-        m_time2SpinBox->blockSignals(true);
-
         // 动态测试模式
         if (m_dcModeRadio->isChecked()) {
             type = "DC";
@@ -435,21 +573,20 @@ void IT8512Plus_Widget::onValueSettingChanged()
 {
     if (!isConnected() || !m_isBasicMode) return;  // 只在基础模式下处理
 
-    double value = m_valueSpinBox->value();
-    QByteArray cmd;
-    
+    float value = float(m_valueSpinBox->value());
+
     if (m_ccModeRadio->isChecked()) {
-        cmd = m_protocol->createSetConstantCurrentCommand(value);
+        m_setpoints->submit(0x2B, m_protocol->createSetConstantCurrentCommand(value),
+                            m_protocol->createGetConstantCurrentCommand(), {value});
     } else if (m_cvModeRadio->isChecked()) {
-        cmd = m_protocol->createSetConstantVoltageCommand(value);
+        m_setpoints->submit(0x2D, m_protocol->createSetConstantVoltageCommand(value),
+                            m_protocol->createGetConstantVoltageCommand(), {value});
     } else if (m_cwModeRadio->isChecked()) {
-        cmd = m_protocol->createSetConstantPowerCommand(value);
+        m_setpoints->submit(0x2F, m_protocol->createSetConstantPowerCommand(value),
+                            m_protocol->createGetConstantPowerCommand(), {value});
     } else if (m_crModeRadio->isChecked()) {
-        cmd = m_protocol->createSetConstantResistanceCommand(value);
-    }
-
-    if (!cmd.isEmpty()) {
-        m_serial->enqueueData(cmd);
+        m_setpoints->submit(0x31, m_protocol->createSetConstantResistanceCommand(value),
+                            m_protocol->createGetConstantResistanceCommand(), {value});
     }
 }
 
@@ -462,41 +599,39 @@ void IT8512Plus_Widget::onDynamicSettingChanged()
     double value2 = m_value2SpinBox->value();
     double time2 = m_time2SpinBox->value();
     uint8_t mode = m_triggerModeCombo->currentIndex();
-    
-    QByteArray cmd;
-    
+    const QVector<float> expected = { float(value1), float(time1), float(value2), float(time2), float(mode) };
+
     if (m_dcModeRadio->isChecked()) {
-        cmd = m_protocol->createSetDynamicCurrentParamsCommand(value1, time1, value2, time2, mode);
+        m_setpoints->submit(0x33, m_protocol->createSetDynamicCurrentParamsCommand(value1, time1, value2, time2, mode),
+                            m_protocol->createGetDynamicCurrentParamsCommand(), expected);
     } else if (m_dvModeRadio->isChecked()) {
-        cmd = m_protocol->createSetDynamicVoltageParamsCommand(value1, time1, value2, time2, mode);
+        m_setpoints->submit(0x35, m_protocol->createSetDynamicVoltageParamsCommand(value1, time1, value2, time2, mode),
+                            m_protocol->createGetDynamicVoltageParamsCommand(), expected);
     } else if (m_dwModeRadio->isChecked()) {
-        cmd = m_protocol->createSetDynamicPowerParamsCommand(value1, time1, value2, time2, mode);
+        m_setpoints->submit(0x37, m_protocol->createSetDynamicPowerParamsCommand(value1, time1, value2, time2, mode),
+                            m_protocol->createGetDynamicPowerParamsCommand(), expected);
     } else if (m_drModeRadio->isChecked()) {
-        cmd = m_protocol->createSetDynamicResistanceParamsCommand(value1, time1, value2, time2, mode);
-    }
-
-    if (!cmd.isEmpty()) {
-        m_serial->enqueueData(cmd);
+        m_setpoints->submit(0x39, m_protocol->createSetDynamicResistanceParamsCommand(value1, time1, value2, time2, mode),
+                            m_protocol->createGetDynamicResistanceParamsCommand(), expected);
     }
 }
 
 void IT8512Plus_Widget::onTriggerSignal()
 {
-    if (!isConnected()) return;
+    if (!isConnected() || m_listEditor->isUploading()) return;
     
     QByteArray cmd = m_protocol->createNewTriggerSignal();
     m_serial->enqueueData(cmd);
 }
 
-void IT8512Plus_Widget::checkTargetValues()
+void IT8512Plus_Widget::checkTargetValues(const LoadState &state)
 {
     if (!isConnected()) return;
 
-    // 获取当前显示的值
-    double voltage = m_voltageLabel->text().toDouble();
-    double current = m_currentLabel->text().toDouble();
-    double power = m_powerLabel->text().toDouble();
-    
+    const double voltage = state.voltage;
+    const double current = state.current;
+    const double power = state.power;
+
     // 检查电压目标值范围
     double minVoltage = m_minVoltageSpinBox->value();
     double maxVoltage = m_maxVoltageSpinBox->value();
@@ -542,8 +677,10 @@ void IT8512Plus_Widget::checkTargetValues()
 
 bool IT8512Plus_Widget::connectToPort(const QString &portName)
 {
+    m_reconnect->cancel();
     if (m_serial->connectToPort(portName)) {
         m_isConnecting = true;
+        m_decoder.clear();      // 丢弃上一次连接残留的数据
         // 发送远程控制模式命令
         QByteArray cmd = m_protocol->createControlModeCommand(0x01);
         m_serial->enqueueData(cmd);
@@ -564,103 +701,44 @@ bool IT8512Plus_Widget::connectToPort(const QString &portName)
 
 void IT8512Plus_Widget::handleSerialData(const QByteArray &data)
 {
-    // 累积接收的数据
-    m_buffer.append(data);
-    
-    // 处理完整的数据包
-    while (m_buffer.size() >= 26) {
-        // 查找同步头
-        int startIndex = m_buffer.indexOf(0xAA);
-        if (startIndex == -1) {
-            m_buffer.clear();
-            return;
-        }
-        
-        // 如果同步头不在开始位置，移除前面的数据
-        if (startIndex > 0) {
-            m_buffer.remove(0, startIndex);
-            continue;
-        }
-        
-        // 确保有完整的数据包
-        if (m_buffer.size() < 26) {
-            return;
-        }
-        
-        // 提取一个完整数据包
-        QByteArray packet = m_buffer.left(26);
-        qDebug() << "!!!!!!!Packetdata is : " << packet.toHex();
-        m_buffer.remove(0, 26);
-        
-        // 验证数据包
-        if (!m_protocol->validateResponse(packet)) {
-            continue;
-        }
-        
-        // 根据功能码处理数据
-        uint8_t functionCode = packet[2];
-        switch (functionCode) {
-            case 0x12: // 设置指令的响应
-                handleSetCommandResponse(packet);
-                break;
-                
-            case 0x23: // 最大电压响应
-                handleMaxVoltageResponse(packet);
-                break;
-                
-            case 0x25: // 最大电流响应
-                handleMaxCurrentResponse(packet);
-                break;
-                
-            case 0x27: // 最大功率响应
-                handleMaxPowerResponse(packet);
-                break;
-                
-            case 0x29: // 工作模式响应
-                handleWorkModeResponse(packet);
-                break;
-                
-            case 0x5F: // 实时状态响应
-                handleStatusResponse(packet);
-                break;
-                
-            case 0x6A: // 产品信息响应
-                handleProductInfoResponse(packet);
-                break;
-                
-            case 0x2B: // CC值
-            case 0x2D: // CV值
-            case 0x2F: // CW值
-            case 0x31: // CR值
-                handleConstantValueResponse(packet);
-                break;
-                
-            case 0x33: // 动态电流参数
-            case 0x35: // 动态电压参数
-            case 0x37: // 动态功率参数
-            case 0x39: // 动态电阻参数
-                handleDynamicValueResponse(packet);
-                break;
-        }
-    }
+    const auto receivedAt = std::chrono::steady_clock::now();
+
+    // 累积接收的数据，取出所有完整且校验通过的数据包
+    m_decoder.append(data.constData(), data.size());
+    m_decoder.decode([this](const uint8_t *frame) {
+        // 数据包直接引用解码器缓冲区，只在本次处理期间有效
+        QByteArray packet = QByteArray::fromRawData(reinterpret_cast<const char *>(frame),
+                                                    EleLoad_ITPlus::CommandLength);
+        LD_TRACE(lcLoad) << "Packet data is : " << packet.toHex();
+        // 按功能码解码，结果通过 EleLoad_ITPlus 的信号送到各处理函数
+        m_protocol->dispatchResponse(packet, receivedAt);
+    });
 }
 
 // 处理设置指令响应
-void IT8512Plus_Widget::handleSetCommandResponse(const QByteArray &packet)
+void IT8512Plus_Widget::handleSetCommandResponse(uint8_t status)
 {
-    if (m_isConnecting) {   // 正在进行连接
+    if (m_isConnecting && m_reconnect->isRecovering()) {    // 自动重连的握手
+        m_isConnecting = false;
+        m_reconnect->handshakeSucceeded();
+    } else if (m_restoreStep != RestoreStep::None) {   // 自动重连后的状态恢复，不逐条提示
+        onRestoreAck(status);
+    } else if (m_isConnecting) {   // 正在进行连接
         m_isConnecting = false;
         m_isRemoteMode = true;
-        m_statusTimer->start(2000);  // 启动状态更新定时器
+        m_telemetry->start();       // 开始状态轮询
         emit serialConnected(m_serial->getPortName());
         
         // 连接成功后获取设备信息
         QTimer::singleShot(100, this, [this]() {
             updateDeviceInfo();
         });
+    } else if (m_listEditor->isUploading()) {
+        // LIST 上传的逐条响应由 ListUploader 处理，不逐条提示
+        return;
     } else {
         // 普通设置指令的响应处理
-        quint8 state = static_cast<quint8>(packet[3]);
+        quint8 state = status;
         QString showText;
 
         if(state == 0x90){
@@ -681,65 +759,64 @@ void IT8512Plus_Widget::handleSetCommandResponse(const QByteArray &packet)
     }
 }
 
-// 处理状态响应
-void IT8512Plus_Widget::handleStatusResponse(const QByteArray &packet)
+// 读取负载状态快照更新显示，并检查目标值；解码路径只更新快照，不格式化文本
+void IT8512Plus_Widget::refreshStatus()
 {
-    QByteArray data;
-    if (m_protocol->parseResponse(packet, data)) {
-        auto params = m_protocol->analyseInputParams(data);
-        
-        // 更新UI显示
-        m_voltageLabel->setText(QString::number(params.voltage, 'f', 3) + " V");
-        m_currentLabel->setText(QString::number(params.current, 'f', 4) + " A");
-        m_powerLabel->setText(QString::number(params.power, 'f', 3) + " W");
-        m_tempLabel->setText(QString::number(params.radiatorTemperature) + " ℃");
-        
-        // 更新工作状态
-        m_isRemoteMode = params.handleStateRegister.rem;
-        m_isOutput = params.handleStateRegister.out;
-        m_controlModeBtn->setText(m_isRemoteMode ? "PC控制" : "面板控制");
-        m_outputStateBtn->setText(m_isOutput ? "输出 ON" : "输出 OFF");
-        qDebug() << "m_isRemoteMode is : " << m_isRemoteMode;
-        qDebug() << "isOutput is : " << m_isOutput;
-        // 发送状态更新信号
-        emit statusUpdated(params.voltage, params.current, params.power);
-        
-        // 检查目标值
-        checkTargetValues();
+    quint64 version = 0;
+    const LoadState state = m_protocol->state().snapshot(&version);
+    if (version == m_displayedVersion) {
+        return;
     }
+    m_displayedVersion = version;
+
+    m_voltageLabel->setText(QString::number(state.voltage, 'f', 3) + " V");
+    m_currentLabel->setText(QString::number(state.current, 'f', 4) + " A");
+    m_powerLabel->setText(QString::number(state.power, 'f', 3) + " W");
+    m_tempLabel->setText(QString::number(state.temperature) + " ℃");
+
+    // 更新工作状态
+    m_isRemoteMode = state.remote;
+    m_isOutput = state.output;
+    m_controlModeBtn->setText(m_isRemoteMode ? "PC控制" : "面板控制");
+    m_outputStateBtn->setText(m_isOutput ? "输出 ON" : "输出 OFF");
+
+    emit statusUpdated(state.voltage, state.current, state.power);
+
+    // 检查目标值
+    checkTargetValues(state);
 }
 
 // 处理最大电压响应
-void IT8512Plus_Widget::handleMaxVoltageResponse(const QByteArray &packet)
+void IT8512Plus_Widget::handleMaxVoltageResponse(float maxVoltage)
 {
-    float maxVoltage = m_protocol->analyseMaxVoltage(packet);
     if (maxVoltage > 0) {
+        QSignalBlocker blocker(m_setMaxVoltageSpinBox);  // 回读值写回界面，不再触发设置
         m_setMaxVoltageSpinBox->setValue(maxVoltage);
+        updateInputLimits();
     }
 }
 
 // 处理最大电流响应
-void IT8512Plus_Widget::handleMaxCurrentResponse(const QByteArray &packet)
+void IT8512Plus_Widget::handleMaxCurrentResponse(float maxCurrent)
 {
-    float maxCurrent = m_protocol->analyseMaxCurrent(packet);
     if (maxCurrent > 0) {
+        QSignalBlocker blocker(m_setMCurrentSpinBox);  // 回读值写回界面，不再触发设置
         m_setMCurrentSpinBox->setValue(maxCurrent);
     }
 }
 
 // 处理最大功率响应
-void IT8512Plus_Widget::handleMaxPowerResponse(const QByteArray &packet)
+void IT8512Plus_Widget::handleMaxPowerResponse(float maxPower)
 {
-    float maxPower = m_protocol->analyseMaxPower(packet);
     if (maxPower > 0) {
+        QSignalBlocker blocker(m_setMPowerSpinBox);  // 回读值写回界面，不再触发设置
         m_setMPowerSpinBox->setValue(maxPower);
     }
 }
 
 // 处理工作模式响应
-void IT8512Plus_Widget::handleWorkModeResponse(const QByteArray &packet)
+void IT8512Plus_Widget::handleWorkModeResponse(uint8_t mode)
 {
-    uint8_t mode = m_protocol->analyseLoadMode(packet);
     QString modeText;
     switch (mode) {
         case 0:
@@ -763,10 +840,8 @@ void IT8512Plus_Widget::handleWorkModeResponse(const QByteArray &packet)
 }
 
 // 处理产品信息响应
-void IT8512Plus_Widget::handleProductInfoResponse(const QByteArray &packet)
+void IT8512Plus_Widget::handleProductInfoResponse(const EleLoad_ITPlus::ProductMessage &info)
 {
-    auto info = m_protocol->analyseProductMessage(packet);
-    
     // 添加调试输出
     qDebug() << "Product info received:";
     qDebug() << "Model:" << info.productModel;
@@ -786,58 +861,39 @@ void IT8512Plus_Widget::handleProductInfoResponse(const QByteArray &packet)
 }
 
 // 处理定值响应
-void IT8512Plus_Widget::handleConstantValueResponse(const QByteArray &packet)
+void IT8512Plus_Widget::handleConstantValueResponse(EleLoad_ITPlus::Mode mode, float value)
 {
-    uint8_t functionCode = packet[2];
-    float value = 0.0f;
-    QString unit;
-
-    switch (functionCode) {
-        case 0x2B: // CC
-            value = m_protocol->analyseConstantCurrent(packet);
-            unit = "A";
-            break;
-        case 0x2D: // CV
-            value = m_protocol->analyseConstantVoltage(packet);
-            unit = "V";
-            break;
-        case 0x2F: // CW
-            value = m_protocol->analyseConstantPower(packet);
-            unit = "W";
-            break;
-        case 0x31: // CR
-            value = m_protocol->analyseConstantResistance(packet);
-            unit = "Ω";
-            break;
-    }
-
-    if (value > 0) {
+    // 切换到基础模式时会读取全部四种定值，只显示当前选中类型的
+    const bool checked = (mode == EleLoad_ITPlus::Mode::CC && m_ccModeRadio->isChecked())
+                      || (mode == EleLoad_ITPlus::Mode::CV && m_cvModeRadio->isChecked())
+                      || (mode == EleLoad_ITPlus::Mode::CW && m_cwModeRadio->isChecked())
+                      || (mode == EleLoad_ITPlus::Mode::CR && m_crModeRadio->isChecked());
+    if (checked && value > 0) {
+        QSignalBlocker blocker(m_valueSpinBox);  // 回读值写回界面，不再触发设置
         m_valueSpinBox->setValue(value);
     }
 }
 
 // 处理动态值响应
-void IT8512Plus_Widget::handleDynamicValueResponse(const QByteArray &packet)
+void IT8512Plus_Widget::handleDynamicValueResponse(EleLoad_ITPlus::Mode mode,
+                                                   const EleLoad_ITPlus::DynamicParams &params)
 {
-    uint8_t functionCode = packet[2];
-    EleLoad_ITPlus::DynamicParams params;
-
-
-    switch (functionCode) {
-        case 0x33: // 动态电流
-            params = m_protocol->analyseDynamicCurrentParams(packet);
-            break;
-        case 0x35: // 动态电压
-            params = m_protocol->analyseDynamicVoltageParams(packet);
-            break;
-        case 0x37: // 动态功率
-            params = m_protocol->analyseDynamicPowerParams(packet);
-            break;
-        case 0x39: // 动态电阻
-            params = m_protocol->analyseDynamicResistanceParams(packet);
-            break;
+    // 切换到动态模式时会读取全部四种动态参数，只显示当前选中类型的
+    const bool checked = (mode == EleLoad_ITPlus::Mode::CC && m_dcModeRadio->isChecked())
+                      || (mode == EleLoad_ITPlus::Mode::CV && m_dvModeRadio->isChecked())
+                      || (mode == EleLoad_ITPlus::Mode::CW && m_dwModeRadio->isChecked())
+                      || (mode == EleLoad_ITPlus::Mode::CR && m_drModeRadio->isChecked());
+    if (!checked) {
+        return;
     }
 
+    // 回读值写回界面，不再触发设置
+    QSignalBlocker value1Blocker(m_value1SpinBox);
+    QSignalBlocker time1Blocker(m_time1SpinBox);
+    QSignalBlocker value2Blocker(m_value2SpinBox);
+    QSignalBlocker time2Blocker(m_time2SpinBox);
+    QSignalBlocker triggerBlocker(m_triggerModeCombo);
+
     // 更新UI显示
     m_value1SpinBox->setValue(params.valueA);
     m_time1SpinBox->setValue(params.timeA);
@@ -846,20 +902,14 @@ void IT8512Plus_Widget::handleDynamicValueResponse(const QByteArray &packet)
     
     // 设置触发模式
     m_triggerModeCombo->setCurrentIndex(params.mode);
-
-    // 恢复信号连接
-    m_value1SpinBox->blockSignals(false);
-    m_time1SpinBox->blockSignals(false);
-    m_value2SpinBox->blockSignals(false);
-    m_time2SpinBox->blockSignals(false);
 }
 
 // 示例：发送设置最大电压命令
 void IT8512Plus_Widget::onMaxVoltageChanged(double value)
 {
     if (m_serial && m_serial->isConnected()) {
-        QByteArray cmd = m_protocol->createSetMaxVoltageCommand(value);
-        m_serial->enqueueData(cmd);
+        m_setpoints->submit(0x23, m_protocol->createSetMaxVoltageCommand(value),
+                            m_protocol->createGetMaxVoltageCommand(), {float(value)});
     }
     updateInputLimits();
 }
@@ -867,12 +917,88 @@ void IT8512Plus_Widget::onMaxVoltageChanged(double value)
 void IT8512Plus_Widget::disconnectPort()
 {
     if (m_serial) {
-        m_statusTimer->stop();   // 断开连接时停止状态更新定时器
+        m_reconnect->cancel();
+        m_isConnecting = false;
+        m_listEditor->cancelUpload();
+        m_telemetry->stop();     // 断开连接时停止状态轮询
+        m_setpoints->clear();
+        abortRestore();
         m_serial->disconnectPort();
         emit serialDisconnected();
     }
 }
 
+// 自动重连成功后逐步恢复断开前的状态，每一步等上一步的应答：
+//   1. 工作模式和负载类型（经 50ms 发送队列）
+//   2. 逐个重放设定值并回读校验（SetpointManager::replay）
+//   3. 全部一致时才按断开前的状态打开输入，否则保持关闭
+// 恢复期间的设置应答不弹出提示；全部完成后才发出 serialRecovered
+void IT8512Plus_Widget::restoreState(qint64 downtimeMs)
+{
+    m_restoreDowntimeMs = downtimeMs;
+    m_restoreOk = true;
+    m_isRemoteMode = true;
+    m_restoreStep = RestoreStep::Modes;
+    m_restoreAcks = 2;
+    m_serial->enqueueData(m_protocol->createSetWorkModel(m_isBasicMode ? 0x00 : 0x02));
+    m_serial->enqueueData(m_protocol->createSetLoadModeCommand(m_restoreState.loadMode));
+    m_restoreTimer->start();
+}
+
+void IT8512Plus_Widget::onRestoreAck(uint8_t status)
+{
+    if (status != 0x80) {
+        LOG_WARNING(QString("电子负载恢复状态时设置失败，状态 0x%1").arg(status, 2, 16, QChar('0')));
+    }
+    switch (m_restoreStep) {
+    case RestoreStep::Modes:
+        m_restoreOk = m_restoreOk && status == 0x80;
+        if (--m_restoreAcks > 0) {
+            return;
+        }
+        m_restoreTimer->stop();
+        m_restoreStep = RestoreStep::Setpoints;
+        m_setpoints->replay();      // 全部回读后 replayFinished -> restoreInput
+        break;
+    case RestoreStep::Setpoints:
+        break;                      // 设定值以回读结果为准
+    case RestoreStep::Input:
+        m_restoreInputOn = m_restoreInputOn && status == 0x80;
+        finishRestore();
+        break;
+    case RestoreStep::None:
+        break;
+    }
+}
+
+void IT8512Plus_Widget::restoreInput(bool confirmed)
+{
+    m_restoreOk = m_restoreOk && confirmed;
+    m_restoreInputOn = m_restoreState.output && m_restoreOk;
+    if (m_restoreState.output && !m_restoreOk) {
+        LOG_WARNING("电子负载恢复后设定值未全部确认，输入保持关闭");
+    }
+    m_restoreStep = RestoreStep::Input;
+    m_serial->enqueueData(m_protocol->createLoadStateCommand(m_restoreInputOn ? 1 : 0));
+    m_restoreTimer->start();
+}
+
+void IT8512Plus_Widget::finishRestore()
+{
+    m_restoreTimer->stop();
+    m_restoreStep = RestoreStep::None;
+    m_telemetry->start();
+    LOG_INFO(QString("电子负载已恢复：%1 模式，输入%2").arg(m_restoreState.loadMode)
+             .arg(m_restoreInputOn ? "打开" : "关闭"));
+    emit serialRecovered(m_restoreDowntimeMs, m_reconnect->statistics().recoveries);
+}
+
+void IT8512Plus_Widget::abortRestore()
+{
+    m_restoreTimer->stop();
+    m_restoreStep = RestoreStep::None;
+}
+
 bool IT8512Plus_Widget::isConnected() const
 {
     return m_serial && m_serial->isConnected();
@@ -902,6 +1028,9 @@ QJsonObject IT8512Plus_Widget::saveSettings() const
     settings["maxCurrent"] = m_maxCurrentSpinBox->value();
     settings["minPower"] = m_minPowerSpinBox->value();
     settings["maxPower"] = m_maxPowerSpinBox->value();
+
+    // 保存LIST序列
+    settings["listSequence"] = m_listEditor->saveSettings();
     
     return settings;
 }
@@ -920,6 +1049,9 @@ void IT8512Plus_Widget::loadSettings(const QJsonObject &settings)
     m_maxCurrentSpinBox->setValue(settings["maxCurrent"].toDouble());
     m_minPowerSpinBox->setValue(settings["minPower"].toDouble());
     m_maxPowerSpinBox->setValue(settings["maxPower"].toDouble());
+
+    // 加载LIST序列
+    m_listEditor->loadSettings(settings["listSequence"].toObject());
 }
 
 // 添加工作模式选择变化的处理函数
@@ -1010,10 +1142,6 @@ void IT8512Plus_Widget::updateInputLimits()
 
 IT8512Plus_Widget::~IT8512Plus_Widget()
 {
-    if (m_statusTimer) {
-        m_statusTimer->stop();
-        delete m_statusTimer;
-    }
     if (m_alertSound) {
         delete m_alertSound;
     }
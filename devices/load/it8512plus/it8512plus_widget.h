@@ -3,7 +3,12 @@
 
 #include "../load_base.h"
 #include "communication/eleload_itplus.h"
+#include "communication/fixedframedecoder.h"
+#include "loadtelemetry.h"
+#include "setpointmanager.h"
+#include "listsequenceeditor.h"
 #include "../../../serial/serialutil.h"
+#include "serial/reconnectsupervisor.h"
 #include "../../../util/Toastmessage.h"
 #include <QTimer>
 #include <QSound>
@@ -29,22 +34,20 @@ public:
 
     QJsonObject saveSettings() const;
     void loadSettings(const QJsonObject &settings);
-
-signals:
-    void serialConnected(const QString &portName);
-    void serialDisconnected();
-    void statusUpdated(float voltage, float current, float power);
+    const DeviceState<LoadState> *state() const override { return &m_protocol->state(); }
+    bool requestSample() override { return m_telemetry->requestSample(); }
+    bool applyConstant(int mode, double value) override;
+    bool setInputOn(bool on) override;
 
 private slots:
     void updateDeviceInfo();        // 更新设备信息
-    void updateStatus();            // 更新状态
     void onControlModeChanged();    // 控制模式改变
     void onOutputStateChanged();    // 输出状态改变
     void onWorkModeChanged();       // 工作模式改变
     void onValueSettingChanged();   // 定值设置改变
     void onDynamicSettingChanged(); // 动态设置改变
     void onTriggerSignal();         // 发送触发信号
-    void checkTargetValues();       // 检查目标值
+    void refreshStatus();           // 按界面刷新率显示负载状态快照
     void onMaxVoltageChanged(double value);
     void onWorkModeSelectChanged(int index);  // 工作模式选择改变
 
@@ -53,11 +56,24 @@ private:
     void initConnections();         // 初始化信号槽
     void updateTargetStatus();      // 更新目标值状态
     void updateInputLimits();       // 更新输入限制
+    void checkTargetValues(const LoadState &state);     // 检查目标值
 
     EleLoad_ITPlus *m_protocol;     // 通信协议
-    QTimer *m_statusTimer;          // 状态更新定时器
+    LoadTelemetry *m_telemetry;     // 状态轮询
+    SetpointManager *m_setpoints;   // 设定值写入
+    ReconnectSupervisor *m_reconnect;   // 意外断开后自动重连
+    LoadState m_restoreState;       // 意外断开时的负载状态，重连后恢复
+    enum class RestoreStep { None, Modes, Setpoints, Input };
+    RestoreStep m_restoreStep = RestoreStep::None;  // 重连后的状态恢复进度
+    int m_restoreAcks = 0;          // 模式命令待收到的应答数
+    bool m_restoreOk = true;        // 恢复的各步骤都已确认
+    bool m_restoreInputOn = false;
+    qint64 m_restoreDowntimeMs = 0;
+    QTimer *m_restoreTimer;         // 恢复步骤的应答超时
     QSound *m_alertSound;           // 提示音
     bool m_isConnecting = false;     // 是否正在连接
+    QTimer *m_displayTimer;         // 状态显示刷新
+    quint64 m_displayedVersion = 0; // 已显示的状态版本
 
     // 目标值状态标志
     bool m_voltageTargetReached = false;
@@ -84,10 +100,13 @@ private:
     QLabel *m_voltageLabel;           // 电压
     QLabel *m_currentLabel;           // 电流
     QLabel *m_powerLabel;             // 功率
+    QLabel *m_telemetryLabel;         // 采样率、抖动、丢失
+    QLabel *m_setpointLabel;          // 设定值确认统计
 
     // 工作模式设置区
     QGroupBox *m_basicModeGroup;      // 基础模式组
     QGroupBox *m_dynamicModeGroup;    // 动态模式组
+    ListSequenceEditor *m_listEditor; // LIST序列
     
     // 基础模式控件
     QRadioButton *m_ccModeRadio;
@@ -116,24 +135,30 @@ private:
     QDoubleSpinBox *m_minPowerSpinBox;
     QDoubleSpinBox *m_maxPowerSpinBox;
 
-    // 响应处理方法
-    void handleSetCommandResponse(const QByteArray &packet);
-    void handleMaxVoltageResponse(const QByteArray &packet); 
-    void handleMaxCurrentResponse(const QByteArray &packet);
-    void handleMaxPowerResponse(const QByteArray &packet);
-    void handleWorkModeResponse(const QByteArray &packet);
-    void handleStatusResponse(const QByteArray &packet);
-    void handleProductInfoResponse(const QByteArray &packet);
-    void handleConstantValueResponse(const QByteArray &packet);
-    void handleDynamicValueResponse(const QByteArray &packet);
+    // 响应处理方法（由 EleLoad_ITPlus::dispatchResponse 解码后调用）
+    void handleSetCommandResponse(uint8_t status);
+    void handleMaxVoltageResponse(float maxVoltage);
+    void handleMaxCurrentResponse(float maxCurrent);
+    void handleMaxPowerResponse(float maxPower);
+    void handleWorkModeResponse(uint8_t mode);
+    void handleProductInfoResponse(const EleLoad_ITPlus::ProductMessage &info);
+    void handleConstantValueResponse(EleLoad_ITPlus::Mode mode, float value);
+    void handleDynamicValueResponse(EleLoad_ITPlus::Mode mode, const EleLoad_ITPlus::DynamicParams &params);
 
     // 添加成员变量
     bool m_isRemoteMode = false;    // 远程控制模式标识
     bool m_isOutput = false;        // 输出状态标识
-    QByteArray m_buffer;            // 数据接收缓存
+    // 数据接收缓存（环形缓冲，按 EleLoad_ITPlus 的帧规则切分）
+    FixedFrameDecoder<EleLoad_ITPlus::CommandLength> m_decoder{EleLoad_ITPlus::SyncHeader,
+                                                              &EleLoad_ITPlus::validateFrame};
 
     void handleSerialData(const QByteArray &data);
     void handleSerialError(const QString &error);
+    void restoreState(qint64 downtimeMs);
+    void onRestoreAck(uint8_t status);
+    void restoreInput(bool confirmed);
+    void finishRestore();
+    void abortRestore();
 
     // 添加工作模式选择控件
     QComboBox *m_workModeSelect;    // 工作模式选择下拉框
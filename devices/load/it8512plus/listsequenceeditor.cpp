@@ -0,0 +1,222 @@
+#include "listsequenceeditor.h"
+#include "serial/serialutil.h"
+#include <QComboBox>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QLabel>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QJsonArray>
+
+ListSequenceEditor::ListSequenceEditor(SerialUtil *serial, EleLoad_ITPlus *protocol, QWidget *parent)
+    : QGroupBox("LIST序列", parent)
+    , m_serial(serial)
+    , m_protocol(protocol)
+    , m_uploader(new ListUploader(serial, protocol, this))
+{
+    setupUi();
+
+    connect(m_addBtn, &QPushButton::clicked, this, &ListSequenceEditor::addStep);
+    connect(m_removeBtn, &QPushButton::clicked, this, &ListSequenceEditor::removeStep);
+    connect(m_uploadBtn, &QPushButton::clicked, this, &ListSequenceEditor::uploadProgram);
+    connect(m_runBtn, &QPushButton::clicked, this, &ListSequenceEditor::runProgram);
+    connect(m_stopBtn, &QPushButton::clicked, this, &ListSequenceEditor::stopProgram);
+
+    connect(m_uploader, &ListUploader::progress, this, [this](int done, int total) {
+        m_statusLabel->setText(QString("上传中 %1/%2").arg(done).arg(total));
+    });
+    connect(m_uploader, &ListUploader::finished, this, [this](bool ok, const QString &message) {
+        m_statusLabel->setText(message);
+        m_statusLabel->setStyleSheet(ok ? QString() : "QLabel { color: red; }");
+        m_uploadBtn->setEnabled(true);
+        m_runBtn->setEnabled(ok);
+        emit uploadingChanged(false);
+    });
+}
+
+void ListSequenceEditor::setupUi()
+{
+    auto *layout = new QVBoxLayout(this);
+
+    auto *optionLayout = new QHBoxLayout();
+    optionLayout->addWidget(new QLabel("模式:"));
+    m_modeCombo = new QComboBox(this);
+    m_modeCombo->addItem("CC (A)", int(EleLoad_ITPlus::Mode::CC));
+    m_modeCombo->addItem("CV (V)", int(EleLoad_ITPlus::Mode::CV));
+    m_modeCombo->addItem("CW (W)", int(EleLoad_ITPlus::Mode::CW));
+    m_modeCombo->addItem("CR (Ω)", int(EleLoad_ITPlus::Mode::CR));
+    optionLayout->addWidget(m_modeCombo);
+
+    optionLayout->addWidget(new QLabel("重复次数:"));
+    m_repeatSpinBox = new QSpinBox(this);
+    m_repeatSpinBox->setRange(0, EleLoad_ITPlus::MaxListSteps / 2);
+    m_repeatSpinBox->setValue(1);
+    m_repeatSpinBox->setSpecialValueText("连续");
+    optionLayout->addWidget(m_repeatSpinBox);
+    layout->addLayout(optionLayout);
+
+    m_stepTable = new QTableWidget(0, 2, this);
+    m_stepTable->setHorizontalHeaderLabels({"设定值", "驻留时间(ms)"});
+    m_stepTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_stepTable->setMinimumHeight(120);
+    layout->addWidget(m_stepTable);
+    appendRow(1.0, 1.0);
+    appendRow(0.0, 1.0);
+
+    auto *buttonLayout = new QHBoxLayout();
+    m_addBtn = new QPushButton("添加步骤", this);
+    m_removeBtn = new QPushButton("删除步骤", this);
+    m_uploadBtn = new QPushButton("上传", this);
+    m_runBtn = new QPushButton("运行", this);
+    m_stopBtn = new QPushButton("停止", this);
+    m_runBtn->setEnabled(false);
+    buttonLayout->addWidget(m_addBtn);
+    buttonLayout->addWidget(m_removeBtn);
+    buttonLayout->addWidget(m_uploadBtn);
+    buttonLayout->addWidget(m_runBtn);
+    buttonLayout->addWidget(m_stopBtn);
+    layout->addLayout(buttonLayout);
+
+    m_statusLabel = new QLabel(this);
+    layout->addWidget(m_statusLabel);
+}
+
+void ListSequenceEditor::appendRow(double value, double dwellMs)
+{
+    const int row = m_stepTable->rowCount();
+    m_stepTable->insertRow(row);
+    m_stepTable->setItem(row, 0, new QTableWidgetItem(QString::number(value)));
+    m_stepTable->setItem(row, 1, new QTableWidgetItem(QString::number(dwellMs)));
+}
+
+void ListSequenceEditor::addStep()
+{
+    if (m_stepTable->rowCount() >= EleLoad_ITPlus::MaxListSteps) {
+        return;
+    }
+    // 默认复制上一步
+    const int last = m_stepTable->rowCount() - 1;
+    if (last >= 0) {
+        appendRow(m_stepTable->item(last, 0)->text().toDouble(), m_stepTable->item(last, 1)->text().toDouble());
+    } else {
+        appendRow(0.0, 1.0);
+    }
+    m_runBtn->setEnabled(false);    // 步骤已修改，需要重新上传
+}
+
+void ListSequenceEditor::removeStep()
+{
+    int row = m_stepTable->currentRow();
+    if (row < 0) {
+        row = m_stepTable->rowCount() - 1;
+    }
+    if (row >= 0) {
+        m_stepTable->removeRow(row);
+        m_runBtn->setEnabled(false);
+    }
+}
+
+EleLoad_ITPlus::Mode ListSequenceEditor::currentMode() const
+{
+    return EleLoad_ITPlus::Mode(m_modeCombo->currentData().toInt());
+}
+
+bool ListSequenceEditor::readSteps(QVector<EleLoad_ITPlus::ListStep> &steps, QString &error) const
+{
+    steps.clear();
+    for (int row = 0; row < m_stepTable->rowCount(); ++row) {
+        bool valueOk = false;
+        bool dwellOk = false;
+        const QTableWidgetItem *valueItem = m_stepTable->item(row, 0);
+        const QTableWidgetItem *dwellItem = m_stepTable->item(row, 1);
+        const float value = valueItem ? valueItem->text().toFloat(&valueOk) : 0.0f;
+        const float dwell = dwellItem ? dwellItem->text().toFloat(&dwellOk) : 0.0f;
+        if (!valueOk || !dwellOk) {
+            error = QString("第 %1 步不是有效数字").arg(row + 1);
+            return false;
+        }
+        steps.append({value, dwell});
+    }
+    return true;
+}
+
+void ListSequenceEditor::uploadProgram()
+{
+    QVector<EleLoad_ITPlus::ListStep> steps;
+    QString error;
+    if (!readSteps(steps, error)) {
+        m_statusLabel->setText(error);
+        m_statusLabel->setStyleSheet("QLabel { color: red; }");
+        return;
+    }
+    if (!m_serial->isConnected()) {
+        m_statusLabel->setText("电子负载未连接");
+        return;
+    }
+
+    const QVector<QByteArray> commands = m_protocol->createListProgram(currentMode(), steps, m_repeatSpinBox->value());
+    if (commands.isEmpty()) {
+        m_statusLabel->setText(QString("步骤数或参数超出范围（展开后 2 ~ %1 步，驻留 0.1 ~ 6553.5 ms）")
+                               .arg(EleLoad_ITPlus::MaxListSteps));
+        m_statusLabel->setStyleSheet("QLabel { color: red; }");
+        return;
+    }
+    m_statusLabel->setStyleSheet(QString());
+    m_runBtn->setEnabled(false);
+    emit uploadingChanged(true);
+    if (m_uploader->upload(commands)) {
+        m_uploadBtn->setEnabled(false);
+    } else {
+        emit uploadingChanged(false);
+    }
+}
+
+// 打开输入后发送总线触发，之后由仪器执行整个序列
+void ListSequenceEditor::runProgram()
+{
+    if (!m_serial->isConnected()) {
+        return;
+    }
+    m_serial->writeData(m_protocol->createLoadStateCommand(1));
+    m_serial->writeData(m_protocol->createBusTriggerSignal());
+}
+
+void ListSequenceEditor::stopProgram()
+{
+    m_uploader->cancel();
+    if (m_serial->isConnected()) {
+        m_serial->writeData(m_protocol->createLoadStateCommand(0));
+    }
+}
+
+QJsonObject ListSequenceEditor::saveSettings() const
+{
+    QJsonArray steps;
+    for (int row = 0; row < m_stepTable->rowCount(); ++row) {
+        steps.append(QJsonArray{ m_stepTable->item(row, 0)->text().toDouble(),
+                                 m_stepTable->item(row, 1)->text().toDouble() });
+    }
+    QJsonObject settings;
+    settings["mode"] = m_modeCombo->currentIndex();
+    settings["repeat"] = m_repeatSpinBox->value();
+    settings["steps"] = steps;
+    return settings;
+}
+
+void ListSequenceEditor::loadSettings(const QJsonObject &settings)
+{
+    const QJsonArray steps = settings["steps"].toArray();
+    if (steps.isEmpty()) {
+        return;
+    }
+    m_modeCombo->setCurrentIndex(settings["mode"].toInt());
+    m_repeatSpinBox->setValue(settings["repeat"].toInt(1));
+    m_stepTable->setRowCount(0);
+    for (const QJsonValue &step : steps) {
+        const QJsonArray pair = step.toArray();
+        appendRow(pair.at(0).toDouble(), pair.at(1).toDouble());
+    }
+    m_runBtn->setEnabled(false);
+}
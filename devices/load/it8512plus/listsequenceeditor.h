@@ -0,0 +1,65 @@
+#ifndef LISTSEQUENCEEDITOR_H
+#define LISTSEQUENCEEDITOR_H
+
+#include <QGroupBox>
+#include <QJsonObject>
+#include "communication/eleload_itplus.h"
+#include "listuploader.h"
+
+class QComboBox;
+class QSpinBox;
+class QTableWidget;
+class QPushButton;
+class QLabel;
+class SerialUtil;
+
+/**
+ * IT8512+ LIST 序列编辑
+    编辑步骤表（设定值、驻留时间），一次上传到仪器，用总线触发启动
+    步骤由仪器按自身时钟执行，驻留时间分辨率0.1ms
+ */
+class ListSequenceEditor : public QGroupBox
+{
+    Q_OBJECT
+public:
+    ListSequenceEditor(SerialUtil *serial, EleLoad_ITPlus *protocol, QWidget *parent = nullptr);
+
+    bool isUploading() const { return m_uploader->isBusy(); }
+    void cancelUpload() { m_uploader->cancel(); }   // 串口断开时调用，不发送任何命令
+
+    QJsonObject saveSettings() const;
+    void loadSettings(const QJsonObject &settings);
+
+signals:
+    // 上传期间仪器对每条 LIST 命令只回 0x12 状态，不带命令码，其他设置命令必须暂停
+    void uploadingChanged(bool uploading);
+
+private slots:
+    void addStep();
+    void removeStep();
+    void uploadProgram();
+    void runProgram();
+    void stopProgram();
+
+private:
+    void setupUi();
+    void appendRow(double value, double dwellMs);
+    EleLoad_ITPlus::Mode currentMode() const;
+    bool readSteps(QVector<EleLoad_ITPlus::ListStep> &steps, QString &error) const;
+
+    SerialUtil *m_serial;
+    EleLoad_ITPlus *m_protocol;
+    ListUploader *m_uploader;
+
+    QComboBox *m_modeCombo;
+    QSpinBox *m_repeatSpinBox;
+    QTableWidget *m_stepTable;
+    QPushButton *m_addBtn;
+    QPushButton *m_removeBtn;
+    QPushButton *m_uploadBtn;
+    QPushButton *m_runBtn;
+    QPushButton *m_stopBtn;
+    QLabel *m_statusLabel;
+};
+
+#endif // LISTSEQUENCEEDITOR_H
@@ -0,0 +1,109 @@
+#include "listuploader.h"
+#include "serial/serialutil.h"
+#include "util/errorhandler.h"
+
+namespace {
+    const int RESPONSE_TIMEOUT_MS = 500;
+    const int MAX_RETRIES = 1;
+
+    QString setResultText(uint8_t status)
+    {
+        switch (status) {
+        case 0x90: return "校验和错误";
+        case 0xA0: return "设置参数错误或参数溢出";
+        case 0xB0: return "命令不能被执行";
+        case 0xC0: return "命令是无效的";
+        case 0xD0: return "命令是未知的";
+        default: return QString("错误码0x%1").arg(status, 2, 16, QChar('0'));
+        }
+    }
+}
+
+ListUploader::ListUploader(SerialUtil *serial, EleLoad_ITPlus *protocol, QObject *parent)
+    : QObject(parent)
+    , m_serial(serial)
+    , m_protocol(protocol)
+{
+    m_timeout.setSingleShot(true);
+    m_timeout.setInterval(RESPONSE_TIMEOUT_MS);
+    connect(&m_timeout, &QTimer::timeout, this, &ListUploader::onTimeout);
+    connect(m_protocol, &EleLoad_ITPlus::setResponseReceived, this, &ListUploader::onSetResponse);
+}
+
+bool ListUploader::upload(const QVector<QByteArray> &commands)
+{
+    if (isBusy() || commands.isEmpty() || !m_serial->isConnected()) {
+        return false;
+    }
+    m_commands = commands;
+    m_index = 0;
+    m_retries = 0;
+    emit progress(0, m_commands.size());
+    sendCurrent();
+    return true;
+}
+
+void ListUploader::cancel()
+{
+    if (isBusy()) {
+        finish(false, "上传已取消");
+    }
+}
+
+void ListUploader::sendCurrent()
+{
+    if (!m_serial->writeData(m_commands.at(m_index))) {
+        finish(false, "串口写入失败");
+        return;
+    }
+    m_timeout.start();
+}
+
+void ListUploader::onSetResponse(uint8_t status)
+{
+    if (!isBusy()) {
+        return;
+    }
+    m_timeout.stop();
+
+    if (status != 0x80) {
+        finish(false, QString("第 %1/%2 条命令失败: %3")
+               .arg(m_index + 1).arg(m_commands.size()).arg(setResultText(status)));
+        return;
+    }
+
+    ++m_index;
+    m_retries = 0;
+    emit progress(m_index, m_commands.size());
+    if (m_index >= m_commands.size()) {
+        finish(true, QString("LIST程序上传完成，共 %1 条命令").arg(m_commands.size()));
+        return;
+    }
+    sendCurrent();
+}
+
+void ListUploader::onTimeout()
+{
+    if (!isBusy()) {
+        return;
+    }
+    if (m_retries < MAX_RETRIES && m_serial->isConnected()) {
+        ++m_retries;
+        sendCurrent();
+        return;
+    }
+    finish(false, QString("第 %1/%2 条命令无响应").arg(m_index + 1).arg(m_commands.size()));
+}
+
+void ListUploader::finish(bool ok, const QString &message)
+{
+    m_timeout.stop();
+    m_index = -1;
+    m_commands.clear();
+    if (ok) {
+        LOG_INFO(message);
+    } else {
+        LOG_WARNING("LIST程序上传失败: " + message);
+    }
+    emit finished(ok, message);
+}
@@ -0,0 +1,45 @@
+#ifndef LISTUPLOADER_H
+#define LISTUPLOADER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include "communication/eleload_itplus.h"
+
+class SerialUtil;
+
+/**
+ * IT8512+ LIST 程序上传
+    依次发送 EleLoad_ITPlus::createListProgram 生成的命令，每条等待设置响应（0x12）后再发下一条，
+    仪器返回错误码时停止；超时重发一次
+    上传完成后由 createBusTriggerSignal 启动，步骤切换由仪器自身计时，不受串口和界面定时器影响
+ */
+class ListUploader : public QObject
+{
+    Q_OBJECT
+public:
+    ListUploader(SerialUtil *serial, EleLoad_ITPlus *protocol, QObject *parent = nullptr);
+
+    bool upload(const QVector<QByteArray> &commands);  // 正在上传或命令为空时返回false
+    void cancel();
+    bool isBusy() const { return m_index >= 0; }
+
+signals:
+    void progress(int done, int total);
+    void finished(bool ok, const QString &message);
+
+private:
+    void sendCurrent();
+    void onSetResponse(uint8_t status);
+    void onTimeout();
+    void finish(bool ok, const QString &message);
+
+    SerialUtil *m_serial;
+    EleLoad_ITPlus *m_protocol;
+    QVector<QByteArray> m_commands;
+    int m_index = -1;       // 当前等待响应的命令，-1 表示空闲
+    int m_retries = 0;
+    QTimer m_timeout;
+};
+
+#endif // LISTUPLOADER_H
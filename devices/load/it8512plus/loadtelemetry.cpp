@@ -0,0 +1,220 @@
+#include "loadtelemetry.h"
+#include "serial/serialutil.h"
+#include "util/config.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+#include "util/steadyclock.h"
+#include <cmath>
+
+using SteadyClock::toMs;
+
+LoadTelemetry::LoadTelemetry(SerialUtil *serial, EleLoad_ITPlus *protocol, QObject *parent)
+    : QObject(parent)
+    , m_serial(serial)
+    , m_protocol(protocol)
+    , m_pollCommand(protocol->createGetInputCommand())
+{
+    m_pollTimer.setSingleShot(true);
+    m_pollTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_pollTimer, &QTimer::timeout, this, &LoadTelemetry::poll);
+
+    m_timeoutTimer.setSingleShot(true);
+    m_timeoutTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timeoutTimer, &QTimer::timeout, this, &LoadTelemetry::onTimeout);
+
+    m_reportTimer.setInterval(1000);
+    connect(&m_reportTimer, &QTimer::timeout, this, &LoadTelemetry::report);
+
+    connect(m_protocol, &EleLoad_ITPlus::inputParamsReceived, this, &LoadTelemetry::onInputParams);
+}
+
+void LoadTelemetry::setMinInterval(int ms)
+{
+    m_minInterval = std::chrono::milliseconds(qMax(0, ms));
+}
+
+void LoadTelemetry::setPipelineDepth(int depth)
+{
+    m_depth = qBound(1, depth, 4);
+}
+
+void LoadTelemetry::setTimeout(int ms)
+{
+    m_timeout = std::chrono::milliseconds(qMax(10, ms));
+}
+
+void LoadTelemetry::start()
+{
+    setMinInterval(Config::getValue(ConfigKeys::ELOAD_TELEMETRY_INTERVAL, 0).toInt());
+    setPipelineDepth(Config::getValue(ConfigKeys::ELOAD_TELEMETRY_PIPELINE, 1).toInt());
+    setTimeout(Config::getValue(ConfigKeys::ELOAD_TELEMETRY_TIMEOUT, 200).toInt());
+
+    m_outstanding.clear();
+    m_hasSample = false;
+    m_freshPending = false;
+    m_window = Window();
+    m_window.start = Clock::now();
+    m_total = m_window;
+    m_running = true;
+
+    m_reportTimer.start();
+    poll();
+}
+
+void LoadTelemetry::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    m_pollTimer.stop();
+    m_timeoutTimer.stop();
+    m_reportTimer.stop();
+    m_outstanding.clear();
+    m_freshPending = false;
+
+    Statistics total = totalStatistics();
+    LOG_INFO(QString("负载遥测结束: %1 个样本，%2 Hz，间隔抖动 %3 ms，最大间隔 %4 ms，应答 %5 ms，丢失 %6")
+             .arg(total.samples)
+             .arg(total.rateHz, 0, 'f', 1)
+             .arg(total.jitterMs, 0, 'f', 2)
+             .arg(total.maxIntervalMs, 0, 'f', 1)
+             .arg(total.turnaroundMs, 0, 'f', 2)
+             .arg(total.missed));
+}
+
+bool LoadTelemetry::requestSample()
+{
+    if (!m_running) {
+        return false;
+    }
+    m_freshAfter = Clock::now();
+    m_freshPending = true;
+    poll();     // 流水线未满时立即补发查询
+    return true;
+}
+
+LoadTelemetry::Statistics LoadTelemetry::totalStatistics() const
+{
+    return summarize(m_total, Clock::now());
+}
+
+// 补足流水线中的查询
+void LoadTelemetry::poll()
+{
+    if (!m_running) {
+        return;
+    }
+    if (!m_serial->isConnected()) {
+        stop();
+        return;
+    }
+
+    while (m_outstanding.size() < m_depth) {
+        const Clock::time_point now = Clock::now();
+        if (m_minInterval.count() > 0) {
+            const Clock::duration wait = m_lastPoll + m_minInterval - now;
+            if (wait.count() > 0) {
+                m_pollTimer.start(int(std::ceil(toMs(wait))));
+                break;
+            }
+        }
+        if (!m_serial->writeData(m_pollCommand)) {
+            break;
+        }
+        m_outstanding.enqueue(now);
+        m_lastPoll = now;
+    }
+    armTimeout();
+}
+
+void LoadTelemetry::onInputParams(const EleLoad_ITPlus::InputParams &params)
+{
+    // 不是本调度器发出的查询（未启动或界面单独查询）
+    if (!m_running || m_outstanding.isEmpty()) {
+        return;
+    }
+
+    const Clock::time_point sent = m_outstanding.dequeue();
+    const double turnaround = toMs(params.time - sent);
+    for (Window *w : {&m_window, &m_total}) {
+        ++w->samples;
+        w->sumTurnaround += turnaround;
+    }
+
+    if (m_hasSample) {
+        const double interval = toMs(params.time - m_lastSample);
+        for (Window *w : {&m_window, &m_total}) {
+            ++w->intervals;
+            w->sumInterval += interval;
+            w->sumSqInterval += interval * interval;
+            w->maxInterval = qMax(w->maxInterval, interval);
+        }
+    }
+    m_lastSample = params.time;
+    m_hasSample = true;
+
+    emit sampleReceived(params);
+    if (m_freshPending && sent >= m_freshAfter) {
+        m_freshPending = false;
+        emit freshSample(params);
+    }
+    poll();
+}
+
+// 最早的查询超时未应答，记为丢失后补发
+void LoadTelemetry::onTimeout()
+{
+    const Clock::time_point now = Clock::now();
+    while (!m_outstanding.isEmpty() && now - m_outstanding.head() >= m_timeout) {
+        m_outstanding.dequeue();
+        ++m_window.missed;
+        ++m_total.missed;
+    }
+    LD_DEBUG(lcLoad) << "遥测查询超时，未应答" << m_outstanding.size();
+    poll();
+}
+
+void LoadTelemetry::armTimeout()
+{
+    if (m_outstanding.isEmpty()) {
+        m_timeoutTimer.stop();
+        return;
+    }
+    const Clock::duration remaining = m_outstanding.head() + m_timeout - Clock::now();
+    m_timeoutTimer.start(qMax(0, int(std::ceil(toMs(remaining)))));
+}
+
+void LoadTelemetry::report()
+{
+    const Clock::time_point now = Clock::now();
+    Statistics stats = summarize(m_window, now);
+    LD_DEBUG(lcLoad) << "遥测" << stats.rateHz << "Hz 抖动" << stats.jitterMs
+                     << "ms 应答" << stats.turnaroundMs << "ms 丢失" << stats.missed;
+    emit statisticsUpdated(stats);
+
+    m_window = Window();
+    m_window.start = now;
+}
+
+LoadTelemetry::Statistics LoadTelemetry::summarize(const Window &window, Clock::time_point end)
+{
+    Statistics stats;
+    stats.samples = window.samples;
+    stats.missed = window.missed;
+
+    const double elapsedMs = toMs(end - window.start);
+    if (elapsedMs > 0) {
+        stats.rateHz = double(window.samples) * 1000.0 / elapsedMs;
+    }
+    if (window.samples > 0) {
+        stats.turnaroundMs = window.sumTurnaround / double(window.samples);
+    }
+    if (window.intervals > 0) {
+        const double n = double(window.intervals);
+        stats.meanIntervalMs = window.sumInterval / n;
+        stats.jitterMs = std::sqrt(qMax(0.0, window.sumSqInterval / n - stats.meanIntervalMs * stats.meanIntervalMs));
+        stats.maxIntervalMs = window.maxInterval;
+    }
+    return stats;
+}
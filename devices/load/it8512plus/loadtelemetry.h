@@ -0,0 +1,104 @@
+#ifndef LOADTELEMETRY_H
+#define LOADTELEMETRY_H
+
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+#include <chrono>
+#include "communication/eleload_itplus.h"
+
+class SerialUtil;
+
+/**
+ * IT8512+ 遥测调度
+    连续发送读取输入参数命令（0x5F），收到应答后立即发出下一次查询，
+    采样率只受仪器应答时间限制；可设置最小间隔限速
+    同时未应答的查询数可配置（流水线深度），大于1时可以掩盖USB串口的往返延迟
+    查询直接写串口，不经过 SerialUtil 的50ms发送队列
+    每个样本的时间戳取接收时刻的单调时钟（InputParams::time）
+    每秒统计一次采样率、采样间隔抖动、应答时间和超时丢失的查询
+    requestSample()：取一个在调用之后才发出的查询的应答（freshSample），
+      用于需要"某一时刻之后"的负载读数的流程，不额外插入查询
+ */
+class LoadTelemetry : public QObject
+{
+    Q_OBJECT
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Statistics {
+        double rateHz = 0;          // 实际采样率
+        double meanIntervalMs = 0;  // 平均采样间隔
+        double jitterMs = 0;        // 采样间隔标准差
+        double maxIntervalMs = 0;   // 最大采样间隔
+        double turnaroundMs = 0;    // 平均应答时间（发送到接收）
+        quint64 samples = 0;
+        quint64 missed = 0;         // 超时未应答的查询
+    };
+
+    LoadTelemetry(SerialUtil *serial, EleLoad_ITPlus *protocol, QObject *parent = nullptr);
+
+    void start();       // 按配置开始轮询
+    void stop();
+    bool isRunning() const { return m_running; }
+    bool requestSample();   // 未启动时返回false
+
+
+    void setMinInterval(int ms);
+    void setPipelineDepth(int depth);
+    void setTimeout(int ms);
+
+    Statistics totalStatistics() const;     // 本次启动以来的统计
+
+signals:
+    void sampleReceived(const EleLoad_ITPlus::InputParams &params);
+    void freshSample(const EleLoad_ITPlus::InputParams &params);      // requestSample() 请求的样本
+    void statisticsUpdated(const LoadTelemetry::Statistics &stats);    // 最近一秒的统计
+
+private slots:
+    void poll();
+    void onInputParams(const EleLoad_ITPlus::InputParams &params);
+    void onTimeout();
+    void report();
+
+private:
+    // 一个统计窗口内的累计值
+    struct Window {
+        Clock::time_point start;
+        quint64 samples = 0;
+        quint64 missed = 0;
+        quint64 intervals = 0;
+        double sumInterval = 0;
+        double sumSqInterval = 0;
+        double maxInterval = 0;
+        double sumTurnaround = 0;
+    };
+
+    void armTimeout();
+    static Statistics summarize(const Window &window, Clock::time_point end);
+
+    SerialUtil *m_serial;
+    EleLoad_ITPlus *m_protocol;
+    QByteArray m_pollCommand;
+
+    QTimer m_pollTimer;         // 最小间隔限速
+    QTimer m_timeoutTimer;      // 最早一次未应答查询的超时
+    QTimer m_reportTimer;
+
+    bool m_running = false;
+    Clock::duration m_minInterval{0};
+    Clock::duration m_timeout{std::chrono::milliseconds(200)};
+    int m_depth = 1;
+
+    QQueue<Clock::time_point> m_outstanding;    // 未应答查询的发送时刻
+    Clock::time_point m_lastPoll;
+    Clock::time_point m_lastSample;
+    bool m_hasSample = false;
+    bool m_freshPending = false;
+    Clock::time_point m_freshAfter;             // 发送时刻不早于此的查询才算新样本
+
+    Window m_window;
+    Window m_total;
+};
+
+#endif // LOADTELEMETRY_H
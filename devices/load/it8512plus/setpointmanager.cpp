@@ -0,0 +1,229 @@
+#include "setpointmanager.h"
+#include "serial/serialutil.h"
+#include "util/config.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+#include "util/steadyclock.h"
+#include <cmath>
+
+SetpointManager::SetpointManager(SerialUtil *serial, EleLoad_ITPlus *protocol, QObject *parent)
+    : QObject(parent)
+    , m_serial(serial)
+    , m_protocol(protocol)
+{
+    setDebounce(Config::getValue(ConfigKeys::ELOAD_SETPOINT_DEBOUNCE, 150).toInt());
+
+    // 回读值
+    connect(m_protocol, &EleLoad_ITPlus::maxVoltageReceived, this, [this](float v) { onReadBack(0x23, {v}); });
+    connect(m_protocol, &EleLoad_ITPlus::maxCurrentReceived, this, [this](float v) { onReadBack(0x25, {v}); });
+    connect(m_protocol, &EleLoad_ITPlus::maxPowerReceived, this, [this](float v) { onReadBack(0x27, {v}); });
+    connect(m_protocol, &EleLoad_ITPlus::constantValueReceived,
+            this, [this](EleLoad_ITPlus::Mode mode, float value) {
+        static const QHash<int, uint8_t> codes = {
+            { int(EleLoad_ITPlus::Mode::CC), 0x2B }, { int(EleLoad_ITPlus::Mode::CV), 0x2D },
+            { int(EleLoad_ITPlus::Mode::CW), 0x2F }, { int(EleLoad_ITPlus::Mode::CR), 0x31 },
+        };
+        onReadBack(codes.value(int(mode)), {value});
+    });
+    connect(m_protocol, &EleLoad_ITPlus::dynamicParamsReceived,
+            this, [this](EleLoad_ITPlus::Mode mode, const EleLoad_ITPlus::DynamicParams &p) {
+        static const QHash<int, uint8_t> codes = {
+            { int(EleLoad_ITPlus::Mode::CC), 0x33 }, { int(EleLoad_ITPlus::Mode::CV), 0x35 },
+            { int(EleLoad_ITPlus::Mode::CW), 0x37 }, { int(EleLoad_ITPlus::Mode::CR), 0x39 },
+        };
+        onReadBack(codes.value(int(mode)), {p.valueA, p.timeA, p.valueB, p.timeB, float(p.mode)});
+    });
+}
+
+void SetpointManager::setDebounce(int ms)
+{
+    m_debounceMs = qMax(0, ms);
+}
+
+SetpointManager::Setpoint &SetpointManager::setpoint(uint8_t readCode)
+{
+    Setpoint &sp = m_setpoints[readCode];
+    if (!sp.debounce) {
+        sp.debounce = new QTimer(this);
+        sp.debounce->setSingleShot(true);
+        connect(sp.debounce, &QTimer::timeout, this, [this, readCode]() { send(readCode); });
+
+        sp.timeout = new QTimer(this);
+        sp.timeout->setSingleShot(true);
+        connect(sp.timeout, &QTimer::timeout, this, [this, readCode]() { onTimeout(readCode); });
+    }
+    return sp;
+}
+
+void SetpointManager::submit(uint8_t readCode, const QByteArray &setCommand, const QByteArray &readCommand,
+                             const QVector<float> &expected)
+{
+    Setpoint &sp = setpoint(readCode);
+    sp.setCommand = setCommand;
+    sp.readCommand = readCommand;
+    sp.expected = expected;
+    sp.dirty = true;
+    ++m_stats.edits;
+
+    // 重新开始防抖计时；正在等待回读时由回读完成后发送
+    if (!sp.awaiting) {
+        sp.debounce->start(m_debounceMs);
+    }
+}
+
+void SetpointManager::clear()
+{
+    m_replayQueue.clear();
+    for (Setpoint &sp : m_setpoints) {
+        sp.dirty = false;
+        sp.awaiting = false;
+        sp.debounce->stop();
+        sp.timeout->stop();
+    }
+}
+
+void SetpointManager::setHeld(bool held)
+{
+    if (m_held == held) {
+        return;
+    }
+    m_held = held;
+    if (held) {
+        return;
+    }
+    for (Setpoint &sp : m_setpoints) {
+        if (sp.dirty && !sp.awaiting) {
+            sp.debounce->start(m_debounceMs);
+        }
+    }
+}
+
+void SetpointManager::replay()
+{
+    m_replayQueue.clear();
+    m_replayConfirmed = true;
+    for (auto it = m_setpoints.begin(); it != m_setpoints.end(); ++it) {
+        if (it->setCommand.isEmpty()) {
+            continue;
+        }
+        it->dirty = false;
+        it->awaiting = false;
+        it->debounce->stop();
+        it->timeout->stop();
+        m_replayQueue.append(it.key());
+    }
+    replayNext();
+}
+
+void SetpointManager::replayNext()
+{
+    while (!m_replayQueue.isEmpty()) {
+        const uint8_t readCode = m_replayQueue.first();
+        Setpoint &sp = setpoint(readCode);
+        sp.dirty = true;
+        send(readCode);
+        if (sp.awaiting) {
+            return;     // 回读或超时后继续
+        }
+        // 串口写入失败
+        sp.dirty = false;
+        m_replayConfirmed = false;
+        m_replayQueue.removeFirst();
+    }
+    emit replayFinished(m_replayConfirmed);
+}
+
+void SetpointManager::advanceReplay(uint8_t readCode, bool confirmed)
+{
+    if (m_replayQueue.isEmpty() || m_replayQueue.first() != readCode) {
+        return;
+    }
+    m_replayQueue.removeFirst();
+    m_replayConfirmed = m_replayConfirmed && confirmed;
+    replayNext();
+}
+
+void SetpointManager::send(uint8_t readCode)
+{
+    Setpoint &sp = setpoint(readCode);
+    if (!sp.dirty || sp.awaiting || m_held || !m_serial->isConnected()) {
+        return;
+    }
+    if (!m_serial->writeData(sp.setCommand) || !m_serial->writeData(sp.readCommand)) {
+        return;
+    }
+
+    sp.dirty = false;
+    sp.awaiting = true;
+    sp.sentExpected = sp.expected;
+    sp.sentAt = Clock::now();
+    sp.timeout->start(m_timeoutMs);
+    ++m_stats.writes;
+    emit statisticsChanged();
+}
+
+void SetpointManager::onReadBack(uint8_t readCode, const QVector<float> &actual)
+{
+    auto it = m_setpoints.find(readCode);
+    if (it == m_setpoints.end() || !it->awaiting) {
+        return;     // 不是本管理器发出的读取（如切换模式时界面读取当前值）
+    }
+    Setpoint &sp = *it;
+    sp.awaiting = false;
+    sp.timeout->stop();
+
+    const bool confirmed = matches(sp.sentExpected, actual);
+    if (confirmed) {
+        const double latency = SteadyClock::toMs(Clock::now() - sp.sentAt);
+        ++m_stats.confirmed;
+        m_latencySum += latency;
+        m_stats.meanLatencyMs = m_latencySum / double(m_stats.confirmed);
+        m_stats.maxLatencyMs = qMax(m_stats.maxLatencyMs, latency);
+        LD_DEBUG(lcLoad) << "设定值" << QString("0x%1").arg(readCode, 2, 16, QChar('0'))
+                         << "确认，延迟" << latency << "ms";
+        emit setpointConfirmed(readCode, latency);
+    } else {
+        ++m_stats.mismatched;
+        LOG_WARNING(QString("设定值回读不一致 0x%1").arg(readCode, 2, 16, QChar('0')));
+        emit setpointMismatch(readCode, sp.sentExpected, actual);
+    }
+    emit statisticsChanged();
+
+    // 等待期间又有新的修改
+    if (sp.dirty) {
+        sp.debounce->start(m_debounceMs);
+    }
+    advanceReplay(readCode, confirmed);
+}
+
+void SetpointManager::onTimeout(uint8_t readCode)
+{
+    Setpoint &sp = setpoint(readCode);
+    if (!sp.awaiting) {
+        return;
+    }
+    sp.awaiting = false;
+    ++m_stats.timedOut;
+    LOG_WARNING(QString("设定值回读超时 0x%1").arg(readCode, 2, 16, QChar('0')));
+    emit statisticsChanged();
+
+    if (sp.dirty) {
+        sp.debounce->start(m_debounceMs);
+    }
+    advanceReplay(readCode, false);
+}
+
+// 按仪器分辨率比较：允许 1e-3 的绝对误差和 1e-4 的相对误差（浮点数转整数时截断）
+bool SetpointManager::matches(const QVector<float> &expected, const QVector<float> &actual)
+{
+    if (expected.size() != actual.size()) {
+        return false;
+    }
+    for (int i = 0; i < expected.size(); ++i) {
+        const double tolerance = 1e-3 + 1e-4 * std::fabs(expected.at(i));
+        if (std::fabs(double(expected.at(i)) - double(actual.at(i))) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
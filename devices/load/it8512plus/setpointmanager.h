@@ -0,0 +1,93 @@
+#ifndef SETPOINTMANAGER_H
+#define SETPOINTMANAGER_H
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <QList>
+#include <QVector>
+#include <chrono>
+#include "communication/eleload_itplus.h"
+
+class SerialUtil;
+
+/**
+ * IT8512+ 设定值写入管理
+    界面上连续修改同一个设定值时（如拖动微调框），在防抖窗口内只保留最后一次，
+    窗口结束后发送一条设置命令，紧接着发送一条对应的读取命令校验回读值
+    设定值以读取命令的功能码区分（0x23 最大电压、0x2B CC 定值、0x33 动态电流参数等）
+    同一设定值的上一次写入还在等待回读时，新的修改在回读完成后再发送
+    暂停期间（setHeld）只记录修改，解除暂停后再发送
+    统计确认延迟（发送设置命令到回读一致）、回读不一致和回读超时次数
+ */
+class SetpointManager : public QObject
+{
+    Q_OBJECT
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Statistics {
+        quint64 edits = 0;          // 界面提交的修改
+        quint64 writes = 0;         // 实际发送的设置命令
+        quint64 confirmed = 0;      // 回读一致
+        quint64 mismatched = 0;     // 回读不一致
+        quint64 timedOut = 0;       // 回读超时
+        double meanLatencyMs = 0;   // 平均确认延迟
+        double maxLatencyMs = 0;
+    };
+
+    SetpointManager(SerialUtil *serial, EleLoad_ITPlus *protocol, QObject *parent = nullptr);
+
+    // 提交一次修改；expected 为回读时应得到的值（定值/最大值1个，动态参数依次为 A值 A时间 B值 B时间 模式）
+    void submit(uint8_t readCode, const QByteArray &setCommand, const QByteArray &readCommand,
+                const QVector<float> &expected);
+    void clear();       // 丢弃所有未发送和等待回读的修改（断开连接时调用）
+    // 逐个重新发送每个设定值最近一次的设置命令，上一个回读（或超时）后才发送下一个，
+    // 全部完成后发出 replayFinished（自动重连后恢复设备状态）
+    void replay();
+    // 暂停发送：期间的修改保留为未发送，解除后统一发送（LIST 上传期间仪器的设置应答不能混入其他命令）
+    void setHeld(bool held);
+
+    void setDebounce(int ms);
+    const Statistics &statistics() const { return m_stats; }
+
+signals:
+    void setpointConfirmed(uint8_t readCode, double latencyMs);
+    void setpointMismatch(uint8_t readCode, const QVector<float> &expected, const QVector<float> &actual);
+    void statisticsChanged();
+    void replayFinished(bool confirmed);    // confirmed: 全部回读一致
+
+private:
+    struct Setpoint {
+        QByteArray setCommand;
+        QByteArray readCommand;
+        QVector<float> expected;
+        bool dirty = false;             // 有尚未发送的修改
+        bool awaiting = false;          // 已发送，等待回读
+        QVector<float> sentExpected;    // 已发送那次修改的期望值
+        Clock::time_point sentAt;
+        QTimer *debounce = nullptr;
+        QTimer *timeout = nullptr;
+    };
+
+    Setpoint &setpoint(uint8_t readCode);
+    void send(uint8_t readCode);
+    void onReadBack(uint8_t readCode, const QVector<float> &actual);
+    void onTimeout(uint8_t readCode);
+    void replayNext();
+    void advanceReplay(uint8_t readCode, bool confirmed);
+    static bool matches(const QVector<float> &expected, const QVector<float> &actual);
+
+    SerialUtil *m_serial;
+    EleLoad_ITPlus *m_protocol;
+    QHash<uint8_t, Setpoint> m_setpoints;
+    int m_debounceMs = 150;
+    int m_timeoutMs = 500;
+    Statistics m_stats;
+    double m_latencySum = 0;
+    QList<uint8_t> m_replayQueue;   // 等待重放的设定值，队首为正在等待回读的一个
+    bool m_replayConfirmed = true;
+    bool m_held = false;
+};
+
+#endif // SETPOINTMANAGER_H
@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include "../../serial/serialutil.h"
+#include "util/devicestate.h"
 
 class LoadBase : public QWidget
 {
@@ -16,12 +17,22 @@ public:
     virtual bool isConnected() const = 0;
     virtual QJsonObject saveSettings() const = 0;
     virtual void loadSettings(const QJsonObject &settings) = 0;
+    // 负载状态快照（任意线程可读），不支持时返回 nullptr
+    virtual const DeviceState<LoadState> *state() const { return nullptr; }
+    // 请求一个在调用之后才读取的输入参数样本，收到后发出 sampleAcquired；不支持或未连接时返回 false
+    virtual bool requestSample() { return false; }
+    // 供自动化流程设置基础模式（0 CC, 1 CV, 2 CW, 3 CR）和定值、输入开关，界面同步显示；不支持或未连接时返回 false
+    virtual bool applyConstant(int mode, double value) { Q_UNUSED(mode) Q_UNUSED(value) return false; }
+    virtual bool setInputOn(bool on) { Q_UNUSED(on) return false; }
 
 signals:
     void serialConnected(const QString &portName);
     void serialDisconnected();
     void serialError(const QString &error);
-    void statusUpdated(float voltage, float current, float power);
+    void serialRecovering();                                            // 意外断开，正在自动重连
+    void serialRecovered(qint64 downtimeMs, int recoveries);            // 自动重连成功，设定值已重放
+    void statusUpdated(float voltage, float current, float power);     // 按界面刷新率发出
+    void sampleAcquired(const LoadState &state);                        // requestSample() 请求的样本
 
 protected:
     SerialUtil *m_serial = nullptr;
@@ -0,0 +1,459 @@
+#include "cl200aengine.h"
+#include "serial/serialutil.h"
+#include "util/config.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+#include "util/colorimetry.h"
+#include "util/steadyclock.h"
+#include <QVarLengthArray>
+
+using SteadyClock::toMs;
+
+namespace {
+    const int ReadTimeoutMs = 300;          // 单条读取命令的应答超时（9600bps，应答约35ms）
+    const int WaitStepMs = 50;              // 量程状态 '0' 时积分时间的增量
+    const int MaxIntegrationMs = 1500;
+
+    bool isMeasurementCode(const QString &code)
+    {
+        return code == "01" || code == "02" || code == "03" || code == "08" || code == "15" || code == "45";
+    }
+}
+
+CL200AEngine::CL200AEngine(SerialUtil *serial, CL_TwoZeroZeroACOM *protocol, QObject *parent)
+    : QObject(parent)
+    , m_serial(serial)
+    , m_protocol(protocol)
+    , m_codes({"01"})
+    , m_heads({0})
+    , m_lastRange(1, 0)
+{
+    qRegisterMetaType<CL200AEngine::Sample>("CL200AEngine::Sample");
+    qRegisterMetaType<QVector<CL200AEngine::Sample>>("QVector<CL200AEngine::Sample>");
+
+    m_phaseTimer.setSingleShot(true);
+    m_phaseTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_phaseTimer, &QTimer::timeout, this, [this]() {
+        if (m_phase == Phase::Integrating) {
+            readNext();
+        } else {
+            trigger();
+        }
+    });
+
+    m_timeoutTimer.setSingleShot(true);
+    m_timeoutTimer.setInterval(ReadTimeoutMs);
+    connect(&m_timeoutTimer, &QTimer::timeout, this, &CL200AEngine::onTimeout);
+
+    m_reportTimer.setInterval(1000);
+    connect(&m_reportTimer, &QTimer::timeout, this, &CL200AEngine::report);
+}
+
+void CL200AEngine::setMeasurementCodes(const QStringList &codes)
+{
+    QStringList valid;
+    for (const QString &code : codes) {
+        const QString trimmed = code.trimmed();
+        if (isMeasurementCode(trimmed) && !valid.contains(trimmed)) {
+            valid.append(trimmed);
+        }
+    }
+    if (valid.isEmpty()) {
+        LOG_WARNING("照度计测量命令无效，使用默认 01");
+        valid.append("01");
+    }
+    m_codes = valid;
+}
+
+void CL200AEngine::setHeads(const QVector<int> &heads)
+{
+    QVector<int> valid;
+    for (int head : heads) {
+        if (head >= 0 && head <= 29 && !valid.contains(head)) {
+            valid.append(head);
+        }
+    }
+    if (valid.isEmpty()) {
+        LOG_WARNING("照度计受光部编号无效，使用默认 0");
+        valid.append(0);
+    }
+    m_heads = valid;
+    m_lastRange.fill(0, m_heads.size());
+}
+
+quint8 CL200AEngine::headAddress(int head)
+{
+    return quint8(((head / 10) << 4) | (head % 10));
+}
+
+void CL200AEngine::setIntegrationTime(int ms)
+{
+    m_integrationMs = qBound(100, ms, MaxIntegrationMs);
+}
+
+void CL200AEngine::setRangeSettleTime(int ms)
+{
+    m_rangeSettleMs = qMax(0, ms);
+}
+
+void CL200AEngine::setMinInterval(int ms)
+{
+    m_minIntervalMs = qMax(0, ms);
+}
+
+void CL200AEngine::applyConfig()
+{
+    setIntegrationTime(Config::getValue(ConfigKeys::METER_INTEGRATION_MS, 500).toInt());
+    setRangeSettleTime(Config::getValue(ConfigKeys::METER_RANGE_SETTLE_MS, 300).toInt());
+    setMinInterval(Config::getValue(ConfigKeys::METER_MIN_INTERVAL_MS, 0).toInt());
+}
+
+void CL200AEngine::start()
+{
+    applyConfig();
+
+    m_single = false;
+    m_extraWaitMs = 0;
+    m_lastRange.fill(0, m_heads.size());
+    m_hasTrigger = false;
+    m_window = Window();
+    m_window.start = Clock::now();
+    m_total = m_window;
+    m_running = true;
+
+    m_reportTimer.start();
+    trigger();
+}
+
+// 单次测量：连续的单次测量之间沿用量程状态和积分等待，不做最小间隔限速
+bool CL200AEngine::triggerOnce()
+{
+    if (m_running) {
+        return false;
+    }
+    if (!m_single) {
+        applyConfig();
+        m_extraWaitMs = 0;
+        m_lastRange.fill(0, m_heads.size());
+        m_window = Window();
+        m_window.start = Clock::now();
+        m_total = m_window;
+    }
+    m_single = true;
+    m_hasTrigger = false;
+    m_running = true;
+    trigger();
+    return m_running;
+}
+
+void CL200AEngine::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    m_phase = Phase::Idle;
+    m_phaseTimer.stop();
+    m_timeoutTimer.stop();
+    m_reportTimer.stop();
+    if (m_single) {
+        return;
+    }
+
+    Statistics total = totalStatistics();
+    LOG_INFO(QString("照度计测量结束: %1 个样本，%2 Hz，周期 %3 ms（积分 %4 ms，读取 %5 ms），丢失 %6")
+             .arg(total.samples)
+             .arg(total.rateHz, 0, 'f', 2)
+             .arg(total.meanCycleMs, 0, 'f', 1)
+             .arg(total.waitMs, 0, 'f', 0)
+             .arg(total.readMs, 0, 'f', 1)
+             .arg(total.missed));
+}
+
+CL200AEngine::Statistics CL200AEngine::totalStatistics() const
+{
+    return summarize(m_total, Clock::now());
+}
+
+// 发送EXT测量命令，启动积分等待
+void CL200AEngine::trigger()
+{
+    if (!m_running) {
+        return;
+    }
+    if (!m_serial->isConnected()) {
+        stop();
+        return;
+    }
+
+    const Clock::time_point now = Clock::now();
+    if (m_hasTrigger && m_minIntervalMs > 0) {
+        const double remaining = m_minIntervalMs - toMs(now - m_lastTrigger);
+        if (remaining > 0) {
+            m_phase = Phase::Idle;
+            m_phaseTimer.start(int(remaining + 0.5));
+            return;
+        }
+    }
+
+    if (!m_serial->writeData(m_protocol->takeEXT40())) {
+        LOG_ERROR("发送 EXT 测量命令失败");
+        stop();
+        return;
+    }
+
+    if (m_hasTrigger) {
+        const double cycle = toMs(now - m_lastTrigger);
+        for (Window *w : {&m_window, &m_total}) {
+            ++w->cycles;
+            w->sumCycle += cycle;
+        }
+    }
+    m_lastTrigger = now;
+    m_hasTrigger = true;
+
+    m_samples.fill(Sample(), m_heads.size());
+    for (int i = 0; i < m_heads.size(); ++i) {
+        m_samples[i].head = m_heads.at(i);
+        m_samples[i].time = now;
+    }
+    m_readIndex = 0;
+    m_phase = Phase::Integrating;
+    m_phaseTimer.start(m_integrationMs + m_extraWaitMs);
+    m_extraWaitMs = 0;
+}
+
+// 发送下一条读取命令（按受光部顺序，每个受光部读取全部测量命令）；全部读完后结束本周期
+void CL200AEngine::readNext()
+{
+    if (!m_running) {
+        return;
+    }
+    if (m_readIndex == 0) {
+        m_readStart = Clock::now();
+    }
+    if (m_readIndex >= m_heads.size() * m_codes.size()) {
+        finishCycle(true);
+        return;
+    }
+
+    m_phase = Phase::Reading;
+    const int head = m_heads.at(m_readIndex / m_codes.size());
+    const QString &code = m_codes.at(m_readIndex % m_codes.size());
+    if (!m_serial->writeData(m_protocol->readMeasure(code, headAddress(head), '2', '0'))) {
+        LOG_ERROR("发送读取测量数据命令失败");
+        finishCycle(false);
+        return;
+    }
+    m_timeoutTimer.start();
+}
+
+bool CL200AEngine::handleFrame(const QByteArray &frame)
+{
+    if (!m_running || m_phase != Phase::Reading || frame.size() < 27) {
+        return false;
+    }
+
+    const QString &expected = m_codes.at(m_readIndex % m_codes.size());
+    CL_TwoZeroZeroACOM::MeasurementData data = expected == "45"
+            ? m_protocol->handleReceivedMeasurementDataSpecial(frame)
+            : m_protocol->handleReceivedMeasurementData(frame);
+    const int headIndex = m_readIndex / m_codes.size();
+    const int head = (frame.at(1) - '0') * 10 + (frame.at(2) - '0');
+    if (data.registerCode != expected || head != m_heads.at(headIndex)) {
+        return false;
+    }
+    m_timeoutTimer.stop();
+
+    if (data.err == '1' || data.err == '2' || data.err == '3') {
+        LOG_WARNING(QString("照度计受光部 %1 测量错误 %2，需要重启 CL-200A").arg(m_heads.at(headIndex)).arg(data.err));
+        finishCycle(false);
+        return true;
+    }
+
+    // 等待时间不足，加长积分等待
+    if (data.rng == '0' && m_integrationMs < MaxIntegrationMs) {
+        m_integrationMs = qMin(MaxIntegrationMs, m_integrationMs + WaitStepMs);
+        LD_DEBUG(lcMeter) << "照度计等待时间不足，积分等待调整为" << m_integrationMs << "ms";
+    }
+    // 量程切换或超量程，下一次多等待量程切换时间
+    char &lastRange = m_lastRange[headIndex];
+    if (data.rng == '6' || (lastRange != 0 && data.rng != lastRange)) {
+        m_extraWaitMs = m_rangeSettleMs;
+    }
+    lastRange = data.rng;
+
+    store(m_samples[headIndex], data);
+    ++m_readIndex;
+    readNext();
+    return true;
+}
+
+void CL200AEngine::store(Sample &sample, const CL_TwoZeroZeroACOM::MeasurementData &data)
+{
+    const QString &code = data.registerCode;
+    if (code == "01") {
+        sample.X = data.data1;
+        sample.Y = data.data2;
+        sample.Z = data.data3;
+    } else if (code == "02") {
+        sample.ev = data.data1;
+        sample.x = data.data2;
+        sample.y = data.data3;
+    } else if (code == "03") {
+        sample.ev = data.data1;
+        sample.u = data.data2;
+        sample.v = data.data3;
+    } else if (code == "08") {
+        sample.ev = data.data1;
+        sample.tcp = data.data2;
+        sample.duv = data.data3;
+    } else if (code == "15") {
+        sample.ev = data.data1;
+        sample.dominantWavelength = data.data2;
+        sample.purity = data.data3;
+    } else if (code == "45") {
+        sample.X2 = data.data1;
+        sample.Y = data.data2;
+        sample.Z = data.data3;
+    }
+    sample.codes.append(code);
+    sample.rangeStatus = data.rng;
+}
+
+// 读取了 XYZ（01）的受光部，本次没有读取的色度量由 XYZ 计算，全部受光部一次批量计算
+void CL200AEngine::deriveColorimetry(QVector<Sample> &samples)
+{
+    QVarLengthArray<int, 8> index;
+    QVarLengthArray<float, 8> X, Y, Z;
+    for (int i = 0; i < samples.size(); ++i) {
+        const Sample &sample = samples.at(i);
+        if (sample.codes.contains("01")) {
+            index.append(i);
+            X.append(sample.X);
+            Y.append(sample.Y);
+            Z.append(sample.Z);
+        }
+    }
+    if (index.isEmpty()) {
+        return;
+    }
+
+    QVarLengthArray<Colorimetry::Result, 8> results(index.size());
+    Colorimetry::fromXYZ(X.constData(), Y.constData(), Z.constData(), index.size(), results.data());
+
+    for (int k = 0; k < index.size(); ++k) {
+        Sample &sample = samples[index.at(k)];
+        const Colorimetry::Result &r = results.at(k);
+        const QStringList &codes = sample.codes;
+        if (!codes.contains("02") && !codes.contains("03") && !codes.contains("08") && !codes.contains("15")) {
+            sample.ev = sample.Y;       // CL-200A 的 Y 即照度（lx）
+        }
+        if (!codes.contains("02")) {
+            sample.x = r.x;
+            sample.y = r.y;
+        }
+        if (!codes.contains("03")) {
+            sample.u = r.u;
+            sample.v = r.v;
+        }
+        if (!codes.contains("08")) {
+            sample.tcp = r.cct;
+            sample.duv = r.duv;
+        }
+        if (!codes.contains("15")) {
+            sample.dominantWavelength = r.dominantWavelength;
+            sample.purity = r.purity;
+        }
+        sample.derived = true;
+    }
+}
+
+void CL200AEngine::finishCycle(bool ok)
+{
+    m_timeoutTimer.stop();
+    if (ok) {
+        const double read = toMs(Clock::now() - m_readStart);
+        for (Window *w : {&m_window, &m_total}) {
+            ++w->samples;
+            w->sumRead += read;
+        }
+        deriveColorimetry(m_samples);
+        const Sample &first = m_samples.first();
+        m_state.update([&first](MeterState &s) {
+            s.ev = first.ev;
+            s.X = first.X;
+            s.Y = first.Y;
+            s.Z = first.Z;
+            s.x = first.x;
+            s.y = first.y;
+            s.u = first.u;
+            s.v = first.v;
+            s.tcp = first.tcp;
+            s.duv = first.duv;
+            s.dominantWavelength = first.dominantWavelength;
+            s.purity = first.purity;
+            s.head = first.head;
+            s.rangeStatus = first.rangeStatus;
+            s.time = first.time;
+            ++s.samples;
+        });
+        emit sampleReceived(first);
+        emit triggerCompleted(m_samples);
+    } else {
+        ++m_window.missed;
+        ++m_total.missed;
+    }
+
+    if (m_single) {
+        m_running = false;
+        m_phase = Phase::Idle;
+        if (!ok) {
+            emit triggerFailed();
+        }
+        return;
+    }
+    trigger();
+}
+
+void CL200AEngine::onTimeout()
+{
+    if (m_phase != Phase::Reading) {
+        return;
+    }
+    LD_DEBUG(lcMeter) << "照度计读取超时，受光部" << m_heads.value(m_readIndex / m_codes.size())
+                      << m_codes.value(m_readIndex % m_codes.size());
+    finishCycle(false);
+}
+
+void CL200AEngine::report()
+{
+    const Clock::time_point now = Clock::now();
+    Statistics stats = summarize(m_window, now);
+    LD_DEBUG(lcMeter) << "照度计" << stats.rateHz << "Hz 周期" << stats.meanCycleMs
+                      << "ms 读取" << stats.readMs << "ms 丢失" << stats.missed;
+    emit statisticsUpdated(stats);
+
+    m_window = Window();
+    m_window.start = now;
+}
+
+CL200AEngine::Statistics CL200AEngine::summarize(const Window &window, Clock::time_point end) const
+{
+    Statistics stats;
+    stats.samples = window.samples;
+    stats.missed = window.missed;
+    stats.waitMs = m_integrationMs;
+
+    const double elapsedMs = toMs(end - window.start);
+    if (elapsedMs > 0) {
+        stats.rateHz = double(window.samples) * 1000.0 / elapsedMs;
+    }
+    if (window.cycles > 0) {
+        stats.meanCycleMs = window.sumCycle / double(window.cycles);
+    }
+    if (window.samples > 0) {
+        stats.readMs = window.sumRead / double(window.samples);
+    }
+    return stats;
+}
@@ -0,0 +1,153 @@
+#ifndef CL200AENGINE_H
+#define CL200AENGINE_H
+
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <chrono>
+#include "communication/cl_twozerozeroacom.h"
+#include "util/devicestate.h"
+
+class SerialUtil;
+
+/**
+ * CL-200A 测量循环
+    EXT测量（takeEXT40，无应答）-> 等待积分完成 -> 依次读取各测量命令 -> 下一次EXT测量
+    全部由定时器和应答驱动，不阻塞界面线程；读取命令之间不插入固定延时，收到应答立即发下一条
+    等待时间 = 积分时间 + 量程切换附加时间：
+      上一次应答的量程状态变化或超量程（rng '6'）时，下一次多等待一个量程切换时间
+      应答量程状态为 '0'（等待时间不足）时，积分时间自动增加 50ms，最多 1500ms
+    一次触发可读取多个测量命令（01 XYZ、02 Ev x y、03 Ev u' v'、08 Ev Tcp Δuv、15 Ev 主波长 纯度、45 X2 Y Z）
+    读取了 01 时，其余没有读取的量由 XYZ 在本地计算（util/colorimetry.h），默认每次触发只读 01
+    多受光部：EXT测量命令发给全部受光部（"99"），同时开始积分；之后按受光部顺序依次读取，
+      一次触发得到一组同步的测量值（triggerCompleted）
+    每秒统计一次实际采样率和周期，停止时写入日志
+    单次测量（triggerOnce）：只触发一次并读完全部受光部，然后回到空闲，用于由外部决定测量时刻的流程
+ */
+class CL200AEngine : public QObject
+{
+    Q_OBJECT
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Sample {
+        float X = 0, Y = 0, Z = 0;          // 01
+        float ev = 0, x = 0, y = 0;         // 02
+        float u = 0, v = 0;                 // 03 u' v'
+        float tcp = 0, duv = 0;             // 08
+        float dominantWavelength = 0;       // 15
+        float purity = 0;
+        float X2 = 0;                       // 45 X2 Y Z（特殊格式）
+        int head = 0;                       // 受光部编号 0~29
+        QStringList codes;                  // 本次成功读取的测量命令
+        bool derived = false;               // 未读取的色度量已由 XYZ（01）计算补齐
+        char rangeStatus = ' ';             // 最后一条应答的量程状态
+        Clock::time_point time;             // EXT测量触发时刻
+    };
+
+    struct Statistics {
+        double rateHz = 0;          // 实际采样率
+        double meanCycleMs = 0;     // 平均测量周期（触发到下一次触发）
+        double waitMs = 0;          // 当前积分等待时间
+        double readMs = 0;          // 平均读取耗时（全部受光部、全部测量命令）
+        quint64 samples = 0;
+        quint64 missed = 0;         // 读取超时或出错的周期
+    };
+
+    CL200AEngine(SerialUtil *serial, CL_TwoZeroZeroACOM *protocol, QObject *parent = nullptr);
+
+    void start();       // 按配置开始测量循环
+    void stop();
+    bool isRunning() const { return m_running; }
+    bool triggerOnce(); // 单次测量，正在测量时返回false；结果由 triggerCompleted 或 triggerFailed 给出
+
+    // 每次触发读取的测量命令（"01"、"02"、"03"、"08"、"15"、"45"）
+    void setMeasurementCodes(const QStringList &codes);
+    QStringList measurementCodes() const { return m_codes; }
+
+    // 读取的受光部编号（0~29），默认只有 0
+    void setHeads(const QVector<int> &heads);
+    QVector<int> heads() const { return m_heads; }
+    static quint8 headAddress(int head);    // 受光部编号 -> readMeasure/setEXT40 的 header（两位十进制按BCD）
+
+    void setIntegrationTime(int ms);
+    void setRangeSettleTime(int ms);
+    void setMinInterval(int ms);
+
+    // 处理一条完整应答（STX ... CRLF），不是测量应答时返回false
+    bool handleFrame(const QByteArray &frame);
+
+    Statistics totalStatistics() const;
+
+    // 第一个受光部的最新测量值，每次触发读完后更新
+    const DeviceState<MeterState> &state() const { return m_state; }
+
+signals:
+    void sampleReceived(const CL200AEngine::Sample &sample);                // 第一个受光部
+    void triggerCompleted(const QVector<CL200AEngine::Sample> &samples);    // 同一次触发的全部受光部，顺序同 heads()
+    void statisticsUpdated(const CL200AEngine::Statistics &stats);     // 最近一秒的统计
+    void triggerFailed();       // 单次测量读取超时或出错
+
+private slots:
+    void trigger();
+    void readNext();
+    void onTimeout();
+    void report();
+
+private:
+    enum class Phase {
+        Idle,
+        Integrating,    // 已触发，等待积分完成
+        Reading         // 等待读取应答
+    };
+
+    struct Window {
+        Clock::time_point start;
+        quint64 samples = 0;
+        quint64 missed = 0;
+        quint64 cycles = 0;
+        double sumCycle = 0;
+        double sumRead = 0;
+    };
+
+    void applyConfig();
+    void store(Sample &sample, const CL_TwoZeroZeroACOM::MeasurementData &data);
+    static void deriveColorimetry(QVector<Sample> &samples);
+    void finishCycle(bool ok);
+    Statistics summarize(const Window &window, Clock::time_point end) const;
+
+    SerialUtil *m_serial;
+    CL_TwoZeroZeroACOM *m_protocol;
+
+    QTimer m_phaseTimer;        // 积分等待 / 最小间隔
+    QTimer m_timeoutTimer;      // 读取应答超时
+    QTimer m_reportTimer;
+
+    bool m_running = false;
+    bool m_single = false;      // 单次测量
+    Phase m_phase = Phase::Idle;
+    QStringList m_codes;
+    QVector<int> m_heads;
+    int m_readIndex = 0;        // 本次触发的第几条读取命令（受光部 × 测量命令）
+
+    int m_integrationMs = 500;
+    int m_rangeSettleMs = 300;
+    int m_minIntervalMs = 0;
+    int m_extraWaitMs = 0;      // 下一次触发附加的量程切换时间
+    QVector<char> m_lastRange;  // 各受光部上一次的量程状态，0 表示尚无
+
+    QVector<Sample> m_samples;  // 本次触发各受光部的测量值
+    Clock::time_point m_lastTrigger;
+    Clock::time_point m_readStart;
+    bool m_hasTrigger = false;
+
+    Window m_window;
+    Window m_total;
+
+    DeviceState<MeterState> m_state;
+};
+
+Q_DECLARE_METATYPE(CL200AEngine::Sample)
+
+#endif // CL200AENGINE_H
@@ -1,19 +1,21 @@
 #include "cl200awidget.h"
 #include "../../../util/logger.h"
 #include "util/errorhandler.h"
+#include "util/config.h"
+#include "util/logcategories.h"
 #include <QMessageBox>
 #include <QDebug>
 #include <math.h>
 
 CL200AWidget::CL200AWidget(QWidget *parent)
     : MeterBase(parent)
-    , m_serialPort(new QSerialPort(this))
+    , m_serial(new SerialUtil(this))
     , m_protocol(new CL_TwoZeroZeroACOM(this))
-    , m_measurementTimer(new QTimer(this))
     , m_commandTimeoutTimer(new QTimer(this))
     , m_commState(CommState::Idle)
     , m_isMeasuring(false)
     , m_isInitialized(false)
+    , m_engine(nullptr)
     , m_currentMeasurementType(0)
     , m_illuminance(0.0f)
     , m_colorTemp(0.0f)
@@ -22,19 +24,65 @@ CL200AWidget::CL200AWidget(QWidget *parent)
     , m_b(0.0f)
 {
     // Connecting serial signal
-    connect(m_serialPort, &QSerialPort::readyRead, this, &CL200AWidget::handleReadyRead);
-    connect(m_serialPort, &QSerialPort::errorOccurred, this, &CL200AWidget::handleError);
+    connect(m_serial, &SerialUtil::dataReceived, this, &CL200AWidget::handleReadyRead);
+    connect(m_serial, &SerialUtil::portError, this, &CL200AWidget::handleError);
     
-    // Set measuring timer to control measuring frequency
-    m_measurementTimer->setInterval(1000); // The measurement is performed every 500ms by default
-    connect(m_measurementTimer, &QTimer::timeout, this, &CL200AWidget::onMeasurementTimerTimeout);
+    // 测量循环：EXT测量和读取由应答驱动，不再使用固定周期定时器
+    m_engine = new CL200AEngine(m_serial, m_protocol, this);
+    connect(m_engine, &CL200AEngine::sampleReceived, this, &CL200AWidget::handleSample);
+    connect(m_engine, &CL200AEngine::triggerCompleted, this, &CL200AWidget::headsMeasured);
+    connect(m_engine, &CL200AEngine::triggerCompleted, this, [this]() {
+        if(!m_isMeasuring) {
+            emit singleMeasured(true, m_engine->state().snapshot());
+        }
+    });
+    connect(m_engine, &CL200AEngine::triggerFailed, this, [this]() {
+        emit singleMeasured(false, m_engine->state().snapshot());
+    });
+    
+    // 意外断开后自动重连：重新设置 PC/EXT 模式，成功后继续之前的连续测量
+    m_reconnect = new ReconnectSupervisor(m_serial, this);
+    connect(m_reconnect, &ReconnectSupervisor::connectionLost, this, [this]() {
+        ++m_handshakeId;
+        m_commandTimeoutTimer->stop();
+        m_engine->stop();       // 保留 m_isMeasuring，恢复后继续
+        m_isInitialized = false;
+        m_commState = CommState::Idle;
+        emit serialRecovering();
+    });
+    connect(m_reconnect, &ReconnectSupervisor::reopened, this, [this]() {
+        m_receivedData.clear();
+        setupInitialCommunication();
+    });
+    connect(m_reconnect, &ReconnectSupervisor::recovered, this, [this](qint64 downtimeMs) {
+        if(m_isMeasuring) {
+            m_engine->start();
+        }
+        emit serialRecovered(downtimeMs, m_reconnect->statistics().recoveries);
+    });
+    // 放弃重连（或配置为不重连）后按设备移除处理
+    connect(m_serial, &SerialUtil::portDisconnected, this, [this]() {
+        ++m_handshakeId;
+        m_isMeasuring = false;
+        m_engine->stop();
+        m_isInitialized = false;
+        m_commState = CommState::Idle;
+        LOG_ERROR("The illuminometer serial port is disconnected");
+        emit serialDisconnected();
+        emit serialError("Device connecting is disconnected");
+    });
     
     // Set the timeout timer for sending commands
     m_commandTimeoutTimer->setSingleShot(true);
     m_commandTimeoutTimer->setInterval(2000); // 2 second timeout
     connect(m_commandTimeoutTimer, &QTimer::timeout, this, [this]() {
         LOG_ERROR("The illuminometer command timed out");
+        ++m_handshakeId;
         m_commState = CommState::Error;
+        if(m_reconnect->isRecovering()) {
+            m_reconnect->handshakeFailed();
+            return;
+        }
         emit serialError("The command timed out, please try again");
 
         connectToPort(m_portname);  // reconnect serial port
@@ -43,31 +91,43 @@ CL200AWidget::CL200AWidget(QWidget *parent)
 
 CL200AWidget::~CL200AWidget()
 {
-    if(m_serialPort->isOpen()) {
-        m_serialPort->close();
+    if(m_serial->isConnected()) {
+        m_serial->disconnectPort();
     }
 }
 
 bool CL200AWidget::connectToPort(const QString &portName)
 {
     m_portname = portName;
+    m_reconnect->cancel();
     // Make sure the previous connection is closed
-    if(m_serialPort->isOpen()) {
-        m_serialPort->close();
+    if(m_serial->isConnected()) {
+        m_serial->disconnectPort();
     }
     
-    // Set the serial port name and parameters
-    m_serialPort->setPortName(portName);
-    setupSerialParameters();
-    
-    // Try to open the serial port
-    if(!m_serialPort->open(QIODevice::ReadWrite)) {
+    // Try to open the serial port (9600, 7E1)
+    if(!m_serial->connectToPort(portName, QSerialPort::Baud9600, QSerialPort::Data7,
+                                QSerialPort::EvenParity, QSerialPort::OneStop,
+                                QSerialPort::NoFlowControl)) {
         LOG_ERROR("Unable to open the illuminometer serial port: " + portName);
         emit serialError("Unable to open the serial port: " + portName);
         return false;
     }
 
     LOG_INFO("The illuminometer serial port is connected: " + portName);
+
+    // 受光部编号
+    QVector<int> heads;
+    const QStringList headList = Config::getValue(ConfigKeys::METER_HEADS, "0").toString().split(',');
+    for(const QString &head : headList) {
+        bool ok = false;
+        const int number = head.trimmed().toInt(&ok);
+        if(ok) {
+            heads.append(number);
+        }
+    }
+    m_engine->setHeads(heads);
+
     m_isInitialized = false;
     m_commState = CommState::Idle;
     
@@ -79,23 +139,29 @@ bool CL200AWidget::connectToPort(const QString &portName)
 
 void CL200AWidget::disconnectPort()
 {
+    const bool recovering = m_reconnect->isRecovering();
+    m_reconnect->cancel();
+
     // Stop measurement
     stopMeasurement();
     
     // Close serial port
-    if(m_serialPort->isOpen()) {
-        m_serialPort->close();
+    if(m_serial->isConnected()) {
+        m_serial->disconnectPort();
         LOG_INFO("The illuminometer serial port is disconnected");
         emit serialDisconnected();
+    } else if(recovering) {
+        emit serialDisconnected();  // 自动重连期间串口未打开
     }
     
+    ++m_handshakeId;
     m_isInitialized = false;
     m_commState = CommState::Idle;
 }
 
 bool CL200AWidget::isConnected() const
 {
-    return m_serialPort->isOpen() && m_isInitialized;
+    return m_serial->isConnected() && m_isInitialized;
 }
 
 void CL200AWidget::startMeasurement()
@@ -106,31 +172,38 @@ void CL200AWidget::startMeasurement()
         return;
     }
     
+    // 每次触发读取配置的测量命令，界面选择的命令排在最前
+    static const char *const typeCodes[] = { "01", "02", "03", "08", "15", "45" };
+    QStringList codes = Config::getValue(ConfigKeys::METER_MEASUREMENT_CODES, "01").toString().split(',');
+    const QString selected = typeCodes[m_currentMeasurementType];
+    codes.removeAll(selected);
+    codes.prepend(selected);
+    m_engine->setMeasurementCodes(codes);
+
     m_isMeasuring = true;
-    m_measurementTimer->start();
-    LOG_INFO("The illuminometer starts measuring");
+    m_engine->start();
+    LOG_INFO("The illuminometer starts measuring: " + m_engine->measurementCodes().join(','));
 }
 
-void CL200AWidget::stopMeasurement()
+bool CL200AWidget::measureOnce()
 {
-    m_isMeasuring = false;
-    m_measurementTimer->stop();
-    LOG_INFO("The illuminometer stops measuring");
+    if(!isConnected() || m_isMeasuring) {
+        return false;
+    }
+    return m_engine->triggerOnce();
 }
 
-void CL200AWidget::setupSerialParameters()
+void CL200AWidget::stopMeasurement()
 {
-    // Setting serial port parameters
-    m_serialPort->setBaudRate(QSerialPort::Baud9600);
-    m_serialPort->setDataBits(QSerialPort::Data7);
-    m_serialPort->setParity(QSerialPort::EvenParity);
-    m_serialPort->setStopBits(QSerialPort::OneStop);
-    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    m_isMeasuring = false;
+    m_engine->stop();
+    LOG_INFO("The illuminometer stops measuring");
 }
 
 void CL200AWidget::setupInitialCommunication()
 {
     // Initialize the communication status
+    ++m_handshakeId;
     m_commState = CommState::WaitingForPCModeResponse;
     
     // 1. Set the PC mode to illuminometer
@@ -144,22 +217,21 @@ void CL200AWidget::setupInitialCommunication()
     m_commandTimeoutTimer->start();
 }
 
-void CL200AWidget::handleReadyRead()
+void CL200AWidget::handleReadyRead(const QByteArray &data)
 {
     // Received all available data
-    m_receivedData.append(m_serialPort->readAll());
-    LOG_INFO("received illuminometer data: " + m_receivedData.toHex());
+    m_receivedData.append(data);
+    LD_TRACE(lcMeter) << "received illuminometer data:" << data.toHex();
     
-    // Check to see if the full message is received(ends with CR+LF)
-    if(m_receivedData.contains("\r\n")) {
-        // Stop the timeout timer
+    // 逐条处理完整应答（以 CR+LF 结尾），一次可能收到多条
+    int end;
+    while((end = m_receivedData.indexOf("\r\n")) >= 0) {
+        const QByteArray frame = m_receivedData.left(end + 2);
+        m_receivedData.remove(0, end + 2);
+
+        // Stop the timeout timer (initialization commands only)
         m_commandTimeoutTimer->stop();
-        
-        // Parse the received data
-        parseReceivedData(m_receivedData);
-        
-        // Clear the receive buffer, ready to receive the next message.
-        m_receivedData.clear();
+        parseReceivedData(frame);
     }
 }
 
@@ -185,15 +257,14 @@ void CL200AWidget::handleError(QSerialPort::SerialPortError error)
             emit serialError("Write error");
             break;
         case QSerialPort::ResourceError:
-            // Device removed
-            disconnectPort();
-            emit serialError("Device connecting is disconnected");
-            break;
+            // Device removed: ReconnectSupervisor 负责重连，放弃时发出 portDisconnected
+            return;
         default:
             emit serialError("Serial port error: " + QString::number(error));
             break;
     }
     
+    ++m_handshakeId;
     m_commState = CommState::Error;
 }
 
@@ -207,23 +278,35 @@ void CL200AWidget::parseReceivedData(const QByteArray &data)
             if(result.registerCode == "54" && result.err == ' ') {
                 LOG_INFO("Illuminometer successed to set PC mode");
                 
+                // 延时回调执行时握手可能已经被断开或新的重连尝试取代
+                const quint32 handshake = m_handshakeId;
                 // Wait 500 milliseconds to send the hold status command
-                QTimer::singleShot(500, this, [this]() {
+                QTimer::singleShot(500, this, [this, handshake]() {
+                    if(handshake != m_handshakeId || !m_serial->isConnected()) {
+                        return;
+                    }
                     QByteArray holdCommand = m_protocol->setHoldState55();
                     sendCommand(holdCommand);
                     
                     // Wait 500 milliseconds to send the set EXT mode command
-                    QTimer::singleShot(500, this, [this]() {
+                    QTimer::singleShot(500, this, [this, handshake]() {
+                        if(handshake != m_handshakeId || !m_serial->isConnected()) {
+                            return;
+                        }
                         m_commState = CommState::WaitingForEXTModeResponse;
-                        QByteArray extCommand = m_protocol->setEXT40(0x00);
-                        sendCommand(extCommand);
-                        m_commandTimeoutTimer->start();
+                        m_extHeadIndex = 0;
+                        sendEXTModeCommand();
                     });
                 });
             } else {
                 LOG_ERROR("Fail to set illuminometer to PC mode");
-                emit serialError("Fail to initialize illuminometer");
+                ++m_handshakeId;
                 m_commState = CommState::Error;
+                if(m_reconnect->isRecovering()) {
+                    m_reconnect->handshakeFailed();
+                } else {
+                    emit serialError("Fail to initialize illuminometer");
+                }
             }
             break;
         }
@@ -232,135 +315,93 @@ void CL200AWidget::parseReceivedData(const QByteArray &data)
             // Parse the response command to set EXT mode
             auto result = m_protocol->handleReceivedSettingResult(data);
             if(result.registerCode == "40" && result.err == ' ') {
-                LOG_INFO("Setting the EXT mode of the illuminometer succeeded");
+                // 多受光部时逐个设置
+                if(++m_extHeadIndex < m_engine->heads().size()) {
+                    sendEXTModeCommand();
+                    break;
+                }
+                LOG_INFO(QString("Setting the EXT mode of the illuminometer succeeded (%1 receptor heads)")
+                         .arg(m_engine->heads().size()));
                 
                 // The inialization is complete, and the measurement can begin after 175 milliseconds
-                QTimer::singleShot(175, this, [this]() {
+                const quint32 handshake = m_handshakeId;
+                QTimer::singleShot(175, this, [this, handshake]() {
+                    if(handshake != m_handshakeId || !m_serial->isConnected()) {
+                        return;
+                    }
                     m_isInitialized = true;
                     m_commState = CommState::Idle;
-                    emit serialConnected(m_serialPort->portName());
+                    if(m_reconnect->isRecovering()) {
+                        m_reconnect->handshakeSucceeded();
+                    } else {
+                        emit serialConnected(m_serial->getPortName());
+                    }
                 });
             } else {
                 LOG_ERROR("Fail to set illuminometer mode to EXT");
-                emit serialError("Fail to initialize the illuminometer");
+                ++m_handshakeId;
                 m_commState = CommState::Error;
+                if(m_reconnect->isRecovering()) {
+                    m_reconnect->handshakeFailed();
+                } else {
+                    emit serialError("Fail to initialize the illuminometer");
+                }
             }
             break;
         }
         
-        case CommState::WaitingForMeasurementData: {
-            // Here we need to parse the data according to the current measurement type
-            // For different measurement commands, the parsing methods are different
-            CL_TwoZeroZeroACOM::MeasurementData measureData;
-            measureData = m_protocol->handleReceivedMeasurementData(data);
-            // The analytical method is determined according to the current measurement type
-            switch(m_currentMeasurementType) {
-                case 0: // command 01 - X,Y,Z
-                    if(measureData.registerCode == "01") {
-                        // The X,Y,Z values are stored in data1,data2,data3 respectively
-                        m_r = measureData.data1;
-                        m_g = measureData.data2;
-                        m_b = measureData.data3;
-
-                        // Send a signal to update the measurement data
-                        emit measurementUpdated(m_illuminance, m_colorTemp, m_r, m_g, m_b);
-                    }
-                    break;
-
-                // Can add data parsing operations for other measurement commands
-                case 1: // command 02 - EV,X,Y
-                    if(measureData.registerCode == "02") {
-                        // Measure the illuminance data
-                        m_illuminance = measureData.data1;
-                        emit measurementUpdated(m_illuminance, m_colorTemp, m_r, m_g, m_b);
-                    }
-                case 2: // command 03 - EV,U',V'
-                case 3: // command 08 - EV,TCP,DUV
-                case 4: // command 15 - EV,DW,P
-                case 5: // command 45 - X2,Y,Z
-                    // The implementation is omitted here and can be added as needed
-                    break;
+        case CommState::Idle:
+            // 初始化完成后的应答都交给测量循环
+            if(!m_engine->handleFrame(data)) {
+                LD_DEBUG(lcMeter) << "ignored illuminometer frame:" << data;
             }
-            
-            m_commState = CommState::Idle;
             break;
-        }
-        
-        case CommState::Idle:
+
         case CommState::Error:
-            // Ignore data received in idle state or error state
+            // Ignore data received in error state
             break;
     }
 }
 
 bool CL200AWidget::sendCommand(const QByteArray &command)
 {
-    if(!m_serialPort->isOpen()) {
+    if(!m_serial->isConnected()) {
         LOG_ERROR("Cannot send command: serial port is not open");
         return false;
     }
     
-    // Write command
-    qint64 written = m_serialPort->write(command);
-    if(written != command.size()) {
+    // Write command immediately, bypassing the 50ms send queue
+    if(!m_serial->writeData(command)) {
         LOG_ERROR("The command was sent incompletely");
         return false;
     }
     
-    // Make sure the data is sent
-    if(!m_serialPort->waitForBytesWritten(1000)) {
-        LOG_ERROR("Waiting for the command to be sent times out");
-        return false;
-    }
-    
     return true;
 }
 
-void CL200AWidget::onMeasurementTimerTimeout()
+void CL200AWidget::sendEXTModeCommand()
 {
-    // 只有在空闲状态下才发送新的测量命令
-    if (m_commState != CommState::Idle || !m_isInitialized) {
-        return;
+    const int head = m_engine->heads().at(m_extHeadIndex);
+    sendCommand(m_protocol->setEXT40(CL200AEngine::headAddress(head)));
+    m_commandTimeoutTimer->start();
+}
+
+void CL200AWidget::handleSample(const CL200AEngine::Sample &sample)
+{
+    // 只更新本次读取到的量；读取了 01 时色温等由 XYZ 计算得到（sample.derived）
+    if(sample.codes.contains("01")) {
+        m_r = sample.X;
+        m_g = sample.Y;
+        m_b = sample.Z;
     }
-    
-    // 先发送 EXT 测试命令
-    QByteArray extTestCommand = m_protocol->takeEXT40();
-    if (!sendCommand(extTestCommand)) {
-        LOG_ERROR("发送 EXT 测试命令失败");
-        return;
+    if(sample.derived || sample.codes.contains("02") || sample.codes.contains("03") ||
+       sample.codes.contains("08") || sample.codes.contains("15")) {
+        m_illuminance = sample.ev;
     }
-    
-    // 等待 750ms 后读取测量数据
-    QTimer::singleShot(750, this, [this]() {
-        // 只有在空闲状态下才继续
-        if (m_commState != CommState::Idle) {
-            return;
-        }
-        
-        m_commState = CommState::WaitingForMeasurementData;
-        
-        // 根据当前测量类型选择命令
-        QString cmdCode;
-        switch (m_currentMeasurementType) {
-            case 0: cmdCode = "01"; break; // X,Y,Z
-            case 1: cmdCode = "02"; break; // EV,X,Y
-            case 2: cmdCode = "03"; break; // EV,U',V'
-            case 3: cmdCode = "08"; break; // EV,TCP,DUV
-            case 4: cmdCode = "15"; break; // EV,DW,P
-            case 5: cmdCode = "45"; break; // X2,Y,Z
-            default: cmdCode = "01"; break;
-        }
-        
-        QByteArray readCommand = m_protocol->readMeasure(cmdCode, 0x00, '2', '0');
-        if (!sendCommand(readCommand)) {
-            LOG_ERROR("发送读取测量数据命令失败");
-            m_commState = CommState::Idle;
-            return;
-        }
-        
-        // 启动超时定时器
-        m_commandTimeoutTimer->start();
-    });
+    if(sample.derived || sample.codes.contains("08")) {
+        m_colorTemp = sample.tcp;
+    }
+    emit measurementUpdated(m_illuminance, m_colorTemp, m_r, m_g, m_b);
 }
 
 void CL200AWidget::setMeasurementType(int type)
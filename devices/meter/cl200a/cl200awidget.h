@@ -5,7 +5,9 @@
 
 #include "../meterbase.h"
 #include "../../../serial/serialutil.h"
+#include "serial/reconnectsupervisor.h"
 #include "../../../communication/cl_twozerozeroacom.h"
+#include "cl200aengine.h"
 #include <QTimer>
 #include <QSerialPort>
 
@@ -22,6 +24,7 @@ public:
     bool isConnected() const override;
     void startMeasurement() override;
     void stopMeasurement() override;
+    bool measureOnce() override;
     
     // CL-200A 特定功能
     void setHold(bool hold);
@@ -30,6 +33,8 @@ public:
     void setPCMode();
     void setEXTMode(bool on);
     void setMeasurementType(int type);
+    QVector<int> heads() const { return m_engine->heads(); }   // 受光部编号（Meter/Heads）
+    const DeviceState<MeterState> *state() const override { return &m_engine->state(); }
 
     // 获取当前测量值
     float getIlluminance() const { return m_illuminance; }
@@ -39,9 +44,9 @@ public:
     float getBValue() const { return m_b; }
 
 private slots:
-    void handleReadyRead();
+    void handleReadyRead(const QByteArray &data);
     void handleError(QSerialPort::SerialPortError error);
-    void onMeasurementTimerTimeout();
+    void handleSample(const CL200AEngine::Sample &sample);
     
 private:
     // 初始化通讯设置
@@ -50,31 +55,33 @@ private:
     void parseReceivedData(const QByteArray &data);
     // 发送命令
     bool sendCommand(const QByteArray &command);
-    // 设置连接参数
-    void setupSerialParameters();
+    // 依次设置各受光部的EXT模式
+    void sendEXTModeCommand();
     
     // 通讯状态枚举
     enum class CommState {
         Idle,                   // 空闲状态
         WaitingForPCModeResponse,  // 等待PC模式设置响应
         WaitingForEXTModeResponse, // 等待EXT模式设置响应
-        WaitingForMeasurementData, // 等待测量数据
         Error                   // 错误状态
     };
 
     // 成员变量
-    QSerialPort *m_serialPort;
+    SerialUtil *m_serial;
     QString m_portname;
     CL_TwoZeroZeroACOM *m_protocol;
-    QTimer *m_measurementTimer;
+    CL200AEngine *m_engine;         // 测量循环
+    ReconnectSupervisor *m_reconnect;   // 意外断开后自动重连
     QTimer *m_commandTimeoutTimer;
     
     QByteArray m_receivedData;
     CommState m_commState;
+    int m_extHeadIndex = 0;         // 正在设置EXT模式的受光部
+    quint32 m_handshakeId = 0;      // 每次握手（含重连的每次尝试）和断开时递增，过期的延时回调据此放弃
     
     bool m_isMeasuring;
     bool m_isInitialized;
-    int m_currentMeasurementType;  // 当前测量类型索引
+    int m_currentMeasurementType;  // 当前测量类型索引（界面选择的主测量命令）
     
     // 测量值保存
     float m_illuminance;
@@ -83,6 +90,11 @@ private:
     float m_g;
     float m_b;
 
+signals:
+    // 多受光部：同一次EXT测量的全部受光部测量值，顺序同 heads()
+    void headsMeasured(const QVector<CL200AEngine::Sample> &samples);
+
+private:
     void initUI();
     void initConnections();
 };
@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include <QDateTime>
+#include "util/devicestate.h"
 
 class MeterBase : public QWidget
 {
@@ -22,14 +23,23 @@ public:
     virtual void startMeasurement() = 0;
     virtual void stopMeasurement() = 0;
 
+    // 照度计状态快照（任意线程可读），不支持时返回 nullptr
+    virtual const DeviceState<MeterState> *state() const { return nullptr; }
+
+    // 单次测量（不在连续测量中时），完成后发出 singleMeasured；不支持或无法开始时返回 false
+    virtual bool measureOnce() { return false; }
+
 signals:
     // 连接状态信号
     void serialConnected(const QString &portName);
     void serialDisconnected();
     void serialError(const QString &errorMessage);
+    void serialRecovering();                                    // 意外断开，正在自动重连
+    void serialRecovered(qint64 downtimeMs, int recoveries);    // 自动重连成功，测量已恢复
     
     // 数据更新信号
     void measurementUpdated(float illuminance, float colorTemp, float r, float g, float b);
+    void singleMeasured(bool ok, const MeterState &state);     // 单次测量结果（第一个受光部）
 };
 
 #endif // METERBASE_H 
\ No newline at end of file
@@ -2,6 +2,13 @@
 #include "splash/splashscreen.h"
 #include "menu/drivemenu.h"
 #include "mainwindow.h"
+#include "station/stationoverview.h"
+#include "util/logger.h"
+#include "util/logcategories.h"
+#include "util/config.h"
+#include "serial/serialtrace.h"
+#include "serial/replayport.h"
+#include <QCommandLineParser>
 #include <QTimer>
 #include <QFile>
 #include <QThread>
@@ -19,6 +26,29 @@ void loadStyleSheet(QApplication &app)
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+
+    // 应用日志分类过滤规则
+    LogCategories::applyFilterRules();
+
+    // 命令行参数：--replay 用记录文件代替真实设备
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption replayOption("replay", "回放串口报文记录文件", "file");
+    QCommandLineOption replayFastOption("replay-fast", "回放时不等待原始时间间隔");
+    parser.addOption(replayOption);
+    parser.addOption(replayFastOption);
+    parser.process(a);
+    if (parser.isSet(replayOption)) {
+        ReplayPort::load(parser.value(replayOption),
+                         parser.isSet(replayFastOption) ? ReplayPort::Fast : ReplayPort::Timed);
+    }
+
+    // 串口报文记录（环形文件，默认常开）
+    if (Config::getValue(ConfigKeys::TRACE_ENABLED, true).toBool()) {
+        qint64 capacityMB = Config::getValue(ConfigKeys::TRACE_CAPACITY_MB, 16).toLongLong();
+        SerialTrace::start(QApplication::applicationDirPath() + "/logs/serial.trace",
+                           capacityMB * 1024 * 1024);
+    }
     
     // 加载样式表
     loadStyleSheet(a);
@@ -58,6 +88,22 @@ int main(int argc, char *argv[])
         menu->hide();  // 隐藏菜单窗口
     });
 
+    // 多工位模式：独立窗口，返回时停止并释放全部工位
+    StationOverview *stationOverview = nullptr;
+    QObject::connect(menu, &DriveMenu::enterStationOverview, [&stationOverview, menu]() {
+        if (!stationOverview) {
+            stationOverview = new StationOverview();
+            QObject::connect(stationOverview, &StationOverview::backToMenu, [&stationOverview, menu]() {
+                stationOverview->hide();
+                stationOverview->deleteLater();
+                stationOverview = nullptr;
+                menu->show();
+            });
+        }
+        stationOverview->show();
+        menu->hide();
+    });
+
     // 模拟加载过程
     for(int i = 0; i <= 100; i++) {
         splash.setProgress(i);
@@ -68,5 +114,11 @@ int main(int argc, char *argv[])
     menu->show();
     splash.finish(menu);
 
-    return a.exec();
+    int ret = a.exec();
+    delete stationOverview;
+
+    // 写完剩余日志和报文记录再退出
+    SerialTrace::shutdown();
+    Logger::shutdown();
+    return ret;
 }
@@ -7,6 +7,7 @@
 #include "communication/eleload_itplus.h"
 #include "communication/cl_twozerozeroacom.h"
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QMessageBox>
 #include "util/datamanager.h"
 
@@ -38,6 +39,10 @@ MainWindow::MainWindow(const QString &driver, const QString &load, const QString
                 this, &MainWindow::onLoadSerialError);
         connect(m_loadWidget, &LoadBase::statusUpdated,
                 this, &MainWindow::updateLoadStatus);
+        connect(m_loadWidget, &LoadBase::serialRecovering,
+                this, [this]() { onDeviceRecovering("load"); });
+        connect(m_loadWidget, &LoadBase::serialRecovered,
+                this, [this](qint64 downtimeMs, int recoveries) { onDeviceRecovered("load", downtimeMs, recoveries); });
     }
     
     // Create illuminometer object based on the selected type
@@ -51,6 +56,10 @@ MainWindow::MainWindow(const QString &driver, const QString &load, const QString
                 this, &MainWindow::onMeterSerialDisconnected);
         connect(m_meterWidget, &MeterBase::measurementUpdated,
                 this, &MainWindow::onMeterDataUpdated);
+        connect(m_meterWidget, &MeterBase::serialRecovering,
+                this, [this]() { onDeviceRecovering("meter"); });
+        connect(m_meterWidget, &MeterBase::serialRecovered,
+                this, [this](qint64 downtimeMs, int recoveries) { onDeviceRecovered("meter", downtimeMs, recoveries); });
     }
 
     initUI();
@@ -121,6 +130,7 @@ void MainWindow::createConnectionArea()
     auto *driverConnBox = new QGroupBox("驱动连接", this);
     auto *driverLayout = new QVBoxLayout(driverConnBox);
     auto *driverPortCombo = new QComboBox(this);
+    driverPortCombo->setObjectName("driverPortCombo");
     m_driverConnectBtn = new QPushButton("连接", this);
     m_driverConnectBtn->setObjectName("driverConnBtn");
 
@@ -137,9 +147,11 @@ void MainWindow::createConnectionArea()
         } else if (channelType != DriverChannelType::Unknown) {
             isConnected = m_driverGeneralWidget && m_driverGeneralWidget->isConnected();
         }
+        isConnected = isConnected || m_recoveringDevices.contains("driver");    // 自动重连中也按断开处理
         
         if (isConnected) {
             // Connected now, be disconnect
+            m_replugPorts.remove("driver");     // 主动断开，不自动重连
             if (channelType == DriverChannelType::CH8 && m_driverWidget) {
                 m_driverWidget->disconnectPort();
             } else if (m_driverGeneralWidget) {
@@ -169,6 +181,7 @@ void MainWindow::createConnectionArea()
     auto *loadConnBox = new QGroupBox("电子负载连接", this);
     auto *loadLayout = new QVBoxLayout(loadConnBox);
     auto *loadPortCombo = new QComboBox(this);
+    loadPortCombo->setObjectName("loadPortCombo");
     auto *loadConnBtn = new QPushButton("连接", this);
     loadConnBtn->setObjectName("loadConnBtn");
     loadConnBtn->setCheckable(true);
@@ -181,9 +194,13 @@ void MainWindow::createConnectionArea()
             // 只发送连接请求
             if (m_loadWidget) {
                 loadConnBtn->setEnabled(false); // 禁用按钮,等待连接结果
-                m_loadWidget->connectToPort(loadPortCombo->currentText());
+                if (!m_loadWidget->connectToPort(loadPortCombo->currentText())) {
+                    // 串口打不开时不会有连接结果，恢复按钮以便手动或插拔后重试
+                    onLoadSerialError("无法打开串口 " + loadPortCombo->currentText());
+                }
             }
         } else {
+            m_replugPorts.remove("load");
             if (m_loadWidget) {
                 m_loadWidget->disconnectPort();
             }
@@ -194,6 +211,7 @@ void MainWindow::createConnectionArea()
     auto *meterConnBox = new QGroupBox("照度计连接", this);
     auto *meterLayout = new QVBoxLayout(meterConnBox);
     auto *meterPortCombo = new QComboBox(this);
+    meterPortCombo->setObjectName("meterPortCombo");
     auto *meterConnBtn = new QPushButton("连接", this);
     meterConnBtn->setObjectName("meterConnBtn");
     meterConnBtn->setCheckable(true);
@@ -211,77 +229,93 @@ void MainWindow::createConnectionArea()
                 m_meterWidget->connectToPort(meterPortCombo->currentText());
             }
         } else {
+            m_replugPorts.remove("meter");
             if (m_meterWidget) {
                 m_meterWidget->disconnectPort();
             }
         }
     });
 
-    // 定时更新可用串口列表
-    auto *portUpdateTimer = new QTimer(this);
-    connect(portUpdateTimer, &QTimer::timeout, this, [=]() {
-        // 获取当前选中的串口
-        QString currentDriverPort = driverPortCombo->currentText();
-        QString currentLoadPort = loadPortCombo->currentText();
-        QString currentMeterPort = meterPortCombo->currentText();
-        
-        // 获取可用串口列表
-        QList<QSerialPortInfo> ports = SerialUtil::getAvailablePorts();
-        
-        // 更新驱动串口列表
-        bool driverConnected = false;
+    // 串口列表由后台线程在插拔时更新（见 PortWatcher），界面线程不再定时枚举串口
+    m_portWatcher = new PortWatcher(this);
+    connect(m_portWatcher, &PortWatcher::portsChanged, this, [this]() {
+        updatePortLists();
+        reconnectReplugged();
+    });
+}
+
+// 是否已连接（自动重连中也算占用），device 为 "driver" / "load" / "meter"
+bool MainWindow::isDeviceConnected(const QString &device) const
+{
+    if (m_recoveringDevices.contains(device)) {
+        return true;
+    }
+    if (device == "driver") {
         if (m_driverType == "8CH") {
-            driverConnected = m_driverWidget && m_driverWidget->isConnected();
-        } else if (m_driverType == "1CH" || m_driverType == "2CH" || m_driverType == "5CH" || m_driverType == "20CH") {
-            driverConnected = m_driverGeneralWidget && m_driverGeneralWidget->isConnected();
-        }
-        if (!driverConnected) {
-            driverPortCombo->clear();
-            for (const auto &port : ports) {
-                driverPortCombo->addItem(port.portName());
-            }
-            // 如果之前选中的串口仍然可用，则保持选中
-            int index = driverPortCombo->findText(currentDriverPort);
-            if (index >= 0) {
-                driverPortCombo->setCurrentIndex(index);
-            }
+            return m_driverWidget && m_driverWidget->isConnected();
         }
-        
-        // 更新电子负载串口列表
-        bool loadConnected = false;
-        if (m_loadType == "IT8512+") {
-            loadConnected = m_loadWidget && m_loadWidget->isConnected();
+        return m_driverGeneralWidget && m_driverGeneralWidget->isConnected();
+    }
+    if (device == "load") {
+        return m_loadType == "IT8512+" && m_loadWidget && m_loadWidget->isConnected();
+    }
+    if (device == "meter") {
+        return m_meterType == "CL-200A" && m_meterWidget && m_meterWidget->isConnected();
+    }
+    return false;
+}
+
+// 用最近一次枚举结果重建未连接设备的串口下拉框，保持原来的选择
+void MainWindow::updatePortLists()
+{
+    const QStringList ports = m_portWatcher->portNames();
+    for (const QString &device : {QString("driver"), QString("load"), QString("meter")}) {
+        auto *combo = m_connectionGroup->findChild<QComboBox*>(device + "PortCombo");
+        if (!combo || isDeviceConnected(device)) {
+            continue;
         }
-        if (!loadConnected) {
-            loadPortCombo->clear();
-            for (const auto &port : ports) {
-                loadPortCombo->addItem(port.portName());
-            }
-            int index = loadPortCombo->findText(currentLoadPort);
-            if (index >= 0) {
-                loadPortCombo->setCurrentIndex(index);
-            }
+        const QString current = combo->currentText();
+        combo->clear();
+        combo->addItems(ports);
+        int index = combo->findText(current);
+        if (index >= 0) {
+            combo->setCurrentIndex(index);
         }
-        
-        // 更新照度计串口列表
-        bool meterConnected = false;
-        if (m_meterType == "CL-200A") {
-            meterConnected = m_meterWidget && m_meterWidget->isConnected();
+    }
+}
+
+// 记录设备连接的端口，拔出重插后按 USB 序列号（没有序列号时按端口名）找回
+void MainWindow::rememberPort(const QString &device, const QString &portName)
+{
+    PortWatcher::PortEntry port;
+    port.name = portName;
+    port.serialNumber = m_portWatcher->serialNumber(portName);
+    m_replugPorts.insert(device, port);
+}
+
+// 意外断开的设备重新出现时自动重连，用户主动断开的设备不在 m_replugPorts 中
+void MainWindow::reconnectReplugged()
+{
+    const QStringList ports = m_portWatcher->portNames();
+    const QHash<QString, PortWatcher::PortEntry> replugPorts = m_replugPorts;     // 重连成功时会更新 m_replugPorts
+    for (auto it = replugPorts.cbegin(); it != replugPorts.cend(); ++it) {
+        const QString &device = it.key();
+        if (isDeviceConnected(device)) {
+            continue;
         }
-        if (!meterConnected) {
-            meterPortCombo->clear();
-            for (const auto &port : ports) {
-                meterPortCombo->addItem(port.portName());
-            }
-            int index = meterPortCombo->findText(currentMeterPort);
-            if (index >= 0) {
-                meterPortCombo->setCurrentIndex(index);
-            }
+        const PortWatcher::PortEntry &known = it.value();
+        const QString portName = known.serialNumber.isEmpty()
+                ? (ports.contains(known.name) ? known.name : QString())
+                : m_portWatcher->portForSerialNumber(known.serialNumber);
+        auto *combo = m_connectionGroup->findChild<QComboBox*>(device + "PortCombo");
+        auto *button = m_connectionGroup->findChild<QPushButton*>(device + "ConnBtn");
+        if (portName.isEmpty() || !combo || !button || !button->isEnabled()) {
+            continue;
         }
-    });
-
-    // 启动定时器，每秒更新一次
-    portUpdateTimer->start(1000);
+        LOG_INFO(QString("%1 重新插入（%2），自动重连").arg(device, portName));
+        combo->setCurrentIndex(combo->findText(portName));
+        button->click();    // 与手动点击“连接”相同的流程
+    }
 }
 
 // 创建电子负载状态区域
@@ -470,7 +504,10 @@ void MainWindow::createIlluminometerArea()
             
             m_measureBtn->setText("停止测量");
         } else if (m_measureBtn->text() == "停止测量") {
-            // 停止测量
+            // 停止测量（恒照度失去反馈，一并停止）
+            if (m_regulator) {
+                m_regulator->stop();
+            }
             if (m_meterWidget) {
                 m_meterWidget->stopMeasurement();
                 LOG_INFO("停止照度计测量");
@@ -481,6 +518,30 @@ void MainWindow::createIlluminometerArea()
     });
 
     layout->addWidget(m_measureBtn);
+
+    // 特性测试：按驱动扫描区的参数逐步写入，每步同时读取照度计和负载
+    m_characterizeBtn = new QPushButton("特性测试", this);
+    connect(m_characterizeBtn, &QPushButton::clicked, this, &MainWindow::onCharacterizeClicked);
+    layout->addWidget(m_characterizeBtn);
+
+    // 恒照度：按照度计读数闭环调节扫描区选定通道的强度
+    auto *regulateLayout = new QHBoxLayout();
+    m_targetLuxBox = new QDoubleSpinBox(this);
+    m_targetLuxBox->setRange(0.1, 200000.0);
+    m_targetLuxBox->setDecimals(1);
+    m_targetLuxBox->setSuffix(" lx");
+    m_targetLuxBox->setValue(500.0);
+    m_regulateBtn = new QPushButton("恒照度", this);
+    regulateLayout->addWidget(new QLabel("目标:", this));
+    regulateLayout->addWidget(m_targetLuxBox);
+    regulateLayout->addWidget(m_regulateBtn);
+    layout->addLayout(regulateLayout);
+    connect(m_regulateBtn, &QPushButton::clicked, this, &MainWindow::onRegulateClicked);
+    connect(m_targetLuxBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double value) {
+        if (m_regulator) {
+            m_regulator->setTarget(value);
+        }
+    });
 }
 
 // 创建软件设置方案区域
@@ -512,8 +573,13 @@ void MainWindow::createSchemeArea()
     buttonLayout->addWidget(loadButton);
     buttonLayout->addWidget(saveButton);
 
+    // 测试脚本：方案只保存界面设置，需要流程控制时用脚本（scripts 目录下的 .js）
+    m_scriptBtn = new QPushButton("运行脚本", this);
+    connect(m_scriptBtn, &QPushButton::clicked, this, &MainWindow::onScriptClicked);
+
     layout->addLayout(schemeLayout);
     layout->addLayout(buttonLayout);
+    layout->addWidget(m_scriptBtn);
 
     // 更新方案列表
     auto updateSchemeList = [=]() {
@@ -979,6 +1045,10 @@ void MainWindow::createDriverArea()
                     this, &MainWindow::onDriverSerialDisconnected);
             connect(m_driverGeneralWidget, &DriverWidget::serialError,
                     this, &MainWindow::onDriverSerialError);
+            connect(m_driverGeneralWidget, &DriverWidget::serialRecovering,
+                    this, [this]() { onDeviceRecovering("driver"); });
+            connect(m_driverGeneralWidget, &DriverWidget::serialRecovered,
+                    this, [this](qint64 downtimeMs, int recoveries) { onDeviceRecovered("driver", downtimeMs, recoveries); });
                     
             // 添加到布局
             driverLayout->addWidget(m_driverGeneralWidget);
@@ -1018,11 +1088,6 @@ void MainWindow::createDriverArea()
 
 void MainWindow::updateLoadStatus(float voltage, float current, float power)
 {
-    // 保存最新的测量值
-    m_lastVoltage = voltage;
-    m_lastCurrent = current;
-    m_lastPower = power;
-    
     // 更新状态显示
     if (m_loadStatusGroup) {
         if (auto *voltageLabel = m_loadStatusGroup->findChild<QLabel*>("voltageLabel")) {
@@ -1092,6 +1157,7 @@ void MainWindow::updateConnectionStatus()
 
 void MainWindow::onLoadSerialConnected(const QString &portName)
 {
+    rememberPort("load", portName);
     updateConnectionStatus();
     
     if (auto *loadConnBtn = m_connectionGroup->findChild<QPushButton*>("loadConnBtn")) {
@@ -1106,6 +1172,7 @@ void MainWindow::onLoadSerialConnected(const QString &portName)
 
 void MainWindow::onLoadSerialDisconnected()
 {
+    m_recoveringDevices.remove("load");
     updateConnectionStatus();
     
     if (auto *loadConnBtn = m_connectionGroup->findChild<QPushButton*>("loadConnBtn")) {
@@ -1114,6 +1181,8 @@ void MainWindow::onLoadSerialDisconnected()
         loadConnBtn->setText("连接");
     }
     
+    updatePortLists();
+
     ToastMessage *toast = new ToastMessage("电子负载已断开连接", this);
     toast->showToast(1000);
 }
@@ -1135,6 +1204,7 @@ void MainWindow::onLoadSerialError(const QString &error)
 
 void MainWindow::onMeterSerialConnected(const QString &portName)
 {
+    rememberPort("meter", portName);
     updateConnectionStatus();
     
     if (m_meterStatusLabel) {
@@ -1148,6 +1218,7 @@ void MainWindow::onMeterSerialConnected(const QString &portName)
 
 void MainWindow::onMeterSerialDisconnected()
 {
+    m_recoveringDevices.remove("meter");
     updateConnectionStatus();
     
     if (m_meterStatusLabel) {
@@ -1156,10 +1227,15 @@ void MainWindow::onMeterSerialDisconnected()
     }
     
     // 如果正在测量，更新测量按钮状态
+    if (m_regulator) {
+        m_regulator->stop();
+    }
     if (m_measureBtn && m_measureBtn->text() == "停止测量") {
         m_measureBtn->setText("开始测量");
     }
     
+    updatePortLists();
+
     ToastMessage *toast = new ToastMessage("照度计已断开连接", this);
     toast->showToast(1000);
 }
@@ -1171,9 +1247,9 @@ void MainWindow::onMeterDataUpdated(float illuminance, float colorTemp, float r,
         m_illuminanceValue->setText(QString::number(illuminance, 'f', 1) + " lx");
     }
     
-//    if (m_colorTempValue) {
-//        m_colorTempValue->setText(QString::number(colorTemp, 'f', 0) + " K");
-//    }
+    if (m_colorTempValue) {
+        m_colorTempValue->setText(QString::number(colorTemp, 'f', 0) + " K");
+    }
     
     // 创建测量数据
     MeasurementData measurementData;
@@ -1184,12 +1260,17 @@ void MainWindow::onMeterDataUpdated(float illuminance, float colorTemp, float r,
     measurementData.g = g;
     measurementData.b = b;
     
-    // 如果电子负载已连接，添加电子负载数据
-    if (m_loadWidget && m_loadWidget->isConnected()) {
-        measurementData.voltage = m_lastVoltage;
-        measurementData.current = m_lastCurrent;
-        measurementData.power = m_lastPower;
-        measurementData.resistance = m_lastVoltage / (m_lastCurrent > 0.001 ? m_lastCurrent : 0.001);
+    // 如果电子负载已连接，从负载状态快照取同一时刻的数据
+    measurementData.voltage = 0;
+    measurementData.current = 0;
+    measurementData.power = 0;
+    measurementData.resistance = 0;
+    if (m_loadWidget && m_loadWidget->isConnected() && m_loadWidget->state()) {
+        const LoadState load = m_loadWidget->state()->snapshot();
+        measurementData.voltage = load.voltage;
+        measurementData.current = load.current;
+        measurementData.power = load.power;
+        measurementData.resistance = load.voltage / (load.current > 0.001f ? load.current : 0.001f);
     }
 
     // 确保图表更新
@@ -1197,8 +1278,10 @@ void MainWindow::onMeterDataUpdated(float illuminance, float colorTemp, float r,
         m_chartWidget->updateChartData(measurementData);
     }
 
-    // 添加到数据管理器
-    DataManager::instance()->addMeasurement(measurementData);
+    // 添加到数据管理器（特性测试和测试脚本运行期间由流程按步记录）
+    if ((!m_characterization || !m_characterization->isRunning()) && (!m_script || !m_script->isRunning())) {
+        DataManager::instance()->addMeasurement(measurementData);
+    }
     
     // 记录数据到本地日志
     LOG_INFO(QString("测量数据 - 照度: %1 lx, 色温: %2 K, RGB: (%3, %4, %5)")
@@ -1209,8 +1292,241 @@ void MainWindow::onMeterDataUpdated(float illuminance, float colorTemp, float r,
              .arg(b, 0, 'f', 1));
 }
 
+void MainWindow::onCharacterizeClicked()
+{
+    if (m_characterization && m_characterization->isRunning()) {
+        m_characterization->stop();
+        return;
+    }
+    if (!m_driverGeneralWidget || !m_driverGeneralWidget->isConnected()) {
+        ToastMessage *toast = new ToastMessage("请先连接驱动器", this);
+        toast->showToast(1000);
+        return;
+    }
+
+    if (!m_characterization) {
+        m_characterization = new CharacterizationRunner(m_driverGeneralWidget->serialPort(),
+                                                        m_driverGeneralWidget->protocol(),
+                                                        m_loadWidget, m_meterWidget, this);
+        connect(m_characterization, &CharacterizationRunner::stepApplied,
+                m_driverGeneralWidget, &DriverWidget::showStrength);
+        connect(m_characterization, &CharacterizationRunner::finished,
+                this, [this](const CharacterizationRunner::Report &report) {
+                    m_characterizeBtn->setText("特性测试");
+                    m_measureBtn->setEnabled(true);
+                    // 走完的测试生成通道标定，中途停止的不用
+                    const int curves = report.completed ? updateCalibration() : 0;
+                    QString calibrationText;
+                    if (curves > 0) {
+                        calibrationText = QString("，已更新 %1 条标定曲线").arg(curves);
+                    } else if (report.completed && m_characterization->plan().channelCount != 1) {
+                        calibrationText = "，多通道同时测试不更新标定";
+                    }
+                    ToastMessage *toast = new ToastMessage(
+                        QString("特性测试%1：%2/%3 步%4").arg(report.completed ? "完成" : "停止")
+                            .arg(report.recorded).arg(report.planned).arg(calibrationText), this);
+                    toast->showToast(2000);
+                });
+    }
+
+    // 单次测量与连续测量不能同时进行
+    if (m_meterWidget && m_measureBtn->text() == "停止测量") {
+        m_meterWidget->stopMeasurement();
+        m_measureBtn->setText("开始测量");
+    }
+
+    // 强度序列取驱动扫描区的起始值、终止值、步长，扫描间隔作为每步的稳定时间
+    const SweepEngine::Range range = m_driverGeneralWidget->scanRange();
+    CharacterizationRunner::Plan plan;
+    plan.firstChannel = range.firstChannel;
+    plan.channelCount = range.channelCount;
+    plan.start = range.start;
+    plan.stop = range.stop;
+    plan.step = range.step;
+    plan.settleMs = range.dwellMs;
+    plan.firstSettleMs = Config::getValue(ConfigKeys::CHAR_FIRST_SETTLE_MS, 0).toInt();
+    plan.timeoutMs = Config::getValue(ConfigKeys::CHAR_ACQUIRE_TIMEOUT_MS, 3000).toInt();
+
+    m_characterization->setAddresses(m_driverGeneralWidget->sendAddress(), m_driverGeneralWidget->receiveAddress());
+    if (!m_characterization->start(plan)) {
+        ToastMessage *toast = new ToastMessage("特性测试无法开始，请检查参数和设备连接", this);
+        toast->showToast(1500);
+        return;
+    }
+    if (m_characterization->isRunning()) {
+        m_characterizeBtn->setText("停止特性测试");
+        m_measureBtn->setEnabled(false);
+    }
+}
+
+// 标定曲线是单个通道的 强度 -> 电流/照度，只能由单通道的特性测试生成：
+// 多个通道同时驱动时负载测得的是总电流，照度是各通道叠加的结果，都无法拆到单个通道上
+int MainWindow::updateCalibration()
+{
+    if (!m_characterization || !m_driverGeneralWidget) {
+        return 0;
+    }
+    const CharacterizationRunner::Plan &plan = m_characterization->plan();
+    if (plan.channelCount != 1) {
+        LOG_WARNING(QString("特性测试同时驱动了 %1 个通道，测得的是合计电流和叠加照度，不更新通道标定；"
+                            "请每次只测一个通道").arg(plan.channelCount));
+        return 0;
+    }
+    QVector<QPointF> current;
+    QVector<QPointF> illuminance;
+    for (const CharacterizationRunner::Row &row : m_characterization->rows()) {
+        if (row.loadOk) {
+            current.append(QPointF(row.value, row.load.current * 1000.0));
+        }
+        if (row.meterOk) {
+            illuminance.append(QPointF(row.value, row.meter.ev));
+        }
+    }
+
+    ChannelCalibration &calibration = m_driverGeneralWidget->calibration();
+    int updated = 0;
+    auto apply = [&](ChannelCalibration::Unit unit, const QVector<QPointF> &points) {
+        CalibrationCurve curve;
+        if (!curve.build(points)) {
+            return;
+        }
+        calibration.setCurve(unit, plan.firstChannel, curve);
+        ++updated;
+    };
+    apply(ChannelCalibration::Current, current);
+    apply(ChannelCalibration::Illuminance, illuminance);
+    if (updated > 0) {
+        calibration.save();
+        m_driverGeneralWidget->refreshCalibrationUnits();
+    }
+    return updated;
+}
+
+void MainWindow::onRegulateClicked()
+{
+    if (m_regulator && m_regulator->isRunning()) {
+        m_regulator->stop();
+        return;
+    }
+    if (!m_driverGeneralWidget || !m_driverGeneralWidget->isConnected()) {
+        ToastMessage *toast = new ToastMessage("请先连接驱动器", this);
+        toast->showToast(1000);
+        return;
+    }
+    // 以照度计连续测量的样本为反馈，控制频率等于照度计采样率
+    if (!m_meterWidget || m_measureBtn->text() != "停止测量") {
+        ToastMessage *toast = new ToastMessage("请先开始照度计测量", this);
+        toast->showToast(1000);
+        return;
+    }
+
+    if (!m_regulator) {
+        m_regulator = new IlluminanceRegulator(m_driverGeneralWidget->serialPort(),
+                                               m_driverGeneralWidget->protocol(), m_meterWidget, this);
+        connect(m_regulator, &IlluminanceRegulator::outputWritten,
+                m_driverGeneralWidget, &DriverWidget::showStrength);
+        connect(m_regulator, &IlluminanceRegulator::settled,
+                this, [this](const IlluminanceRegulator::Report &report) {
+                    ToastMessage *toast = new ToastMessage(
+                        QString("已稳定在 %1 lx：调节时间 %2 s，超调 %3%")
+                            .arg(report.target, 0, 'f', 1)
+                            .arg(report.settlingMs / 1000.0, 0, 'f', 1)
+                            .arg(report.overshootPercent, 0, 'f', 1), this);
+                    toast->showToast(2000);
+                });
+        connect(m_regulator, &IlluminanceRegulator::stopped, this, [this]() {
+            m_regulateBtn->setText("恒照度");
+            m_characterizeBtn->setEnabled(true);
+        });
+    }
+
+    const SweepEngine::Range range = m_driverGeneralWidget->scanRange();
+    IlluminanceRegulator::Settings settings = IlluminanceRegulator::loadSettings();
+    settings.firstChannel = range.firstChannel;
+    settings.channelCount = range.channelCount;
+
+    m_regulator->setAddresses(m_driverGeneralWidget->sendAddress(), m_driverGeneralWidget->receiveAddress());
+    if (!m_regulator->start(settings, m_targetLuxBox->value(),
+                            m_driverGeneralWidget->channelValue(range.firstChannel))) {
+        ToastMessage *toast = new ToastMessage("恒照度无法开始，请检查参数", this);
+        toast->showToast(1500);
+        return;
+    }
+    m_regulateBtn->setText("停止恒照度");
+    m_characterizeBtn->setEnabled(false);
+}
+
+void MainWindow::onScriptClicked()
+{
+    if (m_script && m_script->isRunning()) {
+        m_script->stop();
+        return;
+    }
+    if (!m_driverGeneralWidget || !m_driverGeneralWidget->isConnected()) {
+        ToastMessage *toast = new ToastMessage("请先连接驱动器", this);
+        toast->showToast(1000);
+        return;
+    }
+    if ((m_characterization && m_characterization->isRunning()) || (m_regulator && m_regulator->isRunning())) {
+        ToastMessage *toast = new ToastMessage("请先停止特性测试或恒照度", this);
+        toast->showToast(1000);
+        return;
+    }
+
+    QString scriptDir = QApplication::applicationDirPath() + "/scripts";
+    QDir().mkpath(scriptDir);
+    QString fileName = QFileDialog::getOpenFileName(this, "选择测试脚本", scriptDir, "测试脚本 (*.js)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        ToastMessage *toast = new ToastMessage("无法读取脚本文件", this);
+        toast->showToast(1000);
+        return;
+    }
+    const QString source = QString::fromUtf8(file.readAll());
+    file.close();
+
+    if (!m_script) {
+        m_script = new ScriptRunner(m_driverGeneralWidget->serialPort(), m_driverGeneralWidget->protocol(),
+                                    m_loadWidget, m_meterWidget, this);
+        connect(m_script, &ScriptRunner::strengthApplied,
+                m_driverGeneralWidget, &DriverWidget::showStrength);
+        connect(m_script, &ScriptRunner::finished, this, [this](const ScriptRunner::Report &report) {
+            m_scriptBtn->setText("运行脚本");
+            m_measureBtn->setEnabled(true);
+            m_characterizeBtn->setEnabled(true);
+            m_regulateBtn->setEnabled(true);
+            const QString result = report.completed
+                    ? (report.failedChecks > 0 ? QString("完成，%1/%2 项检查不通过").arg(report.failedChecks).arg(report.checks)
+                                               : QString("完成，测量 %1 次").arg(report.measurements))
+                    : "中止：" + report.error;
+            ToastMessage *toast = new ToastMessage("脚本" + result, this);
+            toast->showToast(report.completed ? 2000 : 3000);
+        });
+    }
+
+    // 单次测量与连续测量不能同时进行
+    if (m_meterWidget && m_measureBtn->text() == "停止测量") {
+        m_meterWidget->stopMeasurement();
+        m_measureBtn->setText("开始测量");
+    }
+
+    m_script->setAddresses(m_driverGeneralWidget->sendAddress(), m_driverGeneralWidget->receiveAddress());
+    m_script->setChannelCount(m_driverGeneralWidget->channelCount());
+    if (!m_script->start(source, QFileInfo(fileName).fileName())) {
+        return;
+    }
+    m_scriptBtn->setText("停止脚本");
+    m_measureBtn->setEnabled(false);
+    m_characterizeBtn->setEnabled(false);
+    m_regulateBtn->setEnabled(false);
+}
+
 void MainWindow::onDriverSerialConnected(const QString &portName)
 {
+    rememberPort("driver", portName);
     // 恢复按钮状态
     m_driverConnectBtn->setEnabled(true);
     m_driverConnectBtn->setChecked(true);
@@ -1226,6 +1542,7 @@ void MainWindow::onDriverSerialConnected(const QString &portName)
 
 void MainWindow::onDriverSerialDisconnected()
 {
+    m_recoveringDevices.remove("driver");
     // 恢复按钮状态
     m_driverConnectBtn->setEnabled(true);
     m_driverConnectBtn->setChecked(false);
@@ -1234,11 +1551,54 @@ void MainWindow::onDriverSerialDisconnected()
     // 更新状态标签
     m_driverStatusLabel->setText("未连接");
     m_driverStatusLabel->setStyleSheet("QLabel { color: red; }");
+
+    // 驱动器断开后自动化流程无法继续
+    if (m_regulator) {
+        m_regulator->stop();
+    }
+    if (m_characterization) {
+        m_characterization->stop();
+    }
+    if (m_script) {
+        m_script->stop();
+    }
     
+    updatePortLists();
+
     ToastMessage *toast = new ToastMessage("驱动已断开连接", this);
     toast->showToast(1000);
 }
 
+// 设备意外断开，正在自动重连（见 ReconnectSupervisor）；自动化流程不停止，重连后设备层重放设定值
+void MainWindow::onDeviceRecovering(const QString &device)
+{
+    m_recoveringDevices.insert(device);
+    QLabel *label = device == "driver" ? m_driverStatusLabel : device == "meter" ? m_meterStatusLabel : nullptr;
+    if (label) {
+        label->setText("重连中...");
+        label->setStyleSheet("QLabel { color: orange; }");
+    }
+    static const QHash<QString, QString> names = {
+        { "driver", "驱动" }, { "load", "电子负载" }, { "meter", "照度计" },
+    };
+    ToastMessage *toast = new ToastMessage(names.value(device) + "连接中断，正在自动重连", this);
+    toast->showToast(1500);
+}
+
+void MainWindow::onDeviceRecovered(const QString &device, qint64 downtimeMs, int recoveries)
+{
+    m_recoveringDevices.remove(device);
+    QLabel *label = device == "driver" ? m_driverStatusLabel : device == "meter" ? m_meterStatusLabel : nullptr;
+    if (label) {
+        label->setText(QString("已恢复连接（第 %1 次）").arg(recoveries));
+        label->setToolTip(QString("最近一次停机 %1 ms").arg(downtimeMs));
+        label->setStyleSheet("QLabel { color: green; }");
+    }
+    updateConnectionStatus();
+    ToastMessage *toast = new ToastMessage(QString("连接已恢复，停机 %1 s").arg(downtimeMs / 1000.0, 0, 'f', 1), this);
+    toast->showToast(1500);
+}
+
 void MainWindow::onDriverSerialError(const QString &error)
 {
     // 恢复按钮状态
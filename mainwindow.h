@@ -11,6 +11,7 @@
 #include <QLabel>
 #include <QStackedWidget>
 #include "serial/serialutil.h"
+#include "serial/portwatcher.h"
 #include <QDir>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -21,6 +22,8 @@
 #include <QDateTimeAxis>
 #include <QValueAxis>
 #include <QTableWidget>
+#include <QHash>
+#include <QSet>
 #include "util/datamanager.h"
 #include "devices/load/it8512plus/it8512plus_widget.h"
 #include "devices/load/load_base.h"
@@ -30,6 +33,9 @@
 #include "devices/driver/driverwidget.h"
 #include "devices/driver/driver8ch/driver8ch.h"
 #include "chart/chartwidget.h"
+#include "automation/characterizationrunner.h"
+#include "automation/illuminanceregulator.h"
+#include "automation/scriptrunner.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -64,6 +70,11 @@ private slots:
     void onDriverSerialConnected(const QString &portName);
     void onDriverSerialDisconnected();
     void onDriverSerialError(const QString &error);
+    void onCharacterizeClicked();   // 开始/停止特性测试
+    void onRegulateClicked();       // 开始/停止恒照度
+    void onScriptClicked();         // 运行/停止测试脚本
+    void onDeviceRecovering(const QString &device);     // 设备意外断开，正在自动重连
+    void onDeviceRecovered(const QString &device, qint64 downtimeMs, int recoveries);
 
 signals:
     void backToMenu();
@@ -99,11 +110,12 @@ private:
     MeterBase *m_meterWidget = nullptr; // 照度计对象
     DriverBase *m_driverWidget = nullptr;         // 驱动对象
     DriverWidget *m_driverGeneralWidget = nullptr;  // 驱动对象
-    
-    // 最新的电子负载数据
-    float m_lastVoltage = 0.0f;
-    float m_lastCurrent = 0.0f;
-    float m_lastPower = 0.0f;
+    CharacterizationRunner *m_characterization = nullptr;   // 特性测试（驱动步进 + 照度计 + 负载）
+    IlluminanceRegulator *m_regulator = nullptr;            // 恒照度闭环
+    ScriptRunner *m_script = nullptr;                       // 测试脚本
+    PortWatcher *m_portWatcher = nullptr;                   // 串口热插拔监视
+    QHash<QString, PortWatcher::PortEntry> m_replugPorts;   // 意外断开后待重连的设备 -> 原端口
+    QSet<QString> m_recoveringDevices;                      // 正在自动重连的设备
     
     // 新增成员变量
     QPushButton *m_driverConnectBtn;    // 驱动串口连接按钮
@@ -140,6 +152,10 @@ private:
     void createIlluminometerArea();    // 创建照度计状态区域
     void createSchemeArea();           // 创建软件设置方案区域
     void createChartArea();            // 创建图表区域
+    void updatePortLists();            // 刷新未连接设备的串口下拉框
+    bool isDeviceConnected(const QString &device) const;
+    void rememberPort(const QString &device, const QString &portName);
+    void reconnectReplugged();         // 重新插入的设备自动重连
     
     // 数据处理相关
     void saveScheme(const QString &name);
@@ -149,12 +165,17 @@ private:
     void startDataCollection();
 
     void setupDataManagement();  // 设置数据管理相关UI和连接
+    int updateCalibration();     // 用特性测试结果更新驱动器通道标定，返回更新的曲线数
 
     // 在 UI 组件部分添加新成员变量
     QLabel *m_meterStatusLabel;       // 照度计状态标签
     QLabel *m_illuminanceValue;       // 照度值显示标签
     QLabel *m_colorTempValue;         // 色温值显示标签
     QPushButton *m_measureBtn;        // 测量控制按钮
+    QPushButton *m_characterizeBtn;   // 特性测试按钮
+    QDoubleSpinBox *m_targetLuxBox;   // 恒照度目标值
+    QPushButton *m_regulateBtn;       // 恒照度按钮
+    QPushButton *m_scriptBtn;         // 测试脚本按钮
     QButtonGroup *m_meterButtonGroup; // 测量模式选择按钮组
 };
 
@@ -85,8 +85,13 @@ void DriveMenu::initUI()
     m_enterButton->setObjectName("enterButton");
     m_enterButton->setFixedSize(200, 45);
 
+    // 多工位：一台电脑同时测试多套工装
+    m_stationButton = new QPushButton("多工位模式", this);
+    m_stationButton->setFixedSize(200, 35);
+
     mainLayout->addWidget(deviceGroup);
     mainLayout->addWidget(m_enterButton, 0, Qt::AlignHCenter);
+    mainLayout->addWidget(m_stationButton, 0, Qt::AlignHCenter);
 }
 
 void DriveMenu::setupStyles()
@@ -124,6 +129,8 @@ void DriveMenu::setupStyles()
 
 void DriveMenu::initConnections()
 {
+    connect(m_stationButton, &QPushButton::clicked, this, &DriveMenu::enterStationOverview);
+
     // 按钮点击动画效果
     connect(m_enterButton, &QPushButton::pressed, this, [this]() {
         auto *animation = new QPropertyAnimation(m_enterButton, "geometry", this);
@@ -15,6 +15,7 @@ public:
 
 signals:
     void enterMainWindow(const QString &driver, const QString &load, const QString &meter);
+    void enterStationOverview();    // 多工位模式
 
 private:
     // UI组件
@@ -23,6 +24,7 @@ private:
     QComboBox *m_loadSelect;
     QComboBox *m_meterSelect;
     QPushButton *m_enterButton;
+    QPushButton *m_stationButton;
 
     void initUI();
     void initConnections();
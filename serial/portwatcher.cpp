@@ -0,0 +1,182 @@
+#include "portwatcher.h"
+#include "serialutil.h"
+#include "util/config.h"
+#include "util/logcategories.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSerialPortInfo>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+    const int DebounceMs = 300;         // udev 创建设备节点后还要改权限、建链接，等一会儿再枚举
+    const int FallbackPollMs = 10000;   // 有 inotify 时的兜底轮询
+    const int PollMs = 1000;            // 没有 inotify 时的轮询
+}
+
+PortWatcher::PortWatcher(QObject *parent)
+    : QObject(parent)
+    , m_thread(new QThread(this))
+    , m_scanner(new PortScanner)
+{
+    qRegisterMetaType<PortWatcher::PortEntry>("PortWatcher::PortEntry");
+    qRegisterMetaType<QList<PortWatcher::PortEntry>>("QList<PortWatcher::PortEntry>");
+
+    m_thread->setObjectName("port-watcher");
+    m_scanner->moveToThread(m_thread);
+    connect(m_thread, &QThread::started, m_scanner, &PortScanner::start);
+    connect(m_thread, &QThread::finished, m_scanner, &QObject::deleteLater);
+    connect(m_scanner, &PortScanner::scanned, this, &PortWatcher::onScanned);
+    m_thread->start();
+}
+
+PortWatcher::~PortWatcher()
+{
+    m_thread->quit();
+    m_thread->wait();
+}
+
+QStringList PortWatcher::portNames() const
+{
+    QStringList names;
+    for (const PortEntry &port : m_ports) {
+        names << port.name;
+    }
+    return names;
+}
+
+QString PortWatcher::serialNumber(const QString &portName) const
+{
+    for (const PortEntry &port : m_ports) {
+        if (port.name == portName) {
+            return port.serialNumber;
+        }
+    }
+    return QString();
+}
+
+QString PortWatcher::portForSerialNumber(const QString &serialNumber) const
+{
+    if (serialNumber.isEmpty()) {
+        return QString();
+    }
+    for (const PortEntry &port : m_ports) {
+        if (port.serialNumber == serialNumber) {
+            return port.name;
+        }
+    }
+    return QString();
+}
+
+// 硬件串口按名称排序，额外设备和回放端口排在后面
+QList<PortWatcher::PortEntry> PortWatcher::enumerate()
+{
+    QList<PortEntry> ports;
+    for (const QSerialPortInfo &info : QSerialPortInfo::availablePorts()) {
+        PortEntry port;
+        port.name = info.portName();
+        port.serialNumber = info.serialNumber();
+        port.description = info.description();
+        if (info.hasVendorIdentifier()) {
+            port.vendorId = info.vendorIdentifier();
+        }
+        if (info.hasProductIdentifier()) {
+            port.productId = info.productIdentifier();
+        }
+        ports.append(port);
+    }
+    std::sort(ports.begin(), ports.end(), [](const PortEntry &a, const PortEntry &b) {
+        return a.name < b.name;
+    });
+    for (const QString &name : SerialUtil::extraPortNames()) {
+        PortEntry port;
+        port.name = name;
+        ports.append(port);
+    }
+    return ports;
+}
+
+void PortWatcher::rescan()
+{
+    PortScanner *scanner = m_scanner;
+    QMetaObject::invokeMethod(scanner, [scanner]() { scanner->scan(); }, Qt::QueuedConnection);
+}
+
+void PortWatcher::onScanned(const QList<PortEntry> &ports)
+{
+    const QList<PortEntry> previous = m_ports;
+    m_ports = ports;
+    for (const PortEntry &port : previous) {
+        if (!ports.contains(port)) {
+            LD_DEBUG(lcSerial) << "串口移除" << port.name << port.serialNumber;
+            emit portRemoved(port);
+        }
+    }
+    for (const PortEntry &port : ports) {
+        if (!previous.contains(port)) {
+            LD_DEBUG(lcSerial) << "串口插入" << port.name << port.serialNumber;
+            emit portArrived(port);
+        }
+    }
+    emit portsChanged(portNames());
+}
+
+PortScanner::PortScanner(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void PortScanner::start()
+{
+    m_debounce = new QTimer(this);
+    m_debounce->setSingleShot(true);
+    m_debounce->setInterval(DebounceMs);
+    connect(m_debounce, &QTimer::timeout, this, &PortScanner::scan);
+
+    m_poll = new QTimer(this);
+    m_poll->setInterval(PollMs);
+    connect(m_poll, &QTimer::timeout, this, &PortScanner::scan);
+
+#ifdef Q_OS_LINUX
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_debounce, QOverload<>::of(&QTimer::start));
+    if (m_watcher->addPath("/dev")) {
+        m_poll->setInterval(FallbackPollMs);
+    } else {
+        delete m_watcher;
+        m_watcher = nullptr;
+    }
+#endif
+    LD_DEBUG(lcSerial) << "串口监视" << (m_watcher ? "inotify" : "轮询") << m_poll->interval() << "ms";
+    m_poll->start();
+    scan();
+}
+
+void PortScanner::scan()
+{
+    updateWatchedPaths();
+    const QList<PortWatcher::PortEntry> ports = PortWatcher::enumerate();
+    if (!m_first && ports == m_last) {
+        return;
+    }
+    m_first = false;
+    m_last = ports;
+    emit scanned(ports);
+}
+
+// 额外设备（devsim 的伪终端链接等）不在 /dev 下，监视它们所在的目录
+void PortScanner::updateWatchedPaths()
+{
+    if (!m_watcher) {
+        return;
+    }
+    const QStringList watched = m_watcher->directories();
+    for (const QString &path : Config::getValue(ConfigKeys::SERIAL_EXTRA_PORTS).toStringList()) {
+        const QString dir = QFileInfo(path).absolutePath();
+        if (!watched.contains(dir) && QDir(dir).exists()) {
+            m_watcher->addPath(dir);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef PORTWATCHER_H
+#define PORTWATCHER_H
+
+#include <QObject>
+#include <QList>
+#include <QStringList>
+
+class QThread;
+class QTimer;
+class QFileSystemWatcher;
+class PortScanner;
+
+/**
+ * 串口热插拔监视
+    串口枚举（QSerialPortInfo::availablePorts，需遍历 sysfs/注册表）在后台线程中进行，界面线程只接收结果
+    Linux：用 inotify（QFileSystemWatcher）监视 /dev 和额外设备所在目录，设备节点增删后去抖 300ms 再枚举，
+           另有 10s 一次的兜底轮询
+    其他平台或 inotify 不可用：每秒轮询一次
+    只有端口集合（端口名 + USB 序列号）真正变化时才发出 portsChanged
+    USB 转串口重新插拔后端口名可能变化（COM3 -> COM5，ttyUSB0 -> ttyUSB1），可按序列号找回同一设备
+ */
+class PortWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    struct PortEntry {
+        QString name;           // 端口名（含额外设备路径和回放端口）
+        QString serialNumber;   // USB 序列号，非 USB 设备为空
+        QString description;
+        quint16 vendorId = 0;
+        quint16 productId = 0;
+
+        bool operator==(const PortEntry &other) const
+        {
+            return name == other.name && serialNumber == other.serialNumber;
+        }
+        bool operator!=(const PortEntry &other) const { return !(*this == other); }
+    };
+
+    explicit PortWatcher(QObject *parent = nullptr);
+    ~PortWatcher();
+
+    QList<PortEntry> ports() const { return m_ports; }    // 最近一次枚举结果
+    QStringList portNames() const;
+    QString serialNumber(const QString &portName) const;            // 没有序列号时为空
+    QString portForSerialNumber(const QString &serialNumber) const; // 没有找到时为空
+
+    static QList<PortEntry> enumerate();    // 同步枚举一次（阻塞，不要在界面线程频繁调用）
+
+public slots:
+    void rescan();      // 立即重新枚举（如修改了额外设备配置之后）
+
+signals:
+    void portsChanged(const QStringList &names);
+    void portArrived(const PortWatcher::PortEntry &port);
+    void portRemoved(const PortWatcher::PortEntry &port);
+
+private:
+    void onScanned(const QList<PortEntry> &ports);
+
+    QThread *m_thread;
+    PortScanner *m_scanner;
+    QList<PortEntry> m_ports;
+};
+
+Q_DECLARE_METATYPE(PortWatcher::PortEntry)
+
+/**
+ * PortWatcher 的后台部分，运行在监视线程中
+ */
+class PortScanner : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PortScanner(QObject *parent = nullptr);
+
+public slots:
+    void start();
+    void scan();
+
+signals:
+    void scanned(const QList<PortWatcher::PortEntry> &ports);   // 只在变化时发出
+
+private:
+    void updateWatchedPaths();
+
+    QFileSystemWatcher *m_watcher = nullptr;
+    QTimer *m_debounce = nullptr;
+    QTimer *m_poll = nullptr;
+    QList<PortWatcher::PortEntry> m_last;
+    bool m_first = true;
+};
+
+#endif // PORTWATCHER_H
@@ -0,0 +1,119 @@
+#include "reconnectsupervisor.h"
+#include "serialutil.h"
+#include "serialtrace.h"
+#include "util/config.h"
+#include "util/errorhandler.h"
+#include "util/logcategories.h"
+#include <QTimer>
+
+namespace {
+    const int InitialBackoffMs = 200;
+    const int MaxBackoffMs = 10000;
+}
+
+ReconnectSupervisor::ReconnectSupervisor(SerialUtil *serial, QObject *parent)
+    : QObject(parent)
+    , m_serial(serial)
+    , m_retryTimer(new QTimer(this))
+    , m_handshakeTimer(new QTimer(this))
+{
+    m_serial->setSupervised(true);
+    connect(m_serial, &SerialUtil::connectionLost, this, &ReconnectSupervisor::onConnectionLost);
+
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, &ReconnectSupervisor::attempt);
+    m_handshakeTimer->setSingleShot(true);
+    connect(m_handshakeTimer, &QTimer::timeout, this, [this]() {
+        LD_DEBUG(lcSerial) << m_portName << "重连握手超时";
+        retry();
+    });
+}
+
+void ReconnectSupervisor::onConnectionLost(const QString &portName)
+{
+    if (m_recovering) {
+        retry();    // 重新打开后握手期间又断开
+        return;
+    }
+    m_giveUpMs = qint64(Config::getValue(ConfigKeys::SERIAL_RECONNECT_TIMEOUT, 600).toInt()) * 1000;
+    if (m_giveUpMs <= 0) {
+        m_serial->notifyDisconnected();
+        return;
+    }
+    m_portName = portName;
+    m_recovering = true;
+    m_backoffMs = InitialBackoffMs;
+    m_downtime.start();
+    ++m_stats.outages;
+    LOG_WARNING(QString("串口 %1 意外断开，开始自动重连（第 %2 次断开）").arg(portName).arg(m_stats.outages));
+    emit connectionLost(portName);
+    m_retryTimer->start(m_backoffMs);
+}
+
+void ReconnectSupervisor::attempt()
+{
+    if (!m_recovering) {
+        return;
+    }
+    ++m_stats.attempts;
+    if (!m_serial->reopen()) {
+        retry();
+        return;
+    }
+    SerialTrace::record(SerialTrace::Event, m_serial->getPortName(), "reopen");
+    LD_DEBUG(lcSerial) << m_portName << "已重新打开，等待握手";
+    m_handshakeTimer->start(m_handshakeTimeoutMs);
+    emit reopened();
+}
+
+// 关闭串口，等待更长时间后再试；超过最长重连时间则放弃
+void ReconnectSupervisor::retry()
+{
+    if (!m_recovering) {
+        return;
+    }
+    m_handshakeTimer->stop();
+    if (m_serial->isConnected()) {
+        m_serial->disconnectPort();
+    }
+    if (m_downtime.elapsed() + m_backoffMs > m_giveUpMs) {
+        m_recovering = false;
+        LOG_ERROR(QString("串口 %1 在 %2 s 内未能恢复，放弃自动重连").arg(m_portName).arg(m_giveUpMs / 1000));
+        emit gaveUp(m_portName);
+        m_serial->notifyDisconnected();
+        return;
+    }
+    m_backoffMs = qMin(m_backoffMs * 2, MaxBackoffMs);
+    m_retryTimer->start(m_backoffMs);
+}
+
+void ReconnectSupervisor::handshakeSucceeded()
+{
+    if (!m_recovering) {
+        return;
+    }
+    m_recovering = false;
+    m_handshakeTimer->stop();
+    const qint64 downtime = m_downtime.elapsed();
+    ++m_stats.recoveries;
+    m_stats.lastDowntimeMs = downtime;
+    m_stats.totalDowntimeMs += downtime;
+    m_stats.maxDowntimeMs = qMax(m_stats.maxDowntimeMs, downtime);
+    SerialTrace::record(SerialTrace::Event, m_serial->getPortName(), "recovered");
+    LOG_INFO(QString("串口 %1 已恢复，停机 %2 ms（累计恢复 %3 次，停机 %4 ms）")
+             .arg(m_serial->getPortName()).arg(downtime).arg(m_stats.recoveries).arg(m_stats.totalDowntimeMs));
+    emit recovered(downtime);
+}
+
+void ReconnectSupervisor::handshakeFailed()
+{
+    LD_DEBUG(lcSerial) << m_portName << "重连握手失败";
+    retry();
+}
+
+void ReconnectSupervisor::cancel()
+{
+    m_recovering = false;
+    m_retryTimer->stop();
+    m_handshakeTimer->stop();
+}
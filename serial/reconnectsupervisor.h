@@ -0,0 +1,67 @@
+#ifndef RECONNECTSUPERVISOR_H
+#define RECONNECTSUPERVISOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class QTimer;
+class SerialUtil;
+
+/**
+ * 串口意外断开（ResourceError）后的自动重连
+    构造后接管 SerialUtil：意外断开时不再发出 portDisconnected，而是按指数退避（200ms 起，每次加倍，最长 10s）
+    重新打开串口，打开后发出 reopened，由设备层重新握手，握手完成调用 handshakeSucceeded，
+    之后发出 recovered，设备层重放断开前的设定值
+    握手超时或失败时关闭串口继续退避；超过 SerialPort/ReconnectTimeout（秒，默认 600）仍未恢复则放弃，
+    按普通断开处理（SerialUtil 发出 portDisconnected）
+    记录断开次数、恢复次数和停机时间
+ */
+class ReconnectSupervisor : public QObject
+{
+    Q_OBJECT
+public:
+    struct Statistics {
+        int outages = 0;            // 意外断开次数
+        int recoveries = 0;         // 成功恢复次数
+        int attempts = 0;           // 重新打开的尝试次数
+        qint64 lastDowntimeMs = 0;  // 最近一次停机时间
+        qint64 totalDowntimeMs = 0;
+        qint64 maxDowntimeMs = 0;
+    };
+
+    explicit ReconnectSupervisor(SerialUtil *serial, QObject *parent = nullptr);
+
+    bool isRecovering() const { return m_recovering; }
+    const Statistics &statistics() const { return m_stats; }
+    void setHandshakeTimeout(int ms) { m_handshakeTimeoutMs = ms; }
+
+    void cancel();      // 用户主动断开或改连其他端口时调用，不发出任何信号
+
+public slots:
+    void handshakeSucceeded();
+    void handshakeFailed();
+
+signals:
+    void connectionLost(const QString &portName);   // 开始重连，设备层应保留设定值
+    void reopened();                                // 串口已重新打开，设备层开始握手
+    void recovered(qint64 downtimeMs);              // 握手完成，设备层重放设定值
+    void gaveUp(const QString &portName);
+
+private:
+    void onConnectionLost(const QString &portName);
+    void attempt();
+    void retry();
+
+    SerialUtil *m_serial;
+    QTimer *m_retryTimer;
+    QTimer *m_handshakeTimer;
+    QElapsedTimer m_downtime;
+    QString m_portName;
+    bool m_recovering = false;
+    int m_backoffMs = 0;
+    int m_handshakeTimeoutMs = 5000;
+    qint64 m_giveUpMs = 0;
+    Statistics m_stats;
+};
+
+#endif // RECONNECTSUPERVISOR_H
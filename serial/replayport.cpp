@@ -0,0 +1,208 @@
+#include "replayport.h"
+#include "util/errorhandler.h"
+#include <QHash>
+#include <cstring>
+
+namespace {
+    const QString REPLAY_PREFIX = "replay:";
+
+    struct ReplaySource {
+        // 记录中的端口名 -> 该端口最近一次会话的收发记录
+        QHash<QString, QVector<SerialTraceRecord>> ports;
+        ReplayPort::Mode mode = ReplayPort::Timed;
+        bool loaded = false;
+    };
+
+    ReplaySource &replaySource()
+    {
+        static ReplaySource source;
+        return source;
+    }
+}
+
+bool ReplayPort::load(const QString &filePath, Mode mode)
+{
+    SerialTraceReader reader;
+    if (!reader.open(filePath)) {
+        LOG_ERROR("无法加载回放文件 " + filePath + ": " + reader.errorString());
+        return false;
+    }
+
+    ReplaySource &source = replaySource();
+    source.ports.clear();
+    source.mode = mode;
+
+    // 同一端口出现在多次会话中时只保留最近一次
+    QHash<QString, int> portSession;
+    int session = 0;
+    for (const SerialTraceRecord &record : reader.records()) {
+        if (record.direction == SerialTrace::Session) {
+            ++session;
+            continue;
+        }
+        if (record.direction != SerialTrace::Tx && record.direction != SerialTrace::Rx) {
+            continue;
+        }
+        if (portSession.value(record.port, -1) != session) {
+            portSession[record.port] = session;
+            source.ports[record.port].clear();
+        }
+        source.ports[record.port].append(record);
+    }
+
+    source.loaded = true;
+    LOG_INFO(QString("加载回放文件 %1，端口: %2").arg(filePath, portNames().join(", ")));
+    return true;
+}
+
+bool ReplayPort::isActive()
+{
+    return replaySource().loaded;
+}
+
+QStringList ReplayPort::portNames()
+{
+    QStringList names;
+    for (const QString &port : replaySource().ports.keys()) {
+        names << REPLAY_PREFIX + port;
+    }
+    names.sort();
+    return names;
+}
+
+bool ReplayPort::isReplayPort(const QString &portName)
+{
+    return portName.startsWith(REPLAY_PREFIX);
+}
+
+ReplayPort::ReplayPort(const QString &portName, QObject *parent)
+    : QIODevice(parent)
+    , m_portName(portName)
+{
+    m_records = replaySource().ports.value(portName.mid(REPLAY_PREFIX.size()));
+
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &ReplayPort::deliverPending);
+}
+
+bool ReplayPort::open(OpenMode mode)
+{
+    if (m_records.isEmpty()) {
+        setErrorString("没有该端口的回放记录");
+        return false;
+    }
+    if (!QIODevice::open(mode | QIODevice::Unbuffered)) {
+        return false;
+    }
+
+    m_cursor = 0;
+    m_rxBuffer.clear();
+    m_stats = Statistics();
+    m_finished = false;
+
+    // 第一次发送之前收到的数据按记录开始时间放出
+    m_anchorNs = m_records.first().timestampNs;
+    m_clock.start();
+    m_timer.start(0);
+    return true;
+}
+
+void ReplayPort::close()
+{
+    m_timer.stop();
+    if (isOpen()) {
+        LOG_INFO(QString("回放 %1 结束: 发送一致 %2，不一致 %3，多余 %4，接收 %5 块 / %6 字节")
+                 .arg(m_portName)
+                 .arg(m_stats.txMatched)
+                 .arg(m_stats.txMismatched)
+                 .arg(m_stats.txExtra)
+                 .arg(m_stats.rxChunks)
+                 .arg(m_stats.rxBytes));
+    }
+    QIODevice::close();
+}
+
+qint64 ReplayPort::bytesAvailable() const
+{
+    return m_rxBuffer.size() + QIODevice::bytesAvailable();
+}
+
+qint64 ReplayPort::readData(char *data, qint64 maxSize)
+{
+    qint64 size = qMin<qint64>(maxSize, m_rxBuffer.size());
+    std::memcpy(data, m_rxBuffer.constData(), size_t(size));
+    m_rxBuffer.remove(0, int(size));
+    return size;
+}
+
+qint64 ReplayPort::writeData(const char *data, qint64 maxSize)
+{
+    // 上一组接收数据还没放完，先全部放出，保证顺序与记录一致
+    bool flushed = false;
+    while (m_cursor < m_records.size() && m_records.at(m_cursor).direction == SerialTrace::Rx) {
+        deliver(m_records.at(m_cursor++));
+        flushed = true;
+    }
+
+    if (m_cursor >= m_records.size()) {
+        ++m_stats.txExtra;
+    } else {
+        const SerialTraceRecord &record = m_records.at(m_cursor++);
+        if (record.data == QByteArray::fromRawData(data, int(maxSize))) {
+            ++m_stats.txMatched;
+        } else {
+            ++m_stats.txMismatched;
+        }
+        // 之后的接收数据相对这次发送计时
+        m_anchorNs = record.timestampNs;
+        m_clock.restart();
+    }
+
+    if (flushed) {
+        QMetaObject::invokeMethod(this, "readyRead", Qt::QueuedConnection);
+    }
+    m_timer.start(0);
+    return maxSize;
+}
+
+void ReplayPort::deliverPending()
+{
+    bool delivered = false;
+    while (m_cursor < m_records.size()) {
+        const SerialTraceRecord &record = m_records.at(m_cursor);
+        if (record.direction == SerialTrace::Tx) {
+            break;  // 等待程序发送
+        }
+        if (replaySource().mode == Timed) {
+            qint64 dueMs = qint64(record.timestampNs - m_anchorNs) / 1000000;
+            qint64 elapsed = m_clock.elapsed();
+            if (elapsed < dueMs) {
+                m_timer.start(int(dueMs - elapsed));
+                break;
+            }
+        }
+        deliver(record);
+        ++m_cursor;
+        delivered = true;
+    }
+
+    if (delivered) {
+        emit readyRead();
+    }
+    checkFinished();
+}
+
+void ReplayPort::deliver(const SerialTraceRecord &record)
+{
+    m_rxBuffer.append(record.data);
+    ++m_stats.rxChunks;
+    m_stats.rxBytes += record.data.size();
+}
+
+void ReplayPort::checkFinished()
+{
+    if (!m_finished && m_cursor >= m_records.size()) {
+        m_finished = true;
+        emit finished();
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef REPLAYPORT_H
+#define REPLAYPORT_H
+
+#include <QIODevice>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QStringList>
+#include "serialtrace.h"
+
+/**
+ * 串口回放设备
+    从报文记录文件（serial.trace）中回放某个端口的接收数据，代替真实串口
+    程序每发送一次数据，依次放出记录中该次发送之后收到的数据：
+      Timed 模式按原始时间间隔（相对于对应的发送）放出
+      Fast  模式立即放出，用于吞吐测试
+    如果程序在上一组接收数据放完之前就发送了下一条，剩余数据立即放出，保证顺序一致
+    发送内容与记录不一致时只做统计，不中断回放
+    回放端口名为 "replay:" + 记录中的端口名，可直接传给 SerialUtil::connectToPort
+ */
+class ReplayPort : public QIODevice
+{
+    Q_OBJECT
+public:
+    enum Mode {
+        Timed,
+        Fast
+    };
+
+    struct Statistics {
+        int txMatched = 0;      // 与记录一致的发送
+        int txMismatched = 0;   // 与记录不一致的发送
+        int txExtra = 0;        // 记录已回放完后的多余发送
+        int rxChunks = 0;
+        qint64 rxBytes = 0;
+    };
+
+    // 加载记录文件（全局，程序启动时调用一次）
+    static bool load(const QString &filePath, Mode mode = Timed);
+    static bool isActive();
+    static QStringList portNames();     // 可回放的端口（已带前缀）
+    static bool isReplayPort(const QString &portName);
+
+    explicit ReplayPort(const QString &portName, QObject *parent = nullptr);
+
+    QString portName() const { return m_portName; }
+    const Statistics &statistics() const { return m_stats; }
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+signals:
+    void finished();    // 记录已全部回放
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private slots:
+    void deliverPending();
+
+private:
+    void deliver(const SerialTraceRecord &record);
+    void checkFinished();
+
+    QString m_portName;
+    QVector<SerialTraceRecord> m_records;   // 本端口的收发记录
+    int m_cursor = 0;
+    QByteArray m_rxBuffer;
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;      // 从上一次发送开始计时
+    quint64 m_anchorNs = 0;     // 上一次发送在记录中的时间
+    bool m_finished = false;
+    Statistics m_stats;
+};
+
+#endif // REPLAYPORT_H
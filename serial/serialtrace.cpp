@@ -0,0 +1,381 @@
+#include "serialtrace.h"
+#include "util/mpscqueue.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QThread>
+#include <QSemaphore>
+#include <QDateTime>
+#include <QtEndian>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    const char FILE_MAGIC[8] = {'L', 'D', 'T', 'R', 'A', 'C', 'E', '\0'};
+    const quint32 FILE_VERSION = 1;
+    const qint64 FILE_HEADER_SIZE = 64;
+    const quint16 RECORD_MAGIC = 0x5254;    // "TR"
+    const qint64 RECORD_HEADER_SIZE = 20;
+    const int WRITE_INTERVAL_MS = 200;      // 批量写入间隔
+
+    // 文件头各字段偏移
+    const int OFF_VERSION = 8;
+    const int OFF_HEADER_SIZE = 12;
+    const int OFF_CAPACITY = 16;
+    const int OFF_WRITE_POS = 24;
+    const int OFF_WRAP_COUNT = 32;
+    const int OFF_NEXT_SEQ = 40;
+
+    // 队列中的一块数据，端口名和数据都是隐式共享，入队不拷贝
+    struct TraceItem {
+        quint64 timestampNs = 0;
+        quint8 direction = 0;
+        QString port;
+        QByteArray data;
+    };
+
+    inline qint64 align4(qint64 size)
+    {
+        return (size + 3) & ~qint64(3);
+    }
+
+    // 解析一条记录，失败返回false
+    bool parseRecord(const uchar *p, qint64 available, SerialTraceRecord &record, qint64 &size)
+    {
+        if (available < RECORD_HEADER_SIZE || qFromLittleEndian<quint16>(p) != RECORD_MAGIC) {
+            return false;
+        }
+        quint8 direction = p[2];
+        quint8 portLen = p[3];
+        quint32 dataLen = qFromLittleEndian<quint32>(p + 4);
+        if (direction > SerialTrace::Event) {
+            return false;
+        }
+        size = align4(RECORD_HEADER_SIZE + portLen + qint64(dataLen));
+        if (size > available) {
+            return false;
+        }
+        record.direction = static_cast<SerialTrace::Direction>(direction);
+        record.seq = qFromLittleEndian<quint32>(p + 8);
+        record.timestampNs = qFromLittleEndian<quint64>(p + 12);
+        record.port = QString::fromLatin1(reinterpret_cast<const char *>(p + RECORD_HEADER_SIZE), portLen);
+        record.data = QByteArray(reinterpret_cast<const char *>(p + RECORD_HEADER_SIZE + portLen), int(dataLen));
+        return true;
+    }
+}
+
+// 后台写线程：把队列中的记录写入内存映射的环形文件
+class TraceWriter : public QThread
+{
+public:
+    ~TraceWriter() override { stop(); }
+
+    bool open(const QString &filePath, qint64 capacity);
+    void stop();
+
+    void enqueue(TraceItem &&item) { m_queue.push(std::move(item)); }
+
+    std::atomic<bool> enabled{false};
+    QString path;
+
+protected:
+    void run() override
+    {
+        while (!m_stopping.load(std::memory_order_acquire)) {
+            m_wake.tryAcquire(1, WRITE_INTERVAL_MS);
+            drain();
+        }
+        drain();
+    }
+
+private:
+    void drain();
+    void writeRecord(const TraceItem &item);
+    void writeHeader();
+
+    MpscQueue<TraceItem> m_queue;
+    QSemaphore m_wake;
+    std::atomic<bool> m_stopping{false};
+
+    QFile m_file;
+    uchar *m_map = nullptr;     // 整个文件的映射
+    uchar *m_data = nullptr;    // 数据区
+    qint64 m_capacity = 0;
+    qint64 m_writePos = 0;
+    quint64 m_wrapCount = 0;
+    quint32 m_nextSeq = 0;
+};
+
+namespace {
+    TraceWriter *traceWriter()
+    {
+        static TraceWriter writer;
+        return &writer;
+    }
+}
+
+bool TraceWriter::open(const QString &filePath, qint64 capacity)
+{
+    capacity = align4(qMax<qint64>(capacity, 4096));
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    // 已有文件且容量一致时续写，否则重新创建
+    bool resume = false;
+    if (m_file.size() == FILE_HEADER_SIZE + capacity) {
+        QByteArray header = m_file.read(FILE_HEADER_SIZE);
+        resume = header.startsWith(QByteArray(FILE_MAGIC, sizeof(FILE_MAGIC)))
+                && qFromLittleEndian<quint32>(header.constData() + OFF_VERSION) == FILE_VERSION
+                && qFromLittleEndian<quint64>(header.constData() + OFF_CAPACITY) == quint64(capacity);
+        if (resume) {
+            m_writePos = qint64(qFromLittleEndian<quint64>(header.constData() + OFF_WRITE_POS));
+            m_wrapCount = qFromLittleEndian<quint64>(header.constData() + OFF_WRAP_COUNT);
+            m_nextSeq = qFromLittleEndian<quint32>(header.constData() + OFF_NEXT_SEQ);
+            resume = m_writePos >= 0 && m_writePos <= capacity && (m_writePos & 3) == 0;
+        }
+    }
+    if (!resume) {
+        m_file.resize(0);
+        if (!m_file.resize(FILE_HEADER_SIZE + capacity)) {
+            m_file.close();
+            return false;
+        }
+        m_writePos = 0;
+        m_wrapCount = 0;
+        m_nextSeq = 0;
+    }
+
+    m_map = m_file.map(0, FILE_HEADER_SIZE + capacity);
+    if (!m_map) {
+        m_file.close();
+        return false;
+    }
+    m_data = m_map + FILE_HEADER_SIZE;
+    m_capacity = capacity;
+    if (!resume) {
+        std::memset(m_map, 0, size_t(FILE_HEADER_SIZE + capacity));
+    }
+    writeHeader();
+
+    path = filePath;
+    m_stopping.store(false);
+    start(QThread::LowPriority);
+    enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+void TraceWriter::stop()
+{
+    enabled.store(false, std::memory_order_release);
+    if (!isRunning()) {
+        return;
+    }
+    m_stopping.store(true, std::memory_order_release);
+    m_wake.release();
+    wait();
+
+    writeHeader();
+    m_file.unmap(m_map);
+    m_map = nullptr;
+    m_data = nullptr;
+    m_file.close();
+}
+
+void TraceWriter::drain()
+{
+    TraceItem item;
+    bool written = false;
+    while (m_queue.pop(item)) {
+        writeRecord(item);
+        written = true;
+    }
+    if (written) {
+        writeHeader();
+    }
+}
+
+void TraceWriter::writeRecord(const TraceItem &item)
+{
+    QByteArray port = item.port.toLatin1().left(255);
+    // 单块数据不超过容量的1/4，避免一次覆盖大半个环
+    int dataLen = int(qMin<qint64>(item.data.size(), m_capacity / 4));
+    qint64 size = align4(RECORD_HEADER_SIZE + port.size() + dataLen);
+
+    // 剩余空间不够时清零尾部并回绕
+    if (m_writePos + size > m_capacity) {
+        std::memset(m_data + m_writePos, 0, size_t(m_capacity - m_writePos));
+        m_writePos = 0;
+        ++m_wrapCount;
+    }
+
+    uchar *p = m_data + m_writePos;
+    qToLittleEndian<quint16>(RECORD_MAGIC, p);
+    p[2] = item.direction;
+    p[3] = quint8(port.size());
+    qToLittleEndian<quint32>(quint32(dataLen), p + 4);
+    qToLittleEndian<quint32>(m_nextSeq++, p + 8);
+    qToLittleEndian<quint64>(item.timestampNs, p + 12);
+    std::memcpy(p + RECORD_HEADER_SIZE, port.constData(), size_t(port.size()));
+    std::memcpy(p + RECORD_HEADER_SIZE + port.size(), item.data.constData(), size_t(dataLen));
+    qint64 used = RECORD_HEADER_SIZE + port.size() + dataLen;
+    std::memset(p + used, 0, size_t(size - used));
+
+    m_writePos += size;
+}
+
+void TraceWriter::writeHeader()
+{
+    if (!m_map) {
+        return;
+    }
+    std::memcpy(m_map, FILE_MAGIC, sizeof(FILE_MAGIC));
+    qToLittleEndian<quint32>(FILE_VERSION, m_map + OFF_VERSION);
+    qToLittleEndian<quint32>(quint32(FILE_HEADER_SIZE), m_map + OFF_HEADER_SIZE);
+    qToLittleEndian<quint64>(quint64(m_capacity), m_map + OFF_CAPACITY);
+    qToLittleEndian<quint64>(quint64(m_writePos), m_map + OFF_WRITE_POS);
+    qToLittleEndian<quint64>(m_wrapCount, m_map + OFF_WRAP_COUNT);
+    qToLittleEndian<quint32>(m_nextSeq, m_map + OFF_NEXT_SEQ);
+}
+
+bool SerialTrace::start(const QString &filePath, qint64 capacity)
+{
+    TraceWriter *writer = traceWriter();
+    if (writer->isRunning()) {
+        return true;
+    }
+    if (!writer->open(filePath, capacity)) {
+        return false;
+    }
+
+    // 会话记录：墙上时间，用于离线换算
+    QByteArray wall(8, '\0');
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), wall.data());
+    record(Session, QString(), wall);
+    return true;
+}
+
+void SerialTrace::shutdown()
+{
+    traceWriter()->stop();
+}
+
+bool SerialTrace::isEnabled()
+{
+    return traceWriter()->enabled.load(std::memory_order_acquire);
+}
+
+QString SerialTrace::filePath()
+{
+    return traceWriter()->path;
+}
+
+void SerialTrace::record(Direction direction, const QString &port, const QByteArray &data)
+{
+    TraceWriter *writer = traceWriter();
+    if (!writer->enabled.load(std::memory_order_acquire)) {
+        return;
+    }
+    TraceItem item;
+    item.timestampNs = steadyNanoseconds();
+    item.direction = direction;
+    item.port = port;
+    item.data = data;
+    writer->enqueue(std::move(item));
+}
+
+quint64 SerialTrace::steadyNanoseconds()
+{
+    return quint64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool SerialTraceReader::open(const QString &filePath)
+{
+    m_records.clear();
+    m_error.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = file.errorString();
+        return false;
+    }
+    QByteArray content = file.readAll();
+    const uchar *base = reinterpret_cast<const uchar *>(content.constData());
+
+    if (content.size() < FILE_HEADER_SIZE
+            || !content.startsWith(QByteArray(FILE_MAGIC, sizeof(FILE_MAGIC)))) {
+        m_error = "不是报文记录文件";
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(base + OFF_VERSION) != FILE_VERSION) {
+        m_error = "不支持的文件版本";
+        return false;
+    }
+    qint64 headerSize = qFromLittleEndian<quint32>(base + OFF_HEADER_SIZE);
+    qint64 capacity = qint64(qFromLittleEndian<quint64>(base + OFF_CAPACITY));
+    qint64 writePos = qint64(qFromLittleEndian<quint64>(base + OFF_WRITE_POS));
+    m_wrapCount = qFromLittleEndian<quint64>(base + OFF_WRAP_COUNT);
+    if (headerSize + capacity != content.size() || writePos > capacity) {
+        m_error = "文件头损坏";
+        return false;
+    }
+    const uchar *data = base + headerSize;
+
+    // 回绕过：写入位置之后是上一圈的记录，第一条可能被覆盖了一半，
+    // 按4字节对齐向后找到能完整解析到结尾的起点
+    if (m_wrapCount > 0) {
+        for (qint64 offset = writePos; offset < capacity; offset += 4) {
+            if (parseRange(data, offset, capacity, true)) {
+                break;
+            }
+        }
+    }
+    parseRange(data, 0, writePos, false);
+
+    // 根据会话记录换算墙上时间
+    qint64 sessionWallMs = 0;
+    quint64 sessionNs = 0;
+    for (SerialTraceRecord &record : m_records) {
+        if (record.direction == SerialTrace::Session && record.data.size() >= 8) {
+            sessionWallMs = qFromLittleEndian<qint64>(record.data.constData());
+            sessionNs = record.timestampNs;
+        }
+        if (sessionWallMs != 0) {
+            record.wallMs = sessionWallMs + qint64(record.timestampNs - sessionNs) / 1000000;
+        }
+    }
+    return true;
+}
+
+bool SerialTraceReader::parseRange(const uchar *data, qint64 begin, qint64 end, bool strict)
+{
+    QVector<SerialTraceRecord> parsed;
+    qint64 offset = begin;
+    while (offset < end) {
+        SerialTraceRecord record;
+        qint64 size = 0;
+        if (!parseRecord(data + offset, end - offset, record, size)) {
+            // 上一圈结尾的清零区域
+            bool padding = end - offset < 2 || qFromLittleEndian<quint16>(data + offset) == 0;
+            if (strict && !padding) {
+                return false;
+            }
+            break;
+        }
+        if (strict && !parsed.isEmpty() && record.seq != parsed.last().seq + 1) {
+            return false;
+        }
+        parsed.append(record);
+        offset += size;
+    }
+    if (strict && parsed.isEmpty()) {
+        return false;
+    }
+    m_records += parsed;
+    return true;
+}
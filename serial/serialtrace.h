@@ -0,0 +1,78 @@
+#ifndef SERIALTRACE_H
+#define SERIALTRACE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * 串口报文记录器
+    记录每一块收发数据：单调时钟纳秒时间戳、端口名、方向、原始字节
+    二进制环形文件（默认16MB，写满后覆盖最旧的记录），通过内存映射写入
+    调用线程只把记录压入无锁队列，由后台线程批量写入，可在生产环境常开
+    每次启动写入一条会话记录（墙上时间），离线解析时据此换算绝对时间
+    只依赖QtCore，离线解析工具 tools/tracedump 直接复用本文件
+
+ 文件格式（小端序）：
+    文件头 64字节：magic "LDTRACE\0"、版本、头长度、数据区容量、
+                  下一次写入位置、回绕次数、下一个序号
+    记录：magic(2) 方向(1) 端口名长度(1) 数据长度(4) 序号(4) 时间戳ns(8)
+          端口名 数据，整体按4字节对齐
+ */
+class SerialTrace
+{
+public:
+    enum Direction : quint8 {
+        Tx = 0,         // 发送
+        Rx = 1,         // 接收
+        Session = 2,    // 会话开始，数据为8字节墙上时间（ms）
+        Event = 3       // 端口事件（打开/关闭/错误），数据为文本
+    };
+
+    // 打开（或续写）环形文件并启动写线程，capacity为数据区字节数
+    static bool start(const QString &filePath, qint64 capacity = DefaultCapacity);
+    // 写完剩余记录并关闭文件
+    static void shutdown();
+
+    static bool isEnabled();
+    static QString filePath();
+
+    // 记录一块数据（任意线程，未启动时直接返回）
+    static void record(Direction direction, const QString &port, const QByteArray &data);
+
+    static quint64 steadyNanoseconds();
+
+    static const qint64 DefaultCapacity = 16 * 1024 * 1024;
+};
+
+// 解析出的一条记录
+struct SerialTraceRecord {
+    quint32 seq = 0;
+    quint64 timestampNs = 0;    // 单调时钟
+    qint64 wallMs = 0;          // 根据会话记录换算的墙上时间，未知时为0
+    SerialTrace::Direction direction = SerialTrace::Tx;
+    QString port;
+    QByteArray data;
+};
+
+/**
+ * 报文记录文件读取
+    按时间顺序还原环形文件中仍然完整的记录
+ */
+class SerialTraceReader
+{
+public:
+    bool open(const QString &filePath);
+    const QVector<SerialTraceRecord> &records() const { return m_records; }
+    QString errorString() const { return m_error; }
+    quint64 wrapCount() const { return m_wrapCount; }
+
+private:
+    bool parseRange(const uchar *data, qint64 begin, qint64 end, bool strict);
+
+    QVector<SerialTraceRecord> m_records;
+    QString m_error;
+    quint64 m_wrapCount = 0;
+};
+
+#endif // SERIALTRACE_H
@@ -1,8 +1,14 @@
 #include "serialutil.h"
+#include "serialtrace.h"
+#include "replayport.h"
+#include "util/config.h"
+#include <QFile>
+#include "util/logcategories.h"
 
-SerialUtil::SerialUtil(QWidget *parent)
-    : QWidget(parent)
+SerialUtil::SerialUtil(QObject *parent)
+    : QObject(parent)
     , m_serial(new QSerialPort(this))
+    , m_device(m_serial)
     , sendTimer(new QTimer(this))
 {
     connect(m_serial,&QSerialPort::readyRead,this,&SerialUtil::readData);
@@ -14,8 +20,8 @@ SerialUtil::SerialUtil(QWidget *parent)
 
 SerialUtil::~SerialUtil()
 {
-    if(m_serial->isOpen()){
-        m_serial->close();
+    if(m_device->isOpen()){
+        m_device->close();
     }
     delete m_serial;
 }
@@ -27,6 +33,31 @@ QList<QSerialPortInfo> SerialUtil::getAvailablePorts()
     return availablePort;
 }
 
+// 可用串口名称，附加配置中的额外设备和回放端口（Config 读取加锁，可在后台线程调用）
+QStringList SerialUtil::availablePortNames()
+{
+    QStringList names;
+    for (const QSerialPortInfo &port : QSerialPortInfo::availablePorts()) {
+        names << port.portName();
+    }
+    return names + extraPortNames();
+}
+
+QStringList SerialUtil::extraPortNames()
+{
+    QStringList names;
+    // 配置中的额外设备（如 devsim 创建的伪终端链接），存在时才列出
+    for (const QString &path : Config::getValue(ConfigKeys::SERIAL_EXTRA_PORTS).toStringList()) {
+        if (QFile::exists(path)) {
+            names << path;
+        }
+    }
+    if (ReplayPort::isActive()) {
+        names << ReplayPort::portNames();
+    }
+    return names;
+}
+
 // 连接到指定串口
 bool SerialUtil::connectToPort(const QString &portName,
                                qint32 baudRate,
@@ -42,6 +73,30 @@ bool SerialUtil::connectToPort(const QString &portName,
              << ", StopBits:" << stopBits
              << ", FlowControl:" << flowControl;
 
+    if(m_device->isOpen()){
+        m_device->close();
+    }
+
+    // 回放端口：用记录文件代替真实串口
+    if(ReplayPort::isReplayPort(portName)){
+        delete m_replay;
+        m_replay = new ReplayPort(portName, this);
+        connect(m_replay, &ReplayPort::readyRead, this, &SerialUtil::readData);
+        m_device = m_replay;
+        if(m_replay->open(QIODevice::ReadWrite)){
+            qDebug() << "Replaying" << portName;
+            return true;
+        }
+        qDebug() << "Failed to replay" << portName << m_replay->errorString();
+        return false;
+    }
+    m_device = m_serial;
+    m_baudRate = baudRate;
+    m_dataBits = dataBits;
+    m_parity = parity;
+    m_stopBits = stopBits;
+    m_flowControl = flowControl;
+
     m_serial->setPortName(portName);
     m_serial->setBaudRate(baudRate);
     m_serial->setDataBits(dataBits);
@@ -51,6 +106,9 @@ bool SerialUtil::connectToPort(const QString &portName,
 
     if(m_serial->open(QIODevice::ReadWrite)){
         qDebug() << "Connected to" << portName;
+        m_serialNumber = QSerialPortInfo(*m_serial).serialNumber();
+        SerialTrace::record(SerialTrace::Event, portName,
+                            QString("open %1").arg(baudRate).toLatin1());
         return true;
     } else {
         qDebug() << "Failed to connect to" << portName;
@@ -58,6 +116,30 @@ bool SerialUtil::connectToPort(const QString &portName,
     }
 }
 
+// 重新打开上次的串口（意外断开后由 ReconnectSupervisor 调用）
+bool SerialUtil::reopen()
+{
+    if(m_device != m_serial){
+        return false;   // 回放设备不会意外断开
+    }
+    QString portName = m_serial->portName();
+    // USB 转串口重新枚举后端口名可能变化，按序列号找回（只在重连时枚举）
+    if(!m_serialNumber.isEmpty() && QSerialPortInfo(portName).serialNumber() != m_serialNumber){
+        for(const QSerialPortInfo &port : QSerialPortInfo::availablePorts()){
+            if(port.serialNumber() == m_serialNumber){
+                portName = port.portName();
+                break;
+            }
+        }
+    }
+    return connectToPort(portName, m_baudRate, m_dataBits, m_parity, m_stopBits, m_flowControl);
+}
+
+void SerialUtil::notifyDisconnected()
+{
+    emit portDisconnected(m_serial->portName());
+}
+
 /*  使用示例
 SerialUtil loadSerial;
 
@@ -79,8 +161,9 @@ if (loadSerial.connectToPort("COM1", 115200, QSerialPort::Data7, QSerialPort::Od
 // 断开当前连接串口
 void SerialUtil::disconnectPort()
 {
-    if(m_serial->isOpen()){
-        m_serial->close();
+    if(m_device->isOpen()){
+        SerialTrace::record(SerialTrace::Event, getPortName(), "close");
+        m_device->close();
         qDebug() << "Disconnected from port";
     }else {
         qDebug() << "No port is currently open";
@@ -117,44 +200,62 @@ void SerialUtil::processQueue()
 // 发送数据
 int SerialUtil::sendData(const QByteArray &data)
 {
-    if(m_serial->isOpen()){
-        // 获取当前时间
-        QDateTime currentTime = QDateTime::currentDateTime();
-        // 将时间格式化为毫秒级
-        QString timeString = currentTime.toString("yyyy-MM-dd hh:mm:ss.zzz");
-        qDebug() << "报文："+data.toHex() + "," + timeString + ",字节数：" + QString::number(data.size());
-        return m_serial->write(data);
+    if(m_device->isOpen()){
+        // 只有打开 ld.serial.trace.debug 时才会格式化时间和报文
+        LD_TRACE(lcSerial).noquote() << "报文：" << data.toHex()
+                                     << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz")
+                                     << "字节数：" << data.size();
+        SerialTrace::record(SerialTrace::Tx, getPortName(), data);
+        return m_device->write(data);
     }else {
         qDebug() << "Serial port is not open";
         return 0;
     }
 }
 
+// 立即发送，不经过50ms的发送队列（用于有严格时序要求的设备）
+bool SerialUtil::writeData(const QByteArray &data)
+{
+    if(!m_device->isOpen()){
+        qDebug() << "Serial port is not open";
+        return false;
+    }
+    SerialTrace::record(SerialTrace::Tx, getPortName(), data);
+    if(m_device->write(data) != data.size()){
+        return false;
+    }
+    if(m_device == m_serial){
+        m_serial->flush();
+    }
+    return true;
+}
+
 // 返回串口名称
 QString SerialUtil::getPortName()
 {
-    return m_serial->portName();
+    return m_device == m_replay ? m_replay->portName() : m_serial->portName();
 }
 
 // 读取数据
 void SerialUtil::readData()
 {
-    QByteArray data = m_serial->readAll();
-    qDebug() << "串口读取数据为：" << data.toHex();
+    QByteArray data = m_device->readAll();
+    SerialTrace::record(SerialTrace::Rx, getPortName(), data);
+    LD_TRACE(lcSerial) << "串口读取数据为：" << data.toHex();
     emit dataReceived(data);
 }
 
 // 检查是否连接
 bool SerialUtil::isConnected() const
 {
-    return m_serial->isOpen();
+    return m_device->isOpen();
 }
 
 // 获取当前连接串口信息
 QString SerialUtil::currentPortName() const
 {
-    if(m_serial->isOpen()){
-        return m_serial->portName();
+    if(m_device->isOpen()){
+        return m_device == m_replay ? m_replay->portName() : m_serial->portName();
     }else{
         return QString();
     }
@@ -163,7 +264,7 @@ QString SerialUtil::currentPortName() const
 // 获取当前连接串口波特率
 qint32 SerialUtil::currentBaudRate() const
 {
-    if(m_serial->isOpen()){
+    if(m_device == m_serial && m_serial->isOpen()){
         return m_serial->baudRate();
     }else{
         return -1;
@@ -172,11 +273,21 @@ qint32 SerialUtil::currentBaudRate() const
 
 // 处理串口错误
 void SerialUtil::onSerialPortError(QSerialPort::SerialPortError error){
+    if(error == QSerialPort::NoError){
+        return;
+    }
+    emit portError(error);
     if(error == QSerialPort::ResourceError){
         // 串口断开或不可用
         qDebug() << "Serial port error: ResourceError (Disconnected)";
-        emit portDisconnected(m_serial->portName());
+        SerialTrace::record(SerialTrace::Event, m_serial->portName(), "resource error");
+        endSending();
         m_serial->close();    // 关闭串口
+        if(m_supervised){
+            emit connectionLost(m_serial->portName());
+        }else{
+            emit portDisconnected(m_serial->portName());
+        }
     }
 }
 
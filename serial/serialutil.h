@@ -1,7 +1,7 @@
 #ifndef ELECTRONICLOADSERIAL_H
 #define ELECTRONICLOADSERIAL_H
 
-#include <QWidget>
+#include <QObject>
 #include <QSerialPort>
 #include <QSerialPortInfo>
 #include <QQueue>
@@ -9,14 +9,24 @@
 #include <QTimer>
 #include <QDateTime>
 
-class SerialUtil : public QWidget
+class ReplayPort;
+
+/**
+ * 串口工具
+    底层设备可以是真实串口，也可以是回放设备（端口名以 "replay:" 开头，见 ReplayPort），
+    上层收发接口不变
+    不依赖界面模块，无界面的测试程序（tools/ldrunner）同样使用
+ */
+class SerialUtil : public QObject
 {
     Q_OBJECT
 public:
-    explicit SerialUtil(QWidget *parent = nullptr);
+    explicit SerialUtil(QObject *parent = nullptr);
     ~SerialUtil();
 
     static QList<QSerialPortInfo> getAvailablePorts(); // 搜索可用串口
+    static QStringList availablePortNames();    // 可用串口名称（含回放端口）
+    static QStringList extraPortNames();        // 配置中存在的额外设备和回放端口
     bool connectToPort(const QString &portName,
                        qint32 baudRate = 256000,
                        QSerialPort::DataBits dataBits = QSerialPort::Data8,
@@ -30,6 +40,13 @@ public:
     QString getPortName();  // 返回串口名称
     void enqueueData(const QByteArray &data);   // 添加数据到队列
     void endSending();      // 停止定时发送
+    bool writeData(const QByteArray &data);     // 立即发送，不经过队列
+
+    // 由 ReconnectSupervisor 接管时，ResourceError 只发出 connectionLost，不发出 portDisconnected
+    void setSupervised(bool supervised) { m_supervised = supervised; }
+    bool isSupervised() const { return m_supervised; }
+    bool reopen();          // 用上次的参数重新打开；原端口名消失时按 USB 序列号查找新端口名
+    void notifyDisconnected();  // 放弃重连，按普通断开处理（发出 portDisconnected）
 
 public slots:
     void readData();    // 读取数据
@@ -39,11 +56,22 @@ public slots:
 signals:
     void dataReceived(const QByteArray &data);  // 数据接收
     void portDisconnected(const QString &portName); // 串口断开信号
+    void portError(QSerialPort::SerialPortError error); // 串口错误信号
+    void connectionLost(const QString &portName);   // 受监管时串口意外断开
 
 private:
     QSerialPort *m_serial;
+    ReplayPort *m_replay = nullptr;     // 回放设备
+    QIODevice *m_device;                // 当前使用的设备（m_serial 或 m_replay）
     QQueue<QByteArray> dataQueue;    // 数据缓存队列
     QTimer sendTimer;                // 定时器
+    bool m_supervised = false;
+    QString m_serialNumber;          // 上次打开的串口的 USB 序列号
+    qint32 m_baudRate = 256000;      // 上次打开的参数，供 reopen 使用
+    QSerialPort::DataBits m_dataBits = QSerialPort::Data8;
+    QSerialPort::Parity m_parity = QSerialPort::NoParity;
+    QSerialPort::StopBits m_stopBits = QSerialPort::OneStop;
+    QSerialPort::FlowControl m_flowControl = QSerialPort::NoFlowControl;
     int sendData(const QByteArray &data);   // 发送数据
 };
 
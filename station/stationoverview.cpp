@@ -0,0 +1,275 @@
+#include "stationoverview.h"
+#include "util/ToastMessage.h"
+#include "util/errorhandler.h"
+#include <QApplication>
+#include <QCloseEvent>
+#include <QDir>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace {
+    enum Column {
+        NameColumn,
+        PortsColumn,
+        StateColumn,
+        ProgressColumn,
+        IlluminanceColumn,
+        CurrentColumn,
+        ResultColumn,
+        ColumnCount
+    };
+
+    QColor stateColor(Station::Status::State state)
+    {
+        switch (state) {
+        case Station::Status::Passed: return QColor("#27ae60");
+        case Station::Status::Failed: return QColor("#e74c3c");
+        case Station::Status::Aborted: return QColor("#e67e22");
+        case Station::Status::Opening:
+        case Station::Status::Running: return QColor("#2980b9");
+        case Station::Status::Idle: break;
+        }
+        return QColor("#7f8c8d");
+    }
+}
+
+StationOverview::StationOverview(QWidget *parent)
+    : QWidget(parent)
+    , m_pool(new StationPool(this))
+{
+    setWindowTitle("多工位");
+    initUI();
+    connect(m_pool, &StationPool::statusChanged, this, &StationOverview::onStatusChanged);
+
+    m_refreshTimer = new QTimer(this);
+    connect(m_refreshTimer, &QTimer::timeout, this, &StationOverview::refreshTable);
+    m_refreshTimer->start(200);
+
+    const QString defaultConfig = QApplication::applicationDirPath() + "/stations.json";
+    if (QFile::exists(defaultConfig)) {
+        loadConfig(defaultConfig);
+    }
+}
+
+void StationOverview::initUI()
+{
+    auto *layout = new QVBoxLayout(this);
+
+    auto *fileLayout = new QHBoxLayout();
+    auto *configButton = new QPushButton("工位配置...", this);
+    auto *sequenceButton = new QPushButton("测试序列...", this);
+    m_configLabel = new QLabel("未加载工位配置", this);
+    m_sequenceLabel = new QLabel("未选择序列", this);
+    fileLayout->addWidget(configButton);
+    fileLayout->addWidget(m_configLabel, 1);
+    fileLayout->addWidget(sequenceButton);
+    fileLayout->addWidget(m_sequenceLabel, 1);
+    layout->addLayout(fileLayout);
+
+    m_table = new QTableWidget(0, ColumnCount, this);
+    m_table->setHorizontalHeaderLabels({"工位", "串口（驱动/负载/照度计）", "状态", "进度",
+                                        "照度(lx)", "电流(A)", "结果"});
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_table->horizontalHeader()->setStretchLastSection(true);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    layout->addWidget(m_table, 1);
+
+    auto *buttonLayout = new QHBoxLayout();
+    auto *backButton = new QPushButton("返回", this);
+    m_summaryLabel = new QLabel(this);
+    m_startAllButton = new QPushButton("全部开始", this);
+    m_stopAllButton = new QPushButton("全部停止", this);
+    buttonLayout->addWidget(backButton);
+    buttonLayout->addWidget(m_summaryLabel, 1);
+    buttonLayout->addWidget(m_startAllButton);
+    buttonLayout->addWidget(m_stopAllButton);
+    layout->addLayout(buttonLayout);
+
+    connect(configButton, &QPushButton::clicked, this, [this]() {
+        const QString path = QFileDialog::getOpenFileName(this, "选择工位配置", QApplication::applicationDirPath(),
+                                                          "工位配置 (*.json)");
+        if (!path.isEmpty()) {
+            loadConfig(path);
+        }
+    });
+    connect(sequenceButton, &QPushButton::clicked, this, [this]() {
+        const QString path = QFileDialog::getOpenFileName(this, "选择测试序列", QApplication::applicationDirPath(),
+                                                          "测试序列 (*.json)");
+        if (!path.isEmpty()) {
+            loadSequence(path);
+        }
+    });
+    connect(m_startAllButton, &QPushButton::clicked, this, &StationOverview::onStartAll);
+    connect(m_stopAllButton, &QPushButton::clicked, m_pool, &StationPool::stopAll);
+    connect(m_table, &QTableWidget::cellDoubleClicked, this, [this](int row, int) { onRowActivated(row); });
+    connect(backButton, &QPushButton::clicked, this, &StationOverview::backToMenu);
+
+    resize(900, 500);
+}
+
+bool StationOverview::loadConfig(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_ERROR("无法读取工位配置: " + path);
+        return false;
+    }
+    const QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+    const QDir base = QFileInfo(path).absoluteDir();
+
+    QVector<Station::Ports> stations;
+    const QJsonArray array = json["stations"].toArray();
+    for (int i = 0; i < array.size(); ++i) {
+        const QJsonObject item = array.at(i).toObject();
+        Station::Ports ports;
+        ports.name = item["name"].toString(QString::number(i + 1));
+        ports.driver = item["driver"].toString();
+        ports.load = item["load"].toString();
+        ports.meter = item["meter"].toString();
+        stations.append(ports);
+    }
+    if (stations.isEmpty()) {
+        ToastMessage *toast = new ToastMessage("工位配置中没有工位", this);
+        toast->showToast(1500);
+        return false;
+    }
+
+    m_pool->setStations(stations);
+    m_outputDir = base.absoluteFilePath(json["output"].toString("results"));
+    m_status = QVector<Station::Status>(stations.size());
+    m_dirty = QVector<bool>(stations.size(), true);
+    m_table->setRowCount(stations.size());
+    for (int row = 0; row < stations.size(); ++row) {
+        const Station::Ports &ports = stations.at(row);
+        for (int column = 0; column < ColumnCount; ++column) {
+            m_table->setItem(row, column, new QTableWidgetItem());
+        }
+        m_table->item(row, NameColumn)->setText(ports.name);
+        m_table->item(row, PortsColumn)->setText(QStringList({ports.driver.isEmpty() ? "-" : ports.driver,
+                                                              ports.load.isEmpty() ? "-" : ports.load,
+                                                              ports.meter.isEmpty() ? "-" : ports.meter}).join(" / "));
+    }
+    m_configLabel->setText(QFileInfo(path).fileName());
+
+    if (json.contains("sequence")) {
+        loadSequence(base.absoluteFilePath(json["sequence"].toString()));
+    }
+    refreshTable();
+    return true;
+}
+
+bool StationOverview::loadSequence(const QString &path)
+{
+    QString error;
+    TestSequence sequence = TestSequence::fromFile(path, &error);
+    if (!error.isEmpty()) {
+        LOG_ERROR(error);
+        ToastMessage *toast = new ToastMessage(error, this);
+        toast->showToast(2000);
+        return false;
+    }
+    m_sequence = sequence;
+    m_sequenceLabel->setText(QString("%1（%2 步）").arg(sequence.name).arg(sequence.steps.size()));
+    return true;
+}
+
+void StationOverview::onStartAll()
+{
+    if (m_sequence.steps.isEmpty()) {
+        ToastMessage *toast = new ToastMessage("请先选择测试序列", this);
+        toast->showToast(1000);
+        return;
+    }
+    m_pool->startAll(m_sequence, m_outputDir);
+}
+
+void StationOverview::onRowActivated(int row)
+{
+    if (row < 0 || row >= m_status.size()) {
+        return;
+    }
+    const Station::Status::State state = m_status.at(row).state;
+    if (state == Station::Status::Opening || state == Station::Status::Running) {
+        m_pool->stop(row);
+    } else if (!m_sequence.steps.isEmpty()) {
+        m_pool->start(row, m_sequence, m_outputDir);
+    }
+}
+
+void StationOverview::onStatusChanged(int index, const Station::Status &status)
+{
+    if (index < 0 || index >= m_status.size()) {
+        return;
+    }
+    m_status[index] = status;
+    m_dirty[index] = true;
+}
+
+// 只重画有变化的行，工位很多、步骤很快时界面开销也不随状态更新次数增长
+void StationOverview::refreshTable()
+{
+    bool changed = false;
+    for (int row = 0; row < m_status.size(); ++row) {
+        if (!m_dirty.at(row)) {
+            continue;
+        }
+        m_dirty[row] = false;
+        changed = true;
+        const Station::Status &status = m_status.at(row);
+        QTableWidgetItem *state = m_table->item(row, StateColumn);
+        state->setText(Station::stateName(status.state));
+        state->setForeground(stateColor(status.state));
+        m_table->item(row, ProgressColumn)->setText(status.steps > 0 ? QString("%1/%2").arg(status.step).arg(status.steps)
+                                                                      : QString());
+        m_table->item(row, IlluminanceColumn)->setText(status.meterOk ? QString::number(status.ev, 'f', 1) : QString());
+        m_table->item(row, CurrentColumn)->setText(status.loadOk ? QString::number(status.current, 'f', 4) : QString());
+        QString result;
+        if (status.state == Station::Status::Passed || status.state == Station::Status::Failed) {
+            result = QString("%1 次测量，%2 项不通过，%3 s  %4").arg(status.measurements).arg(status.failedChecks)
+                    .arg(status.durationMs / 1000.0, 0, 'f', 1).arg(QFileInfo(status.message).fileName());
+        } else {
+            result = status.message;
+        }
+        m_table->item(row, ResultColumn)->setText(result);
+    }
+    if (changed || m_summaryLabel->text().isEmpty()) {
+        updateSummary();
+    }
+}
+
+void StationOverview::updateSummary()
+{
+    int running = 0, passed = 0, failed = 0, aborted = 0;
+    for (const Station::Status &status : m_status) {
+        switch (status.state) {
+        case Station::Status::Opening:
+        case Station::Status::Running: ++running; break;
+        case Station::Status::Passed: ++passed; break;
+        case Station::Status::Failed: ++failed; break;
+        case Station::Status::Aborted: ++aborted; break;
+        case Station::Status::Idle: break;
+        }
+    }
+    m_summaryLabel->setText(QString("%1 个工位 / %2 个工作线程　运行 %3　通过 %4　不通过 %5　中止 %6")
+                            .arg(m_pool->stationCount()).arg(m_pool->threadCount())
+                            .arg(running).arg(passed).arg(failed).arg(aborted));
+}
+
+void StationOverview::closeEvent(QCloseEvent *event)
+{
+    m_pool->stopAll();
+    QWidget::closeEvent(event);
+}
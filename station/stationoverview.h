@@ -0,0 +1,67 @@
+#ifndef STATIONOVERVIEW_H
+#define STATIONOVERVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include "automation/stationpool.h"
+
+class QLabel;
+class QPushButton;
+class QTableWidget;
+class QTimer;
+
+/**
+ * 多工位总览
+    一个工位一行：串口、状态、进度、最近一次照度和电流、结果，界面每 200ms 刷新一次有变化的行
+    工位配置为 JSON 文件（默认 stations.json）：
+    {
+      "sequence": "sequences/ld8.json",     // 相对路径相对于配置文件所在目录
+      "output": "results",
+      "stations": [
+        { "name": "A1", "driver": "COM3", "load": "COM4", "meter": "COM5" },
+        { "name": "A2", "driver": "COM6", "meter": "COM7" }
+      ]
+    }
+    双击一行单独开始/停止该工位
+ */
+class StationOverview : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit StationOverview(QWidget *parent = nullptr);
+
+    bool loadConfig(const QString &path);
+
+signals:
+    void backToMenu();
+
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
+private slots:
+    void onStatusChanged(int index, const Station::Status &status);
+    void refreshTable();
+    void onStartAll();
+    void onRowActivated(int row);
+
+private:
+    void initUI();
+    bool loadSequence(const QString &path);
+    void updateSummary();
+
+    StationPool *m_pool;
+    TestSequence m_sequence;
+    QString m_outputDir;
+    QVector<Station::Status> m_status;
+    QVector<bool> m_dirty;
+
+    QLabel *m_configLabel;
+    QLabel *m_sequenceLabel;
+    QLabel *m_summaryLabel;
+    QPushButton *m_startAllButton;
+    QPushButton *m_stopAllButton;
+    QTableWidget *m_table;
+    QTimer *m_refreshTimer;
+};
+
+#endif // STATIONOVERVIEW_H
@@ -0,0 +1,20 @@
+# 设备模拟器：在Linux伪终端上模拟 IT8512+ / CL-200A / LD驱动，无需实物即可联调和压测
+# 用法：devsim --it8512 2 --cl200a 1 --ld 4 --latency 5 --drop 0.01 --link-dir /tmp/ldsim
+
+QT       = core
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = devsim
+
+!linux: error("devsim 依赖 Linux 伪终端，只能在 Linux 下编译")
+
+SOURCES += \
+    main.cpp \
+    ptyendpoint.cpp \
+    simdevices.cpp
+
+HEADERS += \
+    ptyendpoint.h \
+    simdevices.h
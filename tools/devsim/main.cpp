@@ -0,0 +1,156 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QSocketNotifier>
+#include <csignal>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "ptyendpoint.h"
+
+namespace {
+    // 信号处理函数中只能调用异步信号安全的函数：写一个字节到 socketpair，由事件循环读出后退出
+    int signalFds[2] = { -1, -1 };
+
+    void onSignal(int)
+    {
+        const char byte = 1;
+        ssize_t n = ::write(signalFds[0], &byte, 1);
+        (void)n;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("devsim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("IT8512+ / CL-200A / LD驱动 伪终端模拟器");
+    parser.addHelpOption();
+    QCommandLineOption itOption("it8512", "IT8512+ 电子负载数量", "n", "0");
+    QCommandLineOption clOption("cl200a", "CL-200A 照度计数量", "n", "0");
+    QCommandLineOption ldOption("ld", "LD驱动数量", "n", "0");
+    QCommandLineOption ldChannelsOption("ld-channels", "LD驱动通道数", "n", "8");
+    QCommandLineOption latencyOption("latency", "应答延迟（ms）", "ms", "0");
+    QCommandLineOption jitterOption("jitter", "应答延迟抖动（ms）", "ms", "0");
+    QCommandLineOption dropOption("drop", "丢弃应答的概率（0-1）", "rate", "0");
+    QCommandLineOption corruptOption("corrupt", "应答校验错误的概率（0-1）", "rate", "0");
+    QCommandLineOption splitOption("split", "应答拆成两段发送的概率（0-1）", "rate", "0");
+    QCommandLineOption linkOption("link-dir", "在该目录下创建指向各伪终端的链接", "dir");
+    QCommandLineOption statsOption("stats", "统计输出间隔（秒，0为不输出）", "s", "5");
+    for (const QCommandLineOption &option : {itOption, clOption, ldOption, ldChannelsOption,
+                                             latencyOption, jitterOption, dropOption, corruptOption,
+                                             splitOption, linkOption, statsOption}) {
+        parser.addOption(option);
+    }
+    parser.process(app);
+
+    PtyEndpoint::Faults faults;
+    faults.latencyMs = parser.value(latencyOption).toInt();
+    faults.jitterMs = parser.value(jitterOption).toInt();
+    faults.dropRate = parser.value(dropOption).toDouble();
+    faults.corruptRate = parser.value(corruptOption).toDouble();
+    faults.splitRate = parser.value(splitOption).toDouble();
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QList<PtyEndpoint *> endpoints;
+    QStringList links;
+    const QString linkDir = parser.value(linkOption);
+    if (!linkDir.isEmpty()) {
+        QDir().mkpath(linkDir);
+    }
+
+    auto addDevice = [&](const QString &tag, int index, std::unique_ptr<SimDevice> device) {
+        auto *endpoint = new PtyEndpoint(std::move(device), faults, &app);
+        if (!endpoint->open()) {
+            err << "无法创建伪终端: " << tag << index << "\n";
+            delete endpoint;
+            return;
+        }
+        endpoints.append(endpoint);
+        QString line = QString("%1-%2  %3  %4")
+                .arg(tag).arg(index).arg(endpoint->device()->name(), endpoint->slavePath());
+        if (!linkDir.isEmpty()) {
+            QString link = QDir(linkDir).filePath(QString("%1-%2").arg(tag).arg(index));
+            QFile::remove(link);
+            if (QFile::link(endpoint->slavePath(), link)) {
+                links << link;
+                line += "  -> " + link;
+            }
+        }
+        out << line << "\n";
+    };
+
+    const int ldChannels = parser.value(ldChannelsOption).toInt();
+    for (int i = 0; i < parser.value(itOption).toInt(); ++i) {
+        addDevice("it8512", i, std::make_unique<It8512Sim>(0xFF));
+    }
+    for (int i = 0; i < parser.value(clOption).toInt(); ++i) {
+        addDevice("cl200a", i, std::make_unique<Cl200aSim>());
+    }
+    for (int i = 0; i < parser.value(ldOption).toInt(); ++i) {
+        addDevice("ld", i, std::make_unique<LdDriverSim>(quint8(i + 1), ldChannels));
+    }
+    out.flush();
+
+    if (endpoints.isEmpty()) {
+        err << "没有创建任何设备，使用 --it8512 / --cl200a / --ld 指定数量\n";
+        return 1;
+    }
+
+    // 周期输出收发帧率
+    QElapsedTimer elapsed;
+    elapsed.start();
+    int lastReceived = 0;
+    int lastSent = 0;
+    QTimer statsTimer;
+    int statsInterval = parser.value(statsOption).toInt();
+    QObject::connect(&statsTimer, &QTimer::timeout, [&]() {
+        int received = 0, sent = 0, dropped = 0, corrupted = 0;
+        for (PtyEndpoint *endpoint : endpoints) {
+            received += endpoint->device()->framesReceived();
+            sent += endpoint->device()->framesSent();
+            dropped += endpoint->dropped();
+            corrupted += endpoint->corrupted();
+        }
+        double seconds = statsInterval;
+        out << QString("[%1s] 收 %2 帧/s  发 %3 帧/s  累计 收%4 发%5 丢弃%6 损坏%7\n")
+               .arg(elapsed.elapsed() / 1000)
+               .arg((received - lastReceived) / seconds, 0, 'f', 1)
+               .arg((sent - lastSent) / seconds, 0, 'f', 1)
+               .arg(received).arg(sent).arg(dropped).arg(corrupted);
+        out.flush();
+        lastReceived = received;
+        lastSent = sent;
+    });
+    if (statsInterval > 0) {
+        statsTimer.start(statsInterval * 1000);
+    }
+
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalFds) == 0) {
+        auto *signalNotifier = new QSocketNotifier(signalFds[1], QSocketNotifier::Read, &app);
+        QObject::connect(signalNotifier, &QSocketNotifier::activated, &app, [signalNotifier]() {
+            signalNotifier->setEnabled(false);
+            char byte;
+            ssize_t n = ::read(signalFds[1], &byte, 1);
+            (void)n;
+            QCoreApplication::quit();
+        });
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+    } else {
+        err << "无法创建信号通知 socketpair，Ctrl+C 时不会删除链接\n";
+        err.flush();
+    }
+
+    int ret = app.exec();
+    for (const QString &link : links) {
+        QFile::remove(link);
+    }
+    return ret;
+}
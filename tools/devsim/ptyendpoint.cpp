@@ -0,0 +1,147 @@
+#include "ptyendpoint.h"
+#include <QTimer>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cerrno>
+
+PtyEndpoint::PtyEndpoint(std::unique_ptr<SimDevice> device, const Faults &faults, QObject *parent)
+    : QObject(parent)
+    , m_device(std::move(device))
+    , m_faults(faults)
+    , m_random(QRandomGenerator::global()->generate())
+{
+    m_clock.start();
+}
+
+PtyEndpoint::~PtyEndpoint()
+{
+    if (m_slave >= 0) {
+        ::close(m_slave);
+    }
+    if (m_master >= 0) {
+        ::close(m_master);
+    }
+}
+
+bool PtyEndpoint::open()
+{
+    m_master = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (m_master < 0 || ::grantpt(m_master) != 0 || ::unlockpt(m_master) != 0) {
+        return false;
+    }
+    const char *name = ::ptsname(m_master);
+    if (!name) {
+        return false;
+    }
+    m_slavePath = QString::fromLocal8Bit(name);
+
+    // 从端设为原始模式，避免行规程改写二进制数据
+    m_slave = ::open(name, O_RDWR | O_NOCTTY);
+    if (m_slave < 0) {
+        return false;
+    }
+    termios tio;
+    if (::tcgetattr(m_slave, &tio) == 0) {
+        ::cfmakeraw(&tio);
+        ::tcsetattr(m_slave, TCSANOW, &tio);
+    }
+
+    m_notifier = new QSocketNotifier(m_master, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &PtyEndpoint::onReadable);
+    m_writeNotifier = new QSocketNotifier(m_master, QSocketNotifier::Write, this);
+    m_writeNotifier->setEnabled(false);
+    connect(m_writeNotifier, &QSocketNotifier::activated, this, &PtyEndpoint::onWritable);
+    return true;
+}
+
+void PtyEndpoint::onReadable()
+{
+    char buffer[4096];
+    QByteArray data;
+    while (true) {
+        ssize_t n = ::read(m_master, buffer, sizeof(buffer));
+        if (n > 0) {
+            data.append(buffer, int(n));
+            continue;
+        }
+        break;
+    }
+    if (data.isEmpty()) {
+        return;
+    }
+
+    for (QByteArray &frame : m_device->feed(data)) {
+        if (m_random.generateDouble() < m_faults.dropRate) {
+            ++m_dropped;
+            continue;
+        }
+        if (m_random.generateDouble() < m_faults.corruptRate) {
+            m_device->corrupt(frame);
+            ++m_corrupted;
+        }
+        send(frame);
+    }
+}
+
+void PtyEndpoint::send(QByteArray frame)
+{
+    int delay = m_faults.latencyMs;
+    if (m_faults.jitterMs > 0) {
+        delay += int(m_random.bounded(m_faults.jitterMs));
+    }
+
+    // 真实设备不会乱序：抖动只推迟，不超过前一帧
+    qint64 now = m_clock.elapsed();
+    qint64 due = qMax(now + delay, m_lastDue);
+
+    // 拆包：前半段先发，后半段再等一个延迟
+    if (frame.size() > 1 && m_random.generateDouble() < m_faults.splitRate) {
+        int cut = 1 + int(m_random.bounded(frame.size() - 1));
+        QByteArray tail = frame.mid(cut);
+        frame.truncate(cut);
+        qint64 tailDue = due + qMax(1, m_faults.latencyMs);
+        QTimer::singleShot(int(tailDue - now), this, [this, tail]() { writeAll(tail); });
+        m_lastDue = tailDue;
+    } else {
+        m_lastDue = due;
+    }
+
+    QTimer::singleShot(int(due - now), this, [this, frame]() { writeAll(frame); });
+}
+
+// 被测程序读得慢时主端会写满，剩余数据留到可写时再发，不阻塞事件循环
+void PtyEndpoint::writeAll(const QByteArray &data)
+{
+    m_pending.append(data);
+    if (m_pending.size() == data.size()) {
+        flushPending();
+    }
+}
+
+void PtyEndpoint::onWritable()
+{
+    flushPending();
+}
+
+void PtyEndpoint::flushPending()
+{
+    qint64 written = 0;
+    while (written < m_pending.size()) {
+        ssize_t n = ::write(m_master, m_pending.constData() + written, size_t(m_pending.size() - written));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN) {
+                break;
+            }
+            written = m_pending.size();     // 主端出错，丢弃
+            break;
+        }
+        written += n;
+    }
+    m_pending.remove(0, int(written));
+    m_writeNotifier->setEnabled(!m_pending.isEmpty());
+}
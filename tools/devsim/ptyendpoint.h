@@ -0,0 +1,63 @@
+#ifndef PTYENDPOINT_H
+#define PTYENDPOINT_H
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <QRandomGenerator>
+#include <QElapsedTimer>
+#include <memory>
+#include "simdevices.h"
+
+/**
+ * 伪终端端点
+    打开一对PTY，主端由模拟设备读写，从端（/dev/pts/N）交给被测程序当作串口打开
+    应答延迟 = latency + [0, jitter) 随机抖动
+    故障注入：按概率丢弃应答、破坏校验、拆成两段发送
+ */
+class PtyEndpoint : public QObject
+{
+    Q_OBJECT
+public:
+    struct Faults {
+        int latencyMs = 0;
+        int jitterMs = 0;
+        double dropRate = 0;        // 丢弃应答
+        double corruptRate = 0;     // 校验错误
+        double splitRate = 0;       // 拆包
+    };
+
+    PtyEndpoint(std::unique_ptr<SimDevice> device, const Faults &faults, QObject *parent = nullptr);
+    ~PtyEndpoint() override;
+
+    bool open();
+    QString slavePath() const { return m_slavePath; }
+    SimDevice *device() const { return m_device.get(); }
+
+    int dropped() const { return m_dropped; }
+    int corrupted() const { return m_corrupted; }
+
+private slots:
+    void onReadable();
+    void onWritable();
+
+private:
+    void send(QByteArray frame);
+    void writeAll(const QByteArray &data);
+    void flushPending();
+
+    std::unique_ptr<SimDevice> m_device;
+    Faults m_faults;
+    int m_master = -1;
+    int m_slave = -1;       // 保持从端打开，被测程序关闭串口时主端不会读到EIO
+    QString m_slavePath;
+    QSocketNotifier *m_notifier = nullptr;
+    QSocketNotifier *m_writeNotifier = nullptr;    // 主端写满（EAGAIN）时启用，可写后继续发送
+    QByteArray m_pending;                          // 尚未写入主端的应答数据
+    QRandomGenerator m_random;
+    QElapsedTimer m_clock;
+    qint64 m_lastDue = 0;   // 上一帧计划发送的时间，保证应答按顺序发出
+    int m_dropped = 0;
+    int m_corrupted = 0;
+};
+
+#endif // PTYENDPOINT_H
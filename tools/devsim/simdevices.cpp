@@ -0,0 +1,581 @@
+#include "simdevices.h"
+#include <QtEndian>
+#include <QtMath>
+
+namespace {
+    const int IT_FRAME_LENGTH = 26;
+    const int CL_MAX_FRAME_LENGTH = 64;
+}
+
+void SimDevice::corrupt(QByteArray &frame) const
+{
+    if (!frame.isEmpty()) {
+        frame[frame.size() - 1] = char(frame.at(frame.size() - 1) ^ 0x5A);
+    }
+}
+
+// ---------------- IT8512+ ----------------
+
+It8512Sim::It8512Sim(quint8 address)
+    : m_address(address)
+{
+    for (QByteArray &params : m_dynamic) {
+        params = QByteArray(22, '\0');
+    }
+    m_clock.start();
+}
+
+QVector<QByteArray> It8512Sim::feed(const QByteArray &data)
+{
+    m_buffer.append(data);
+    QVector<QByteArray> replies;
+
+    while (m_buffer.size() >= IT_FRAME_LENGTH) {
+        int start = m_buffer.indexOf(char(0xAA));
+        if (start < 0) {
+            m_buffer.clear();
+            break;
+        }
+        if (start > 0) {
+            m_buffer.remove(0, start);
+            continue;
+        }
+        if (m_buffer.size() < IT_FRAME_LENGTH) {
+            break;
+        }
+        QByteArray frame = m_buffer.left(IT_FRAME_LENGTH);
+        m_buffer.remove(0, IT_FRAME_LENGTH);
+        ++m_framesReceived;
+
+        QByteArray response = handle(frame);
+        if (!response.isEmpty()) {
+            replies.append(response);
+            ++m_framesSent;
+        }
+    }
+    return replies;
+}
+
+QByteArray It8512Sim::handle(const QByteArray &frame)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(frame.constData());
+    quint8 sum = 0;
+    for (int i = 0; i < IT_FRAME_LENGTH - 1; ++i) {
+        sum += p[i];
+    }
+    if (sum != p[IT_FRAME_LENGTH - 1]) {
+        return setResult(0x90);
+    }
+
+    const quint8 cmd = p[2];
+    const quint32 value = qFromLittleEndian<quint32>(p + 3);
+    auto le32 = [](quint32 v) {
+        QByteArray bytes(4, '\0');
+        qToLittleEndian<quint32>(v, bytes.data());
+        return bytes;
+    };
+
+    switch (cmd) {
+    case 0x20: m_controlMode = p[3]; return setResult(0x80);
+    case 0x21: m_loadOn = p[3] != 0; return setResult(0x80);
+    case 0x22: m_maxVoltage = value; return setResult(0x80);
+    case 0x23: return reply(cmd, le32(m_maxVoltage));
+    case 0x24: m_maxCurrent = value; return setResult(0x80);
+    case 0x25: return reply(cmd, le32(m_maxCurrent));
+    case 0x26: m_maxPower = value; return setResult(0x80);
+    case 0x27: return reply(cmd, le32(m_maxPower));
+    case 0x28:
+        if (p[3] > 3) {
+            return setResult(0xA0);
+        }
+        m_loadMode = p[3];
+        return setResult(0x80);
+    case 0x29: return reply(cmd, QByteArray(1, char(m_loadMode)));
+    case 0x2A:
+        if (value > m_maxCurrent) {
+            return setResult(0xA0);
+        }
+        m_cc = value;
+        return setResult(0x80);
+    case 0x2B: return reply(cmd, le32(m_cc));
+    case 0x2C:
+        if (value > m_maxVoltage) {
+            return setResult(0xA0);
+        }
+        m_cv = value;
+        return setResult(0x80);
+    case 0x2D: return reply(cmd, le32(m_cv));
+    case 0x2E:
+        if (value > m_maxPower) {
+            return setResult(0xA0);
+        }
+        m_cw = value;
+        return setResult(0x80);
+    case 0x2F: return reply(cmd, le32(m_cw));
+    case 0x30: m_cr = value; return setResult(0x80);
+    case 0x31: return reply(cmd, le32(m_cr));
+    case 0x32: case 0x34: case 0x36: case 0x38:
+        m_dynamic[(cmd - 0x32) / 2] = frame.mid(3, 22);
+        return setResult(0x80);
+    case 0x33: case 0x35: case 0x37: case 0x39:
+        return reply(cmd, m_dynamic[(cmd - 0x33) / 2]);
+    case 0x3A:
+        if (p[3] > 3) {
+            return setResult(0xA0);
+        }
+        m_listMode = p[3];
+        return setResult(0x80);
+    case 0x3B: return reply(cmd, QByteArray(1, char(m_listMode)));
+    case 0x3C: m_listRepeat = p[3] ? 1 : 0; return setResult(0x80);
+    case 0x3D: return reply(cmd, QByteArray(1, char(m_listRepeat)));
+    case 0x3E: {
+        const quint16 count = qFromLittleEndian<quint16>(p + 3);
+        if (count < 2 || count > 84) {
+            return setResult(0xA0);
+        }
+        m_listCount = count;
+        return setResult(0x80);
+    }
+    case 0x3F: {
+        QByteArray count(2, '\0');
+        qToLittleEndian<quint16>(m_listCount, count.data());
+        return reply(cmd, count);
+    }
+    case 0x40: case 0x42: case 0x44: case 0x46: {
+        const quint16 step = qFromLittleEndian<quint16>(p + 3);
+        if (step < 1 || step > m_listCount) {
+            return setResult(0xA0);
+        }
+        m_listSteps[step] = frame.mid(5, 6);
+        return setResult(0x80);
+    }
+    case 0x41: case 0x43: case 0x45: case 0x47: {
+        const quint16 step = qFromLittleEndian<quint16>(p + 3);
+        return reply(cmd, frame.mid(3, 2) + m_listSteps.value(step, QByteArray(6, '\0')));
+    }
+    case 0x48: m_listName = frame.mid(3, 10); return setResult(0x80);
+    case 0x49: return reply(cmd, m_listName);
+    case 0x4A:
+        if (p[3] != 1 && p[3] != 2 && p[3] != 4 && p[3] != 8) {
+            return setResult(0xA0);
+        }
+        m_listPartition = p[3];
+        return setResult(0x80);
+    case 0x4B: return reply(cmd, QByteArray(1, char(m_listPartition)));
+    case 0x4C: case 0x4D:
+        return setResult(p[3] >= 1 && p[3] <= 8 / m_listPartition ? 0x80 : 0xA0);
+    case 0x58:
+        if (p[3] > 2) {
+            return setResult(0xA0);
+        }
+        m_triggerSource = p[3];
+        return setResult(0x80);
+    case 0x59: return reply(cmd, QByteArray(1, char(m_triggerSource)));
+    case 0x5A: case 0x9D: case 0x98:
+        return setResult(0x80);
+    case 0x5D: m_workMode = p[3]; return setResult(0x80);
+    case 0x5E: return reply(cmd, QByteArray(1, char(m_workMode)));
+    case 0x5F: return inputParams();
+    case 0x6A: {
+        QByteArray info("85120");               // 型号
+        info.append(char(0x01)).append(char(0x20));   // 版本 BCD
+        info.append("SIM0000001");              // 序列号
+        return reply(cmd, info);
+    }
+    default:
+        return setResult(0xC0);
+    }
+}
+
+QByteArray It8512Sim::reply(quint8 cmd, const QByteArray &payload) const
+{
+    QByteArray frame(IT_FRAME_LENGTH, '\0');
+    frame[0] = char(0xAA);
+    frame[1] = char(m_address);
+    frame[2] = char(cmd);
+    for (int i = 0; i < payload.size() && i < IT_FRAME_LENGTH - 4; ++i) {
+        frame[3 + i] = payload.at(i);
+    }
+    quint8 sum = 0;
+    for (int i = 0; i < IT_FRAME_LENGTH - 1; ++i) {
+        sum += quint8(frame.at(i));
+    }
+    frame[IT_FRAME_LENGTH - 1] = char(sum);
+    return frame;
+}
+
+QByteArray It8512Sim::setResult(quint8 status) const
+{
+    return reply(0x12, QByteArray(1, char(status)));
+}
+
+QByteArray It8512Sim::inputParams() const
+{
+    // 12V电源带载，按当前模式计算电流，叠加少量纹波
+    double ripple = 1.0 + 0.002 * qSin(m_clock.elapsed() / 500.0);
+    double voltage = 12.0 * ripple;
+    double current = 0;
+    if (m_loadOn) {
+        switch (m_loadMode) {
+        case 0: current = m_cc / 10000.0; break;
+        case 1: voltage = m_cv / 1000.0; current = 1.0; break;
+        case 2: current = (m_cw / 1000.0) / voltage; break;
+        case 3: current = m_cr ? voltage / (m_cr / 1000.0) : 0; break;
+        }
+        voltage -= current * 0.05;  // 线阻压降
+    }
+    double power = voltage * current;
+
+    QByteArray payload(22, '\0');
+    uchar *p = reinterpret_cast<uchar *>(payload.data());
+    qToLittleEndian<quint32>(quint32(voltage * 1000), p);
+    qToLittleEndian<quint32>(quint32(current * 10000), p + 4);
+    qToLittleEndian<quint32>(quint32(power * 1000), p + 8);
+    p[12] = quint8((m_loadOn ? 0x08 : 0) | (m_controlMode ? 0x04 : 0));    // 操作状态
+    p[17] = 30;             // 散热器温度
+    p[18] = m_workMode;
+    return reply(0x5F, payload);
+}
+
+// ---------------- CL-200A ----------------
+
+Cl200aSim::Cl200aSim()
+{
+    m_clock.start();
+}
+
+QVector<QByteArray> Cl200aSim::feed(const QByteArray &data)
+{
+    m_buffer.append(data);
+    QVector<QByteArray> replies;
+
+    while (true) {
+        int start = m_buffer.indexOf(char(0x02));
+        if (start < 0) {
+            m_buffer.clear();
+            break;
+        }
+        m_buffer.remove(0, start);
+        int end = m_buffer.indexOf("\r\n");
+        if (end < 0) {
+            if (m_buffer.size() > CL_MAX_FRAME_LENGTH) {
+                m_buffer.remove(0, 1);
+                continue;
+            }
+            break;
+        }
+        QByteArray frame = m_buffer.left(end + 2);
+        m_buffer.remove(0, end + 2);
+        ++m_framesReceived;
+
+        // STX 数据 ETX BCC(2) CRLF
+        int total = frame.size();
+        if (total < 10 || frame.at(total - 5) != 0x03) {
+            continue;
+        }
+        quint8 bcc = 0;
+        for (int i = 1; i <= total - 5; ++i) {
+            bcc ^= quint8(frame.at(i));
+        }
+        if (frame.mid(total - 4, 2).toUInt(nullptr, 16) != bcc) {
+            continue;   // 校验错误，真机不应答
+        }
+
+        QByteArray response = handle(frame.mid(1, total - 6));
+        if (!response.isEmpty()) {
+            replies.append(response);
+            ++m_framesSent;
+        }
+    }
+    return replies;
+}
+
+void Cl200aSim::corrupt(QByteArray &frame) const
+{
+    // 改写BCC的低位字符
+    if (frame.size() >= 4) {
+        char &c = frame[frame.size() - 3];
+        c = (c == '0') ? '1' : '0';
+    }
+}
+
+QByteArray Cl200aSim::handle(const QByteArray &body)
+{
+    const QByteArray head = body.left(2);
+    const QByteArray cmd = body.mid(2, 2);
+
+    if (cmd == "54") {
+        m_pcMode = true;
+        return message(head + "541   ");
+    }
+    if (!m_pcMode) {
+        return QByteArray();
+    }
+    if (cmd == "55") {
+        return QByteArray();    // 保持状态，无应答
+    }
+    if (cmd == "40") {
+        if (head == "99") {
+            // EXT测量：D65光源，照度带纹波
+            double t = m_clock.elapsed() / 1000.0;
+            m_ev = 500.0 + 25.0 * qSin(t);
+            const double x = 0.3127, y = 0.3290;
+            m_y = m_ev;
+            m_x = x / y * m_ev;
+            m_z = (1 - x - y) / y * m_ev;
+            m_measured = true;
+            return QByteArray();
+        }
+        return message(head + "40    ");
+    }
+    if (cmd == "48") {
+        return message(head + "48    ");
+    }
+
+    // 读取测量值：受光部 功能码 固定'1' 错误 量程（'1'正常） 电池 + 3个数据块
+    QByteArray reply = head + cmd + '1' + (m_measured ? ' ' : '1') + "10";
+    // 多受光部：各受光部照度依次递减2%，模拟均匀度测量
+    const double k = 1.0 - 0.02 * head.toInt();
+    const double ev = m_ev * k;
+    const double x = m_x / (m_x + m_y + m_z + 1e-12);
+    const double y = m_y / (m_x + m_y + m_z + 1e-12);
+    const double denom = -2 * x + 12 * y + 3;
+    if (cmd == "01") {
+        reply += longBlock(m_x * k) + longBlock(m_y * k) + longBlock(m_z * k);
+    } else if (cmd == "02") {
+        reply += longBlock(ev) + longBlock(x) + longBlock(y);
+    } else if (cmd == "03") {
+        reply += longBlock(ev) + longBlock(4 * x / denom) + longBlock(9 * y / denom);
+    } else if (cmd == "08") {
+        reply += longBlock(ev) + longBlock(6504) + longBlock(0.0032);
+    } else if (cmd == "15") {
+        reply += longBlock(ev) + longBlock(475.0) + longBlock(2.0);
+    } else {
+        return QByteArray();
+    }
+    return message(reply);
+}
+
+QByteArray Cl200aSim::message(const QByteArray &body)
+{
+    QByteArray frame;
+    frame.append(char(0x02));
+    frame.append(body);
+    frame.append(char(0x03));
+    quint8 bcc = 0;
+    for (char c : body) {
+        bcc ^= quint8(c);
+    }
+    bcc ^= 0x03;
+    frame.append(QByteArray::number(bcc, 16).rightJustified(2, '0').toUpper());
+    frame.append("\r\n");
+    return frame;
+}
+
+// 长格式数据块：符号 + 4位有效数字 + 指数，值 = 有效数字 × 10^(指数-4)
+QByteArray Cl200aSim::longBlock(double value)
+{
+    char sign = value < 0 ? '-' : '+';
+    value = qAbs(value);
+    int exponent = 0;
+    double mantissa = value * 10000.0;
+    while (mantissa >= 9999.5 && exponent < 9) {
+        ++exponent;
+        mantissa = value / qPow(10.0, exponent - 4);
+    }
+    QByteArray block;
+    block.append(sign);
+    block.append(QByteArray::number(qRound(mantissa)).rightJustified(4, '0'));
+    block.append(char('0' + exponent));
+    return block;
+}
+
+// ---------------- LD驱动 ----------------
+
+LdDriverSim::LdDriverSim(quint8 address, int channelCount)
+    : m_address(address)
+    , m_channels(channelCount, 0)
+{
+}
+
+QVector<QByteArray> LdDriverSim::feed(const QByteArray &data)
+{
+    m_buffer.append(data);
+    QVector<QByteArray> replies;
+
+    while (m_buffer.size() >= 3) {
+        int start = m_buffer.indexOf("LD");
+        if (start < 0) {
+            m_buffer = m_buffer.right(1);
+            break;
+        }
+        if (start > 0) {
+            m_buffer.remove(0, start);
+            continue;
+        }
+        if (m_buffer.size() < 3) {
+            break;
+        }
+        int total = quint8(m_buffer.at(2)) + 5;
+        if (m_buffer.size() < total) {
+            break;
+        }
+        QByteArray frame = m_buffer.left(total);
+        quint16 crc = qFromBigEndian<quint16>(frame.constData() + total - 2);
+        if (total < 9 || crc16(frame.constData() + 2, total - 4) != crc) {
+            m_buffer.remove(0, 1);  // 重新同步
+            continue;
+        }
+        m_buffer.remove(0, total);
+        ++m_framesReceived;
+
+        QByteArray response = handle(frame);
+        if (!response.isEmpty()) {
+            replies.append(response);
+            ++m_framesSent;
+        }
+    }
+    return replies;
+}
+
+void LdDriverSim::corrupt(QByteArray &frame) const
+{
+    if (frame.size() >= 2) {
+        frame[frame.size() - 2] = char(frame.at(frame.size() - 2) ^ 0x5A);
+    }
+}
+
+QByteArray LdDriverSim::handle(const QByteArray &frame)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(frame.constData());
+    const quint8 action = p[3];
+    const quint8 sender = p[4];
+    const quint8 func = p[6];
+    const QByteArray data = frame.mid(7, frame.size() - 9);
+    const uchar *d = reinterpret_cast<const uchar *>(data.constData());
+
+    auto be16 = [](quint16 v) {
+        QByteArray bytes(2, '\0');
+        qToBigEndian<quint16>(v, bytes.data());
+        return bytes;
+    };
+    auto be32 = [](quint32 v) {
+        QByteArray bytes(4, '\0');
+        qToBigEndian<quint32>(v, bytes.data());
+        return bytes;
+    };
+
+    if (action == 0x81) {
+        switch (func) {
+        case 0x08: {
+            QByteArray payload;
+            payload.append(char(m_channels.size()));
+            payload.append(be16(0xFE00));   // bit15-bit9 功能可用
+            payload.append(be32(0)).append(be32(m_maxVoltage));
+            payload.append(be32(0)).append(be32(m_maxCurrent));
+            return reply(action, sender, func, payload);
+        }
+        case 0x1C:
+            return reply(action, sender, func, be32(35).append(be32(30)));
+        case 0x24:
+            return reply(action, sender, func, be16(m_ledStatus));
+        case 0x26: {
+            if (data.size() < 2) {
+                return QByteArray();
+            }
+            QByteArray payload = data.left(2);
+            for (int i = 0; i < d[1]; ++i) {
+                int channel = d[0] + i;
+                payload.append(be16(channel < m_channels.size() ? m_channels.at(channel) : 0));
+            }
+            return reply(action, sender, func, payload);
+        }
+        case 0x50:
+            return reply(action, sender, func, be16(m_ledMode));
+        case 0x52:
+            return reply(action, sender, func, be32(m_workTime));
+        case 0x56: {
+            // 电流随亮度线性变化
+            quint32 sum = 0;
+            for (quint16 value : m_channels) {
+                sum += value;
+            }
+            quint32 current = m_ledStatus ? sum / qMax(1, m_channels.size()) * m_maxCurrent / 1000 : 0;
+            return reply(action, sender, func, be32(2400).append(be32(current)));
+        }
+        default:
+            return QByteArray();
+        }
+    }
+
+    switch (func) {
+    case 0x1B:
+        if (!data.isEmpty()) {
+            m_address = d[0];
+        }
+        break;
+    case 0x24:
+        if (data.size() >= 2) {
+            m_ledStatus = qFromBigEndian<quint16>(d);
+        }
+        break;
+    case 0x26:
+        if (data.size() >= 2) {
+            for (int i = 0; i < d[1] && 2 + i * 2 + 1 < data.size(); ++i) {
+                int channel = d[0] + i;
+                if (channel < m_channels.size()) {
+                    m_channels[channel] = qFromBigEndian<quint16>(d + 2 + i * 2);
+                }
+            }
+        }
+        break;
+    case 0x50:
+        if (data.size() >= 2) {
+            m_ledMode = qFromBigEndian<quint16>(d);
+        }
+        break;
+    case 0x52:
+        if (data.size() >= 4) {
+            m_workTime = qFromBigEndian<quint32>(d);
+        }
+        break;
+    case 0x5E:
+        if (data.size() >= 8) {
+            m_maxVoltage = qFromBigEndian<quint32>(d);
+            m_maxCurrent = qFromBigEndian<quint32>(d + 4);
+        }
+        break;
+    default:
+        break;
+    }
+    // 写指令原样应答
+    return reply(action, sender, func, data);
+}
+
+QByteArray LdDriverSim::reply(quint8 action, quint8 receiver, quint8 func, const QByteArray &payload) const
+{
+    QByteArray frame;
+    frame.append("LD");
+    frame.append(char(4 + payload.size()));
+    frame.append(char(action));
+    frame.append(char(m_address));
+    frame.append(char(receiver));
+    frame.append(char(func));
+    frame.append(payload);
+    quint16 crc = crc16(frame.constData() + 2, frame.size() - 2);
+    frame.append(char(crc >> 8));
+    frame.append(char(crc & 0xFF));
+    return frame;
+}
+
+quint16 LdDriverSim::crc16(const char *data, int size)
+{
+    quint16 crc = 0x4c44;
+    for (int i = 0; i < size; ++i) {
+        crc ^= quint8(data[i]);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x0001) ? quint16((crc >> 1) ^ 0xA001) : quint16(crc >> 1);
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,120 @@
+#ifndef SIMDEVICES_H
+#define SIMDEVICES_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QString>
+#include <QElapsedTimer>
+#include <QHash>
+
+/**
+ * 模拟设备
+    从收到的字节流中切出完整命令，返回应答报文（可能没有应答）
+    校验错误的命令按真实设备处理：IT8512+ 回 0x12/0x90，其余丢弃
+ */
+class SimDevice
+{
+public:
+    virtual ~SimDevice() = default;
+
+    virtual QString name() const = 0;
+    // 追加收到的数据，返回需要发送的应答
+    virtual QVector<QByteArray> feed(const QByteArray &data) = 0;
+    // 在应答中注入校验错误
+    virtual void corrupt(QByteArray &frame) const;
+
+    int framesReceived() const { return m_framesReceived; }
+    int framesSent() const { return m_framesSent; }
+
+protected:
+    QByteArray m_buffer;
+    int m_framesReceived = 0;
+    int m_framesSent = 0;
+};
+
+// IT8512+ 电子负载，26字节定长报文
+class It8512Sim : public SimDevice
+{
+public:
+    explicit It8512Sim(quint8 address = 0x00);
+
+    QString name() const override { return "IT8512+"; }
+    QVector<QByteArray> feed(const QByteArray &data) override;
+
+private:
+    QByteArray handle(const QByteArray &frame);
+    QByteArray reply(quint8 cmd, const QByteArray &payload = QByteArray()) const;
+    QByteArray setResult(quint8 status) const;
+    QByteArray inputParams() const;
+
+    quint8 m_address;
+    quint8 m_controlMode = 0;   // 0面板 1远程
+    bool m_loadOn = false;
+    quint8 m_loadMode = 0;      // 0 CC 1 CV 2 CW 3 CR
+    quint8 m_workMode = 0;
+    quint32 m_maxVoltage = 120000;  // 1mV
+    quint32 m_maxCurrent = 300000;  // 0.1mA
+    quint32 m_maxPower = 300000;    // 1mW
+    quint32 m_cc = 10000;
+    quint32 m_cv = 12000;
+    quint32 m_cw = 10000;
+    quint32 m_cr = 10000;
+    QByteArray m_dynamic[4];    // 动态参数原样保存
+    // LIST 模式
+    quint8 m_listMode = 0;
+    quint8 m_listRepeat = 0;
+    quint16 m_listCount = 0;
+    QHash<quint16, QByteArray> m_listSteps;     // 步号 -> 设定值(4) + 时间(2)
+    QByteArray m_listName;
+    quint8 m_listPartition = 1;
+    quint8 m_triggerSource = 0;
+    QElapsedTimer m_clock;
+};
+
+// CL-200A 照度计，STX 数据 ETX BCC CRLF
+class Cl200aSim : public SimDevice
+{
+public:
+    Cl200aSim();
+
+    QString name() const override { return "CL-200A"; }
+    QVector<QByteArray> feed(const QByteArray &data) override;
+    void corrupt(QByteArray &frame) const override;
+
+private:
+    QByteArray handle(const QByteArray &body);
+    static QByteArray message(const QByteArray &body);
+    static QByteArray longBlock(double value);
+
+    bool m_pcMode = false;
+    bool m_measured = false;    // EXT测量后才有数据
+    double m_ev = 0;
+    double m_x = 0, m_y = 0, m_z = 0;
+    QElapsedTimer m_clock;
+};
+
+// LD驱动，0x4C44起始，CRC16
+class LdDriverSim : public SimDevice
+{
+public:
+    LdDriverSim(quint8 address, int channelCount);
+
+    QString name() const override { return QString("LD-%1CH").arg(m_channels.size()); }
+    QVector<QByteArray> feed(const QByteArray &data) override;
+    void corrupt(QByteArray &frame) const override;
+
+private:
+    QByteArray handle(const QByteArray &frame);
+    QByteArray reply(quint8 action, quint8 receiver, quint8 func, const QByteArray &payload) const;
+    static quint16 crc16(const char *data, int size);
+
+    quint8 m_address;
+    QVector<quint16> m_channels;
+    quint16 m_ledStatus = 0;
+    quint16 m_ledMode = 0;
+    quint32 m_workTime = 0;
+    quint32 m_maxVoltage = 4800;    // 0.01V
+    quint32 m_maxCurrent = 300;     // 0.01A
+};
+
+#endif // SIMDEVICES_H
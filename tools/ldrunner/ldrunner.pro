@@ -0,0 +1,58 @@
+# 无界面测试序列执行程序：按序列文件控制驱动器/电子负载/照度计并写出结果，适合产线脚本和CI调用
+# 用法：ldrunner sequence.json [--driver COM3] [--load COM4] [--meter COM5] [--output results.csv]
+#       ldrunner sequence.json --replay serial.trace [--replay-fast]
+# 退出码：0 通过，1 检查不通过，2 序列或设备错误
+
+QT       = core serialport
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = ldrunner
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../automation/devicesession.cpp \
+    ../../automation/pairedacquisition.cpp \
+    ../../automation/sequencerunner.cpp \
+    ../../automation/testsequence.cpp \
+    ../../serial/serialutil.cpp \
+    ../../serial/serialtrace.cpp \
+    ../../serial/replayport.cpp \
+    ../../communication/protocol.cpp \
+    ../../communication/drivergeneral.cpp \
+    ../../communication/eleload_itplus.cpp \
+    ../../communication/cl_twozerozeroacom.cpp \
+    ../../devices/meter/cl200a/cl200aengine.cpp \
+    ../../devices/load/it8512plus/loadtelemetry.cpp \
+    ../../util/config.cpp \
+    ../../util/logger.cpp \
+    ../../util/logcategories.cpp \
+    ../../util/colorimetry.cpp
+
+HEADERS += \
+    ../../automation/devicesession.h \
+    ../../automation/pairedacquisition.h \
+    ../../automation/sequencerunner.h \
+    ../../automation/testsequence.h \
+    ../../serial/serialutil.h \
+    ../../serial/serialtrace.h \
+    ../../serial/replayport.h \
+    ../../communication/protocol.h \
+    ../../communication/drivergeneral.h \
+    ../../communication/eleload_itplus.h \
+    ../../communication/cl_twozerozeroacom.h \
+    ../../communication/fieldcodec.h \
+    ../../communication/clblockcodec.h \
+    ../../communication/fixedframedecoder.h \
+    ../../devices/meter/cl200a/cl200aengine.h \
+    ../../devices/load/it8512plus/loadtelemetry.h \
+    ../../util/config.h \
+    ../../util/logger.h \
+    ../../util/logcategories.h \
+    ../../util/colorimetry.h \
+    ../../util/devicestate.h \
+    ../../util/mpscqueue.h \
+    ../../util/steadyclock.h
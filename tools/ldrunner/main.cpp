@@ -0,0 +1,166 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QTimer>
+#include <csignal>
+#include "automation/devicesession.h"
+#include "automation/sequencerunner.h"
+#include "automation/testsequence.h"
+#include "serial/replayport.h"
+#include "serial/serialtrace.h"
+#include "util/config.h"
+#include "util/logcategories.h"
+#include "util/logger.h"
+
+namespace {
+    volatile std::sig_atomic_t g_interrupted = 0;
+
+    enum ExitCode {
+        Passed = 0,
+        ChecksFailed = 1,
+        Error = 2
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    QElapsedTimer startup;
+    startup.start();
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ldrunner");
+    LogCategories::applyFilterRules();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("无界面测试序列执行程序");
+    parser.addHelpOption();
+    parser.addPositionalArgument("sequence", "测试序列文件（JSON）");
+    QCommandLineOption driverOption("driver", "驱动器串口（覆盖序列中的设置）", "port");
+    QCommandLineOption loadOption("load", "电子负载串口（覆盖序列中的设置）", "port");
+    QCommandLineOption meterOption("meter", "照度计串口（覆盖序列中的设置）", "port");
+    QCommandLineOption outputOption("output", "结果CSV文件，默认 results/<序列名>_<时间>.csv", "file");
+    QCommandLineOption replayOption("replay", "回放串口报文记录文件", "file");
+    QCommandLineOption replayFastOption("replay-fast", "回放时不等待原始时间间隔");
+    QCommandLineOption quietOption("quiet", "不逐条输出测量结果");
+    for (const QCommandLineOption &option : {driverOption, loadOption, meterOption, outputOption,
+                                             replayOption, replayFastOption, quietOption}) {
+        parser.addOption(option);
+    }
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (parser.positionalArguments().size() != 1) {
+        err << "需要指定一个序列文件，见 --help\n";
+        return Error;
+    }
+
+    QString error;
+    TestSequence sequence = TestSequence::fromFile(parser.positionalArguments().first(), &error);
+    if (!error.isEmpty()) {
+        err << error << "\n";
+        return Error;
+    }
+    if (parser.isSet(driverOption)) {
+        sequence.driverPort = parser.value(driverOption);
+    }
+    if (parser.isSet(loadOption)) {
+        sequence.loadPort = parser.value(loadOption);
+    }
+    if (parser.isSet(meterOption)) {
+        sequence.meterPort = parser.value(meterOption);
+    }
+
+    if (parser.isSet(replayOption) &&
+        !ReplayPort::load(parser.value(replayOption),
+                          parser.isSet(replayFastOption) ? ReplayPort::Fast : ReplayPort::Timed)) {
+        err << "无法读取回放文件 " << parser.value(replayOption) << "\n";
+        return Error;
+    }
+    if (Config::getValue(ConfigKeys::TRACE_ENABLED, true).toBool()) {
+        qint64 capacityMB = Config::getValue(ConfigKeys::TRACE_CAPACITY_MB, 16).toLongLong();
+        SerialTrace::start(QCoreApplication::applicationDirPath() + "/logs/serial.trace",
+                           capacityMB * 1024 * 1024);
+    }
+
+    // 序列用不到的设备不创建串口
+    DriverSession *driver = sequence.driverPort.isEmpty() ? nullptr : new DriverSession(&app);
+    LoadSession *load = sequence.loadPort.isEmpty() ? nullptr : new LoadSession(&app);
+    MeterSession *meter = sequence.meterPort.isEmpty() ? nullptr : new MeterSession(&app);
+    SequenceRunner runner(driver, load, meter);
+
+    const bool quiet = parser.isSet(quietOption);
+    QObject::connect(&runner, &SequenceRunner::measured, &runner, [&](const SequenceRunner::Result &r) {
+        if (quiet) {
+            return;
+        }
+        QString line = QString("%1  %2 ms").arg(r.label, 8).arg(r.elapsedMs, 9, 'f', 1);
+        if (r.meterOk) {
+            line += QString("  %1 lx  x=%2 y=%3  %4 K")
+                    .arg(r.meter.ev, 0, 'f', 2).arg(r.meter.x, 0, 'f', 4).arg(r.meter.y, 0, 'f', 4)
+                    .arg(r.meter.tcp, 0, 'f', 0);
+        }
+        if (r.loadOk) {
+            line += QString("  %1 V  %2 A  %3 W")
+                    .arg(r.load.voltage, 0, 'f', 3).arg(r.load.current, 0, 'f', 4).arg(r.load.power, 0, 'f', 3);
+        }
+        out << line << "\n";
+        out.flush();
+    });
+
+    int exitCode = Error;
+    bool done = false;
+    QObject::connect(&runner, &SequenceRunner::finished, &runner, [&](const SequenceRunner::Report &report) {
+        QString output = parser.value(outputOption);
+        if (output.isEmpty()) {
+            QDir().mkpath("results");
+            output = QString("results/%1_%2.csv").arg(sequence.name)
+                    .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+        }
+        const bool written = runner.results().isEmpty() || runner.writeCsv(output);
+
+        out << QString("序列 %1: %2\n").arg(sequence.name)
+               .arg(report.passed ? "通过" : report.completed ? "不通过" : "中止（" + report.error + "）");
+        out << QString("  步骤 %1/%2  测量 %3  检查 %4（不通过 %5）\n")
+               .arg(report.executed).arg(sequence.steps.size())
+               .arg(report.measurements).arg(report.checks).arg(report.failedChecks);
+        out << QString("  打开设备 %1 ms  执行 %2 ms\n")
+               .arg(report.openMs, 0, 'f', 0).arg(report.durationMs, 0, 'f', 0);
+        if (!runner.results().isEmpty()) {
+            out << "  结果: " << (written ? output : QString("写入失败")) << "\n";
+        }
+        out.flush();
+
+        done = true;
+        exitCode = !report.completed || !written ? Error : report.passed ? Passed : ChecksFailed;
+        QCoreApplication::quit();
+    });
+
+    // Ctrl+C 中止序列，已有的结果照常写出
+    std::signal(SIGINT, [](int) { g_interrupted = 1; });
+    std::signal(SIGTERM, [](int) { g_interrupted = 1; });
+    QTimer interruptTimer;
+    QObject::connect(&interruptTimer, &QTimer::timeout, &runner, [&]() {
+        if (g_interrupted) {
+            runner.stop();
+        }
+    });
+    interruptTimer.start(100);
+
+    LD_DEBUG(lcProtocol) << "ldrunner 启动用时" << startup.elapsed() << "ms";
+    // 打开设备失败等情况下 finished 在 start() 内同步发出，此时不再进入事件循环
+    runner.start(sequence);
+    if (!done && runner.isRunning()) {
+        app.exec();
+    }
+    if (!done) {
+        err << "无法开始序列，详见日志\n";
+    }
+
+    SerialTrace::shutdown();
+    Logger::shutdown();
+    return exitCode;
+}
@@ -0,0 +1,170 @@
+#include "clbench.h"
+#include "communication/clblockcodec.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // 原先 CL_TwoZeroZeroACOM::parseLongDataBlock 的实现，作为对照
+    float legacyParseLong(const QByteArray &block)
+    {
+        if(block.size() != 6) return 0.0f;
+        int sign = (block.at(0) == '-') ? -1 : 1;
+        QString valueStr = block.mid(1,4).trimmed();
+        float value = valueStr.toFloat();
+        int exponent = block.at(5) - '0';
+        float multiplier = std::pow(10,exponent - 4);
+        return sign * value * multiplier;
+    }
+
+    // 原先 CL_TwoZeroZeroACOM::calculateBCC 的实现
+    QString legacyBCC(const QByteArray &data)
+    {
+        quint8 bcc = 0;
+        for(char byte : data){
+            bcc ^= static_cast<quint8>(byte);
+        }
+        char highNibble = (bcc >> 4) < 10 ? (bcc >> 4) + '0' : (bcc >> 4) - 10 + 'A';
+        char lowNibble = (bcc & 0x0F) < 10 ? (bcc & 0x0F) + '0' : (bcc & 0x0F) - 10 + 'A';
+        QString bccResult;
+        bccResult.append(highNibble);
+        bccResult.append(lowNibble);
+        return bccResult;
+    }
+
+    bool sameBits(float a, float b)
+    {
+        return std::memcmp(&a, &b, sizeof(float)) == 0;
+    }
+
+    // 全部合法的长格式数据块
+    QVector<QByteArray> longBlocks()
+    {
+        QVector<QByteArray> blocks;
+        blocks.reserve(2 * 10000 * 2 * 10);
+        for (char sign : {'+', '-'}) {
+            for (int mantissa = 0; mantissa < 10000; ++mantissa) {
+                const QByteArray zeroPadded = QByteArray::number(mantissa).rightJustified(4, '0');
+                const QByteArray spacePadded = QByteArray::number(mantissa).rightJustified(4, ' ');
+                for (const QByteArray &digits : {zeroPadded, spacePadded}) {
+                    for (char exponent = '0'; exponent <= '9'; ++exponent) {
+                        blocks.append(sign + digits + exponent);
+                    }
+                }
+            }
+        }
+        return blocks;
+    }
+
+    int checkLong(const QVector<QByteArray> &blocks, QTextStream &out)
+    {
+        int mismatches = 0;
+        for (const QByteArray &block : blocks) {
+            const float expected = legacyParseLong(block);
+            const float actual = ClBlockCodec::parseLong(block.constData());
+            if (!sameBits(expected, actual)) {
+                if (mismatches < 10) {
+                    out << "  长格式不一致: \"" << block << "\" 旧 " << expected << " 新 " << actual << "\n";
+                }
+                ++mismatches;
+            }
+        }
+        return mismatches;
+    }
+
+    int checkSpecial(QTextStream &out)
+    {
+        const float values[] = { 0.0f, -0.0f, 1.0f, -1.0f, 0.3127f, 0.329f, 6504.0f, -0.0032f,
+                                 1e-10f, 3.4e38f, 1.17549435e-38f, 123456.789f };
+        int mismatches = 0;
+        char block[ClBlockCodec::SpecialBlockSize];
+        for (float value : values) {
+            ClBlockCodec::formatSpecial(value, block);
+            const float parsed = ClBlockCodec::parseSpecial(block);
+            if (!sameBits(value, parsed)) {
+                out << "  特殊格式往返不一致: " << value << " -> "
+                    << QByteArray(block, ClBlockCodec::SpecialBlockSize) << " -> " << parsed << "\n";
+                ++mismatches;
+            }
+        }
+        // 小写十六进制同样接受
+        if (ClBlockCodec::parseSpecial("3f800000") != 1.0f || ClBlockCodec::parseSpecial("3F80000G") != 0.0f) {
+            out << "  特殊格式十六进制解析错误\n";
+            ++mismatches;
+        }
+        return mismatches;
+    }
+
+    int checkBCC(QTextStream &out)
+    {
+        int mismatches = 0;
+        QByteArray data;
+        for (int size = 0; size < 64; ++size) {
+            char bcc[2];
+            ClBlockCodec::formatHexByte(ClBlockCodec::bcc(data.constData(), data.size()), bcc);
+            if (QString::fromLatin1(bcc, 2) != legacyBCC(data)) {
+                out << "  BCC 不一致: " << data.toHex() << "\n";
+                ++mismatches;
+            }
+            data.append(char(size * 37 + 11));
+        }
+        return mismatches;
+    }
+
+    double nsPerBlock(qint64 nsecs, qint64 blocks)
+    {
+        return blocks > 0 ? double(nsecs) / double(blocks) : 0.0;
+    }
+}
+
+int runClBenchmark(int iterations, QTextStream &out)
+{
+    const QVector<QByteArray> blocks = longBlocks();
+
+    const int longMismatches = checkLong(blocks, out);
+    const int specialMismatches = checkSpecial(out);
+    const int bccMismatches = checkBCC(out);
+    out << "长格式数据块 " << blocks.size() << " 个，与旧实现不一致 " << longMismatches << "\n"
+        << "特殊格式往返不一致 " << specialMismatches << "，BCC 不一致 " << bccMismatches << "\n";
+
+    // 基准：一段连续缓冲区中的数据块，旧实现需要先 mid() 出 QByteArray
+    QByteArray buffer;
+    buffer.reserve(blocks.size() * ClBlockCodec::LongBlockSize);
+    for (const QByteArray &block : blocks) {
+        buffer.append(block);
+    }
+    const int count = blocks.size();
+    volatile float sink = 0;
+    QElapsedTimer timer;
+
+    timer.start();
+    for (int n = 0; n < iterations; ++n) {
+        float sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += legacyParseLong(buffer.mid(i * ClBlockCodec::LongBlockSize, ClBlockCodec::LongBlockSize));
+        }
+        sink = sink + sum;
+    }
+    const qint64 legacyNs = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int n = 0; n < iterations; ++n) {
+        float sum = 0;
+        const char *p = buffer.constData();
+        for (int i = 0; i < count; ++i) {
+            sum += ClBlockCodec::parseLong(p + i * ClBlockCodec::LongBlockSize);
+        }
+        sink = sink + sum;
+    }
+    const qint64 codecNs = timer.nsecsElapsed();
+
+    const qint64 total = qint64(count) * iterations;
+    out << "重复 " << iterations << " 次\n"
+        << "  QString/std::pow  " << QString::number(nsPerBlock(legacyNs, total), 'f', 1) << " ns/块\n"
+        << "  ClBlockCodec      " << QString::number(nsPerBlock(codecNs, total), 'f', 1) << " ns/块\n";
+
+    return (longMismatches + specialMismatches + bccMismatches) == 0 ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+#ifndef CLBENCH_H
+#define CLBENCH_H
+
+#include <QTextStream>
+
+/**
+ * CL-200A 数据块编解码校验和基准测试（不需要报文记录）
+ *  校验：长格式数据块穷举（符号 × 0000~9999 及前导空格形式 × 指数0~9）与旧的 QString/std::pow
+ *        解析结果逐位比较；特殊格式数据块做格式化/解析往返；BCC 与旧实现比较
+ *  基准：重复 iterations 次解析同一组数据块，输出旧实现和 ClBlockCodec 每个数据块的耗时
+ *  校验失败时返回 1
+ */
+int runClBenchmark(int iterations, QTextStream &out);
+
+#endif // CLBENCH_H
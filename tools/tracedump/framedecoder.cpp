@@ -0,0 +1,260 @@
+#include "framedecoder.h"
+#include <QtEndian>
+
+namespace {
+    const int IT_FRAME_LENGTH = 26;
+    const int CL_MAX_FRAME_LENGTH = 64;
+
+    QString itCommandName(quint8 cmd)
+    {
+        switch (cmd) {
+        case 0x12: return "设置响应";
+        case 0x20: return "设置控制模式";
+        case 0x21: return "设置负载状态";
+        case 0x22: return "设置最大电压";
+        case 0x23: return "读取最大电压";
+        case 0x24: return "设置最大电流";
+        case 0x25: return "读取最大电流";
+        case 0x26: return "设置最大功率";
+        case 0x27: return "读取最大功率";
+        case 0x28: return "设置负载模式";
+        case 0x29: return "读取负载模式";
+        case 0x2A: return "设置CC值";
+        case 0x2B: return "读取CC值";
+        case 0x2C: return "设置CV值";
+        case 0x2D: return "读取CV值";
+        case 0x2E: return "设置CW值";
+        case 0x2F: return "读取CW值";
+        case 0x30: return "设置CR值";
+        case 0x31: return "读取CR值";
+        case 0x32: return "设置动态电流参数";
+        case 0x33: return "读取动态电流参数";
+        case 0x34: return "设置动态电压参数";
+        case 0x35: return "读取动态电压参数";
+        case 0x36: return "设置动态功率参数";
+        case 0x37: return "读取动态功率参数";
+        case 0x38: return "设置动态电阻参数";
+        case 0x39: return "读取动态电阻参数";
+        case 0x3A: return "设置LIST模式";
+        case 0x3B: return "读取LIST模式";
+        case 0x3C: return "设置LIST重复方式";
+        case 0x3D: return "读取LIST重复方式";
+        case 0x3E: return "设置LIST步数";
+        case 0x3F: return "读取LIST步数";
+        case 0x40: return "设置LIST步骤电流";
+        case 0x41: return "读取LIST步骤电流";
+        case 0x42: return "设置LIST步骤电压";
+        case 0x43: return "读取LIST步骤电压";
+        case 0x44: return "设置LIST步骤功率";
+        case 0x45: return "读取LIST步骤功率";
+        case 0x46: return "设置LIST步骤电阻";
+        case 0x47: return "读取LIST步骤电阻";
+        case 0x48: return "设置LIST文件名";
+        case 0x49: return "读取LIST文件名";
+        case 0x4A: return "设置LIST存储分区";
+        case 0x4B: return "读取LIST存储分区";
+        case 0x4C: return "保存LIST文件";
+        case 0x4D: return "调用LIST文件";
+        case 0x58: return "设置触发源";
+        case 0x59: return "读取触发源";
+        case 0x5A: return "总线触发";
+        case 0x5D: return "设置工作模式";
+        case 0x5E: return "读取工作模式";
+        case 0x5F: return "读取输入参数";
+        case 0x6A: return "读取产品信息";
+        case 0x98: return "模拟按键";
+        case 0x9D: return "新触发";
+        default: return QString("未知功能码0x%1").arg(cmd, 2, 16, QChar('0'));
+        }
+    }
+
+    QString itSetResult(quint8 code)
+    {
+        switch (code) {
+        case 0x80: return "成功";
+        case 0x90: return "校验和错误";
+        case 0xA0: return "参数错误或越界";
+        case 0xB0: return "命令无法执行";
+        case 0xC0: return "无效命令";
+        case 0xD0: return "未知命令";
+        default: return QString("0x%1").arg(code, 2, 16, QChar('0'));
+        }
+    }
+
+    QString ldFunctionName(quint8 func)
+    {
+        switch (func) {
+        case 0x08: return "初始化";
+        case 0x1B: return "从机地址";
+        case 0x1C: return "温度";
+        case 0x24: return "LED开关";
+        case 0x26: return "LED亮度";
+        case 0x50: return "LED模式";
+        case 0x52: return "工作时间";
+        case 0x56: return "电压电流";
+        case 0x5E: return "电压电流上限";
+        case 0x60: return "清除报警";
+        default: return QString("未知功能0x%1").arg(func, 2, 16, QChar('0'));
+        }
+    }
+
+    QString clCommandName(const QByteArray &cmd)
+    {
+        if (cmd == "01") return "读取测量值 XYZ";
+        if (cmd == "02") return "读取测量值 EV x y";
+        if (cmd == "03") return "读取测量值 EV u' v'";
+        if (cmd == "08") return "读取测量值 EV TCP Δuv";
+        if (cmd == "15") return "读取测量值 EV 主波长 激发纯度";
+        if (cmd == "40") return "设置EXT模式";
+        if (cmd == "45") return "读取测量值 X2 Y Z";
+        if (cmd == "47") return "读取用户校准系数";
+        if (cmd == "48") return "写入用户校准系数";
+        if (cmd == "54") return "PC连接模式";
+        if (cmd == "55") return "保持状态";
+        return "未知命令" + QString::fromLatin1(cmd);
+    }
+
+    quint16 ldCrc16(const char *data, int size)
+    {
+        quint16 crc = 0x4c44;
+        for (int i = 0; i < size; ++i) {
+            crc ^= quint8(data[i]);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x0001) ? quint16((crc >> 1) ^ 0xA001) : quint16(crc >> 1);
+            }
+        }
+        return crc;
+    }
+
+    bool isStartByte(quint8 byte)
+    {
+        return byte == 0xAA || byte == 0x4C || byte == 0x02;
+    }
+}
+
+QVector<FrameDecoder::Frame> FrameDecoder::feed(const QByteArray &chunk)
+{
+    m_buffer.append(chunk);
+
+    QVector<Frame> frames;
+    Frame frame;
+    while (takeFrame(frame)) {
+        // 连续的无法识别字节合并输出
+        if (frame.protocol == Unknown && !frames.isEmpty() && frames.last().protocol == Unknown) {
+            frames.last().raw.append(frame.raw);
+        } else {
+            frames.append(frame);
+        }
+    }
+    return frames;
+}
+
+QString FrameDecoder::protocolName(Protocol protocol)
+{
+    switch (protocol) {
+    case LDDriver: return "LD";
+    case IT8512Plus: return "IT8512+";
+    case CL200A: return "CL-200A";
+    default: return "?";
+    }
+}
+
+bool FrameDecoder::takeFrame(Frame &frame)
+{
+    if (m_buffer.isEmpty()) {
+        return false;
+    }
+
+    frame = Frame();
+    const quint8 head = quint8(m_buffer.at(0));
+
+    if (head == 0xAA) {
+        if (m_buffer.size() < IT_FRAME_LENGTH) {
+            return false;
+        }
+        quint8 sum = 0;
+        for (int i = 0; i < IT_FRAME_LENGTH - 1; ++i) {
+            sum += quint8(m_buffer.at(i));
+        }
+        if (sum == quint8(m_buffer.at(IT_FRAME_LENGTH - 1))) {
+            frame.protocol = IT8512Plus;
+            frame.raw = m_buffer.left(IT_FRAME_LENGTH);
+            m_buffer.remove(0, IT_FRAME_LENGTH);
+
+            const uchar *p = reinterpret_cast<const uchar *>(frame.raw.constData());
+            quint8 cmd = p[2];
+            frame.note = QString("地址%1 %2").arg(p[1]).arg(itCommandName(cmd));
+            if (cmd == 0x12) {
+                frame.note += " " + itSetResult(p[3]);
+            } else if (cmd == 0x5F && (p[3] | p[4] | p[5] | p[6]) != 0) {
+                frame.note += QString(" U=%1V I=%2A P=%3W")
+                        .arg(qFromLittleEndian<quint32>(p + 3) / 1000.0)
+                        .arg(qFromLittleEndian<quint32>(p + 7) / 10000.0)
+                        .arg(qFromLittleEndian<quint32>(p + 11) / 1000.0);
+            }
+            return true;
+        }
+    } else if (head == 0x4C) {
+        if (m_buffer.size() < 3) {
+            return false;
+        }
+        if (quint8(m_buffer.at(1)) == 0x44) {
+            int total = quint8(m_buffer.at(2)) + 5;
+            if (m_buffer.size() < total) {
+                return false;
+            }
+            quint16 crc = ldCrc16(m_buffer.constData() + 2, total - 4);
+            quint16 expected = qFromBigEndian<quint16>(m_buffer.constData() + total - 2);
+            if (total >= 9 && crc == expected) {
+                frame.protocol = LDDriver;
+                frame.raw = m_buffer.left(total);
+                m_buffer.remove(0, total);
+
+                const uchar *p = reinterpret_cast<const uchar *>(frame.raw.constData());
+                QString action = p[3] == 0x80 ? "写" : (p[3] == 0x81 ? "读" : QString("动作0x%1").arg(p[3], 2, 16, QChar('0')));
+                frame.note = QString("%1->%2 %3%4").arg(p[4]).arg(p[5]).arg(action, ldFunctionName(p[6]));
+                return true;
+            }
+        }
+    } else if (head == 0x02) {
+        int end = m_buffer.indexOf("\r\n");
+        if (end < 0) {
+            if (m_buffer.size() <= CL_MAX_FRAME_LENGTH) {
+                return false;
+            }
+        } else {
+            int total = end + 2;
+            // STX + 数据 + ETX + BCC(2) + CRLF
+            if (total >= 10 && m_buffer.at(total - 5) == 0x03) {
+                quint8 bcc = 0;
+                for (int i = 1; i <= total - 5; ++i) {
+                    bcc ^= quint8(m_buffer.at(i));
+                }
+                bool ok = false;
+                quint8 expected = quint8(m_buffer.mid(total - 4, 2).toUInt(&ok, 16));
+
+                frame.protocol = CL200A;
+                frame.raw = m_buffer.left(total);
+                frame.checksumOk = ok && bcc == expected;
+                m_buffer.remove(0, total);
+
+                QByteArray body = frame.raw.mid(1, total - 6);
+                frame.note = QString("受光部%1 %2 \"%3\"")
+                        .arg(QString::fromLatin1(body.left(2)),
+                             clCommandName(body.mid(2, 2)),
+                             QString::fromLatin1(body.mid(4)));
+                return true;
+            }
+        }
+    }
+
+    // 无法识别：跳到下一个可能的起始字节
+    int next = 1;
+    while (next < m_buffer.size() && !isStartByte(quint8(m_buffer.at(next)))) {
+        ++next;
+    }
+    frame.protocol = Unknown;
+    frame.raw = m_buffer.left(next);
+    m_buffer.remove(0, next);
+    return true;
+}
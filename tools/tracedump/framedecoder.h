@@ -0,0 +1,44 @@
+#ifndef FRAMEDECODER_H
+#define FRAMEDECODER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * 报文切分与注释
+    按收发方向分别缓存数据块，从字节流中切出完整报文：
+    LD驱动（4C 44起始，长度字段，CRC16）
+    IT8512+电子负载（AA起始，定长26字节，累加和）
+    CL-200A照度计（STX...ETX BCC CRLF，ASCII）
+    无法识别的字节单独输出
+ */
+class FrameDecoder
+{
+public:
+    enum Protocol {
+        Unknown,
+        LDDriver,
+        IT8512Plus,
+        CL200A
+    };
+
+    struct Frame {
+        Protocol protocol = Unknown;
+        QByteArray raw;
+        bool checksumOk = true;
+        QString note;       // 功能码说明
+    };
+
+    // 追加一块数据，返回其中已完整的报文
+    QVector<Frame> feed(const QByteArray &chunk);
+
+    static QString protocolName(Protocol protocol);
+
+private:
+    bool takeFrame(Frame &frame);
+
+    QByteArray m_buffer;
+};
+
+#endif // FRAMEDECODER_H
@@ -0,0 +1,17 @@
+#ifndef ITBENCH_H
+#define ITBENCH_H
+
+#include <QVector>
+#include <QTextStream>
+#include "serial/serialtrace.h"
+
+/**
+ * IT8512+ 接收解码基准测试
+ *  把记录中每个端口的接收数据按原始分块依次送入解码器，重复 iterations 次，
+ *  对比旧的 QByteArray 缓存方式（indexOf/left/remove）和 FixedFrameDecoder
+ *  输出两种方式得到的帧数和吞吐量，没有 IT8512+ 帧的端口不输出
+ */
+int runItBenchmark(const QVector<SerialTraceRecord> &records, const QString &portFilter,
+                   int iterations, QTextStream &out);
+
+#endif // ITBENCH_H
@@ -0,0 +1,124 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QHash>
+#include <QTextStream>
+#include <QtEndian>
+#include "serial/serialtrace.h"
+#include "framedecoder.h"
+#include "itbench.h"
+#include "clbench.h"
+
+// 输出一行：墙上时间 相对时间 端口 方向 十六进制 注释
+static void printLine(QTextStream &out, const SerialTraceRecord &record, quint64 firstNs,
+                      const QString &direction, const QByteArray &raw, const QString &note)
+{
+    QString wall = record.wallMs != 0
+            ? QDateTime::fromMSecsSinceEpoch(record.wallMs).toString("yyyy-MM-dd hh:mm:ss.zzz")
+            : QString("-");
+    double relative = double(record.timestampNs - firstNs) / 1e9;
+    out << wall << "  "
+        << QString::number(relative, 'f', 6).rightJustified(12) << "  "
+        << record.port.leftJustified(8) << " "
+        << direction.leftJustified(3) << " "
+        << raw.toHex(' ');
+    if (!note.isEmpty()) {
+        out << "  | " << note;
+    }
+    out << "\n";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("tracedump");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("串口报文记录离线解析");
+    parser.addHelpOption();
+    parser.addPositionalArgument("file", "报文记录文件（serial.trace）");
+    QCommandLineOption portOption("port", "只输出指定端口", "name");
+    QCommandLineOption rawOption("raw", "按原始数据块输出，不切分报文");
+    QCommandLineOption benchOption("bench-it8512", "对 IT8512+ 接收数据做解码基准测试，重复 n 次", "n");
+    QCommandLineOption clBenchOption("bench-cl200a", "校验 CL-200A 数据块编解码并做基准测试，重复 n 次（不需要记录文件）", "n");
+    parser.addOption(portOption);
+    parser.addOption(rawOption);
+    parser.addOption(benchOption);
+    parser.addOption(clBenchOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    out.setCodec("UTF-8");
+    QTextStream err(stderr);
+
+    if (parser.isSet(clBenchOption)) {
+        return runClBenchmark(qMax(1, parser.value(clBenchOption).toInt()), out);
+    }
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    SerialTraceReader reader;
+    if (!reader.open(parser.positionalArguments().first())) {
+        err << "无法读取: " << reader.errorString() << "\n";
+        return 1;
+    }
+
+    const QString portFilter = parser.value(portOption);
+    const bool raw = parser.isSet(rawOption);
+    const QVector<SerialTraceRecord> &records = reader.records();
+    quint64 firstNs = records.isEmpty() ? 0 : records.first().timestampNs;
+
+    if (parser.isSet(benchOption)) {
+        int iterations = qMax(1, parser.value(benchOption).toInt());
+        return runItBenchmark(records, portFilter, iterations, out);
+    }
+
+    // 每个端口、每个方向各自切分报文
+    QHash<QString, FrameDecoder> decoders;
+
+    for (const SerialTraceRecord &record : records) {
+        if (record.direction == SerialTrace::Session) {
+            qint64 wallMs = record.data.size() >= 8 ? qFromLittleEndian<qint64>(record.data.constData()) : 0;
+            out << "---- 会话开始 "
+                << QDateTime::fromMSecsSinceEpoch(wallMs).toString("yyyy-MM-dd hh:mm:ss.zzz")
+                << " ----\n";
+            firstNs = record.timestampNs;
+            decoders.clear();
+            continue;
+        }
+        if (!portFilter.isEmpty() && record.port != portFilter) {
+            continue;
+        }
+        if (record.direction == SerialTrace::Event) {
+            printLine(out, record, firstNs, "EV", QByteArray(), QString::fromLatin1(record.data));
+            continue;
+        }
+
+        const QString direction = record.direction == SerialTrace::Tx ? "TX" : "RX";
+        if (raw) {
+            printLine(out, record, firstNs, direction, record.data, QString());
+            continue;
+        }
+
+        FrameDecoder &decoder = decoders[record.port + direction];
+        for (const FrameDecoder::Frame &frame : decoder.feed(record.data)) {
+            QString note = FrameDecoder::protocolName(frame.protocol);
+            if (!frame.note.isEmpty()) {
+                note += " " + frame.note;
+            }
+            if (!frame.checksumOk) {
+                note += " [校验错误]";
+            }
+            printLine(out, record, firstNs, direction, frame.raw, note);
+        }
+    }
+
+    out << records.size() << " 条记录";
+    if (reader.wrapCount() > 0) {
+        out << "（环形文件已回绕 " << reader.wrapCount() << " 次，更早的记录已被覆盖）";
+    }
+    out << "\n";
+    return 0;
+}
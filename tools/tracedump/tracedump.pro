@@ -0,0 +1,35 @@
+# 串口报文记录离线解析工具
+# 用法：tracedump [--port COM3] [--raw] serial.trace
+#       tracedump --bench-it8512 100 [--port COM3] serial.trace
+#       tracedump --bench-cl200a 20
+
+QT       = core
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = tracedump
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    framedecoder.cpp \
+    itbench.cpp \
+    clbench.cpp \
+    ../../serial/serialtrace.cpp \
+    ../../communication/protocol.cpp \
+    ../../communication/eleload_itplus.cpp
+
+HEADERS += \
+    framedecoder.h \
+    itbench.h \
+    clbench.h \
+    ../../serial/serialtrace.h \
+    ../../communication/protocol.h \
+    ../../communication/eleload_itplus.h \
+    ../../communication/fieldcodec.h \
+    ../../communication/clblockcodec.h \
+    ../../communication/fixedframedecoder.h \
+    ../../util/devicestate.h \
+    ../../util/mpscqueue.h
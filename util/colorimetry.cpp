@@ -0,0 +1,213 @@
+#include "colorimetry.h"
+#include <cmath>
+
+namespace {
+    // 离普朗克轨迹太远时相关色温没有意义（CIE 15）
+    constexpr float MaxCctDuv = 0.05f;
+
+    // Robertson 等温线：倒色温(MK⁻¹)、CIE 1960 u v、等温线斜率
+    struct Isotherm {
+        float mired;
+        float u;
+        float v;
+        float t;
+    };
+    constexpr Isotherm Isotherms[] = {
+        {   0.0f, 0.18006f, 0.26352f,   -0.24341f },
+        {  10.0f, 0.18066f, 0.26589f,   -0.25479f },
+        {  20.0f, 0.18133f, 0.26846f,   -0.26876f },
+        {  30.0f, 0.18208f, 0.27119f,   -0.28539f },
+        {  40.0f, 0.18293f, 0.27407f,   -0.30470f },
+        {  50.0f, 0.18388f, 0.27709f,   -0.32675f },
+        {  60.0f, 0.18494f, 0.28021f,   -0.35156f },
+        {  70.0f, 0.18611f, 0.28342f,   -0.37915f },
+        {  80.0f, 0.18740f, 0.28668f,   -0.40955f },
+        {  90.0f, 0.18880f, 0.28997f,   -0.44278f },
+        { 100.0f, 0.19032f, 0.29326f,   -0.47888f },
+        { 125.0f, 0.19462f, 0.30141f,   -0.58204f },
+        { 150.0f, 0.19962f, 0.30921f,   -0.70471f },
+        { 175.0f, 0.20525f, 0.31647f,   -0.84901f },
+        { 200.0f, 0.21142f, 0.32312f,   -1.0182f },
+        { 225.0f, 0.21807f, 0.32909f,   -1.2168f },
+        { 250.0f, 0.22511f, 0.33439f,   -1.4512f },
+        { 275.0f, 0.23247f, 0.33904f,   -1.7298f },
+        { 300.0f, 0.24010f, 0.34308f,   -2.0637f },
+        { 325.0f, 0.24792f, 0.34655f,   -2.4681f },
+        { 350.0f, 0.25591f, 0.34951f,   -2.9641f },
+        { 375.0f, 0.26400f, 0.35200f,   -3.5814f },
+        { 400.0f, 0.27218f, 0.35407f,   -4.3633f },
+        { 425.0f, 0.28039f, 0.35577f,   -5.3762f },
+        { 450.0f, 0.28863f, 0.35714f,   -6.7262f },
+        { 475.0f, 0.29685f, 0.35823f,   -8.5955f },
+        { 500.0f, 0.30505f, 0.35907f,  -11.324f },
+        { 525.0f, 0.31320f, 0.35968f,  -15.628f },
+        { 550.0f, 0.32129f, 0.36011f,  -23.325f },
+        { 575.0f, 0.32931f, 0.36038f,  -40.770f },
+        { 600.0f, 0.33724f, 0.36051f, -116.45f },
+    };
+    constexpr int IsothermCount = int(sizeof(Isotherms) / sizeof(Isotherms[0]));
+
+    // CIE 1931 2° 光谱轨迹色度坐标，380~700nm，间隔5nm（700nm 以后与 700nm 重合）
+    struct LocusPoint {
+        float x;
+        float y;
+    };
+    constexpr float LocusFirstNm = 380.0f;
+    constexpr float LocusStepNm = 5.0f;
+    constexpr LocusPoint Locus[] = {
+        { 0.1741f, 0.0050f }, { 0.1740f, 0.0050f }, { 0.1738f, 0.0049f }, { 0.1736f, 0.0049f },     // 380
+        { 0.1733f, 0.0048f }, { 0.1730f, 0.0048f }, { 0.1726f, 0.0048f }, { 0.1721f, 0.0048f },     // 400
+        { 0.1714f, 0.0051f }, { 0.1703f, 0.0058f }, { 0.1689f, 0.0069f }, { 0.1669f, 0.0086f },     // 420
+        { 0.1644f, 0.0109f }, { 0.1611f, 0.0138f }, { 0.1566f, 0.0177f }, { 0.1510f, 0.0227f },     // 440
+        { 0.1440f, 0.0297f }, { 0.1355f, 0.0399f }, { 0.1241f, 0.0578f }, { 0.1096f, 0.0868f },     // 460
+        { 0.0913f, 0.1327f }, { 0.0687f, 0.2007f }, { 0.0454f, 0.2950f }, { 0.0235f, 0.4127f },     // 480
+        { 0.0082f, 0.5384f }, { 0.0039f, 0.6548f }, { 0.0139f, 0.7502f }, { 0.0389f, 0.8120f },     // 500
+        { 0.0743f, 0.8338f }, { 0.1142f, 0.8262f }, { 0.1547f, 0.8059f }, { 0.1929f, 0.7816f },     // 520
+        { 0.2296f, 0.7543f }, { 0.2658f, 0.7243f }, { 0.3016f, 0.6923f }, { 0.3373f, 0.6589f },     // 540
+        { 0.3731f, 0.6245f }, { 0.4087f, 0.5896f }, { 0.4441f, 0.5547f }, { 0.4788f, 0.5202f },     // 560
+        { 0.5125f, 0.4866f }, { 0.5448f, 0.4544f }, { 0.5752f, 0.4242f }, { 0.6029f, 0.3965f },     // 580
+        { 0.6270f, 0.3725f }, { 0.6482f, 0.3514f }, { 0.6658f, 0.3340f }, { 0.6801f, 0.3197f },     // 600
+        { 0.6915f, 0.3083f }, { 0.7006f, 0.2993f }, { 0.7079f, 0.2920f }, { 0.7140f, 0.2859f },     // 620
+        { 0.7190f, 0.2809f }, { 0.7230f, 0.2770f }, { 0.7260f, 0.2740f }, { 0.7283f, 0.2717f },     // 640
+        { 0.7300f, 0.2700f }, { 0.7311f, 0.2689f }, { 0.7320f, 0.2680f }, { 0.7327f, 0.2673f },     // 660
+        { 0.7334f, 0.2666f }, { 0.7340f, 0.2660f }, { 0.7344f, 0.2656f }, { 0.7346f, 0.2654f },     // 680
+        { 0.7347f, 0.2653f },                                                                       // 700
+    };
+    constexpr int LocusCount = int(sizeof(Locus) / sizeof(Locus[0]));
+
+    // 射线 w + t·d 与线段 a→b 求交，成功时返回 t 和线段上的比例 s（0~1）
+    bool intersect(float wx, float wy, float dx, float dy, const LocusPoint &a, const LocusPoint &b,
+                   float &t, float &s)
+    {
+        const float ex = b.x - a.x;
+        const float ey = b.y - a.y;
+        const float denom = dx * ey - dy * ex;
+        if (std::fabs(denom) < 1e-12f) {
+            return false;
+        }
+        const float ax = a.x - wx;
+        const float ay = a.y - wy;
+        t = (ax * ey - ay * ex) / denom;
+        s = (ax * dy - ay * dx) / denom;
+        return s >= 0.0f && s <= 1.0f;
+    }
+
+    // 射线沿 direction（+1 正向，-1 反向）与光谱轨迹的第一个交点
+    bool locusHit(float wx, float wy, float dx, float dy, float direction, float &t, float &wavelength)
+    {
+        bool found = false;
+        for (int i = 0; i + 1 < LocusCount; ++i) {
+            float ti, si;
+            if (!intersect(wx, wy, dx, dy, Locus[i], Locus[i + 1], ti, si)) {
+                continue;
+            }
+            ti *= direction;
+            if (ti > 0.0f && (!found || ti < t)) {
+                found = true;
+                t = ti;
+                wavelength = LocusFirstNm + (float(i) + si) * LocusStepNm;
+            }
+        }
+        return found;
+    }
+}
+
+namespace Colorimetry {
+
+void fromXYZ(const float *X, const float *Y, const float *Z, int count, Result *out, WhitePoint white)
+{
+    // 色度坐标和 Δuv：逐元素算术，无分支
+    for (int i = 0; i < count; ++i) {
+        const float sum = X[i] + Y[i] + Z[i];
+        const float denom = X[i] + 15.0f * Y[i] + 3.0f * Z[i];
+        const bool valid = Y[i] > 0.0f && sum > 0.0f;
+        const float invSum = valid ? 1.0f / sum : 0.0f;
+        const float invDenom = valid ? 1.0f / denom : 0.0f;
+        out[i].x = X[i] * invSum;
+        out[i].y = Y[i] * invSum;
+        out[i].u = 4.0f * X[i] * invDenom;
+        out[i].v = 9.0f * Y[i] * invDenom;
+        out[i].duv = valid ? deltaUv(out[i].u, out[i].v) : 0.0f;
+    }
+
+    // 色温和主波长需要查表
+    for (int i = 0; i < count; ++i) {
+        Result &r = out[i];
+        if (r.y <= 0.0f) {
+            r = Result();
+            continue;
+        }
+        r.cct = std::fabs(r.duv) <= MaxCctDuv ? correlatedColorTemperature(r.u, r.v) : 0.0f;
+        dominantWavelength(r.x, r.y, white, r.dominantWavelength, r.purity);
+    }
+}
+
+Result fromXYZ(float X, float Y, float Z, WhitePoint white)
+{
+    Result result;
+    fromXYZ(&X, &Y, &Z, 1, &result, white);
+    return result;
+}
+
+float correlatedColorTemperature(float u, float v)
+{
+    // Robertson：找到样本点在哪两条等温线之间，按到两条线的距离插值倒色温
+    const float u60 = u;
+    const float v60 = v * (2.0f / 3.0f);
+    float previous = 0.0f;
+    for (int i = 0; i < IsothermCount; ++i) {
+        const Isotherm &line = Isotherms[i];
+        const float distance = ((v60 - line.v) - line.t * (u60 - line.u)) / std::sqrt(1.0f + line.t * line.t);
+        if (i > 0 && (distance < 0.0f) != (previous < 0.0f)) {
+            const float ratio = previous / (previous - distance);
+            const float mired = Isotherms[i - 1].mired + ratio * (line.mired - Isotherms[i - 1].mired);
+            return mired > 0.0f ? 1e6f / mired : 0.0f;
+        }
+        previous = distance;
+    }
+    return 0.0f;
+}
+
+float deltaUv(float u, float v)
+{
+    // Ohno (2014)：CIE 1960 uv 相对 (0.292, 0.24) 的极坐标，用角度的多项式近似轨迹距离
+    const float du = u - 0.292f;
+    const float dv = v * (2.0f / 3.0f) - 0.24f;
+    const float lfp = std::sqrt(du * du + dv * dv);
+    const float a = std::acos(lfp > 0.0f ? du / lfp : 1.0f);
+    const float lbb = ((((((-0.00616793f * a + 0.0893944f) * a - 0.5179722f) * a + 1.5317403f) * a
+                        - 2.4243787f) * a + 1.925865f) * a - 0.471106f);
+    return lfp - lbb;
+}
+
+void dominantWavelength(float x, float y, WhitePoint white, float &wavelength, float &purity)
+{
+    wavelength = 0.0f;
+    purity = 0.0f;
+    const float dx = x - white.x;
+    const float dy = y - white.y;
+    const float distance = std::sqrt(dx * dx + dy * dy);
+    if (distance < 1e-6f) {
+        return;
+    }
+
+    float t = 0.0f;
+    if (locusHit(white.x, white.y, dx, dy, 1.0f, t, wavelength)) {
+        purity = 1.0f / t;      // |样本-白点| / |交点-白点|
+    } else {
+        // 紫色区域：纯度按紫色线计算，主波长取反向射线的补色波长
+        float ts, s;
+        if (intersect(white.x, white.y, dx, dy, Locus[LocusCount - 1], Locus[0], ts, s) && ts > 0.0f) {
+            purity = 1.0f / ts;
+        }
+        float tc;
+        if (locusHit(white.x, white.y, dx, dy, -1.0f, tc, wavelength)) {
+            wavelength = -wavelength;
+        }
+    }
+    if (purity > 1.0f) {
+        purity = 1.0f;
+    }
+}
+
+}
@@ -0,0 +1,45 @@
+#ifndef COLORIMETRY_H
+#define COLORIMETRY_H
+
+/**
+ * 由 CIE 1931 XYZ 计算色度量（CIE 1931 2° 标准观察者）
+ *  x y、u' v'（CIE 1976 UCS）
+ *  相关色温 Tcp：Robertson 等温线插值，适用范围 1667K 以上且 |Δuv| <= 0.05，超出范围为 0
+ *  Δuv：CIE 1960 uv 平面上到普朗克轨迹的距离（Ohno 多项式近似），轨迹上方为正
+ *  主波长和色纯度：以白点（默认等能白 E，LED 主波长的常用约定）为中心，向光谱轨迹作射线求交；
+ *    落在紫色线上时给出补色波长，以负值表示，与 CL-200A 的 15 命令一致
+ *  Y <= 0 或 X+Y+Z <= 0 时全部结果为 0
+ *
+ *  批量接口按数组（结构数组拆分为分量数组）处理，色度坐标和 Δuv 的循环没有分支，便于编译器向量化；
+ *  多受光部一次触发的全部样本一次算完
+ */
+namespace Colorimetry {
+    struct WhitePoint {
+        float x;
+        float y;
+    };
+    constexpr WhitePoint IlluminantE = { 1.0f / 3.0f, 1.0f / 3.0f };
+    constexpr WhitePoint IlluminantD65 = { 0.31271f, 0.32902f };
+
+    struct Result {
+        float x = 0, y = 0;
+        float u = 0, v = 0;                 // u' v'
+        float cct = 0;                      // K
+        float duv = 0;
+        float dominantWavelength = 0;       // nm，补色波长为负
+        float purity = 0;                   // 0~1
+    };
+
+    // 批量计算：X/Y/Z 各 count 个，结果写入 out[0..count)
+    void fromXYZ(const float *X, const float *Y, const float *Z, int count, Result *out,
+                 WhitePoint white = IlluminantE);
+
+    Result fromXYZ(float X, float Y, float Z, WhitePoint white = IlluminantE);
+
+    // 单项计算
+    float correlatedColorTemperature(float u, float v);     // u' v'
+    float deltaUv(float u, float v);                        // u' v'
+    void dominantWavelength(float x, float y, WhitePoint white, float &wavelength, float &purity);
+}
+
+#endif // COLORIMETRY_H
@@ -1,7 +1,8 @@
 #include "config.h"
-#include <QApplication>
+#include <QCoreApplication>
 #include <QDir>
 #include <QDebug>
+#include <QMutex>
 #include "logger.h"
 
 namespace {
@@ -10,18 +11,25 @@ namespace {
     // 串口配置键
     const QString SERIAL_BAUDRATE = "SerialPort/BaudRate";
     const QString SERIAL_DATABITS = "SerialPort/DataBits";
+
+    // 多工位模式下各工作线程都会读取配置，共用的 QSettings 对象加锁访问
+    QMutex &settingsMutex()
+    {
+        static QMutex mutex;
+        return mutex;
+    }
 }
 
 // 初始化静态成员
 QSettings Config::m_settings(
-    QApplication::applicationDirPath() + "/" + CONFIG_PATH + "/" + CONFIG_FILE,
+    QCoreApplication::applicationDirPath() + "/" + CONFIG_PATH + "/" + CONFIG_FILE,
     QSettings::IniFormat
 );
 
 void Config::loadConfig()
 {
     // 确保配置目录存在
-    QDir configDir(QApplication::applicationDirPath() + "/" + CONFIG_PATH);
+    QDir configDir(QCoreApplication::applicationDirPath() + "/" + CONFIG_PATH);
     if (!configDir.exists()) {
         configDir.mkpath(".");
     }
@@ -57,11 +65,13 @@ void Config::saveConfig()
 
 QVariant Config::getValue(const QString &key, const QVariant &defaultValue)
 {
+    QMutexLocker locker(&settingsMutex());
     return m_settings.value(key, defaultValue);
 }
 
 void Config::setValue(const QString &key, const QVariant &value)
 {
+    QMutexLocker locker(&settingsMutex());
     m_settings.setValue(key, value);
 }
 
@@ -36,6 +36,8 @@ namespace ConfigKeys {
     const QString SERIAL_PARITY = "SerialPort/Parity";
     const QString SERIAL_STOPBITS = "SerialPort/StopBits";
     const QString SERIAL_FLOWCONTROL = "SerialPort/FlowControl";
+    const QString SERIAL_EXTRA_PORTS = "SerialPort/ExtraPorts";     // 额外的串口设备路径，如模拟器的伪终端
+    const QString SERIAL_RECONNECT_TIMEOUT = "SerialPort/ReconnectTimeout"; // 意外断开后自动重连的最长时间（秒），0 不重连
 
     // 驱动配置键
     const QString DRIVER_LEVEL = "Driver/DefaultLevel";
@@ -48,17 +50,43 @@ namespace ConfigKeys {
     const QString ELOAD_MAX_CURRENT = "ELoad/MaxCurrent";
     const QString ELOAD_MAX_VOLTAGE = "ELoad/MaxVoltage";
     const QString ELOAD_MAX_POWER = "ELoad/MaxPower";
+    const QString ELOAD_TELEMETRY_INTERVAL = "ELoad/TelemetryIntervalMs";  // 两次状态查询的最小间隔，0为应答后立即查询
+    const QString ELOAD_TELEMETRY_PIPELINE = "ELoad/TelemetryPipeline";    // 同时未应答的查询数
+    const QString ELOAD_TELEMETRY_TIMEOUT = "ELoad/TelemetryTimeoutMs";    // 查询应答超时
+    const QString ELOAD_SETPOINT_DEBOUNCE = "ELoad/SetpointDebounceMs";    // 设定值修改合并窗口
 
     // 照度计配置键
     const QString METER_RANGE = "Meter/DefaultRange";
     const QString METER_BACKLIGHT = "Meter/BacklightEnabled";
     const QString METER_AUTORANGE = "Meter/AutoRange";
+    const QString METER_INTEGRATION_MS = "Meter/IntegrationMs";        // EXT测量后等待积分完成的时间
+    const QString METER_RANGE_SETTLE_MS = "Meter/RangeSettleMs";       // 量程切换后附加的等待时间
+    const QString METER_MIN_INTERVAL_MS = "Meter/MinIntervalMs";       // 两次EXT测量的最小间隔，0为读完立即触发
+    const QString METER_MEASUREMENT_CODES = "Meter/MeasurementCodes";  // 每次触发读取的测量命令，默认 "01"（其余由 XYZ 计算）
+    const QString METER_HEADS = "Meter/Heads";                         // 受光部编号，多受光部如 "0,1,2,3"
+
+    // 特性测试配置键
+    const QString CHAR_FIRST_SETTLE_MS = "Characterization/FirstSettleMs";     // 第一步附加的稳定时间（从关断到点亮）
+    const QString CHAR_ACQUIRE_TIMEOUT_MS = "Characterization/AcquireTimeoutMs"; // 等待照度计、负载读数的超时
+
+    // 恒照度配置键
+    const QString REGULATOR_KP = "Regulator/Kp";                   // 比例增益（强度/lx）
+    const QString REGULATOR_KI = "Regulator/Ki";                   // 积分增益（强度/(lx·s)）
+    const QString REGULATOR_KD = "Regulator/Kd";                   // 微分增益（强度·s/lx）
+    const QString REGULATOR_OUTPUT_MAX = "Regulator/OutputMax";    // 驱动强度上限
+    const QString REGULATOR_TOLERANCE = "Regulator/Tolerance";     // 稳定判定的容差带（相对目标）
+    const QString REGULATOR_SETTLE_SAMPLES = "Regulator/SettleSamples"; // 连续落在容差带内的样本数
 
     // UI配置键
     const QString UI_THEME = "UI/Theme";
     const QString UI_LANGUAGE = "UI/Language";
     const QString UI_CHART_INTERVAL = "UI/ChartUpdateInterval";
     const QString UI_AUTOSAVE_INTERVAL = "UI/AutoSaveInterval";
+
+    // 日志配置键
+    const QString LOG_FILTER_RULES = "Log/FilterRules";
+    const QString TRACE_ENABLED = "Trace/Enabled";
+    const QString TRACE_CAPACITY_MB = "Trace/CapacityMB";
 }
 
 class Config {
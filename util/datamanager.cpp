@@ -64,7 +64,7 @@ bool DataManager::exportToCSV(const QString &filename) const
     stream.setCodec("UTF-8");
 
     // 写入表头
-    stream << "时间戳,电流(A),电压(V),功率(W),电阻(Ω),照度(lx),色温(K),R,G,B\n";
+    stream << "时间戳,电流(A),电压(V),功率(W),电阻(Ω),照度(lx),色温(K),R,G,B,驱动强度\n";
 
     // 写入数据
     for (const auto &data : m_data) {
@@ -176,7 +176,7 @@ void DataManager::trimData()
 
 QString DataManager::measurementToCSV(const MeasurementData &data) const
 {
-    return QString("%1,%2,%3,%4,%5,%6,%7,%8,%9,%10")
+    return QString("%1,%2,%3,%4,%5,%6,%7,%8,%9,%10,%11")
         .arg(data.timestamp.toString("yyyy-MM-dd hh:mm:ss.zzz"))
         .arg(data.current, 0, 'f', 3)
         .arg(data.voltage, 0, 'f', 3)
@@ -186,7 +186,8 @@ QString DataManager::measurementToCSV(const MeasurementData &data) const
         .arg(data.colorTemp, 0, 'f', 3)
         .arg(data.r, 0, 'f', 3)
         .arg(data.g, 0, 'f', 3)
-        .arg(data.b, 0, 'f', 3);
+        .arg(data.b, 0, 'f', 3)
+        .arg(data.drive >= 0 ? QString::number(data.drive) : QString());
 }
 
 QJsonObject DataManager::measurementToJSON(const MeasurementData &data) const
@@ -202,6 +203,9 @@ QJsonObject DataManager::measurementToJSON(const MeasurementData &data) const
     obj["r"] = data.r;
     obj["g"] = data.g;
     obj["b"] = data.b;
+    if (data.drive >= 0) {
+        obj["drive"] = data.drive;
+    }
     return obj;
 }
 
@@ -218,5 +222,6 @@ MeasurementData DataManager::jsonToMeasurement(const QJsonObject &json) const
     data.r = json["r"].toDouble();
     data.g = json["g"].toDouble();
     data.b = json["b"].toDouble();
+    data.drive = json["drive"].toDouble(-1);
     return data;
 }
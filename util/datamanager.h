@@ -40,6 +40,7 @@ struct MeasurementData {
     double r;
     double g;
     double b;
+    double drive = -1;      // 驱动强度设定值（特性测试时记录，-1 表示无）
 };
 
 class DataManager : public QObject
@@ -0,0 +1,166 @@
+#ifndef DEVICESTATE_H
+#define DEVICESTATE_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+/**
+ * 设备状态快照（顺序锁）
+ *  每台设备一个，由协议层在解码响应后更新（单一写入方），界面、报警、记录和自动化从任意线程读取同一份快照
+ *  写入不加锁、不分配：序号置奇数 -> 写数据 -> 序号置偶数；读取方序号前后一致才接受，否则重读
+ *  数据按 64 位原子字保存，读写过程没有数据竞争；T 必须可平凡复制
+ *  version() 每次发布加一，读取方可据此跳过没有变化的刷新
+ *
+ *  用法：
+ *    // 解码线程
+ *    m_state.update([&](LoadState &s) { s.voltage = v; });
+ *    // 任意线程
+ *    quint64 version;
+ *    LoadState s = protocol->state().snapshot(&version);
+ */
+template<typename T>
+class DeviceState
+{
+    static_assert(std::is_trivially_copyable<T>::value, "DeviceState requires a trivially copyable T");
+
+public:
+    DeviceState()
+    {
+        store(m_local);
+    }
+
+    DeviceState(const DeviceState &) = delete;
+    DeviceState &operator=(const DeviceState &) = delete;
+
+    // 写入方：在当前值上修改后发布，返回新版本号
+    template<typename Modify>
+    quint64 update(Modify &&modify)
+    {
+        modify(m_local);
+        return store(m_local);
+    }
+
+    // 写入方：整体替换
+    quint64 publish(const T &value)
+    {
+        m_local = value;
+        return store(m_local);
+    }
+
+    // 写入方：清空为默认值（断开连接时）
+    quint64 reset()
+    {
+        return publish(T());
+    }
+
+    // 读取方（任意线程）
+    T snapshot(quint64 *version = nullptr) const
+    {
+        std::uint64_t words[WordCount];
+        std::uint64_t before;
+        for (;;) {
+            before = m_sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();      // 写入进行中
+                continue;
+            }
+            for (int i = 0; i < WordCount; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        if (version) {
+            *version = before / 2;
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    quint64 version() const
+    {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr int WordCount = int((sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+
+    quint64 store(const T &value)
+    {
+        std::uint64_t words[WordCount] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const std::uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i < WordCount; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+        return (sequence + 2) / 2;
+    }
+
+    std::atomic<std::uint64_t> m_sequence{0};
+    std::atomic<std::uint64_t> m_words[WordCount];
+    T m_local{};        // 写入方持有的当前值
+};
+
+// 电子负载（IT8512+）状态，由 EleLoad_ITPlus 在分发响应时更新
+struct LoadState {
+    float voltage = 0;              // V
+    float current = 0;              // A
+    float power = 0;                // W
+    float maxVoltage = 0;           // 0x23/0x25/0x27 回读的上限
+    float maxCurrent = 0;
+    float maxPower = 0;
+    std::uint8_t temperature = 0;   // 散热器温度 ℃
+    std::uint8_t loadMode = 0;      // 0 CC, 1 CV, 2 CW, 3 CR
+    bool remote = false;            // 远程控制
+    bool output = false;            // 输入打开
+    quint64 samples = 0;            // 收到的输入参数（0x5F）应答数
+    std::chrono::steady_clock::time_point time;     // 最近一次 0x5F 应答的接收时刻
+};
+
+// 照度计（CL-200A）状态，由 CL200AEngine 在每次触发读完后更新（第一个受光部）
+struct MeterState {
+    float ev = 0;                   // lx
+    float X = 0, Y = 0, Z = 0;
+    float x = 0, y = 0;
+    float u = 0, v = 0;             // u' v'
+    float tcp = 0;                  // K
+    float duv = 0;
+    float dominantWavelength = 0;   // nm
+    float purity = 0;
+    int head = 0;
+    char rangeStatus = ' ';
+    quint64 samples = 0;
+    std::chrono::steady_clock::time_point time;     // EXT测量触发时刻
+};
+
+// 恒流驱动器状态，由 DriverWidget 解码驱动器响应后写入 DriverGeneral::state()
+struct DriverState {
+    static constexpr int MaxChannels = 32;
+
+    int channelCount = 0;
+    std::uint16_t strength[MaxChannels] = {};   // 各通道强度寄存器（回读值）
+    bool ledOn = false;
+    std::uint16_t ledMode = 0;
+    std::uint32_t workTime = 0;
+    float ledTemperature = 0;       // ℃
+    float pcbTemperature = 0;       // ℃
+    float ratedVoltage = 0;         // V
+    float ratedCurrent = 0;         // A
+    std::uint32_t voltage = 0;      // 0x56 读取的电压、电流原始值
+    std::uint32_t current = 0;
+    std::chrono::steady_clock::time_point time;     // 最近一次响应的接收时刻
+};
+
+#endif // DEVICESTATE_H
@@ -0,0 +1,26 @@
+#include "logcategories.h"
+#include "config.h"
+
+// 默认只输出 info 及以上，debug/trace 需要在运行期打开
+Q_LOGGING_CATEGORY(lcSerial, "ld.serial", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcProtocol, "ld.protocol", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcLoad, "ld.load", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcMeter, "ld.meter", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcDriver, "ld.driver", QtInfoMsg)
+
+Q_LOGGING_CATEGORY(lcSerialTrace, "ld.serial.trace", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcProtocolTrace, "ld.protocol.trace", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcLoadTrace, "ld.load.trace", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcMeterTrace, "ld.meter.trace", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcDriverTrace, "ld.driver.trace", QtInfoMsg)
+
+void LogCategories::applyFilterRules()
+{
+    // 多条规则用分号或换行分隔，例如 "ld.serial.debug=true;ld.load.debug=true"
+    QString rules = Config::getValue(ConfigKeys::LOG_FILTER_RULES).toString();
+    if (rules.isEmpty()) {
+        return;
+    }
+    rules.replace(';', '\n');
+    QLoggingCategory::setFilterRules(rules);
+}
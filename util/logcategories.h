@@ -0,0 +1,82 @@
+#ifndef LOGCATEGORIES_H
+#define LOGCATEGORIES_H
+
+#include <QLoggingCategory>
+
+/**
+ * 分类日志
+    按模块划分日志分类（ld.serial / ld.protocol / ld.load / ld.meter / ld.driver）
+    运行期级别：各分类默认只输出 info 及以上，
+    可通过配置项 Log/FilterRules 或环境变量 QT_LOGGING_RULES 打开，
+    例如 "ld.serial.debug=true"
+    逐帧报文等高频输出（LD_TRACE）有单独的 .trace 分类，与 debug 分开打开，
+    例如 "ld.protocol.trace.debug=true"；"ld.serial*.debug=true" 同时打开两者
+    编译期裁剪：低于 LD_LOG_MIN_LEVEL 的宏展开为空语句，
+    Release 构建（QT_NO_DEBUG）默认只保留 info 及以上
+    惰性格式化：只有该条日志确实会输出时才会计算 << 后面的参数，
+    因此 toHex() 等开销在关闭时不会发生
+ */
+
+Q_DECLARE_LOGGING_CATEGORY(lcSerial)
+Q_DECLARE_LOGGING_CATEGORY(lcProtocol)
+Q_DECLARE_LOGGING_CATEGORY(lcLoad)
+Q_DECLARE_LOGGING_CATEGORY(lcMeter)
+Q_DECLARE_LOGGING_CATEGORY(lcDriver)
+
+// LD_TRACE 使用的分类，名称为对应分类加 .trace
+Q_DECLARE_LOGGING_CATEGORY(lcSerialTrace)
+Q_DECLARE_LOGGING_CATEGORY(lcProtocolTrace)
+Q_DECLARE_LOGGING_CATEGORY(lcLoadTrace)
+Q_DECLARE_LOGGING_CATEGORY(lcMeterTrace)
+Q_DECLARE_LOGGING_CATEGORY(lcDriverTrace)
+
+// 编译期级别：0 trace, 1 debug, 2 info, 3 warning
+#define LD_LEVEL_TRACE   0
+#define LD_LEVEL_DEBUG   1
+#define LD_LEVEL_INFO    2
+#define LD_LEVEL_WARNING 3
+
+#ifndef LD_LOG_MIN_LEVEL
+#  ifdef QT_NO_DEBUG
+#    define LD_LOG_MIN_LEVEL LD_LEVEL_INFO
+#  else
+#    define LD_LOG_MIN_LEVEL LD_LEVEL_TRACE
+#  endif
+#endif
+
+// 被裁剪的级别：while(false) 保证参数既不求值也不生成代码
+#define LD_LOG_STRIPPED while (false) QMessageLogger().noDebug()
+
+// 逐帧报文等高频输出用 TRACE，LD_TRACE(lcSerial) 输出到 lcSerialTrace（ld.serial.trace）
+#if LD_LOG_MIN_LEVEL <= LD_LEVEL_TRACE
+#  define LD_TRACE(category) qCDebug(category##Trace)
+#else
+#  define LD_TRACE(category) LD_LOG_STRIPPED
+#endif
+
+#if LD_LOG_MIN_LEVEL <= LD_LEVEL_DEBUG
+#  define LD_DEBUG(category) qCDebug(category)
+#else
+#  define LD_DEBUG(category) LD_LOG_STRIPPED
+#endif
+
+#if LD_LOG_MIN_LEVEL <= LD_LEVEL_INFO
+#  define LD_INFO(category) qCInfo(category)
+#else
+#  define LD_INFO(category) LD_LOG_STRIPPED
+#endif
+
+#define LD_WARNING(category) qCWarning(category)
+
+namespace LogCategories {
+    // 从配置中读取过滤规则并应用（程序启动时调用一次）
+    void applyFilterRules();
+}
+
+#endif // LOGCATEGORIES_H
+
+/**
+// 使用示例：
+LD_TRACE(lcSerial) << "TX" << data.toHex(' ');   // 关闭时 toHex 不会执行
+LD_WARNING(lcLoad) << "校验失败" << packet.size();
+ */
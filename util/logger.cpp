@@ -1,70 +1,267 @@
 #include "logger.h"
+#include "mpscqueue.h"
 #include <QDateTime>
 #include <QFile>
 #include <QDir>
 #include <QTextStream>
 #include <QDebug>
+#include <QThread>
+#include <QSemaphore>
 #include <QMutex>
-#include <QApplication>
+#include <QCoreApplication>
+#include <atomic>
 
 namespace {
-    QMutex logMutex;  // 用于多线程日志写入同步
     const QString LOG_PATH = "logs";
     const QString LOG_FILE_FORMAT = "yyyy-MM-dd.log";
-    const int MAX_LOG_DAYS = 30;  // 日志保留天数
+    const int MAX_LOG_DAYS = 30;        // 日志保留天数
+    const int FLUSH_INTERVAL_MS = 100;  // 批量写入间隔
+
+    const char LEVEL_INFO[] = "INFO";
+    const char LEVEL_WARNING[] = "WARNING";
+    const char LEVEL_ERROR[] = "ERROR";
+
+    // 队列中的一条日志，时间戳在调用线程采集，格式化放到写线程
+    struct LogRecord {
+        qint64 msecs = 0;
+        const char *level = nullptr;    // nullptr 表示flush标记
+        QString message;
+        QSemaphore *done = nullptr;     // flush完成后释放
+    };
 }
 
-void Logger::info(const QString &message)
+// 后台写线程：保持当天日志文件常开，批量写入，跨零点轮转
+class LogWriter : public QThread
 {
-    writeLog("INFO", message);
-    qDebug() << "[INFO]" << message;
+public:
+    LogWriter() { start(QThread::LowPriority); }
+
+    // 写线程已停止时返回 false，record 保持不变，由调用者改为直接写入
+    bool enqueue(LogRecord &record, bool urgent)
+    {
+        // 不加锁：先登记再检查停止标志（均为顺序一致的原子操作），
+        // 看到未停止的记录一定在写线程等待 m_inFlight 归零之前入队，会被最后一次 drain() 写出
+        m_inFlight.fetch_add(1);
+        if (m_stopping.load()) {
+            m_inFlight.fetch_sub(1);
+            return false;
+        }
+        m_queue.push(std::move(record));
+        if (urgent) {
+            m_wake.release();
+        }
+        m_inFlight.fetch_sub(1);
+        return true;
+    }
+
+    void stop()
+    {
+        if (m_stopping.exchange(true)) {
+            return;
+        }
+        m_wake.release();
+        wait();
+    }
+
+    // 写线程停止后（退出过程中）的日志同步写入文件
+    void writeDirect(const LogRecord &record)
+    {
+        QMutexLocker locker(&m_directMutex);
+        if (write(record)) {
+            m_stream.flush();
+        }
+    }
+
+protected:
+    void run() override
+    {
+        while (!m_stopping.load(std::memory_order_acquire)) {
+            m_wake.tryAcquire(1, FLUSH_INTERVAL_MS);
+            QMutexLocker locker(&m_directMutex);
+            drain();
+        }
+        // 等待停止前已通过检查的 enqueue 完成入队（只有几条指令）
+        while (m_inFlight.load() != 0) {
+            QThread::yieldCurrentThread();
+        }
+        QMutexLocker locker(&m_directMutex);
+        drain();
+        closeFile();
+    }
+
+private:
+    void drain();
+    bool write(const LogRecord &record);
+    void openFileFor(const QDate &date);
+    void closeFile();
+    static void echo(const LogRecord &record);
+
+    MpscQueue<LogRecord> m_queue;
+    QSemaphore m_wake;
+    std::atomic<bool> m_stopping{false};
+    std::atomic<int> m_inFlight{0};     // 正在 enqueue 中的调用数
+
+    // 以下成员由写线程和停止后的 writeDirect 访问，都在 m_directMutex 保护下
+    QMutex m_directMutex;
+    QFile m_file;
+    QTextStream m_stream;
+    QDate m_fileDate;       // 当前打开文件对应的日期
+    QDate m_lastCleanDate;  // 上次清理旧日志的日期
+};
+
+namespace {
+    struct LogWriterHolder {
+        LogWriter writer;
+        ~LogWriterHolder() { writer.stop(); }
+    };
+
+    LogWriter *logWriter()
+    {
+        static LogWriterHolder holder;
+        return &holder.writer;
+    }
 }
 
-void Logger::warning(const QString &message)
+void LogWriter::drain()
 {
-    writeLog("WARNING", message);
-    qWarning() << "[WARNING]" << message;
+    LogRecord record;
+    bool written = false;
+
+    while (m_queue.pop(record)) {
+        if (!record.level) {
+            // flush标记：之前的记录都已写入
+            if (m_file.isOpen()) {
+                m_stream.flush();
+            }
+            if (record.done) {
+                record.done->release();
+            }
+            continue;
+        }
+
+        written = write(record) || written;
+    }
+
+    if (written) {
+        m_stream.flush();
+    }
 }
 
-void Logger::error(const QString &message)
+bool LogWriter::write(const LogRecord &record)
 {
-    writeLog("ERROR", message);
-    qCritical() << "[ERROR]" << message;
+    QDateTime time = QDateTime::fromMSecsSinceEpoch(record.msecs);
+    if (time.date() != m_fileDate) {
+        openFileFor(time.date());
+    }
+
+    bool written = false;
+    if (m_file.isOpen()) {
+        m_stream << time.toString("yyyy-MM-dd hh:mm:ss.zzz")
+                 << " [" << record.level << "] "
+                 << record.message << '\n';
+        written = true;
+    }
+    echo(record);
+    return written;
 }
 
-void Logger::writeLog(const QString &level, const QString &message)
+void LogWriter::openFileFor(const QDate &date)
 {
-    QMutexLocker locker(&logMutex);
+    closeFile();
 
     // 创建日志目录
-    QString logDir = QApplication::applicationDirPath() + "/" + LOG_PATH;
-    QDir dir(logDir);
+    QDir dir(QCoreApplication::applicationDirPath() + "/" + LOG_PATH);
     if (!dir.exists()) {
         dir.mkpath(".");
     }
 
-    // 清理旧日志
-    cleanOldLogs(dir);
+    // 每天清理一次旧日志
+    if (m_lastCleanDate != date) {
+        Logger::cleanOldLogs(dir);
+        m_lastCleanDate = date;
+    }
+
+    // 以追加模式打开当天的文件，打开失败时当天不再重试
+    m_fileDate = date;
+    m_file.setFileName(dir.filePath(date.toString(LOG_FILE_FORMAT)));
+    if (m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        m_stream.setDevice(&m_file);
+        m_stream.setCodec("UTF-8");
+    }
+}
+
+void LogWriter::closeFile()
+{
+    if (m_file.isOpen()) {
+        m_stream.flush();
+        m_stream.setDevice(nullptr);
+        m_file.close();
+    }
+    m_fileDate = QDate();   // 停止后直接写入时重新打开
+}
+
+void LogWriter::echo(const LogRecord &record)
+{
+    if (record.level == LEVEL_INFO) {
+        qDebug() << "[INFO]" << record.message;
+    } else if (record.level == LEVEL_WARNING) {
+        qWarning() << "[WARNING]" << record.message;
+    } else {
+        qCritical() << "[ERROR]" << record.message;
+    }
+}
+
+void Logger::info(const QString &message)
+{
+    writeLog(LEVEL_INFO, message);
+}
+
+void Logger::warning(const QString &message)
+{
+    writeLog(LEVEL_WARNING, message);
+}
 
-    // 获取当前日期作为文件名
-    QString fileName = QDateTime::currentDateTime().toString(LOG_FILE_FORMAT);
-    QFile file(dir.filePath(fileName));
+void Logger::error(const QString &message)
+{
+    writeLog(LEVEL_ERROR, message);
+}
 
-    // 以追加模式打开文件
-    if (file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        QTextStream stream(&file);
-        stream.setCodec("UTF-8");
+void Logger::writeLog(const char *level, const QString &message)
+{
+    LogRecord record;
+    record.msecs = QDateTime::currentMSecsSinceEpoch();
+    record.level = level;
+    record.message = message;
 
-        // 写入日志
-        QString logLine = QString("%1 [%2] %3\n")
-            .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"))
-            .arg(level)
-            .arg(message);
-        stream << logLine;
-        file.close();
+    // 错误日志立即唤醒写线程，其余按批量间隔写入；写线程已停止时直接写入
+    LogWriter *writer = logWriter();
+    if (!writer->enqueue(record, level == LEVEL_ERROR)) {
+        writer->writeDirect(record);
     }
 }
 
+void Logger::flush()
+{
+    LogWriter *writer = logWriter();
+    if (QThread::currentThread() == writer) {
+        return;
+    }
+
+    // 标记入队成功说明写线程还会再 drain 一次，一定会释放；
+    // 入队失败说明写线程已停止，之后的日志都是同步写入的，无需等待
+    QSemaphore done;
+    LogRecord marker;
+    marker.done = &done;
+    if (writer->enqueue(marker, true)) {
+        done.acquire();
+    }
+}
+
+void Logger::shutdown()
+{
+    logWriter()->stop();
+}
+
 void Logger::cleanOldLogs(const QDir &logDir)
 {
     QDateTime now = QDateTime::currentDateTime();
@@ -76,4 +273,4 @@ void Logger::cleanOldLogs(const QDir &logDir)
             QFile::remove(file.filePath());
         }
     }
-} 
\ No newline at end of file
+}
@@ -4,11 +4,14 @@
 #include <QString>
 #include <QDir>
 
+class LogWriter;
+
 /**
  * 日志记录器
     分级日志（INFO/WARNING/ERROR）
-    自动日志轮转（保留30天）
-    线程安全的日志写入
+    自动日志轮转（跨零点切换文件，每天清理一次，保留30天）
+    异步写入：调用线程只把记录压入无锁队列，
+    由后台写线程保持文件常开、批量写入
     日志格式化（时间戳、级别、消息）
  */
 class Logger {
@@ -16,9 +19,13 @@ public:
     static void info(const QString &message);
     static void warning(const QString &message);
     static void error(const QString &message);
-    
+
+    static void flush();        // 等待队列中已有的日志写入文件
+    static void shutdown();     // 写完剩余日志并停止写线程（程序退出前调用），之后的日志同步写入文件
+
 private:
-    static void writeLog(const QString &level, const QString &message);
+    friend class LogWriter;
+    static void writeLog(const char *level, const QString &message);
     static void cleanOldLogs(const QDir &dir);
 }; 
 
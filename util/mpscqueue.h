@@ -0,0 +1,74 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+/**
+ * 无锁多生产者单消费者队列 (Vyukov MPSC)
+ *  多个线程可以同时调用 push()，只做一次原子交换，不加锁
+ *  只能由一个线程调用 pop()
+ *  T 需要可默认构造、可移动
+ */
+template<typename T>
+class MpscQueue
+{
+public:
+    MpscQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+    ~MpscQueue()
+    {
+        T value;
+        while (pop(value)) {}
+        if (m_tail != &m_stub) {
+            delete m_tail;
+        }
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    // 入队（任意线程）
+    void push(T value)
+    {
+        Node *node = new Node(std::move(value));
+        Node *prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // 出队（仅消费者线程），队列为空时返回false
+    bool pop(T &value)
+    {
+        Node *tail = m_tail;
+        Node *next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        value = std::move(next->value);
+        m_tail = next;      // next 成为新的哨兵节点
+        if (tail != &m_stub) {
+            delete tail;
+        }
+        return true;
+    }
+
+    // 队列是否为空（仅消费者线程调用时结果可靠）
+    bool isEmpty() const
+    {
+        return m_tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        explicit Node(T &&v) : value(std::move(v)) {}
+        std::atomic<Node *> next{nullptr};
+        T value;
+    };
+
+    Node m_stub;                    // 初始哨兵节点
+    std::atomic<Node *> m_head;     // 生产者端
+    Node *m_tail;                   // 消费者端
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,28 @@
+#ifndef STEADYCLOCK_H
+#define STEADYCLOCK_H
+
+#include <QDateTime>
+#include <chrono>
+
+/**
+ * 单调时钟换算
+    各模块的时间戳和间隔都用 std::chrono::steady_clock，不受系统时间调整影响
+    toMs：时长换算为毫秒
+    wallTime：单调时钟时刻换算为墙上时间（DataManager、结果文件按 QDateTime 记录）
+ */
+namespace SteadyClock {
+    using Clock = std::chrono::steady_clock;
+
+    inline double toMs(Clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    inline QDateTime wallTime(Clock::time_point time)
+    {
+        const double ago = toMs(Clock::now() - time);
+        return QDateTime::currentDateTime().addMSecs(-qint64(ago + 0.5));
+    }
+}
+
+#endif // STEADYCLOCK_H